@@ -0,0 +1,145 @@
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "AsyncShader.hpp"
+#include "BenchUtils.hpp"
+
+// 启动延迟对比：同步编译 / 共享上下文工作线程 / KHR_parallel_shader_compile
+// 模拟启动阶段的渲染循环：程序未就绪时用占位程序绘制，统计首帧时间、全部就绪时间和期间绘制的帧数
+// 另外对比逐个 loadShaderFromFile 与批量 loadShaderFiles 的读取耗时
+// 用法：AsyncShaderBenchmark [程序数量，默认 48]
+// Mesa 自带磁盘着色器缓存，建议设置 MESA_SHADER_CACHE_DISABLE=true
+
+const char* fallbackVertex = R"(#version 330 core
+layout(location=0) in vec3 aPos;
+void main(){ gl_Position = vec4(aPos, 1.0); })";
+
+const char* fallbackFragment = R"(#version 330 core
+out vec4 FragColor;
+void main(){ FragColor = vec4(1.0, 0.0, 1.0, 1.0); })";
+
+// 每个程序的源码都不同，避免驱动内部按源码去重
+std::vector<glutils::ProgramStages> makePrograms(int count, int salt) {
+    std::vector<glutils::ProgramStages> programs;
+    for (int i = 0; i < count; ++i) {
+        const std::string k = std::to_string(i + salt * count);
+        glutils::VertexShaderSource vertex(R"(#version 330 core
+layout(location=0) in vec3 aPos;
+uniform mat4 mvp;
+out vec3 vPos;
+void main(){
+    vec3 p = aPos;
+    for (int k = 0; k < 4; ++k)
+        p += 0.01 * sin(p.yzx * float(k + )" + k + R"());
+    vPos = p;
+    gl_Position = mvp * vec4(p, 1.0);
+})");
+        glutils::FragmentShaderSource fragment(R"(#version 330 core
+in vec3 vPos;
+out vec4 FragColor;
+void main(){
+    vec3 N = normalize(cross(dFdx(vPos), dFdy(vPos)));
+    float diff = max(dot(N, normalize(vec3(0.5, 1.0, 0.8))), 0.0);
+    float rim = pow(1.0 - abs(N.z), )" + std::to_string(2 + i % 7) + R"(.0);
+    vec3 color = (0.3 + diff * vec3(0.6, 0.6, 0.55) + rim * 0.5) * vec3(0.95, 0.94, 0.88) * )" + k + R"(.0001;
+    FragColor = vec4(pow(color, vec3(1.0/2.2)), 1.0);
+})");
+        programs.push_back(glutils::makeStages(vertex, fragment));
+    }
+    return programs;
+}
+
+int main(int argc, char** argv) {
+    using namespace glutils;
+    const int count = argc > 1 ? std::stoi(argv[1]) : 48;
+
+    initGLFW();
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    auto window = createWindow(256, 256, "AsyncShaderBenchmark");
+
+    unsigned int fallback = compileShader(VertexShaderSource(fallbackVertex), FragmentShaderSource(fallbackFragment));
+    float triangle[] = { -0.5f, -0.5f, 0.0f, 0.5f, -0.5f, 0.0f, 0.0f, 0.5f, 0.0f };
+    unsigned int VAO, VBO;
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(triangle), triangle, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+
+    const std::pair<AsyncCompileMode, const char*> modes[] = {
+        { AsyncCompileMode::Sync, "同步编译" },
+        { AsyncCompileMode::Worker, "共享上下文工作线程" },
+        { AsyncCompileMode::DriverParallel, "KHR_parallel_shader_compile" },
+    };
+    int salt = 0;
+    for (auto [requested, name] : modes) {
+        // 每种模式使用不同的源码，避免前一轮编译结果被驱动复用
+        auto programs = makePrograms(count, salt++);
+        Stopwatch timer;
+        AsyncShaderCompiler compiler(window, requested);
+        if (compiler.mode() != requested) {
+            std::cout << name << ": 不可用，跳过" << std::endl;
+            continue;
+        }
+        auto handles = compiler.submit(std::move(programs));
+        double submitMs = timer.milliseconds();
+
+        double firstFrameMs = 0.0;
+        int frames = 0;
+        std::size_t remaining = handles.size();
+        while (remaining > 0 || frames == 0) {
+            remaining = compiler.poll();
+            glClear(GL_COLOR_BUFFER_BIT);
+            for (const auto& handle : handles) {
+                glUseProgram(handle.programOr(fallback));
+                glDrawArrays(GL_TRIANGLES, 0, 3);
+            }
+            glfwSwapBuffers(window);
+            if (frames++ == 0) {
+                glFinish();
+                firstFrameMs = timer.milliseconds();
+            }
+        }
+        double readyMs = timer.milliseconds();
+
+        int failed = 0;
+        for (const auto& handle : handles) {
+            failed += handle.failed() ? 1 : 0;
+            glDeleteProgram(handle.program());
+        }
+        std::cout << name << ": 提交 " << submitMs << " ms，首帧 " << firstFrameMs << " ms，全部就绪 " << readyMs
+                  << " ms，期间绘制 " << frames << " 帧" << (failed ? "，失败 " + std::to_string(failed) : "") << std::endl;
+    }
+
+    // 批量读取着色器文件
+    const auto directory = std::filesystem::temp_directory_path() / "glutils_async_shader_bench";
+    std::filesystem::create_directories(directory);
+    std::vector<std::string> paths;
+    auto files = makePrograms(count, salt);
+    for (int i = 0; i < count; ++i) {
+        for (std::size_t s = 0; s < files[i].size(); ++s) {
+            paths.push_back((directory / (std::to_string(i) + "_" + std::to_string(s) + ".glsl")).string());
+            std::ofstream(paths.back(), std::ios::binary) << files[i][s].source;
+        }
+    }
+    Stopwatch timer;
+    std::size_t bytes = 0;
+    for (const auto& path : paths)
+        bytes += Shader::loadShaderFromFile(path).size();
+    double serialMs = timer.milliseconds();
+    timer.reset();
+    std::vector<std::string> sources;
+    loadShaderFiles(paths, sources);
+    double batchMs = timer.milliseconds();
+    std::cout << "读取 " << paths.size() << " 个文件（" << bytes / 1024.0 << " KiB）：逐个 " << serialMs << " ms，批量 " << batchMs << " ms" << std::endl;
+    std::filesystem::remove_all(directory);
+
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteProgram(fallback);
+    glfwDestroyWindow(window);
+    glfwTerminate();
+}
@@ -0,0 +1,159 @@
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "BatchRenderer.hpp"
+#include "BenchUtils.hpp"
+#include "GLUtils.hpp"
+#include "Profiler.hpp"
+
+// 大量立方体的绘制提交开销对比（ExportableCube 的网格与顶点布局）：
+// 1. 逐物体循环：每个物体 setUniform("model") + glDrawElements（ExportableCube 的写法）
+// 2. BatchRenderer 实例化绘制（每个网格一次 glDrawElementsInstanced*）
+// 3. BatchRenderer 多重间接绘制（一次 glMultiDrawElementsIndirect，需要 4.3）
+// 4. 同 3，另加并行视锥剔除（相机绕场景旋转，每帧重新剔除、生成命令并上传可见实例）
+// 用法：BatchBenchmark [立方体数，默认 100000] [帧数，默认 30]
+
+const char* naiveVertex = R"(#version 330 core
+layout(location=0) in vec3 aPos;
+layout(location=1) in vec3 aColor;
+uniform mat4 viewProjection;
+uniform mat4 model;
+out vec3 vColor;
+void main(){ vColor = aColor; gl_Position = viewProjection * model * vec4(aPos, 1.0); })";
+
+float cubeVertices[] = {
+    -0.5f,-0.5f,-0.5f,  1.0f,0.0f,0.0f,  0.5f,-0.5f,-0.5f,  0.0f,1.0f,0.0f,
+     0.5f, 0.5f,-0.5f,  0.0f,0.0f,1.0f, -0.5f, 0.5f,-0.5f,  1.0f,1.0f,0.0f,
+    -0.5f,-0.5f, 0.5f,  1.0f,0.0f,1.0f,  0.5f,-0.5f, 0.5f,  0.0f,1.0f,1.0f,
+     0.5f, 0.5f, 0.5f,  1.0f,1.0f,1.0f, -0.5f, 0.5f, 0.5f,  0.5f,0.5f,0.5f
+};
+std::uint32_t cubeIndices[] = {
+    0,1,2, 2,3,0, 4,5,6, 6,7,4, 0,4,7, 7,3,0,
+    1,5,6, 6,2,1, 3,2,6, 6,7,3, 0,1,5, 5,4,0
+};
+
+// 与批量着色器中的组合方式一致：先缩放、再按四元数旋转、最后平移
+glm::mat4 modelMatrix(const glm::vec3& t, const glm::vec4& q, float s) {
+    const float x = q.x, y = q.y, z = q.z, w = q.w;
+    glm::mat4 m(1.0f);
+    m[0] = glm::vec4(1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y + w * z), 2.0f * (x * z - w * y), 0.0f) * s;
+    m[1] = glm::vec4(2.0f * (x * y - w * z), 1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z + w * x), 0.0f) * s;
+    m[2] = glm::vec4(2.0f * (x * z + w * y), 2.0f * (y * z - w * x), 1.0f - 2.0f * (x * x + y * y), 0.0f) * s;
+    m[3] = glm::vec4(t, 1.0f);
+    return m;
+}
+
+int main(int argc, char** argv) {
+    using namespace glutils;
+    const int cubes = argc > 1 ? std::stoi(argv[1]) : 100000;
+    const int frames = argc > 2 ? std::stoi(argv[2]) : 30;
+
+    initGLFW();
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    auto window = createWindow(256, 256, "BatchBenchmark");
+    glState().enable(GL_DEPTH_TEST);
+    // 只测提交开销，不让光栅化影响结果
+    glState().enable(GL_RASTERIZER_DISCARD);
+    std::cout << "OpenGL " << glGetString(GL_VERSION) << "，立方体 " << cubes << " 个" << std::endl;
+
+    // 立方体排成边长约 side 的方阵，间距 2
+    const int side = std::max(1, static_cast<int>(std::ceil(std::cbrt(double(cubes)))));
+    std::vector<glm::vec3> positions(cubes);
+    std::vector<glm::vec4> rotations(cubes);
+    std::vector<float> scales(cubes);
+    for (int i = 0; i < cubes; ++i) {
+        positions[i] = glm::vec3(float(i % side), float(i / side % side), float(i / (side * side))) * 2.0f - glm::vec3(float(side));
+        rotations[i] = axisAngle(glm::normalize(glm::vec3(1.0f, float(i % 7) + 1.0f, 0.5f)), float(i) * 0.37f);
+        scales[i] = 0.6f + 0.4f * float(i % 5) / 4.0f;
+    }
+    const float radius = float(side) * 2.5f;
+    const glm::mat4 projection = glm::perspective(glm::radians(45.0f), 1.0f, 0.1f, radius * 4.0f);
+    auto viewProjection = [&](int frame) {
+        const float angle = float(frame) * 0.05f;
+        const glm::vec3 eye(std::sin(angle) * radius, radius * 0.3f, std::cos(angle) * radius);
+        return projection * glm::lookAt(eye, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    };
+
+    auto run = [&](const char* name, auto&& frame) {
+        glFinish();
+        GLUTILS_PROFILE_FRAME();
+        Stopwatch timer;
+        for (int f = 0; f < frames; ++f) {
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            frame(f);
+            glfwSwapBuffers(window);
+            GLUTILS_PROFILE_FRAME();
+        }
+        glFinish();
+        const double ms = timer.milliseconds() / frames;
+        std::cout << name << ": 每帧 " << ms << " ms";
+#if GLUTILS_PROFILING
+        std::cout << "，绘制调用 " << Profiler::instance().lastFrame().drawCalls << " 次";
+#endif
+        std::cout << std::endl;
+    };
+
+    {
+        unsigned int VAO, VBO, EBO;
+        glGenVertexArrays(1, &VAO);
+        glGenBuffers(1, &VBO);
+        glGenBuffers(1, &EBO);
+        glState().bindVertexArray(VAO);
+        glState().bindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(cubeVertices), cubeVertices, GL_STATIC_DRAW);
+        glState().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(cubeIndices), cubeIndices, GL_STATIC_DRAW);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+        glEnableVertexAttribArray(1);
+
+        Shader shader(compileShader(VertexShaderSource(naiveVertex), FragmentShaderSource(kBatchFragmentShader)));
+        run("逐物体循环", [&](int f) {
+            shader.use();
+            shader.setUniform("viewProjection", viewProjection(f));
+            glState().bindVertexArray(VAO);
+            for (int i = 0; i < cubes; ++i) {
+                shader.setUniform("model", modelMatrix(positions[i], rotations[i], scales[i]));
+                glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+            }
+            GLUTILS_COUNT_DRAW(cubes);
+        });
+        glState().deleteVertexArray(VAO);
+        glState().deleteBuffer(VBO);
+        glState().deleteBuffer(EBO);
+    }
+
+    auto runBatch = [&](const char* name, BatchRenderer::SubmitMode mode, bool cull) {
+        Shader batchShader(compileShader(VertexShaderSource(kBatchVertexShader), FragmentShaderSource(kBatchFragmentShader)));
+        BatchRenderer batch(mode);
+        if (mode == BatchRenderer::SubmitMode::MultiDrawIndirect && batch.mode() != mode) {
+            std::cout << name << ": 需要 OpenGL 4.3，跳过" << std::endl;
+            return;
+        }
+        const std::uint32_t cube = batch.addMesh(cubeVertices, 8, cubeIndices, 36);
+        for (int i = 0; i < cubes; ++i)
+            batch.addInstance(cube, positions[i], rotations[i], scales[i]);
+        std::size_t visibleTotal = 0;
+        run(name, [&](int f) {
+            const glm::mat4 vp = viewProjection(f);
+            cull ? batch.prepare(vp) : batch.prepare();
+            visibleTotal += batch.visibleCount();
+            batchShader.use();
+            batchShader.setUniform("viewProjection", vp);
+            batch.draw();
+        });
+        if (cull)
+            std::cout << "  平均可见 " << visibleTotal / frames << " / " << cubes << "，命令 " << batch.commands().size() << " 条" << std::endl;
+    };
+    runBatch("实例化绘制", BatchRenderer::SubmitMode::Instanced, false);
+    runBatch("多重间接绘制", BatchRenderer::SubmitMode::MultiDrawIndirect, false);
+    runBatch("多重间接绘制 + 并行视锥剔除", BatchRenderer::SubmitMode::MultiDrawIndirect, true);
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+}
@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "BenchUtils.hpp"
+#include "GLUtils.hpp"
+#include "GpuPointCloud.hpp"
+#include "PointCloud.hpp"
+
+// 点云生成与逐帧处理：CPU 生成 + 上传 vs 计算着色器直接在 GPU 上生成；
+// 每帧的动画 + 视锥剔除 + 紧缩：CPU 多线程处理后上传 vs 计算着色器写入间接绘制命令
+// 校验：GPU 生成的点与 RandomPointSource 逐位比较；可见点数与 CPU 结果比较（边界上的点允许少量差异），
+// 紧缩后的每个点都必须在视锥内；不符合时返回非零退出码
+// 用法：ComputePointBenchmark [点数，默认 10000000] [帧数，默认 10]
+
+const char* vertexShaderSource = "#version 330 core\n layout (location = 0) in vec3 aPos; uniform mat4 mvp; out vec3 vColor; void main() { gl_Position = mvp * vec4(aPos, 1.0); vColor = vec3(aPos.y + 0.5, 0.5, 1.0 - aPos.y); }";
+const char* fragmentShaderSource = "#version 330 core\n in vec3 vColor; out vec4 FragColor; void main() { FragColor = vec4(vColor, 1.0); }";
+
+bool insideFrustum(const glm::mat4& mvp, const glm::vec3& p, float slack) {
+    const glm::vec4 clip = mvp * glm::vec4(p, 1.0f);
+    const float w = clip.w * (1.0f + slack);
+    return std::abs(clip.x) <= w && std::abs(clip.y) <= w && std::abs(clip.z) <= w;
+}
+
+int main(int argc, char** argv) {
+    using namespace glutils;
+    const std::size_t count = argc > 1 ? std::stoull(argv[1]) : 10000000;
+    const int frames = argc > 2 ? std::stoi(argv[2]) : 10;
+
+    initGLFW();
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    auto window = createWindow(800, 600, "ComputePointBenchmark");
+    std::cout << "OpenGL " << glGetString(GL_VERSION) << "，" << count << " 个点" << std::endl;
+    if (!GpuPointCloud::supported()) {
+        std::cout << "需要 OpenGL 4.3 的计算着色器，跳过" << std::endl;
+        glfwTerminate();
+        return 0;
+    }
+    if (!GpuPointCloud::supported(count)) {
+        std::cout << "点数超出 GPU 路径上限 " << GpuPointCloud::maxPoints() << "，跳过" << std::endl;
+        glfwTerminate();
+        return 0;
+    }
+    glState().enable(GL_DEPTH_TEST);
+
+    bool ok = true;
+    {
+        Shader shader(compileShader(VertexShaderSource(vertexShaderSource), FragmentShaderSource(fragmentShaderSource)));
+        const RandomPointSource source(count, 42, -3.0f, 3.0f);
+
+        // CPU 生成 + 上传
+        std::vector<float> cpuPoints(count * 3);
+        unsigned int cpuBuffer;
+        glGenBuffers(1, &cpuBuffer);
+        glFinish();
+        Stopwatch timer;
+        readParallel(source, 0, count, cpuPoints.data());
+        const double generateMs = timer.milliseconds();
+        glState().bindBuffer(GL_ARRAY_BUFFER, cpuBuffer);
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(cpuPoints.size() * sizeof(float)), cpuPoints.data(), GL_DYNAMIC_DRAW);
+        glFinish();
+        std::cout << "CPU 生成 + 上传: " << timer.milliseconds() << " ms（其中生成 " << generateMs << " ms）" << std::endl;
+
+        // GPU 生成（构造时分派一次，这里计入编译时间；再单独计时一次重新生成）
+        timer.reset();
+        GpuPointCloud gpu(count, 42, -3.0f, 3.0f);
+        glFinish();
+        std::cout << "GPU 生成（含着色器编译）: " << timer.milliseconds() << " ms" << std::endl;
+        timer.reset();
+        gpu.generate();
+        glFinish();
+        std::cout << "GPU 重新生成: " << timer.milliseconds() << " ms" << std::endl;
+
+        std::vector<float> readback;
+        gpu.readPoints(0, count, readback);
+        std::size_t mismatched = 0;
+        float maxError = 0.0f;
+        for (std::size_t i = 0; i < readback.size(); ++i) {
+            if (std::memcmp(&readback[i], &cpuPoints[i], sizeof(float)) != 0) {
+                ++mismatched;
+                maxError = std::max(maxError, std::abs(readback[i] - cpuPoints[i]));
+            }
+        }
+        std::cout << "与 CPU 生成器逐位比较: " << mismatched << " 个分量不同，最大误差 " << maxError << std::endl;
+        if (mismatched != 0)
+            ok = false;
+
+        // 逐帧处理
+        const glm::mat4 projection = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 100.0f);
+        const glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 10.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        auto mvpAt = [&](int frame) {
+            return projection * view * glm::rotate(glm::mat4(1.0f), float(frame) * 0.2f, glm::vec3(0.0f, 1.0f, 0.0f));
+        };
+        const PointAnimation animation;
+        gpu.animation = animation;
+
+        unsigned int cpuVao;
+        glGenVertexArrays(1, &cpuVao);
+        glState().bindVertexArray(cpuVao);
+        glState().bindBuffer(GL_ARRAY_BUFFER, cpuBuffer);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
+
+        // CPU：各线程把可见点写到自己区间的开头，再拼接成连续数组上传
+        std::vector<float> visible(count * 3);
+        std::vector<std::size_t> blockCounts;
+        std::size_t cpuVisible = 0;
+        // 软件光栅化器上点的光栅化远比处理慢，计时只看处理 + 提交开销
+        glState().enable(GL_RASTERIZER_DISCARD);
+        glFinish();
+        timer.reset();
+        for (int f = 0; f < frames; ++f) {
+            const glm::mat4 mvp = mvpAt(f);
+            const float time = float(f) * 0.1f;
+            constexpr std::size_t kBlock = 1 << 16;
+            blockCounts.assign((count + kBlock - 1) / kBlock, 0);
+            parallelFor(blockCounts.size(), 1, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t b = begin; b < end; ++b) {
+                    std::size_t n = 0;
+                    float* out = visible.data() + b * kBlock * 3;
+                    for (std::size_t i = b * kBlock; i < std::min(count, (b + 1) * kBlock); ++i) {
+                        const glm::vec3 p = animatePoint(glm::vec3(cpuPoints[i * 3], cpuPoints[i * 3 + 1], cpuPoints[i * 3 + 2]), animation, time);
+                        if (!insideFrustum(mvp, p, 0.0f))
+                            continue;
+                        out[n * 3] = p.x, out[n * 3 + 1] = p.y, out[n * 3 + 2] = p.z;
+                        ++n;
+                    }
+                    blockCounts[b] = n;
+                }
+            });
+            cpuVisible = 0;
+            for (std::size_t b = 0; b < blockCounts.size(); ++b) {
+                std::copy_n(visible.data() + b * kBlock * 3, blockCounts[b] * 3, visible.data() + cpuVisible * 3);
+                cpuVisible += blockCounts[b];
+            }
+            glState().bindBuffer(GL_ARRAY_BUFFER, cpuBuffer);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(cpuVisible * 3 * sizeof(float)), visible.data());
+
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            shader.use();
+            shader.setUniform("mvp", mvp);
+            glState().bindVertexArray(cpuVao);
+            glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(cpuVisible));
+            glfwSwapBuffers(window);
+        }
+        glFinish();
+        std::cout << "CPU 动画 + 剔除 + 上传: 每帧 " << timer.milliseconds() / frames << " ms" << std::endl;
+
+        timer.reset();
+        for (int f = 0; f < frames; ++f) {
+            const glm::mat4 mvp = mvpAt(f);
+            gpu.update(mvp, float(f) * 0.1f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            shader.use();
+            shader.setUniform("mvp", mvp);
+            gpu.draw();
+            glfwSwapBuffers(window);
+        }
+        glFinish();
+        std::cout << "GPU 动画 + 剔除 + 间接绘制: 每帧 " << timer.milliseconds() / frames << " ms" << std::endl;
+        glState().disable(GL_RASTERIZER_DISCARD);
+
+        // 最后一帧：可见数与 CPU 比较，紧缩结果逐点检查
+        const glm::mat4 lastMvp = mvpAt(frames - 1);
+        const std::size_t gpuVisible = gpu.readVisibleCount();
+        const std::size_t difference = gpuVisible > cpuVisible ? gpuVisible - cpuVisible : cpuVisible - gpuVisible;
+        std::cout << "可见点: GPU " << gpuVisible << "，CPU " << cpuVisible << std::endl;
+        if (difference > std::max<std::size_t>(16, count / 10000)) {
+            std::cerr << "可见点数差异过大: " << difference << std::endl;
+            ok = false;
+        }
+        std::vector<float> compacted;
+        gpu.readVisiblePoints(gpuVisible, compacted);
+        std::size_t outside = 0;
+        for (std::size_t i = 0; i < gpuVisible; ++i)
+            if (!insideFrustum(lastMvp, glm::vec3(compacted[i * 3], compacted[i * 3 + 1], compacted[i * 3 + 2]), 1e-3f))
+                ++outside;
+        if (outside != 0) {
+            std::cerr << "紧缩结果中有 " << outside << " 个点在视锥外" << std::endl;
+            ok = false;
+        }
+
+        glState().deleteVertexArray(cpuVao);
+        glState().deleteBuffer(cpuBuffer);
+    }
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    std::cout << (ok ? "GPU 结果与 CPU 一致" : "GPU 结果与 CPU 不一致") << std::endl;
+    return ok ? 0 : 1;
+}
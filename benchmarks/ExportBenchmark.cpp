@@ -0,0 +1,103 @@
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "MeshExporter.hpp"
+
+// 原 ExportableCube 中的 ASCII 导出实现，作为对照组保留
+void exportSceneToSTLAscii(float* vertices, unsigned int* indices, int indexCount, const char* filename) {
+    std::ofstream file(filename);
+    file << "solid ExportedCube" << std::endl;
+    for (int i = 0; i < indexCount; i += 3) {
+        int i0 = indices[i] * 6;
+        int i1 = indices[i + 1] * 6;
+        int i2 = indices[i + 2] * 6;
+
+        file << "  facet normal 0 0 0" << std::endl;
+        file << "    outer loop" << std::endl;
+        file << "      vertex " << vertices[i0] << " " << vertices[i0 + 1] << " " << vertices[i0 + 2] << std::endl;
+        file << "      vertex " << vertices[i1] << " " << vertices[i1 + 1] << " " << vertices[i1 + 2] << std::endl;
+        file << "      vertex " << vertices[i2] << " " << vertices[i2 + 1] << " " << vertices[i2 + 2] << std::endl;
+        file << "    endloop" << std::endl;
+        file << "  endfacet" << std::endl;
+    }
+    file << "endsolid ExportedCube" << std::endl;
+}
+
+// 生成一个 N x N 网格的起伏曲面，顶点格式与 ExportableCube 相同：位置(3) + 颜色(3)
+void buildGrid(std::size_t n, std::vector<float>& vertices, std::vector<unsigned int>& indices) {
+    vertices.resize((n + 1) * (n + 1) * 6);
+    for (std::size_t y = 0; y <= n; ++y) {
+        for (std::size_t x = 0; x <= n; ++x) {
+            float u = float(x) / n, v = float(y) / n;
+            float* p = &vertices[(y * (n + 1) + x) * 6];
+            p[0] = u - 0.5f;
+            p[1] = 0.1f * std::sin(u * 20.0f) * std::cos(v * 20.0f);
+            p[2] = v - 0.5f;
+            p[3] = u; p[4] = v; p[5] = 1.0f;
+        }
+    }
+    indices.resize(n * n * 6);
+    for (std::size_t y = 0; y < n; ++y) {
+        for (std::size_t x = 0; x < n; ++x) {
+            unsigned int a = unsigned(y * (n + 1) + x), b = a + 1, c = a + unsigned(n + 1), d = c + 1;
+            unsigned int* q = &indices[(y * n + x) * 6];
+            q[0] = a; q[1] = c; q[2] = b;
+            q[3] = b; q[4] = c; q[5] = d;
+        }
+    }
+}
+
+template<typename Fn>
+double measure(Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    // 参数：三角形数量（默认约 100 万）
+    std::size_t requested = argc > 1 ? std::stoull(argv[1]) : 1000000;
+    std::size_t n = std::max<std::size_t>(1, std::size_t(std::sqrt(requested / 2.0)));
+
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+    buildGrid(n, vertices, indices);
+    const std::size_t triangles = indices.size() / 3;
+
+    auto dir = std::filesystem::temp_directory_path();
+    auto asciiPath = dir / "glutils_bench_ascii.stl";
+    auto stlPath = dir / "glutils_bench_binary.stl";
+    auto plyPath = dir / "glutils_bench_binary.ply";
+
+    glutils::MeshView mesh{
+        .vertices = vertices.data(),
+        .vertexCount = vertices.size() / 6,
+        .indices = indices.data(),
+        .indexCount = indices.size(),
+        .layout = { 6 * sizeof(float), 0 },
+    };
+
+    std::cout << "三角形数量: " << triangles << "，线程数: " << glutils::workerCount() << std::endl;
+
+    auto report = [&](const char* name, double seconds, const std::filesystem::path& path) {
+        std::cout << name << ": " << seconds * 1000.0 << " ms, "
+                  << triangles / seconds / 1e6 << " M 三角形/秒, "
+                  << std::filesystem::file_size(path) / (1024.0 * 1024.0) << " MiB" << std::endl;
+    };
+
+    double ascii = measure([&] { exportSceneToSTLAscii(vertices.data(), indices.data(), int(indices.size()), asciiPath.string().c_str()); });
+    report("ASCII STL (原实现)", ascii, asciiPath);
+    double stl = measure([&] { glutils::exportSTL(mesh, stlPath); });
+    report("二进制 STL", stl, stlPath);
+    double ply = measure([&] { glutils::exportPLY(mesh, plyPath); });
+    report("二进制 PLY", ply, plyPath);
+    std::cout << "二进制 STL 相对 ASCII 加速: " << ascii / stl << "x" << std::endl;
+
+    std::filesystem::remove(asciiPath);
+    std::filesystem::remove(stlPath);
+    std::filesystem::remove(plyPath);
+}
@@ -0,0 +1,218 @@
+// 性能分析器的事件记录本身会按需扩容，这里关掉，只统计帧内代码的分配
+#define GLUTILS_PROFILING 0
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+#include "BenchUtils.hpp"
+#include "FrameArena.hpp"
+#include "GLHandles.hpp"
+#include "GLUtils.hpp"
+#include "JobSystem.hpp"
+
+// 每帧临时数据与临时 GL 对象的堆分配次数和耗时对比：
+// 1. 每帧新建 std::vector 存放位置与可见列表，临时缓冲逐个 glGenBuffers / glDeleteBuffers（示例程序常见写法）
+// 2. FrameArena 存放临时数据，临时缓冲用 BufferHandle 从对象池取出，析构后由 glObjects() 成批延迟删除，
+//    点的动画用 JobSystem::parallelFor 分块并行计算，任务提交与执行也计入分配次数
+// 替换全局 operator new 统计每帧的堆分配次数；预热之后第 2 种方式每帧必须为 0 次，否则返回非零退出码，
+// 两种方式每帧的可见点数也必须一致
+// 用法：FrameArenaBenchmark [点数，默认 200000] [帧数，默认 120]
+
+namespace {
+
+std::atomic<std::size_t> heapAllocations{ 0 };
+
+}
+
+void* operator new(std::size_t bytes) {
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(bytes ? bytes : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+const char* vertexShaderSource = "#version 330 core\n layout (location = 0) in vec4 aPos; void main() { gl_Position = aPos; }";
+const char* fragmentShaderSource = "#version 330 core\n out vec4 FragColor; void main() { FragColor = vec4(1.0); }";
+
+// 每帧单独上传的小缓冲个数（例如每个物体的 uniform 数据）
+constexpr int kTransientBuffers = 16;
+// 预热帧数：容量在这几帧内增长到稳定值
+constexpr int kWarmupFrames = 5;
+// 并行计算点动画时每个任务的点数
+constexpr std::size_t kAnimateGrain = 4096;
+
+struct Vec4 {
+    float x, y, z, w;
+};
+
+// 第 frame 帧第 i 个点的位置，w 分量用作可见性判断
+Vec4 animatePoint(std::size_t i, int frame) {
+    const float t = float(frame) * 0.05f, phase = float(i) * 0.001f;
+    return { std::sin(phase + t), std::cos(phase * 1.3f + t), 0.0f, 1.0f + 0.5f * std::sin(phase * 0.7f - t) };
+}
+
+bool visible(const Vec4& p) {
+    return std::abs(p.x) < p.w && std::abs(p.y) < p.w;
+}
+
+int main(int argc, char** argv) {
+    using namespace glutils;
+    const std::size_t points = argc > 1 ? std::stoull(argv[1]) : 200000;
+    const int frames = argc > 2 ? std::stoi(argv[2]) : 120;
+
+    initGLFW();
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    auto window = createWindow(64, 64, "FrameArenaBenchmark");
+    // 只测 CPU 侧开销，不让光栅化影响结果
+    glState().enable(GL_RASTERIZER_DISCARD);
+    std::cout << "OpenGL " << glGetString(GL_VERSION) << "，每帧 " << points << " 个点、" << kTransientBuffers
+              << " 个临时缓冲，" << frames << " 帧（前 " << kWarmupFrames << " 帧预热）" << std::endl;
+
+    bool ok = true;
+    {
+        Shader shader(compileShader(VertexShaderSource(vertexShaderSource), FragmentShaderSource(fragmentShaderSource)));
+        auto vao = VertexArrayHandle::create();
+        glState().bindVertexArray(vao.get());
+        glEnableVertexAttribArray(0);
+        float uniformData[64]{};
+
+        struct Result {
+            double ms = 0.0;
+            std::size_t allocations = 0;
+            std::size_t maxFrameAllocations = 0;
+            std::vector<std::size_t> visibleCounts;
+        };
+        auto report = [&](const char* name, const Result& result) {
+            const int measured = frames - kWarmupFrames;
+            std::cout << name << ": 每帧 " << result.ms / measured << " ms，堆分配 " << double(result.allocations) / measured
+                      << " 次（单帧最多 " << result.maxFrameAllocations << " 次）" << std::endl;
+        };
+
+        // 方式 1：每帧新建容器，临时缓冲逐个创建和删除
+        Result naive;
+        naive.visibleCounts.reserve(frames);
+        for (int f = 0; f < frames; ++f) {
+            Stopwatch timer;
+            const std::size_t before = heapAllocations.load(std::memory_order_relaxed);
+
+            std::vector<Vec4> positions;
+            std::vector<std::uint32_t> visibleIndices;
+            for (std::size_t i = 0; i < points; ++i) {
+                positions.push_back(animatePoint(i, f));
+                if (visible(positions.back()))
+                    visibleIndices.push_back(static_cast<std::uint32_t>(i));
+            }
+            std::vector<Vec4> visiblePositions;
+            for (std::uint32_t i : visibleIndices)
+                visiblePositions.push_back(positions[i]);
+
+            unsigned int vbo;
+            glGenBuffers(1, &vbo);
+            glState().bindBuffer(GL_ARRAY_BUFFER, vbo);
+            glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(visiblePositions.size() * sizeof(Vec4)), visiblePositions.data(), GL_STREAM_DRAW);
+            glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(Vec4), (void*)0);
+            for (int b = 0; b < kTransientBuffers; ++b) {
+                unsigned int ubo;
+                glGenBuffers(1, &ubo);
+                glState().bindBuffer(GL_UNIFORM_BUFFER, ubo);
+                glBufferData(GL_UNIFORM_BUFFER, sizeof(uniformData), uniformData, GL_STREAM_DRAW);
+                glState().deleteBuffer(ubo);
+            }
+            shader.use();
+            glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(visiblePositions.size()));
+            glState().deleteBuffer(vbo);
+            glfwSwapBuffers(window);
+
+            const std::size_t allocations = heapAllocations.load(std::memory_order_relaxed) - before;
+            naive.visibleCounts.push_back(visiblePositions.size());
+            if (f >= kWarmupFrames) {
+                naive.ms += timer.milliseconds();
+                naive.allocations += allocations;
+                naive.maxFrameAllocations = std::max(naive.maxFrameAllocations, allocations);
+            }
+        }
+        glFinish();
+        report("每帧 std::vector + glGen/glDelete", naive);
+
+        // 方式 2：FrameArena + 对象池
+        Result pooled;
+        pooled.visibleCounts.reserve(frames);
+        FrameArena arena(1 << 16);
+        JobSystem jobs;
+        const GLObjectPoolStats poolBefore = glObjects().stats();
+        for (int f = 0; f < frames; ++f) {
+            Stopwatch timer;
+            const std::size_t before = heapAllocations.load(std::memory_order_relaxed);
+            arena.reset();
+
+            std::span<Vec4> positions = arena.allocateArray<Vec4>(points);
+            jobs.parallelFor(points, kAnimateGrain, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i)
+                    positions[i] = animatePoint(i, f);
+            });
+            FrameVector<std::uint32_t> visibleIndices(arena);
+            visibleIndices.reserve(points);
+            for (std::size_t i = 0; i < points; ++i)
+                if (visible(positions[i]))
+                    visibleIndices.push_back(static_cast<std::uint32_t>(i));
+            std::span<Vec4> visiblePositions = arena.allocateArray<Vec4>(visibleIndices.size());
+            for (std::size_t k = 0; k < visibleIndices.size(); ++k)
+                visiblePositions[k] = positions[visibleIndices[k]];
+
+            auto vbo = BufferHandle::create();
+            glState().bindBuffer(GL_ARRAY_BUFFER, vbo.get());
+            glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(visiblePositions.size_bytes()), visiblePositions.data(), GL_STREAM_DRAW);
+            glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(Vec4), (void*)0);
+            for (int b = 0; b < kTransientBuffers; ++b) {
+                auto ubo = BufferHandle::create();
+                glState().bindBuffer(GL_UNIFORM_BUFFER, ubo.get());
+                glBufferData(GL_UNIFORM_BUFFER, sizeof(uniformData), uniformData, GL_STREAM_DRAW);
+            }
+            shader.use();
+            glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(visiblePositions.size()));
+            vbo.reset();
+            glObjects().endFrame();
+            glfwSwapBuffers(window);
+
+            const std::size_t allocations = heapAllocations.load(std::memory_order_relaxed) - before;
+            pooled.visibleCounts.push_back(visiblePositions.size());
+            if (f >= kWarmupFrames) {
+                pooled.ms += timer.milliseconds();
+                pooled.allocations += allocations;
+                pooled.maxFrameAllocations = std::max(pooled.maxFrameAllocations, allocations);
+            }
+        }
+        glFinish();
+        report("FrameArena + 对象池 + JobSystem", pooled);
+
+        const GLObjectPoolStats& pool = glObjects().stats();
+        std::cout << "  对象池: glGenBuffers " << pool.genCalls - poolBefore.genCalls << " 次（" << pool.generated - poolBefore.generated
+                  << " 个），glDeleteBuffers " << pool.deleteCalls - poolBefore.deleteCalls << " 次（" << pool.deleted - poolBefore.deleted
+                  << " 个），等待栅栏 " << pool.stalls - poolBefore.stalls << " 次；arena 容量 " << arena.capacity() / 1024
+                  << " KiB，申请 " << arena.blockAllocations() << " 次" << std::endl;
+
+        if (pooled.allocations != 0) {
+            std::cerr << "FrameArena + 对象池 + JobSystem: 预热后仍有 " << pooled.allocations << " 次堆分配" << std::endl;
+            ok = false;
+        }
+        if (naive.visibleCounts != pooled.visibleCounts) {
+            std::cerr << "两种方式的可见点数不一致" << std::endl;
+            ok = false;
+        }
+        vao.reset();
+    }
+    glObjects().flush();
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    std::cout << (ok ? "预热后每帧零堆分配，结果一致" : "存在堆分配或结果不一致") << std::endl;
+    return ok ? 0 : 1;
+}
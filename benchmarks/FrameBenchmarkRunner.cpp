@@ -0,0 +1,122 @@
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+// 帧时间回归基准：以无窗口模式依次运行各示例场景固定帧数，汇总每个场景的 CPU / GPU 帧时间分位数为 JSON
+// 用法：FrameBenchmarkRunner [帧数，默认 300] [输出 JSON 路径] [基线 JSON 路径]
+// 给出基线时，额外打印各场景 p50 / p95 相对基线的变化
+// 示例程序需要已构建在与 benchmarks 同级的 examples 目录下
+
+struct Scene {
+    const char* example;
+    std::vector<std::string> args;
+};
+
+void setEnv(const char* name, const std::string& value) {
+#ifdef _WIN32
+    _putenv_s(name, value.c_str());
+#else
+    setenv(name, value.c_str(), 1);
+#endif
+}
+
+std::string sceneKey(const nlohmann::json& entry) {
+    std::string key = entry.value("example", "");
+    for (const auto& arg : entry.value("args", nlohmann::json::array()))
+        key += " " + arg.get<std::string>();
+    return key;
+}
+
+void compareWithBaseline(const nlohmann::json& results, const std::filesystem::path& baselinePath) {
+    std::ifstream file(baselinePath);
+    if (!file.is_open()) {
+        std::cerr << "无法打开基线文件: " << baselinePath << std::endl;
+        return;
+    }
+    nlohmann::json baseline = nlohmann::json::parse(file, nullptr, false);
+    if (baseline.is_discarded() || !baseline.contains("scenes")) {
+        std::cerr << "基线文件格式错误: " << baselinePath << std::endl;
+        return;
+    }
+    auto change = [](const nlohmann::json& now, const nlohmann::json& before, const char* key) {
+        if (!now.is_object() || !before.is_object() || before.value(key, 0.0) <= 0.0)
+            return std::string("   n/a");
+        char text[32];
+        std::snprintf(text, sizeof(text), "%+6.1f%%", 100.0 * (now.value(key, 0.0) / before.value(key, 0.0) - 1.0));
+        return std::string(text);
+    };
+    std::cerr << "\n相对基线的变化（CPU p50 / CPU p95 / GPU p50 / GPU p95）：" << std::endl;
+    for (const auto& scene : results["scenes"]) {
+        for (const auto& old : baseline["scenes"]) {
+            if (sceneKey(old) != sceneKey(scene))
+                continue;
+            std::cerr << "  " << sceneKey(scene) << ": " << change(scene["cpu_ms"], old["cpu_ms"], "p50") << " / "
+                      << change(scene["cpu_ms"], old["cpu_ms"], "p95") << " / " << change(scene["gpu_ms"], old["gpu_ms"], "p50")
+                      << " / " << change(scene["gpu_ms"], old["gpu_ms"], "p95") << std::endl;
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    const std::string frames = argc > 1 ? argv[1] : "300";
+    const std::filesystem::path outputPath = argc > 2 ? argv[2] : "";
+    const std::filesystem::path baselinePath = argc > 3 ? argv[3] : "";
+
+    const std::filesystem::path examples = std::filesystem::absolute(argv[0]).parent_path().parent_path() / "examples";
+    const std::vector<Scene> scenes = {
+        { "DrawTriangle", {} },
+        { "ExportableCube", {} },
+        { "InteractivePointCloud", { "1000000" } },
+        { "InteractivePointCloud", { "1000000", "octree" } },
+    };
+
+    setEnv("GLUTILS_HEADLESS", "1");
+    setEnv("GLUTILS_BENCH_FRAMES", frames);
+    const std::filesystem::path report = std::filesystem::temp_directory_path() / "glutils_frame_report.json";
+    setEnv("GLUTILS_BENCH_OUTPUT", report.string());
+
+    nlohmann::json results = { { "frames", std::stoi(frames) }, { "scenes", nlohmann::json::array() } };
+    for (const auto& scene : scenes) {
+        std::filesystem::path exe = examples / scene.example;
+#ifdef _WIN32
+        exe += ".exe";
+#endif
+        if (!std::filesystem::exists(exe)) {
+            std::cerr << "跳过 " << scene.example << "：找不到 " << exe << std::endl;
+            continue;
+        }
+        std::string command = "\"" + exe.string() + "\"";
+        for (const auto& arg : scene.args)
+            command += " " + arg;
+        std::filesystem::remove(report);
+        // 示例自身的日志转到标准错误，标准输出只留 JSON
+#ifdef _WIN32
+        int status = std::system(("\"" + command + " 1>&2\"").c_str());
+#else
+        int status = std::system((command + " 1>&2").c_str());
+#endif
+        std::ifstream file(report);
+        nlohmann::json entry = file.is_open() ? nlohmann::json::parse(file, nullptr, false) : nlohmann::json();
+        if (status != 0 || !entry.is_object()) {
+            std::cerr << "场景 " << scene.example << " 运行失败（退出码 " << status << "）" << std::endl;
+            continue;
+        }
+        entry["example"] = scene.example;
+        entry["args"] = scene.args;
+        results["scenes"].push_back(entry);
+    }
+    std::filesystem::remove(report);
+
+    const std::string text = results.dump(2);
+    std::cout << text << std::endl;
+    if (!outputPath.empty())
+        std::ofstream(outputPath) << text << std::endl;
+    if (!baselinePath.empty())
+        compareWithBaseline(results, baselinePath);
+    return results["scenes"].empty() ? 1 : 0;
+}
@@ -0,0 +1,150 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "BenchUtils.hpp"
+#include "FrameCapture.hpp"
+#include "GLUtils.hpp"
+
+// 逐帧捕获的开销：无窗口渲染到离屏 FBO，比较
+// 1. 不捕获
+// 2. 阻塞捕获：每帧 glReadPixels 到内存，在渲染线程上写 PPM（最直接的写法）
+// 3. FrameCapture 异步捕获：PBO 环形缓冲读回，编码线程写 PPM / PNG / YUV
+// 报告每帧耗时和渲染线程等待空闲 PBO 的时间；60 fps 的预算为 16.7 ms。
+// 异步 PPM 的每一帧都与阻塞方式 glReadPixels 得到的像素逐字节比较，YUV 文件大小必须为帧数 × 一帧，否则返回非零退出码。
+// 用法：FrameCaptureBenchmark [宽，默认 1920] [高，默认 1080] [帧数，默认 30] [输出目录，默认 capture_bench，结束后删除]
+
+// 第 frame 帧的画面：背景色和一组矩形的位置随帧号变化，保证每帧内容不同
+void renderFrame(int width, int height, int frame) {
+    glutils::glState().disable(GL_SCISSOR_TEST);
+    glClearColor(float(frame % 7) / 7.0f, 0.2f, float(frame % 11) / 11.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glutils::glState().enable(GL_SCISSOR_TEST);
+    for (int i = 0; i < 16; ++i) {
+        const int x = (frame * 37 + i * 113) % width, y = (frame * 19 + i * 71) % height;
+        glScissor(x, y, width / 8, height / 8);
+        glClearColor(float(i) / 16.0f, float((i * 5) % 16) / 16.0f, 1.0f - float(i) / 16.0f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+    }
+    glutils::glState().disable(GL_SCISSOR_TEST);
+}
+
+// 读取 PPM 的像素部分，并核对尺寸
+bool readPPMPixels(const std::filesystem::path& path, int width, int height, std::vector<std::uint8_t>& pixels) {
+    int w = 0, h = 0;
+    return glutils::readPPM(path, pixels, w, h) && w == width && h == height;
+}
+
+int main(int argc, char** argv) {
+    using namespace glutils;
+    const int width = argc > 1 ? std::stoi(argv[1]) : 1920;
+    const int height = argc > 2 ? std::stoi(argv[2]) : 1080;
+    const int frames = argc > 3 ? std::stoi(argv[3]) : 30;
+    const std::filesystem::path outputDir = argc > 4 ? argv[4] : "capture_bench";
+    const std::size_t frameBytes = std::size_t(width) * height * 4;
+
+    initGLFW(true);
+    auto window = createWindow(width, height, "FrameCaptureBenchmark");
+    const GLuint framebuffer = offscreenFramebuffer();
+    std::cout << "OpenGL " << glGetString(GL_VERSION) << "，" << width << "x" << height << "，" << frames << " 帧" << std::endl;
+
+    auto report = [&](const char* name, double ms, const FrameCaptureStats* stats) {
+        std::cout << name << ": 每帧 " << ms / frames << " ms（" << (ms / frames <= 1000.0 / 60.0 ? "满足" : "超出") << " 60 fps 预算）";
+        if (stats)
+            std::cout << "，等待 PBO " << stats->stallMs << " ms，写出 " << stats->encoded << " 帧，丢弃 " << stats->dropped << " 帧";
+        std::cout << std::endl;
+    };
+
+    bool ok = true;
+    std::filesystem::remove_all(outputDir);
+    std::filesystem::create_directories(outputDir / "blocking");
+
+    {
+        glFinish();
+        Stopwatch timer;
+        for (int f = 0; f < frames; ++f)
+            renderFrame(width, height, f);
+        glFinish();
+        report("不捕获", timer.milliseconds(), nullptr);
+    }
+
+    // 阻塞方式同时保存每帧的像素，作为异步捕获的期望值（PPM 像素部分：从上到下、RGB）
+    std::vector<std::vector<std::uint8_t>> expected(frames);
+    {
+        std::vector<std::uint8_t> pixels(frameBytes);
+        glFinish();
+        Stopwatch timer;
+        for (int f = 0; f < frames; ++f) {
+            renderFrame(width, height, f);
+            glState().bindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+            glPixelStorei(GL_PACK_ALIGNMENT, 4);
+            glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+            ok &= writePPM(outputDir / "blocking" / ("frame_" + std::to_string(f) + ".ppm"), flippedImage(pixels.data(), width, height));
+        }
+        glFinish();
+        report("阻塞 glReadPixels + PPM", timer.milliseconds(), nullptr);
+
+        // 期望值在计时之外重新读取
+        for (int f = 0; f < frames; ++f)
+            ok &= readPPMPixels(outputDir / "blocking" / ("frame_" + std::to_string(f) + ".ppm"), width, height, expected[f]);
+    }
+
+    struct Mode {
+        const char* name;
+        CaptureFormat format;
+        std::filesystem::path output;
+    };
+    const Mode modes[] = {
+        { "异步 PPM", CaptureFormat::PPM, outputDir / "ppm" },
+        { "异步 PNG", CaptureFormat::PNG, outputDir / "png" },
+        { "异步 YUV", CaptureFormat::YUV, outputDir / "video.yuv" },
+    };
+    for (const Mode& mode : modes) {
+        FrameCaptureOptions options;
+        options.format = mode.format;
+        options.output = mode.output;
+        // 基准要求每帧都写出，环满时等待而不是丢帧，等待时间单独报告
+        options.dropWhenBusy = false;
+        FrameCapture capture(width, height, options);
+        glFinish();
+        Stopwatch timer;
+        for (int f = 0; f < frames; ++f) {
+            renderFrame(width, height, f);
+            capture.capture(f, framebuffer);
+        }
+        glFinish();
+        const double renderMs = timer.milliseconds();
+        capture.finish();
+        const double totalMs = timer.milliseconds();
+        const FrameCaptureStats stats = capture.stats();
+        report(mode.name, renderMs, &stats);
+        std::cout << "  （含等待编码线程写完全部帧：每帧 " << totalMs / frames << " ms）" << std::endl;
+        if (stats.encoded != std::size_t(frames) || stats.failed != 0) {
+            std::cerr << mode.name << ": 只写出 " << stats.encoded << " / " << frames << " 帧" << std::endl;
+            ok = false;
+        }
+    }
+
+    std::vector<std::uint8_t> pixels;
+    for (int f = 0; f < frames; ++f) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "frame_%06d.ppm", f);
+        if (!readPPMPixels(outputDir / "ppm" / name, width, height, pixels) || pixels != expected[f]) {
+            std::cerr << "异步 PPM 第 " << f << " 帧与 glReadPixels 结果不一致" << std::endl;
+            ok = false;
+        }
+    }
+    const std::size_t yuvFrameBytes = std::size_t(width) * height + 2 * std::size_t((width + 1) / 2) * ((height + 1) / 2);
+    if (std::filesystem::file_size(outputDir / "video.yuv") != yuvFrameBytes * frames) {
+        std::cerr << "YUV 文件大小不是 " << frames << " 帧" << std::endl;
+        ok = false;
+    }
+
+    std::filesystem::remove_all(outputDir);
+    std::cout << (ok ? "异步捕获的每一帧与 glReadPixels 一致" : "捕获结果校验失败") << std::endl;
+    glfwTerminate();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,267 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "BenchUtils.hpp"
+#include "FramePipeline.hpp"
+#include "GLUtils.hpp"
+#include "JobSystem.hpp"
+#include "StreamBuffer.hpp"
+#include "Transforms.hpp"
+
+// 每帧 CPU 工作（动画 -> 世界 / MVP 矩阵 -> 视锥剔除 -> 紧缩可见实例）与渲染提交的组织方式对比：
+// 1. 单线程：全部在渲染线程上串行
+// 2. 任务系统并行：CPU 工作用 JobSystem::parallelFor 分给所有核心，但渲染线程要等它做完才能提交
+// 3. 帧流水线：模拟线程（+ 任务系统）计算第 N + 1 帧的同时，渲染线程上传并绘制第 N 帧
+// 三种方式逐帧比较可见实例数和矩阵校验和，不一致时返回非零退出码
+// 用法：FramePipelineBenchmark [实例数，默认 200000] [帧数，默认 60]
+
+const char* vertexShaderSource = R"(#version 330 core
+layout(location=0) in vec3 aPos;
+layout(location=1) in vec3 aColor;
+layout(location=2) in mat4 iModel;
+uniform mat4 viewProjection;
+out vec3 vColor;
+void main(){ vColor = aColor; gl_Position = viewProjection * iModel * vec4(aPos, 1.0); })";
+
+const char* fragmentShaderSource = R"(#version 330 core
+in vec3 vColor;
+out vec4 FragColor;
+void main(){ FragColor = vec4(vColor, 1.0); })";
+
+float cubeVertices[] = {
+    -0.5f,-0.5f,-0.5f,  1.0f,0.0f,0.0f,  0.5f,-0.5f,-0.5f,  0.0f,1.0f,0.0f,
+     0.5f, 0.5f,-0.5f,  0.0f,0.0f,1.0f, -0.5f, 0.5f,-0.5f,  1.0f,1.0f,0.0f,
+    -0.5f,-0.5f, 0.5f,  1.0f,0.0f,1.0f,  0.5f,-0.5f, 0.5f,  0.0f,1.0f,1.0f,
+     0.5f, 0.5f, 0.5f,  1.0f,1.0f,1.0f, -0.5f, 0.5f, 0.5f,  0.5f,0.5f,0.5f
+};
+unsigned int cubeIndices[] = {
+    0,1,2, 2,3,0, 4,5,6, 6,7,4, 0,4,7, 7,3,0,
+    1,5,6, 6,2,1, 3,2,6, 6,7,3, 0,1,5, 5,4,0
+};
+
+// 渲染线程交给模拟线程的输入快照
+struct FrameInput {
+    int frame = 0;
+    float time = 0.0f;
+    glm::mat4 viewProjection{ 1.0f };
+};
+
+// 模拟线程的输出：渲染线程只读这些数据
+struct FrameData {
+    int frame = 0;
+    glm::mat4 viewProjection{ 1.0f };
+    glutils::TransformArrays transforms;
+    std::vector<glm::mat4> world, mvp;
+    std::vector<std::uint8_t> keep;
+    std::vector<std::size_t> chunkOffsets;
+    std::vector<glm::mat4> visible;
+};
+
+// 只读的场景：每个实例的位置、旋转轴和转速
+struct Scene {
+    std::vector<glm::vec3> position;
+    std::vector<glm::vec3> axis;
+    std::vector<float> speed;
+    float radius = 0.9f;
+};
+
+constexpr std::size_t kChunk = 4096;
+
+void simulateFrame(const Scene& scene, const FrameInput& input, FrameData& out, glutils::JobSystem& jobs) {
+    const std::size_t count = scene.position.size();
+    out.frame = input.frame;
+    out.viewProjection = input.viewProjection;
+    out.transforms.resize(count);
+    out.world.resize(count);
+    out.mvp.resize(count);
+    out.keep.resize(count);
+    const std::size_t chunks = (count + kChunk - 1) / kChunk;
+    out.chunkOffsets.assign(chunks + 1, 0);
+
+    // 动画 + 变换 + 剔除，每块统计可见数
+    jobs.parallelFor(count, kChunk, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            const float half = input.time * scene.speed[i] * 0.5f, s = std::sin(half);
+            out.transforms.set(i, scene.position[i], glm::vec4(scene.axis[i] * s, std::cos(half)), glm::vec3(0.6f));
+        }
+        glutils::computeTransforms(out.transforms, input.viewProjection, out.world.data(), out.mvp.data(), begin, end);
+        std::size_t visible = 0;
+        for (std::size_t i = begin; i < end; ++i) {
+            // 实例中心的裁剪坐标就是 MVP 的平移列，按包围球半径放宽
+            const glm::vec4 c = out.mvp[i][3];
+            const float w = c.w + scene.radius;
+            out.keep[i] = c.w > -scene.radius && std::abs(c.x) <= w && std::abs(c.y) <= w && std::abs(c.z) <= w;
+            visible += out.keep[i];
+        }
+        out.chunkOffsets[begin / kChunk + 1] = visible;
+    });
+    for (std::size_t c = 0; c < chunks; ++c)
+        out.chunkOffsets[c + 1] += out.chunkOffsets[c];
+
+    // 紧缩：各块按前缀和写到各自的位置，结果与串行顺序一致
+    out.visible.resize(out.chunkOffsets[chunks]);
+    jobs.parallelFor(count, kChunk, [&](std::size_t begin, std::size_t end) {
+        std::size_t o = out.chunkOffsets[begin / kChunk];
+        for (std::size_t i = begin; i < end; ++i)
+            if (out.keep[i])
+                out.visible[o++] = out.world[i];
+    });
+}
+
+std::uint64_t checksum(const FrameData& frame) {
+    std::uint64_t hash = 1469598103934665603ull ^ frame.visible.size();
+    for (const glm::mat4& m : frame.visible) {
+        std::uint32_t bits[2];
+        std::memcpy(&bits[0], &m[3][0], 4);
+        std::memcpy(&bits[1], &m[0][1], 4);
+        hash = (hash ^ bits[0] ^ (std::uint64_t(bits[1]) << 32)) * 1099511628211ull;
+    }
+    return hash;
+}
+
+int main(int argc, char** argv) {
+    using namespace glutils;
+    const std::size_t count = argc > 1 ? std::stoull(argv[1]) : 200000;
+    const int frames = argc > 2 ? std::stoi(argv[2]) : 60;
+
+    initGLFW();
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    auto window = createWindow(256, 256, "FramePipelineBenchmark");
+    glState().enable(GL_DEPTH_TEST);
+
+    Scene scene;
+    const int side = std::max(1, static_cast<int>(std::ceil(std::cbrt(double(count)))));
+    for (std::size_t i = 0; i < count; ++i) {
+        scene.position.push_back(glm::vec3(float(i % side), float(i / side % side), float(i / (side * side))) * 2.0f - glm::vec3(float(side)));
+        scene.axis.push_back(glm::normalize(glm::vec3(1.0f, float(i % 7) + 1.0f, 0.5f)));
+        scene.speed.push_back(0.5f + float(i % 11) * 0.1f);
+    }
+    const float radius = float(side) * 2.0f;
+    const glm::mat4 projection = glm::perspective(glm::radians(45.0f), 1.0f, 0.1f, radius * 4.0f);
+    auto inputFor = [&](int frame) {
+        const float angle = float(frame) * 0.05f;
+        const glm::vec3 eye(std::sin(angle) * radius, radius * 0.3f, std::cos(angle) * radius);
+        return FrameInput{ frame, float(frame) / 60.0f, projection * glm::lookAt(eye, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f)) };
+    };
+
+    JobSystem& jobs = JobSystem::global();
+    std::cout << "OpenGL " << glGetString(GL_VERSION) << "，实例 " << count << " 个，任务系统工作线程 " << jobs.threadCount() << std::endl;
+
+    bool ok = true;
+    {
+        Shader shader(compileShader(VertexShaderSource(vertexShaderSource), FragmentShaderSource(fragmentShaderSource)));
+        unsigned int vao, vbo, ebo;
+        glGenVertexArrays(1, &vao);
+        glGenBuffers(1, &vbo);
+        glGenBuffers(1, &ebo);
+        glState().bindVertexArray(vao);
+        glState().bindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(cubeVertices), cubeVertices, GL_STATIC_DRAW);
+        glState().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(cubeIndices), cubeIndices, GL_STATIC_DRAW);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+        glEnableVertexAttribArray(1);
+
+        StreamBuffer instances(GL_ARRAY_BUFFER, count * sizeof(glm::mat4) * 3);
+        auto render = [&](const FrameData& frame) {
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            if (!frame.visible.empty()) {
+                StreamAllocation allocation = instances.allocate(frame.visible.size() * sizeof(glm::mat4), sizeof(glm::mat4));
+                std::memcpy(allocation.data, frame.visible.data(), allocation.size);
+                instances.commit(allocation);
+                glState().bindVertexArray(vao);
+                glState().bindBuffer(GL_ARRAY_BUFFER, instances.buffer());
+                for (int c = 0; c < 4; ++c) {
+                    glVertexAttribPointer(2 + c, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(allocation.offset + c * sizeof(glm::vec4)));
+                    glEnableVertexAttribArray(2 + c);
+                    glVertexAttribDivisor(2 + c, 1);
+                }
+                shader.use();
+                shader.setUniform("viewProjection", frame.viewProjection);
+                glDrawElementsInstanced(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0, static_cast<GLsizei>(frame.visible.size()));
+            }
+            instances.fence();
+            glfwSwapBuffers(window);
+        };
+
+        {
+            // 预热：首次绘制时驱动才真正编译着色器，不计入第一种方式
+            FrameData warmup;
+            simulateFrame(scene, inputFor(0), warmup, jobs);
+            render(warmup);
+            glFinish();
+        }
+
+        std::vector<std::uint64_t> reference;
+        auto record = [&](const char* name, std::size_t index, const FrameData& frame) {
+            const std::uint64_t sum = checksum(frame);
+            if (reference.size() <= index) {
+                reference.push_back(sum);
+            } else if (reference[index] != sum) {
+                std::cerr << name << ": 第 " << index << " 帧结果与单线程不一致" << std::endl;
+                ok = false;
+            }
+        };
+        auto report = [&](const char* name, double ms, double simulateMs) {
+            std::cout << name << ": 每帧 " << ms / frames << " ms（CPU 工作 " << simulateMs / frames << " ms）" << std::endl;
+        };
+
+        auto runSequential = [&](const char* name, JobSystem& system) {
+            FrameData frame;
+            double simulateMs = 0.0;
+            glFinish();
+            Stopwatch timer;
+            for (int f = 0; f < frames; ++f) {
+                Stopwatch cpu;
+                simulateFrame(scene, inputFor(f), frame, system);
+                simulateMs += cpu.milliseconds();
+                record(name, static_cast<std::size_t>(f), frame);
+                render(frame);
+            }
+            glFinish();
+            report(name, timer.milliseconds(), simulateMs);
+        };
+        {
+            // 没有工作线程：parallelFor 的所有块都在调用线程上执行
+            JobSystem serial(0);
+            runSequential("单线程", serial);
+        }
+        runSequential("任务系统并行", jobs);
+
+        {
+            FramePipeline<FrameInput, FrameData> pipeline(
+                [&](const FrameInput& input, FrameData& frame, JobSystem& system) { simulateFrame(scene, input, frame, system); }, jobs);
+            glFinish();
+            Stopwatch timer;
+            pipeline.submit(inputFor(0));
+            for (int f = 0; f < frames; ++f) {
+                if (f + 1 < frames)
+                    pipeline.submit(inputFor(f + 1));
+                const FrameData& frame = pipeline.acquire();
+                record("帧流水线", static_cast<std::size_t>(frame.frame), frame);
+                render(frame);
+                pipeline.release();
+            }
+            glFinish();
+            const FramePipelineStats stats = pipeline.stats();
+            report("帧流水线", timer.milliseconds(), stats.simulateMs);
+            std::cout << "  渲染线程等待模拟结果: 每帧 " << stats.renderWaitMs / frames << " ms" << std::endl;
+        }
+
+        glState().deleteVertexArray(vao);
+        glState().deleteBuffer(vbo);
+        glState().deleteBuffer(ebo);
+    }
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    std::cout << (ok ? "三种方式逐帧结果一致" : "存在结果不一致的方式") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,130 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "BenchUtils.hpp"
+#include "MappedFile.hpp"
+#include "MeshOptimizer.hpp"
+
+// 网格优化流程的离线评估，只用 CPU，不需要 GL 上下文：
+// 三角形汤（STL 式，每个三角形独立的三个顶点，且三角形顺序打乱）-> 合并顶点 -> 顶点缓存顺序 -> 过度绘制顺序 -> 顶点读取顺序 -> 紧凑格式
+// 每一步输出 ACMR / ATVR（16 项 FIFO 缓存模拟）、顶点读取放大倍数（读取字节 / 顶点缓冲字节）、顶点缓冲和索引缓冲字节数以及耗时
+// 用法：MeshOptimizerBenchmark [二进制 STL 路径]，不给路径时生成一个带法线和颜色的环面
+
+// 环面三角形汤：位置(3) + 法线(3) + 颜色(3)
+glutils::Mesh buildTorusSoup(std::size_t rings, std::size_t sides) {
+    glutils::Mesh mesh;
+    mesh.vertexFloats = 9;
+    mesh.attributes = {
+        { glutils::AttributeKind::Position, 3, 0 },
+        { glutils::AttributeKind::Normal, 3, 3 },
+        { glutils::AttributeKind::Color, 3, 6 },
+    };
+    auto vertex = [&](std::size_t i, std::size_t j) {
+        const float u = float(i % rings) / rings * 6.2831853f, v = float(j % sides) / sides * 6.2831853f;
+        const float nx = std::cos(u) * std::cos(v), ny = std::sin(u) * std::cos(v), nz = std::sin(v);
+        const float px = std::cos(u) * 1.0f + nx * 0.3f, py = std::sin(u) * 1.0f + ny * 0.3f, pz = nz * 0.3f;
+        const float c = float(i % rings) / rings;
+        mesh.vertices.insert(mesh.vertices.end(), { px, py, pz, nx, ny, nz, c, 1.0f - c, 0.5f });
+    };
+    std::vector<std::size_t> order(rings * sides);
+    for (std::size_t q = 0; q < order.size(); ++q)
+        order[q] = q;
+    // 确定性的伪随机打乱，模拟导出工具给出的无序三角形
+    std::uint64_t state = 42;
+    for (std::size_t q = order.size(); q > 1; --q) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        std::swap(order[q - 1], order[(state >> 33) % q]);
+    }
+    for (std::size_t q : order) {
+        const std::size_t i = q / sides, j = q % sides;
+        vertex(i, j); vertex(i + 1, j); vertex(i + 1, j + 1);
+        vertex(i, j); vertex(i + 1, j + 1); vertex(i, j + 1);
+    }
+    return mesh;
+}
+
+bool loadBinaryStl(const char* path, glutils::Mesh& mesh) {
+    glutils::MappedFile file;
+    if (!file.openRead(path) || file.size() < 84) {
+        std::cerr << "无法读取 STL 文件: " << path << std::endl;
+        return false;
+    }
+    const char* data = static_cast<const char*>(file.data());
+    std::uint32_t triangles = 0;
+    std::memcpy(&triangles, data + 80, 4);
+    if (file.size() < 84 + std::size_t(triangles) * 50) {
+        std::cerr << "不是二进制 STL 或文件被截断: " << path << std::endl;
+        return false;
+    }
+    mesh.vertices.resize(std::size_t(triangles) * 9);
+    for (std::size_t t = 0; t < triangles; ++t)
+        std::memcpy(&mesh.vertices[t * 9], data + 84 + t * 50 + 12, 36);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    using namespace glutils;
+    Mesh mesh;
+    if (argc > 1) {
+        if (!loadBinaryStl(argv[1], mesh))
+            return 1;
+    } else {
+        mesh = buildTorusSoup(400, 250);
+    }
+    std::cout << "三角形 " << mesh.vertexCount() / 3 << " 个" << std::endl;
+
+    auto report = [&](const char* step, double ms) {
+        const VertexCacheStats stats = analyzeVertexCache(mesh.indices, mesh.vertexCount());
+        std::cout << step << ": 顶点 " << mesh.vertexCount() << "，ACMR " << stats.acmr << "，ATVR " << stats.atvr << "，读取放大 "
+                  << analyzeVertexFetch(mesh.indices, mesh.vertexCount(), mesh.vertexFloats * sizeof(float))
+                  << "，顶点缓冲 " << mesh.vertexBytes() / 1024.0 << " KiB，索引 " << mesh.indexBytes() / 1024.0 << " KiB";
+        if (ms >= 0.0)
+            std::cout << "，耗时 " << ms << " ms";
+        std::cout << std::endl;
+    };
+
+    // 三角形汤视为顺序索引
+    mesh.indices.resize(mesh.vertexCount());
+    for (std::size_t i = 0; i < mesh.indices.size(); ++i)
+        mesh.indices[i] = static_cast<std::uint32_t>(i);
+    report("三角形汤", -1.0);
+
+    Stopwatch timer;
+    weldVertices(mesh);
+    report("合并重复顶点", timer.milliseconds());
+
+    timer.reset();
+    optimizeVertexCache(mesh.indices, mesh.vertexCount());
+    report("顶点缓存顺序", timer.milliseconds());
+
+    timer.reset();
+    optimizeOverdraw(mesh, mesh.indices);
+    report("过度绘制顺序", timer.milliseconds());
+
+    timer.reset();
+    optimizeVertexFetch(mesh);
+    report("顶点读取顺序", timer.milliseconds());
+
+    timer.reset();
+    const PackedMesh packed = packMesh(mesh);
+    const double packMs = timer.milliseconds();
+    std::cout << "紧凑格式: 每顶点 " << packed.stride << " 字节（原 " << mesh.vertexFloats * sizeof(float) << "），顶点缓冲 "
+              << packed.vertexBytes() / 1024.0 << " KiB，索引 " << packed.indexBytes() / 1024.0 << " KiB（"
+              << (packed.indexType == GL_UNSIGNED_SHORT ? "16" : "32") << " 位），耗时 " << packMs << " ms" << std::endl;
+
+    PackOptions halfOptions;
+    halfOptions.halfPositions = true;
+    const PackedMesh half = packMesh(mesh, halfOptions);
+    float maxError = 0.0f;
+    for (std::size_t v = 0; v < half.vertexCount(); ++v) {
+        for (int k = 0; k < 3; ++k) {
+            std::uint16_t bits;
+            std::memcpy(&bits, &half.vertices[v * half.stride + k * 2], 2);
+            maxError = std::max(maxError, std::abs(detail::halfToFloat(bits) - mesh.vertices[v * mesh.vertexFloats + k]));
+        }
+    }
+    std::cout << "半精度位置: 每顶点 " << half.stride << " 字节，最大位置误差 " << maxError << std::endl;
+}
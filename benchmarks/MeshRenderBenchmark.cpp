@@ -0,0 +1,222 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "AsyncShader.hpp"
+#include "BenchUtils.hpp"
+#include "GLHandles.hpp"
+#include "GLUtils.hpp"
+#include "MeshLoader.hpp"
+#include "Parallel.hpp"
+#include "Transforms.hpp"
+
+// MeshViewer 的两部分开销：
+// 1. 加载：同一个球面网格分别存为二进制 STL、ASCII STL、二进制 PLY、OBJ，报告并行解析的 MiB/s 与 M 三角形/s，
+//    以及合并顶点 + 平滑法线的耗时；各格式读回的三角形位置必须与原网格逐位一致
+// 2. 顶点着色器：MilkWhite.vert（uniform 法线矩阵）与 MilkWhiteLegacy.vert（逐顶点 transpose(inverse(model))）各画若干帧，
+//    开启 GL_RASTERIZER_DISCARD 只留下顶点阶段；两者在 512x512 的离屏帧缓冲中渲染的图像每个通道相差不能超过 2
+// 任何校验失败返回非零退出码
+// 用法：MeshRenderBenchmark [球面纬线数，默认 500（约 100 万三角形）] [帧数，默认 30] [临时目录，默认 mesh_bench，结束后删除]
+
+// 经纬度球面，只有位置；法线由加载和平滑步骤生成
+glutils::Mesh buildSphere(int rings) {
+    const int segments = rings * 2;
+    const float pi = 3.14159265f;
+    glutils::Mesh mesh = glutils::makePositionNormalMesh();
+    for (int r = 0; r <= rings; ++r) {
+        const float theta = pi * float(r) / float(rings);
+        for (int s = 0; s <= segments; ++s) {
+            const float phi = 2.0f * pi * float(s) / float(segments);
+            mesh.vertices.insert(mesh.vertices.end(), { std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi), 0.0f, 0.0f, 0.0f });
+        }
+    }
+    for (int r = 0; r < rings; ++r) {
+        for (int s = 0; s < segments; ++s) {
+            const std::uint32_t a = r * (segments + 1) + s, b = a + segments + 1;
+            mesh.indices.insert(mesh.indices.end(), { a, b, a + 1, a + 1, b, b + 1 });
+        }
+    }
+    return mesh;
+}
+
+// %.9g 可以精确还原 float，文本格式读回后位置逐位一致
+bool writeObj(const glutils::Mesh& mesh, const std::filesystem::path& path) {
+    std::FILE* file = std::fopen(path.string().c_str(), "wb");
+    if (!file)
+        return false;
+    for (std::size_t v = 0; v < mesh.vertexCount(); ++v)
+        std::fprintf(file, "v %.9g %.9g %.9g\n", mesh.vertices[v * 6], mesh.vertices[v * 6 + 1], mesh.vertices[v * 6 + 2]);
+    for (std::size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+        std::fprintf(file, "f %u %u %u\n", mesh.indices[i] + 1, mesh.indices[i + 1] + 1, mesh.indices[i + 2] + 1);
+    return std::fclose(file) == 0;
+}
+
+bool writeAsciiStl(const glutils::Mesh& mesh, const std::filesystem::path& path) {
+    std::FILE* file = std::fopen(path.string().c_str(), "wb");
+    if (!file)
+        return false;
+    std::fprintf(file, "solid sphere\n");
+    for (std::size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+        std::fprintf(file, "  facet normal 0 0 0\n    outer loop\n");
+        for (int k = 0; k < 3; ++k) {
+            const float* p = &mesh.vertices[mesh.indices[i + k] * 6];
+            std::fprintf(file, "      vertex %.9g %.9g %.9g\n", p[0], p[1], p[2]);
+        }
+        std::fprintf(file, "    endloop\n  endfacet\n");
+    }
+    std::fprintf(file, "endsolid sphere\n");
+    return std::fclose(file) == 0;
+}
+
+// 按三角形逐个比较位置，与顶点编号无关
+bool samePositions(const glutils::Mesh& a, const glutils::Mesh& b) {
+    if (a.indices.size() != b.indices.size())
+        return false;
+    for (std::size_t i = 0; i < a.indices.size(); ++i)
+        if (std::memcmp(&a.vertices[a.indices[i] * a.vertexFloats], &b.vertices[b.indices[i] * b.vertexFloats], 3 * sizeof(float)) != 0)
+            return false;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    using namespace glutils;
+    const int rings = argc > 1 ? std::stoi(argv[1]) : 500;
+    const int frames = argc > 2 ? std::stoi(argv[2]) : 30;
+    const std::filesystem::path tempDir = argc > 3 ? argv[3] : "mesh_bench";
+    bool ok = true;
+
+    Mesh sphere = buildSphere(rings);
+    computeSmoothNormals(sphere);
+    std::filesystem::create_directories(tempDir);
+    struct Format {
+        const char* name;
+        std::filesystem::path path;
+    };
+    const Format formats[] = {
+        { "二进制 STL", tempDir / "sphere.stl" },
+        { "ASCII STL", tempDir / "sphere_ascii.stl" },
+        { "二进制 PLY", tempDir / "sphere.ply" },
+        { "OBJ", tempDir / "sphere.obj" },
+    };
+    ok &= exportSTL(sphere.view(), formats[0].path) && writeAsciiStl(sphere, formats[1].path) && exportPLY(sphere.view(), formats[2].path) &&
+          writeObj(sphere, formats[3].path);
+    std::cout << "球面网格 " << sphere.triangleCount() << " 个三角形，" << sphere.vertexCount() << " 个顶点，" << workerCount() << " 个线程" << std::endl;
+
+    Mesh loaded;
+    for (const Format& format : formats) {
+        const double mib = double(std::filesystem::file_size(format.path)) / (1024.0 * 1024.0);
+        // 第一次加载预热页缓存，计时取后两次的平均
+        ok &= loadMesh(format.path, loaded);
+        Stopwatch timer;
+        for (int i = 0; i < 2; ++i)
+            ok &= loadMesh(format.path, loaded);
+        const double ms = timer.milliseconds() / 2.0;
+        std::cout << format.name << "（" << mib << " MiB）：" << ms << " ms，" << mib / (ms / 1000.0) << " MiB/s，"
+                  << double(loaded.triangleCount()) / (ms * 1000.0) << " M 三角形/s" << std::endl;
+        if (!samePositions(sphere, loaded)) {
+            std::cerr << format.name << " 读回的三角形与原网格不一致" << std::endl;
+            ok = false;
+        }
+    }
+    {
+        // loaded 为最后一种格式（OBJ，无法线时已经计算过平滑法线），重新计时只算法线；STL 三角形汤需要先合并
+        Stopwatch timer;
+        computeSmoothNormals(loaded);
+        std::cout << "平滑法线（索引网格）：" << timer.milliseconds() << " ms" << std::endl;
+        ok &= loadMesh(formats[0].path, loaded);
+        timer.reset();
+        smoothMeshNormals(loaded);
+        std::cout << "合并顶点 + 平滑法线（STL 三角形汤）：" << timer.milliseconds() << " ms，" << loaded.vertexCount() << " 个顶点" << std::endl;
+    }
+    std::filesystem::remove_all(tempDir);
+
+    // 无窗口模式：渲染到离屏 FBO，读回的像素有定义；不可见窗口的默认帧缓冲可能不存在
+    initGLFW(true);
+    auto window = createWindow(512, 512, "MeshRenderBenchmark");
+    glState().enable(GL_DEPTH_TEST);
+    std::cout << "OpenGL " << glGetString(GL_VERSION) << std::endl;
+    {
+        std::vector<std::string> sources;
+        if (!loadShaderFiles({ "res/shaders/MilkWhite.vert", "res/shaders/MilkWhite.frag", "res/shaders/MilkWhiteLegacy.vert" }, sources)) {
+            glfwTerminate();
+            return 1;
+        }
+        Shader uniformProgram(compileShader(VertexShaderSource{ sources[0] }, FragmentShaderSource{ sources[1] }));
+        Shader legacyProgram(compileShader(VertexShaderSource{ sources[2] }, FragmentShaderSource{ sources[1] }));
+
+        auto vao = VertexArrayHandle::create();
+        auto vbo = BufferHandle::create();
+        auto ebo = BufferHandle::create();
+        glState().bindVertexArray(vao.get());
+        glState().bindBuffer(GL_ARRAY_BUFFER, vbo.get());
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(loaded.vertexBytes()), loaded.vertices.data(), GL_STATIC_DRAW);
+        glState().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo.get());
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(loaded.indexBytes()), loaded.indices.data(), GL_STATIC_DRAW);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+        glEnableVertexAttribArray(1);
+        const GLsizei indexCount = static_cast<GLsizei>(loaded.indices.size());
+
+        const glm::vec3 eye(0.0f, 0.5f, 3.0f);
+        const glm::mat4 viewProjection = glm::perspective(glm::radians(45.0f), 1.0f, 0.1f, 100.0f) *
+                                         glm::lookAt(eye, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        // 非均匀缩放：法线必须用逆转置变换，才能看出两种写法是否等价
+        auto modelAt = [](int frame) {
+            return glm::scale(glm::rotate(glm::mat4(1.0f), float(frame) * 0.05f, glm::vec3(0.3f, 1.0f, 0.0f)), glm::vec3(1.0f, 0.6f, 0.8f));
+        };
+        auto draw = [&](bool legacy, int frame) {
+            Shader& program = legacy ? legacyProgram : uniformProgram;
+            const glm::mat4 model = modelAt(frame);
+            program.use();
+            program.setUniform("mvp", viewProjection * model);
+            if (legacy)
+                program.setUniform("model", model);
+            else
+                program.setUniform("normalMatrix", normalMatrix(model));
+            program.setUniform("viewPos", eye);
+            glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
+        };
+
+        std::vector<std::uint8_t> images[2];
+        for (int legacy = 0; legacy < 2; ++legacy) {
+            glState().enable(GL_RASTERIZER_DISCARD);
+            draw(legacy, 0);
+            glFinish();
+            Stopwatch timer;
+            for (int f = 0; f < frames; ++f)
+                draw(legacy, f);
+            glFinish();
+            const double ms = timer.milliseconds() / frames;
+            std::cout << (legacy ? "逐顶点 transpose(inverse(model))" : "uniform 法线矩阵") << "：顶点阶段每帧 " << ms << " ms，"
+                      << double(indexCount) / (ms * 1000.0) << " M 顶点调用/s（按索引数计）" << std::endl;
+
+            glState().disable(GL_RASTERIZER_DISCARD);
+            glClearColor(0.08f, 0.08f, 0.1f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            draw(legacy, 7);
+            images[legacy].resize(512 * 512 * 4);
+            glState().bindFramebuffer(GL_READ_FRAMEBUFFER, offscreenFramebuffer());
+            glPixelStorei(GL_PACK_ALIGNMENT, 4);
+            glReadPixels(0, 0, 512, 512, GL_RGBA, GL_UNSIGNED_BYTE, images[legacy].data());
+        }
+        int maxDelta = 0;
+        for (std::size_t i = 0; i < images[0].size(); ++i)
+            maxDelta = std::max(maxDelta, std::abs(int(images[0][i]) - int(images[1][i])));
+        std::cout << "两种着色器的图像最大通道差 " << maxDelta << std::endl;
+        if (maxDelta > 2) {
+            std::cerr << "uniform 法线矩阵与逐顶点求逆的结果不一致" << std::endl;
+            ok = false;
+        }
+    }
+    glObjects().flush();
+    glfwTerminate();
+    std::cout << (ok ? "所有校验通过" : "校验失败") << std::endl;
+    return ok ? 0 : 1;
+}
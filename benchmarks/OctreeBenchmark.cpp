@@ -0,0 +1,85 @@
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "BenchUtils.hpp"
+#include "Octree.hpp"
+#include "PointCloud.hpp"
+
+// 无窗口基准：八叉树构建耗时，以及几条脚本化相机路径下每帧提交的点数
+// 用法：OctreeBenchmark [点数，默认 1000 万]
+
+constexpr int FRAMES = 240;
+constexpr float WIDTH = 800.0f, HEIGHT = 600.0f;
+
+struct CameraPath {
+    const char* name;
+    // 输入 [0, 1) 的进度，返回 (相机位置, 观察目标)
+    std::function<std::pair<glm::vec3, glm::vec3>(float)> pose;
+};
+
+int main(int argc, char** argv) {
+    std::size_t count = argc > 1 ? std::stoull(argv[1]) : 10000000;
+
+    std::vector<float> points(count * 3);
+    glutils::RandomPointSource source(count, 42, -3.0f, 3.0f);
+    glutils::readParallel(source, 0, count, points.data());
+
+    glutils::Stopwatch buildTimer;
+    glutils::Octree octree;
+    octree.build(points.data(), count);
+    double buildMs = buildTimer.milliseconds();
+    std::cout << "点数: " << count << "，线程数: " << glutils::workerCount() << std::endl;
+    std::cout << "构建耗时: " << buildMs << " ms，节点数: " << octree.nodes().size()
+              << "（" << octree.nodes().size() * sizeof(glutils::OctreeNode) / 1024.0 << " KiB）" << std::endl;
+
+    const std::vector<CameraPath> paths = {
+        { "环绕", [](float t) {
+            float a = t * 6.2831853f;
+            return std::pair{ glm::vec3(10.0f * std::cos(a), 2.0f, 10.0f * std::sin(a)), glm::vec3(0.0f) };
+        } },
+        { "穿越", [](float t) {
+            glm::vec3 eye(0.3f, 0.2f, 10.0f - 20.0f * t);
+            return std::pair{ eye, eye + glm::vec3(0.0f, 0.0f, -1.0f) };
+        } },
+        { "内部环视", [](float t) {
+            float a = t * 6.2831853f;
+            glm::vec3 eye(0.0f, 0.0f, 1.0f);
+            return std::pair{ eye, eye + glm::vec3(std::cos(a), 0.0f, std::sin(a)) };
+        } },
+        { "远景", [](float t) {
+            float a = t * 6.2831853f;
+            return std::pair{ glm::vec3(40.0f * std::cos(a), 10.0f, 40.0f * std::sin(a)), glm::vec3(0.0f) };
+        } },
+    };
+
+    glm::mat4 proj = glm::perspective(glm::radians(45.0f), WIDTH / HEIGHT, 0.1f, 100.0f);
+    glutils::OctreeDrawList drawList;
+    for (bool lodEnabled : { false, true }) {
+        glutils::OctreeLod lod;
+        lod.viewportHeight = HEIGHT;
+        lod.projScale = proj[1][1];
+        lod.enabled = lodEnabled;
+        std::cout << (lodEnabled ? "\n[剔除 + LOD]" : "\n[仅视锥剔除]") << std::endl;
+        for (const auto& path : paths) {
+            double selectMs = 0.0, points = 0.0, ranges = 0.0;
+            for (int frame = 0; frame < FRAMES; ++frame) {
+                auto [eye, target] = path.pose(float(frame) / FRAMES);
+                glm::mat4 view = glm::lookAt(eye, target, glm::vec3(0.0f, 1.0f, 0.0f));
+                glm::mat4 model = glm::rotate(glm::mat4(1.0f), frame / 60.0f * 0.2f, glm::vec3(0.0f, 1.0f, 0.0f));
+                glm::mat4 mvp = proj * view * model;
+                glutils::Stopwatch timer;
+                octree.select(mvp, lod, drawList);
+                selectMs += timer.milliseconds();
+                points += double(drawList.points);
+                ranges += double(drawList.first.size());
+            }
+            std::cout << "  " << path.name << ": 平均每帧提交 " << points / FRAMES << " 点（"
+                      << 100.0 * points / FRAMES / count << "%），" << ranges / FRAMES << " 个绘制区间，选择耗时 "
+                      << selectMs / FRAMES << " ms" << std::endl;
+        }
+    }
+}
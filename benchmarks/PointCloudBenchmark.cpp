@@ -0,0 +1,73 @@
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "BenchUtils.hpp"
+#include "PointCloud.hpp"
+
+// 用法：
+//   PointCloudBenchmark                    依次以子进程运行 1M / 10M / 50M / 100M 两种模式（峰值内存按进程统计）
+//   PointCloudBenchmark <点数> legacy      原实现：单个 mt19937 + 未 reserve 的 push_back
+//   PointCloudBenchmark <点数> chunked     计数器随机数分块并行生成，写入一次性分配的目标缓冲
+//
+// chunked 模式的目标缓冲模拟持久映射的顶点缓冲，"首块就绪" 即示例中能画出第一帧的时间点。
+
+constexpr std::size_t CHUNK_POINTS = 1 << 20;
+
+void runLegacy(std::size_t count) {
+    glutils::Stopwatch timer;
+    std::vector<float> vertices;
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> dist(-3.0f, 3.0f);
+    for (std::size_t i = 0; i < count * 3; ++i) vertices.push_back(dist(rng));
+    double total = timer.milliseconds();
+    // 原实现要等全部生成完才能调用 glBufferData，首帧时间即总时间
+    std::cout << "legacy  " << count << " 点: 首帧可用 " << total << " ms, 全部完成 " << total << " ms, 峰值内存 "
+              << glutils::peakResidentBytes() / (1024.0 * 1024.0) << " MiB" << std::endl;
+}
+
+void runChunked(std::size_t count) {
+    glutils::Stopwatch timer;
+    glutils::RandomPointSource source(count, 42, -3.0f, 3.0f);
+    // 不做值初始化，避免先把整块内存清零一遍
+    std::unique_ptr<float[]> target(new float[count * 3]);
+    double firstChunk = 0.0;
+    for (std::size_t first = 0; first < count; first += CHUNK_POINTS) {
+        std::size_t n = std::min(CHUNK_POINTS, count - first);
+        glutils::readParallel(source, first, n, target.get() + first * 3);
+        if (first == 0)
+            firstChunk = timer.milliseconds();
+    }
+    double total = timer.milliseconds();
+    std::cout << "chunked " << count << " 点: 首帧可用 " << firstChunk << " ms, 全部完成 " << total << " ms, 峰值内存 "
+              << glutils::peakResidentBytes() / (1024.0 * 1024.0) << " MiB（" << glutils::workerCount() << " 线程）" << std::endl;
+
+    // 确定性检查：分块并行结果必须与单线程逐点生成一致
+    float check[3];
+    source.read(count - 1, 1, check);
+    if (check[0] != target[(count - 1) * 3] || check[2] != target[(count - 1) * 3 + 2]) {
+        std::cerr << "并行生成结果与顺序生成不一致" << std::endl;
+        std::exit(1);
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 3) {
+        std::size_t count = std::stoull(argv[1]);
+        std::string mode = argv[2];
+        if (mode == "legacy")
+            runLegacy(count);
+        else
+            runChunked(count);
+        return 0;
+    }
+    for (std::size_t count : { 1000000ull, 10000000ull, 50000000ull, 100000000ull }) {
+        for (const char* mode : { "legacy", "chunked" }) {
+            std::string command = "\"" + std::string(argv[0]) + "\" " + std::to_string(count) + " " + mode;
+            if (std::system(command.c_str()) != 0)
+                return 1;
+        }
+    }
+}
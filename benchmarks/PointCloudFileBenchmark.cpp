@@ -0,0 +1,113 @@
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "BenchUtils.hpp"
+#include "Octree.hpp"
+#include "PointCloudFile.hpp"
+
+// .gpc 量化点云文件与原始 float32 文件的体积、加载吞吐对比，以及 ASCII XYZ 导入吞吐
+// 用法：PointCloudFileBenchmark [点数，默认 1000 万]
+// 注意：文件刚写完，页缓存是热的，测到的是内存映射 + 解码的上限，而不是磁盘带宽
+
+int main(int argc, char** argv) {
+    std::size_t count = argc > 1 ? std::stoull(argv[1]) : 10000000;
+    const double GiB = 1024.0 * 1024.0 * 1024.0, MiB = 1024.0 * 1024.0;
+
+    std::vector<float> points(count * 3);
+    glutils::readParallel(glutils::RandomPointSource(count, 42, -3.0f, 3.0f), 0, count, points.data());
+    // 按 Morton 序重排，使每个块在空间上紧凑，量化精度更高
+    glutils::Octree().build(points.data(), count);
+
+    auto dir = std::filesystem::temp_directory_path();
+    auto rawPath = dir / "glutils_bench_points.f32";
+    auto gpcPath = dir / "glutils_bench_points.gpc";
+    auto xyzPath = dir / "glutils_bench_points.xyz";
+
+    glutils::Stopwatch timer;
+    {
+        std::ofstream raw(rawPath, std::ios::binary);
+        raw.write(reinterpret_cast<const char*>(points.data()), static_cast<std::streamsize>(points.size() * sizeof(float)));
+    }
+    double rawWrite = timer.seconds();
+    timer.reset();
+    glutils::writePointCloudFile(gpcPath, points.data(), count);
+    double gpcWrite = timer.seconds();
+
+    const double rawBytes = double(std::filesystem::file_size(rawPath));
+    const double gpcBytes = double(std::filesystem::file_size(gpcPath));
+    const double floatBytes = double(count) * 3 * sizeof(float);
+    std::cout << "点数: " << count << "，线程数: " << glutils::workerCount() << std::endl;
+    std::cout << "float32 文件: " << rawBytes / MiB << " MiB，写入 " << rawWrite * 1000 << " ms" << std::endl;
+    std::cout << ".gpc 文件:    " << gpcBytes / MiB << " MiB（" << 100.0 * gpcBytes / rawBytes << "%），写入 " << gpcWrite * 1000 << " ms" << std::endl;
+
+    // 原始 float32：读进 vector
+    timer.reset();
+    std::vector<float> loaded(count * 3);
+    {
+        std::ifstream raw(rawPath, std::ios::binary);
+        raw.read(reinterpret_cast<char*>(loaded.data()), static_cast<std::streamsize>(loaded.size() * sizeof(float)));
+    }
+    double rawLoad = timer.seconds();
+    std::cout << "float32 ifstream 读取: " << floatBytes / GiB / rawLoad << " GB/s" << std::endl;
+
+    // .gpc：映射后直接解码到目标缓冲（实际使用中目标就是持久映射的顶点缓冲）
+    std::unique_ptr<float[]> staging(new float[count * 3]);
+    timer.reset();
+    glutils::PointCloudFile file;
+    if (!file.open(gpcPath))
+        return 1;
+    glutils::readParallel(file, 0, count, staging.get());
+    double gpcLoad = timer.seconds();
+    std::cout << ".gpc 映射 + 并行 SIMD 解码: " << floatBytes / GiB / gpcLoad << " GB/s（输出 float），"
+              << gpcBytes / GiB / gpcLoad << " GB/s（文件）" << std::endl;
+
+    // 单线程解码：SIMD 与标量
+    for (bool simd : { false, true }) {
+        timer.reset();
+        for (std::size_t b = 0; b < file.blockCount(); ++b) {
+            const glutils::PointBlock& block = file.blocks()[b];
+            float step[3];
+            glutils::detail::quantStep(block.boundsMin, block.boundsMax, step);
+            auto q = reinterpret_cast<const std::uint16_t*>(reinterpret_cast<const char*>(&file.header()) + block.offset);
+            float* out = staging.get() + b * std::size_t{file.header().blockPoints} * 3;
+            if (simd)
+                glutils::decodeQuantized(q, block.count, block.boundsMin, step, out);
+            else
+                glutils::decodeQuantizedScalar(q, block.count, block.boundsMin, step, out);
+        }
+        std::cout << (simd ? "单线程 SIMD 解码: " : "单线程标量解码: ") << floatBytes / GiB / timer.seconds() << " GB/s" << std::endl;
+    }
+
+    // 量化误差
+    float maxError = 0.0f;
+    for (std::size_t i = 0; i < count * 3; ++i)
+        maxError = std::max(maxError, std::fabs(staging[i] - points[i]));
+    std::cout << "最大量化误差: " << maxError << "（坐标范围 6.0）" << std::endl;
+
+    // ASCII XYZ 导入
+    const std::size_t xyzCount = std::min<std::size_t>(count, 2000000);
+    {
+        std::ofstream xyz(xyzPath);
+        char line[96];
+        for (std::size_t i = 0; i < xyzCount; ++i) {
+            int n = std::snprintf(line, sizeof(line), "%.6f %.6f %.6f\n", points[i * 3], points[i * 3 + 1], points[i * 3 + 2]);
+            xyz.write(line, n);
+        }
+    }
+    std::vector<float> imported;
+    timer.reset();
+    glutils::importPointCloud(xyzPath, imported);
+    double xyzLoad = timer.seconds();
+    std::cout << "ASCII XYZ 导入: " << imported.size() / 3 << " 点，" << std::filesystem::file_size(xyzPath) / MiB / xyzLoad << " MiB/s" << std::endl;
+
+    std::cout << "峰值内存: " << glutils::peakResidentBytes() / MiB << " MiB" << std::endl;
+
+    std::filesystem::remove(rawPath);
+    std::filesystem::remove(gpcPath);
+    std::filesystem::remove(xyzPath);
+}
@@ -0,0 +1,236 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "BenchUtils.hpp"
+#include "GLHandles.hpp"
+#include "GLUtils.hpp"
+#include "PointCloud.hpp"
+#include "Scene.hpp"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// 场景启动耗时对比：JSON 描述（解析 JSON、逐个读取并解析 OBJ / XYZ / 着色器文件）与烘焙缓存（映射一个文件）
+// 在临时目录生成一个合成场景：若干 OBJ 球体网格、一个 ASCII XYZ 点云、两组着色器文件和大量实例。
+// 每种方式分别测冷启动（先用 posix_fadvise(DONTNEED) 把涉及的文件逐出页缓存，只在 Linux 上支持）
+// 和热启动（紧接着再加载一次），时间分为"读取"（得到 SceneView）和"上传"（SceneRenderer 构造 + glFinish）两部分。
+// 两种方式得到的数组和着色器源码必须逐字节相同，否则返回非零退出码
+// 用法：SceneBenchmark [网格数，默认 24] [点数，默认 500000] [实例数，默认 2000]
+
+const char* meshVertexSource = R"(#version 330 core
+layout(location=0) in vec3 aPos;
+layout(location=1) in vec3 aNormal;
+uniform mat4 mvp;
+uniform mat4 model;
+out vec3 vNormal;
+void main(){ vNormal = mat3(model) * aNormal; gl_Position = mvp * vec4(aPos, 1.0); }
+)";
+const char* meshFragmentSource = R"(#version 330 core
+in vec3 vNormal;
+out vec4 FragColor;
+uniform vec4 color;
+void main(){ FragColor = vec4(color.rgb * (0.3 + 0.7 * max(dot(normalize(vNormal), vec3(0.0, 1.0, 0.0)), 0.0)), 1.0); }
+)";
+const char* pointVertexSource = "#version 330 core\nlayout(location=0) in vec3 aPos; uniform mat4 mvp; void main(){ gl_Position = mvp * vec4(aPos, 1.0); }\n";
+const char* pointFragmentSource = "#version 330 core\nout vec4 FragColor; uniform vec4 color; void main(){ FragColor = color; }\n";
+
+// 写出经纬度球体 OBJ（带法线），约 2 * rings * segments 个三角形
+void writeSphereObj(const std::filesystem::path& path, int rings, int segments) {
+    std::ofstream out(path);
+    const float pi = 3.14159265f;
+    for (int r = 0; r <= rings; ++r) {
+        const float theta = pi * float(r) / float(rings);
+        for (int s = 0; s <= segments; ++s) {
+            const float phi = 2.0f * pi * float(s) / float(segments);
+            const float x = std::sin(theta) * std::cos(phi), y = std::cos(theta), z = std::sin(theta) * std::sin(phi);
+            out << "v " << x * 0.5f << ' ' << y * 0.5f << ' ' << z * 0.5f << "\nvn " << x << ' ' << y << ' ' << z << '\n';
+        }
+    }
+    for (int r = 0; r < rings; ++r) {
+        for (int s = 0; s < segments; ++s) {
+            const int a = r * (segments + 1) + s + 1, b = a + segments + 1;
+            out << "f " << a << "//" << a << ' ' << b << "//" << b << ' ' << b + 1 << "//" << b + 1 << ' ' << a + 1 << "//" << a + 1 << '\n';
+        }
+    }
+}
+
+void writeText(const std::filesystem::path& path, const char* text) {
+    std::ofstream(path) << text;
+}
+
+// 把文件逐出页缓存，模拟冷启动；不支持时返回 false
+bool evictFromPageCache(const std::filesystem::path& path) {
+#ifdef __linux__
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    // 刚写完的脏页必须先落盘才能被逐出
+    fdatasync(fd);
+    const bool ok = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+    ::close(fd);
+    return ok;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+template<typename T>
+bool sameBytes(std::span<const T> a, std::span<const T> b) {
+    return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.size_bytes()) == 0);
+}
+
+int main(int argc, char** argv) {
+    using namespace glutils;
+    const int meshCount = argc > 1 ? std::stoi(argv[1]) : 24;
+    const std::size_t pointCount = argc > 2 ? std::stoull(argv[2]) : 500000;
+    const int instanceCount = argc > 3 ? std::stoi(argv[3]) : 2000;
+
+    initGLFW();
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    auto window = createWindow(64, 64, "SceneBenchmark");
+
+    // 生成合成场景
+    const auto dir = std::filesystem::temp_directory_path() / "glutils_bench_scene";
+    std::filesystem::create_directories(dir);
+    std::vector<std::filesystem::path> files;
+    nlohmann::json root;
+    root["camera"] = { { "position", { 0, 5, 20 } }, { "target", { 0, 0, 0 } } };
+    writeText(dir / "mesh.vert", meshVertexSource);
+    writeText(dir / "mesh.frag", meshFragmentSource);
+    writeText(dir / "points.vert", pointVertexSource);
+    writeText(dir / "points.frag", pointFragmentSource);
+    root["shaders"]["mesh"] = { { "vertex", "mesh.vert" }, { "fragment", "mesh.frag" } };
+    root["shaders"]["points"] = { { "vertex", "points.vert" }, { "fragment", "points.frag" } };
+    for (const char* name : { "mesh.vert", "mesh.frag", "points.vert", "points.frag" })
+        files.push_back(dir / name);
+    for (int m = 0; m < meshCount; ++m) {
+        const std::string name = "sphere" + std::to_string(m) + ".obj";
+        writeSphereObj(dir / name, 48 + m * 4, 96 + m * 8);
+        root["meshes"]["sphere" + std::to_string(m)] = name;
+        files.push_back(dir / name);
+    }
+    {
+        std::vector<float> points(pointCount * 3);
+        readParallel(RandomPointSource(pointCount, 7, -10.0f, 10.0f), 0, pointCount, points.data());
+        std::ofstream xyz(dir / "cloud.xyz");
+        for (std::size_t i = 0; i < pointCount; ++i)
+            xyz << points[i * 3] << ' ' << points[i * 3 + 1] << ' ' << points[i * 3 + 2] << '\n';
+        root["pointClouds"]["cloud"] = "cloud.xyz";
+        files.push_back(dir / "cloud.xyz");
+    }
+    root["instances"] = nlohmann::json::array();
+    for (int i = 0; i < instanceCount; ++i) {
+        const float x = float(i % 50) - 25.0f, z = float(i / 50) - 20.0f;
+        root["instances"].push_back({ { "mesh", "sphere" + std::to_string(i % std::max(meshCount, 1)) },
+                                      { "shader", "mesh" },
+                                      { "position", { x, 0.0f, z } },
+                                      { "rotation", { 0.0f, float(i * 7 % 360), 0.0f } },
+                                      { "scale", 0.4f + float(i % 5) * 0.1f },
+                                      { "color", { 0.9f, 0.85f, 0.8f, 1.0f } } });
+    }
+    root["instances"].push_back({ { "points", "cloud" }, { "shader", "points" } });
+    const auto scenePath = dir / "scene.json";
+    std::ofstream(scenePath) << root.dump(1);
+    files.push_back(scenePath);
+    const auto bakedPath = dir / "scene.gsc";
+
+    std::size_t sourceBytes = 0;
+    for (const auto& file : files)
+        sourceBytes += std::filesystem::file_size(file);
+    std::cout << "OpenGL " << glGetString(GL_VERSION) << "，" << meshCount << " 个网格、" << pointCount << " 个点、" << instanceCount
+              << " 个实例，源文件 " << files.size() << " 个共 " << sourceBytes / (1024.0 * 1024.0) << " MiB" << std::endl;
+
+    bool ok = true;
+    {
+        // 烘焙一次，作为离线步骤单独计时
+        Scene reference;
+        if (!loadScene(scenePath, reference))
+            return 1;
+        Stopwatch bakeTimer;
+        if (!bakeScene(reference.view(), bakedPath))
+            return 1;
+        std::cout << "烘焙: " << bakeTimer.milliseconds() << " ms，文件 " << std::filesystem::file_size(bakedPath) / (1024.0 * 1024.0) << " MiB" << std::endl;
+
+        bool coldSupported = true;
+        auto evict = [&](const std::vector<std::filesystem::path>& paths) {
+            for (const auto& path : paths)
+                coldSupported &= evictFromPageCache(path);
+        };
+        auto upload = [&](const SceneView& view) {
+            Stopwatch timer;
+            {
+                SceneRenderer renderer(view);
+                glFinish();
+            }
+            glObjects().flush();
+            return timer.milliseconds();
+        };
+        auto report = [](const char* name, double readMs, double uploadMs) {
+            std::cout << name << ": 读取 " << readMs << " ms + 上传 " << uploadMs << " ms = " << readMs + uploadMs << " ms" << std::endl;
+        };
+
+        // 着色器编译的首次开销（驱动初始化等）不计入任何一种方式
+        upload(reference.view());
+
+        for (bool cold : { true, false }) {
+            const char* temperature = cold ? "冷" : "热";
+            {
+                if (cold)
+                    evict(files);
+                Scene scene;
+                Stopwatch timer;
+                if (!loadScene(scenePath, scene))
+                    return 1;
+                const SceneView view = scene.view();
+                const double readMs = timer.milliseconds();
+                report((std::string("JSON ") + temperature + "启动").c_str(), readMs, upload(view));
+            }
+            {
+                if (cold)
+                    evict({ bakedPath });
+                BakedScene baked;
+                Stopwatch timer;
+                if (!baked.open(bakedPath))
+                    return 1;
+                const SceneView view = baked.view();
+                const double readMs = timer.milliseconds();
+                // 映射是惰性的，页面在上传时才真正读入，所以冷启动的 IO 计入上传时间
+                report((std::string("烘焙 ") + temperature + "启动").c_str(), readMs, upload(view));
+
+                const SceneView expected = reference.view();
+                bool same = sameBytes(view.vertices, expected.vertices) && sameBytes(view.indices, expected.indices) &&
+                            sameBytes(view.points, expected.points) && sameBytes(view.meshes, expected.meshes) &&
+                            sameBytes(view.pointClouds, expected.pointClouds) && sameBytes(view.instances, expected.instances) &&
+                            std::memcmp(&view.camera, &expected.camera, sizeof(SceneCamera)) == 0 && view.shaders.size() == expected.shaders.size();
+                for (std::size_t s = 0; same && s < view.shaders.size(); ++s)
+                    same = view.shaders[s].vertex == expected.shaders[s].vertex && view.shaders[s].fragment == expected.shaders[s].fragment;
+                same = same && view.dependencies.size() == expected.dependencies.size();
+                for (std::size_t d = 0; same && d < view.dependencies.size(); ++d)
+                    same = view.dependencies[d].path == expected.dependencies[d].path && view.dependencies[d].writeTime == expected.dependencies[d].writeTime &&
+                           view.dependencies[d].bytes == expected.dependencies[d].bytes;
+                same = same && !sceneDependenciesChanged(view);
+                if (!same) {
+                    std::cerr << "烘焙场景与 JSON 场景的数据不一致" << std::endl;
+                    ok = false;
+                }
+            }
+        }
+        if (!coldSupported)
+            std::cout << "注意：当前平台不能逐出页缓存，冷启动结果实际上也是热的" << std::endl;
+    }
+
+    std::filesystem::remove_all(dir);
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    std::cout << (ok ? "烘焙场景与 JSON 场景数据一致" : "烘焙场景与 JSON 场景数据不一致") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,95 @@
+#include <string>
+#include <vector>
+#include "BenchUtils.hpp"
+#include "GLUtils.hpp"
+#include "ShaderCache.hpp"
+
+// 程序二进制缓存的启动时间对比：直接编译 / 冷缓存 / 热缓存
+// 用法：ShaderCacheBenchmark [程序数量，默认 48]
+// Mesa 自带磁盘着色器缓存，测量冷启动时建议设置 MESA_SHADER_CACHE_DISABLE=true
+
+// 生成互不相同、带一定计算量的着色器，避免驱动内部按源码去重
+std::vector<glutils::VertexShaderSource> makeVertexShaders(int count) {
+    std::vector<glutils::VertexShaderSource> shaders;
+    for (int i = 0; i < count; ++i) {
+        shaders.emplace_back(R"(#version 330 core
+layout(location=0) in vec3 aPos;
+layout(location=1) in vec3 aNormal;
+uniform mat4 mvp;
+uniform mat4 model;
+out vec3 vNormal;
+out vec3 vPos;
+void main(){
+    vec3 p = aPos;
+    for (int k = 0; k < 4; ++k)
+        p += 0.01 * sin(p.yzx * float(k + )" + std::to_string(i) + R"());
+    vPos = p;
+    vNormal = mat3(transpose(inverse(model))) * aNormal;
+    gl_Position = mvp * vec4(p, 1.0);
+})");
+    }
+    return shaders;
+}
+
+std::vector<glutils::FragmentShaderSource> makeFragmentShaders(int count) {
+    std::vector<glutils::FragmentShaderSource> shaders;
+    for (int i = 0; i < count; ++i) {
+        shaders.emplace_back(R"(#version 330 core
+in vec3 vNormal;
+in vec3 vPos;
+out vec4 FragColor;
+uniform vec3 viewPos;
+void main(){
+    vec3 N = normalize(vNormal);
+    vec3 V = normalize(viewPos - vPos);
+    float hemi = max(0.0, dot(N, vec3(0, 1, 0)) * 0.5 + 0.5);
+    vec3 ambient = mix(vec3(0.2, 0.2, 0.25), vec3(1.0, 1.0, 0.95), hemi) * 0.4;
+    float diff = max(dot(N, normalize(vec3(0.5, 1.0, 0.8))), 0.0);
+    float rim = pow(1.0 - max(dot(N, V), 0.0), )" + std::to_string(2 + i % 7) + R"(.0);
+    vec3 color = (ambient + diff * vec3(0.6, 0.6, 0.55) + rim * vec3(0.5)) * vec3(0.95, 0.94, 0.88) * )" + std::to_string(1.0 + i * 0.001) + R"(;
+    FragColor = vec4(pow(color, vec3(1.0/2.2)), 1.0);
+})");
+    }
+    return shaders;
+}
+
+int main(int argc, char** argv) {
+    using namespace glutils;
+    const int count = argc > 1 ? std::stoi(argv[1]) : 48;
+
+    initGLFW();
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    auto window = createWindow(64, 64, "ShaderCacheBenchmark");
+
+    auto vertexShaders = makeVertexShaders(count);
+    auto fragmentShaders = makeFragmentShaders(count);
+    auto runPass = [&](const char* name, auto&& build) {
+        std::vector<unsigned int> programs;
+        Stopwatch timer;
+        for (int i = 0; i < count; ++i)
+            programs.push_back(build(i));
+        double ms = timer.milliseconds();
+        for (unsigned int program : programs)
+            glDeleteProgram(program);
+        std::cout << name << ": " << count << " 个程序共 " << ms << " ms，平均 " << ms / count << " ms" << std::endl;
+    };
+
+    runPass("直接编译", [&](int i) { return compileShader(vertexShaders[i], fragmentShaders[i]); });
+
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "glutils_program_cache_bench";
+    {
+        ProgramCache cold(directory);
+        cold.clear();
+        runPass("冷缓存", [&](int i) { return cold.get(vertexShaders[i], fragmentShaders[i]); });
+        cold.printStats();
+    }
+    {
+        ProgramCache warm(directory);
+        runPass("热缓存", [&](int i) { return warm.get(vertexShaders[i], fragmentShaders[i]); });
+        warm.printStats();
+        warm.clear();
+    }
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+}
@@ -0,0 +1,126 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "BenchUtils.hpp"
+#include "GLUtils.hpp"
+#include "ShaderHotReload.hpp"
+
+// 着色器热重载的迭代延迟：在临时目录写入若干程序（一半包含公共的 common.glsl），
+// 1. 全部从头加载（相当于重启程序后重新加载着色器，不含重新生成数据的时间）
+// 2. 改动一个片段着色器，从写完文件到新程序可用的延迟，只应重建 1 个程序
+// 3. 改动 common.glsl，只应重建包含它的程序
+// 4. 写入语法错误，程序 ID 不变、继续可用；修复后恢复
+// 任一检查不符合预期时返回非零退出码
+// 用法：ShaderReloadBenchmark [程序数量，默认 16]
+
+namespace fs = std::filesystem;
+
+void writeFile(const fs::path& path, const std::string& text) {
+    std::ofstream(path, std::ios::binary) << text;
+}
+
+std::string fragmentSource(int i, bool useCommon, float tint) {
+    std::string source = "#version 330 core\n";
+    if (useCommon)
+        source += "#include \"common.glsl\"\n";
+    source += "in vec3 vPos;\nout vec4 FragColor;\nvoid main(){\n";
+    source += "    vec3 c = vec3(" + std::to_string(tint) + ", " + std::to_string(i) + ".0 / 64.0, 0.5);\n";
+    if (useCommon)
+        source += "    c = shade(c, vPos);\n";
+    source += "    FragColor = vec4(c, 1.0);\n}\n";
+    return source;
+}
+
+std::string commonSource(float gamma) {
+    return "#pragma once\nvec3 shade(vec3 c, vec3 p){ return pow(c * (0.5 + 0.5 * sin(p * 10.0)), vec3(" +
+           std::to_string(gamma) + ")); }\n";
+}
+
+int main(int argc, char** argv) {
+    using namespace glutils;
+    const int count = argc > 1 ? std::stoi(argv[1]) : 16;
+
+    initGLFW();
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    auto window = createWindow(64, 64, "ShaderReloadBenchmark");
+
+    const fs::path dir = fs::temp_directory_path() / "glutils_shader_reload";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    writeFile(dir / "shared.vert", "#version 330 core\nlayout(location=0) in vec3 aPos;\nout vec3 vPos;\n"
+                                   "void main(){ vPos = aPos; gl_Position = vec4(aPos, 1.0); }\n");
+    writeFile(dir / "common.glsl", commonSource(2.2f));
+    for (int i = 0; i < count; ++i)
+        writeFile(dir / ("program" + std::to_string(i) + ".frag"), fragmentSource(i, i % 2 == 0, 1.0f));
+    const int withCommon = (count + 1) / 2;
+
+    bool ok = true;
+    auto expect = [&](bool condition, const char* what) {
+        if (!condition) {
+            std::cerr << "检查失败: " << what << std::endl;
+            ok = false;
+        }
+    };
+    {
+        Stopwatch timer;
+        ShaderHotReloader reloader;
+        std::vector<std::shared_ptr<ReloadableShader>> programs;
+        for (int i = 0; i < count; ++i)
+            programs.push_back(reloader.load((dir / "shared.vert").string(), (dir / ("program" + std::to_string(i) + ".frag")).string()));
+        glFinish();
+        std::cout << "OpenGL " << glGetString(GL_VERSION) << "，" << count << " 个程序，"
+                  << (reloader.usingInotify() ? "inotify 监视" : "定时检查修改时间") << std::endl;
+        std::cout << "全部重新加载: " << timer.milliseconds() << " ms" << std::endl;
+        for (const auto& program : programs)
+            expect(program->valid(), "初始加载");
+
+        // 写完文件后反复 poll，直到有程序被替换或出现失败
+        auto waitReload = [&](const char* name) {
+            Stopwatch latency;
+            HotReloadStats stats;
+            while (stats.reloaded == 0 && stats.failed == 0 && latency.milliseconds() < 2000.0) {
+                stats = reloader.poll();
+                if (stats.reloaded == 0 && stats.failed == 0)
+                    std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+            glFinish();
+            std::cout << name << ": 写入后 " << latency.milliseconds() << " ms 可用（重建 " << stats.milliseconds
+                      << " ms），替换 " << stats.reloaded << " 个，失败 " << stats.failed << " 个，重新读取文件 "
+                      << stats.filesRead << " 个" << std::endl;
+            return stats;
+        };
+
+        const fs::path edited = dir / "program1.frag";
+        const unsigned int before = programs[1]->getID();
+        writeFile(edited, fragmentSource(1, false, 0.25f));
+        HotReloadStats stats = waitReload("改动单个片段着色器");
+        expect(stats.reloaded == 1 && stats.filesRead == 1, "只重建改动的程序、只重读改动的文件");
+        expect(programs[1]->getID() != before && programs[1]->generation() == 2, "程序 ID 已替换");
+
+        writeFile(dir / "common.glsl", commonSource(1.8f));
+        stats = waitReload("改动 common.glsl");
+        expect(stats.reloaded == std::size_t(withCommon) && stats.filesRead == 1, "只重建包含 common.glsl 的程序");
+
+        const unsigned int good = programs[1]->getID();
+        writeFile(edited, "#version 330 core\n#include \"common.glsl\"\nout vec4 FragColor;\nvoid main(){ FragColor = vec4(1.0) }\n");
+        stats = waitReload("写入语法错误");
+        expect(stats.failed == 1 && programs[1]->failed() && programs[1]->getID() == good, "失败时保留旧程序");
+        programs[1]->use();
+        expect(glGetError() == GL_NO_ERROR, "旧程序仍可使用");
+
+        writeFile(edited, fragmentSource(1, true, 0.5f));
+        stats = waitReload("修复错误");
+        expect(stats.reloaded == 1 && !programs[1]->failed() && programs[1]->getID() != good, "修复后恢复");
+    }
+
+    fs::remove_all(dir);
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    std::cout << (ok ? "热重载行为符合预期" : "热重载行为不符合预期") << std::endl;
+    return ok ? 0 : 1;
+}
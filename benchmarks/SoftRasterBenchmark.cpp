@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "BenchUtils.hpp"
+#include "JobSystem.hpp"
+#include "SoftRasterizer.hpp"
+
+// 软件光栅化吞吐量：按线程数和 SIMD 级别渲染同一个 MilkWhite 场景（球体网格阵列 + 地面），
+// 报告每帧耗时、帧缓冲 Mpixels/s（分辨率 × 帧数 / 时间）和实际着色的 Mfragments/s。
+// 所有配置的图像必须与"标量、单线程"逐位一致，否则返回非零退出码。
+// 用法：SoftRasterBenchmark [宽，默认 1280] [高，默认 720] [帧数，默认 10] [最大线程数，默认核心数] [球体阵列边长，默认 6]
+
+// 经纬度球体，顶点为 Position(3) + Normal(3)
+void buildSphere(int rings, int segments, std::vector<float>& vertices, std::vector<std::uint32_t>& indices) {
+    const float pi = 3.14159265f;
+    for (int r = 0; r <= rings; ++r) {
+        const float theta = pi * float(r) / float(rings);
+        for (int s = 0; s <= segments; ++s) {
+            const float phi = 2.0f * pi * float(s) / float(segments);
+            const float x = std::sin(theta) * std::cos(phi), y = std::cos(theta), z = std::sin(theta) * std::sin(phi);
+            vertices.insert(vertices.end(), { x * 0.5f, y * 0.5f, z * 0.5f, x, y, z });
+        }
+    }
+    for (int r = 0; r < rings; ++r) {
+        for (int s = 0; s < segments; ++s) {
+            const std::uint32_t a = r * (segments + 1) + s, b = a + segments + 1;
+            indices.insert(indices.end(), { a, a + 1, b, b, a + 1, b + 1 });
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    using namespace glutils;
+    const int width = argc > 1 ? std::stoi(argv[1]) : 1280;
+    const int height = argc > 2 ? std::stoi(argv[2]) : 720;
+    const int frames = argc > 3 ? std::stoi(argv[3]) : 10;
+    const unsigned int maxThreads = argc > 4 ? static_cast<unsigned int>(std::stoi(argv[4])) : workerCount();
+    const int grid = argc > 5 ? std::stoi(argv[5]) : 6;
+
+    std::vector<float> sphereVertices, groundVertices = {
+        -1, 0, -1, 0, 1, 0,  1, 0, -1, 0, 1, 0,  1, 0, 1, 0, 1, 0,  -1, 0, 1, 0, 1, 0,
+    };
+    std::vector<std::uint32_t> sphereIndices, groundIndices = { 0, 2, 1, 0, 3, 2 };
+    buildSphere(48, 96, sphereVertices, sphereIndices);
+
+    const glm::vec3 eye(0.0f, 3.0f, float(grid) * 1.2f + 2.0f);
+    const glm::mat4 viewProjection = glm::perspective(glm::radians(45.0f), float(width) / float(height), 0.1f, 100.0f) *
+                                     glm::lookAt(eye, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    auto renderFrame = [&](SoftRasterizer& rasterizer, SoftFramebuffer& target, int frame) {
+        target.clear({ 0.08f, 0.08f, 0.1f, 1.0f });
+        SoftDrawState state;
+        state.depthTest = true;
+        state.cullBackFaces = true;
+        SoftMilkWhiteProgram program;
+        program.viewPos = eye;
+        const glm::mat4 ground = glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, -0.6f, 0.0f)), glm::vec3(float(grid) * 2.0f));
+        program.setModel(ground);
+        program.mvp = viewProjection * ground;
+        rasterizer.drawElements(target, program, state, SoftPrimitive::Triangles, groundVertices, 6, groundIndices);
+        for (int i = 0; i < grid * grid; ++i) {
+            const float x = (float(i % grid) - float(grid - 1) * 0.5f) * 1.2f, z = (float(i / grid) - float(grid - 1) * 0.5f) * 1.2f;
+            const glm::mat4 model = glm::rotate(glm::translate(glm::mat4(1.0f), glm::vec3(x, 0.0f, z)), float(frame) * 0.1f + float(i),
+                                                glm::vec3(0.0f, 1.0f, 0.0f));
+            program.setModel(model);
+            program.mvp = viewProjection * model;
+            rasterizer.drawElements(target, program, state, SoftPrimitive::Triangles, sphereVertices, 6, sphereIndices);
+        }
+    };
+
+    std::cout << width << "x" << height << "，" << frames << " 帧，每帧 " << grid * grid << " 个球体（" << sphereIndices.size() / 3
+              << " 个三角形）+ 地面，本机 " << workerCount() << " 个核心，SIMD 最高 " << simdLevelName(detectSimdLevel()) << std::endl;
+
+    std::vector<unsigned int> threadCounts;
+    for (unsigned int n = 1; n < maxThreads; n *= 2)
+        threadCounts.push_back(n);
+    threadCounts.push_back(std::max(1u, maxThreads));
+    std::vector<SimdLevel> levels = { SimdLevel::Scalar };
+    if (detectSimdLevel() >= SimdLevel::SSE2)
+        levels.push_back(SimdLevel::SSE2);
+    if (detectSimdLevel() >= SimdLevel::AVX2)
+        levels.push_back(SimdLevel::AVX2);
+
+    bool ok = true;
+    SoftFramebuffer reference;
+    for (unsigned int threads : threadCounts) {
+        // 调用线程也执行任务，所以工作线程比总线程数少一个
+        JobSystem jobs(threads - 1);
+        for (SimdLevel level : levels) {
+            SoftRasterizer rasterizer(jobs, level);
+            SoftFramebuffer target(width, height);
+            // 预热一帧：中间数组扩容到稳定大小
+            renderFrame(rasterizer, target, 0);
+            rasterizer.resetStats();
+            Stopwatch timer;
+            for (int f = 0; f < frames; ++f)
+                renderFrame(rasterizer, target, f);
+            const double seconds = timer.seconds();
+            const double pixels = double(width) * height * frames;
+            std::cout << threads << " 线程 " << simdLevelName(level) << ": 每帧 " << seconds * 1000.0 / frames << " ms，"
+                      << pixels / seconds / 1e6 << " Mpixels/s，" << double(rasterizer.stats().fragments) / seconds / 1e6 << " Mfragments/s"
+                      << std::endl;
+
+            // 最后一帧的图像与第一种配置比较
+            if (reference.width == 0) {
+                reference = target;
+            } else if (const SoftImageDiff diff = compareImages(reference, target); diff.differingPixels != 0) {
+                std::cerr << threads << " 线程 " << simdLevelName(level) << " 的图像与标量单线程相差 " << diff.differingPixels << " 个像素" << std::endl;
+                ok = false;
+            }
+        }
+    }
+    std::cout << (ok ? "所有配置的图像逐位一致" : "不同配置的图像不一致") << std::endl;
+    return ok ? 0 : 1;
+}
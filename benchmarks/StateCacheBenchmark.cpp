@@ -0,0 +1,147 @@
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "BenchUtils.hpp"
+#include "GLUtils.hpp"
+#include "GLState.hpp"
+
+// 大量物体逐个绘制时状态切换的 CPU 开销对比：
+// 1. 每次绘制都直接调用 glUseProgram / glBindVertexArray / glBindTexture / glEnable（逐物体设置全部状态的常见写法）
+// 2. 同样的调用经过 GLStateCache，和上一次相同的状态直接跳过
+// 3. 先按 (程序, VAO, 纹理) 排序再经过 GLStateCache，连续物体共享状态，实际发出的调用最少
+// 用法：StateCacheBenchmark [物体数，默认 20000] [帧数，默认 30]
+
+const char* vertexSource = R"(#version 330 core
+layout(location=0) in vec2 aPos;
+out vec2 vUv;
+void main(){ vUv = aPos + 0.5; gl_Position = vec4(aPos, 0.0, 1.0); })";
+
+const char* fragmentSources[] = {
+    R"(#version 330 core
+in vec2 vUv; out vec4 FragColor; uniform sampler2D tex;
+void main(){ FragColor = texture(tex, vUv); })",
+    R"(#version 330 core
+in vec2 vUv; out vec4 FragColor; uniform sampler2D tex;
+void main(){ FragColor = texture(tex, vUv).bgra; })",
+    R"(#version 330 core
+in vec2 vUv; out vec4 FragColor; uniform sampler2D tex;
+void main(){ FragColor = vec4(texture(tex, vUv).rgb * 0.5, 1.0); })",
+    R"(#version 330 core
+in vec2 vUv; out vec4 FragColor; uniform sampler2D tex;
+void main(){ FragColor = vec4(1.0) - texture(tex, vUv); })",
+};
+
+struct DrawItem {
+    unsigned program;
+    unsigned vao;
+    unsigned texture;
+    bool blend;
+};
+
+int main(int argc, char** argv) {
+    using namespace glutils;
+    const int objects = argc > 1 ? std::stoi(argv[1]) : 20000;
+    const int frames = argc > 2 ? std::stoi(argv[2]) : 30;
+
+    initGLFW();
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    auto window = createWindow(64, 64, "StateCacheBenchmark");
+    // 只测提交开销，不让光栅化影响结果
+    glEnable(GL_RASTERIZER_DISCARD);
+
+    std::vector<unsigned> programs;
+    for (const char* fragment : fragmentSources)
+        programs.push_back(compileShader(VertexShaderSource(vertexSource), FragmentShaderSource(fragment)));
+
+    float triangle[] = { -0.5f, -0.5f, 0.5f, -0.5f, 0.0f, 0.5f };
+    std::vector<unsigned> vaos(8), vbos(8), textures(16);
+    glGenVertexArrays(static_cast<GLsizei>(vaos.size()), vaos.data());
+    glGenBuffers(static_cast<GLsizei>(vbos.size()), vbos.data());
+    for (std::size_t i = 0; i < vaos.size(); ++i) {
+        glBindVertexArray(vaos[i]);
+        glBindBuffer(GL_ARRAY_BUFFER, vbos[i]);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(triangle), triangle, GL_STATIC_DRAW);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
+    }
+    glGenTextures(static_cast<GLsizei>(textures.size()), textures.data());
+    for (std::size_t i = 0; i < textures.size(); ++i) {
+        const unsigned char pixel[4] = { static_cast<unsigned char>(i * 16), 128, 255, 255 };
+        glBindTexture(GL_TEXTURE_2D, textures[i]);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    }
+    // 以上初始化绕过了缓存
+    glState().invalidate();
+
+    // 物体按场景图顺序排列，相邻物体的状态几乎都不同
+    std::vector<DrawItem> items(objects);
+    for (int i = 0; i < objects; ++i) {
+        const unsigned hash = static_cast<unsigned>(i) * 2654435761u;
+        items[i] = { programs[hash % programs.size()], vaos[(hash >> 8) % vaos.size()], textures[(hash >> 16) % textures.size()], (hash >> 24) % 4 == 0 };
+    }
+    std::vector<DrawItem> sorted = items;
+    std::sort(sorted.begin(), sorted.end(), [](const DrawItem& a, const DrawItem& b) {
+        if (a.program != b.program) return a.program < b.program;
+        if (a.vao != b.vao) return a.vao < b.vao;
+        if (a.texture != b.texture) return a.texture < b.texture;
+        return a.blend < b.blend;
+    });
+
+    auto run = [&](const char* name, auto&& frame) {
+        glFinish();
+        glState().resetStats();
+        Stopwatch timer;
+        for (int f = 0; f < frames; ++f) {
+            frame();
+            GLUTILS_PROFILE_FRAME();
+        }
+        glFinish();
+        const double ms = timer.milliseconds() / frames;
+        std::cout << name << ": 每帧 " << ms << " ms，每个物体 " << ms * 1.0e6 / objects << " ns";
+        const auto& stats = glState().stats();
+        if (stats.issued + stats.skipped > 0)
+            std::cout << "，每帧发出 " << stats.issued / frames << " 次、跳过 " << stats.skipped / frames << " 次";
+        std::cout << std::endl;
+    };
+
+    run("直接调用", [&] {
+        for (const auto& item : items) {
+            glUseProgram(item.program);
+            glBindVertexArray(item.vao);
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, item.texture);
+            item.blend ? glEnable(GL_BLEND) : glDisable(GL_BLEND);
+            glDrawArrays(GL_TRIANGLES, 0, 3);
+        }
+    });
+    glState().invalidate();
+
+    auto cached = [&](const std::vector<DrawItem>& list) {
+        for (const auto& item : list) {
+            glState().useProgram(item.program);
+            glState().bindVertexArray(item.vao);
+            glState().bindTexture(0, GL_TEXTURE_2D, item.texture);
+            glState().setEnabled(GL_BLEND, item.blend);
+            glDrawArrays(GL_TRIANGLES, 0, 3);
+        }
+    };
+    run("GLStateCache", [&] { cached(items); });
+    run("排序 + GLStateCache", [&] { cached(sorted); });
+
+    const bool consistent = glState().validate();
+    std::cout << "影子状态与实际状态" << (consistent ? "一致" : "不一致") << std::endl;
+
+    for (unsigned program : programs)
+        glState().deleteProgram(program);
+    for (unsigned texture : textures)
+        glState().deleteTexture(texture);
+    for (std::size_t i = 0; i < vaos.size(); ++i) {
+        glState().deleteVertexArray(vaos[i]);
+        glState().deleteBuffer(vbos[i]);
+    }
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return consistent ? 0 : 1;
+}
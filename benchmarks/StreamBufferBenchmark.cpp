@@ -0,0 +1,137 @@
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "BenchUtils.hpp"
+#include "GLUtils.hpp"
+#include "Parallel.hpp"
+#include "StreamBuffer.hpp"
+
+// 每帧重新上传整块点云（模拟实时传感器数据）的吞吐量对比：
+// 1. 每帧 glBufferData(GL_STREAM_DRAW) 整块重新分配并从 CPU 数组拷贝（示例程序目前的写法）
+// 2. StreamBuffer::Orphan：CPU 暂存 + glBufferSubData，环绕时孤立旧存储
+// 3. StreamBuffer::Unsynchronized：栅栏保护的 glMapBufferRange(UNSYNCHRONIZED)，多线程直接写入映射
+// 4. StreamBuffer::Persistent：持久 + 一致映射，多线程直接写入（需要 4.4）
+// 另外给出环容量只有一帧时的 Persistent 结果，用于观察等待次数
+// 每种方式最后回读最近一帧的数据与期望值比较，不一致时返回非零退出码
+// 用法：StreamBufferBenchmark [每帧点数，默认 1000000] [帧数，默认 60]
+
+const char* vertexShaderSource = "#version 330 core\n layout (location = 0) in vec3 aPos; void main() { gl_Position = vec4(aPos * 0.1, 1.0); }";
+const char* fragmentShaderSource = "#version 330 core\n out vec4 FragColor; void main() { FragColor = vec4(1.0); }";
+
+// 第 frame 帧的点：简单的波动网格，生产线程按区间并行写入
+void producePoints(float* out, std::size_t first, std::size_t count, int frame) {
+    for (std::size_t i = first; i < first + count; ++i) {
+        const float x = float(i % 1000) * 0.01f, z = float(i / 1000 % 1000) * 0.01f;
+        out[i * 3 + 0] = x;
+        out[i * 3 + 1] = std::sin(x * 3.0f + float(frame) * 0.1f) * 0.1f;
+        out[i * 3 + 2] = z;
+    }
+}
+
+int main(int argc, char** argv) {
+    using namespace glutils;
+    const std::size_t points = argc > 1 ? std::stoull(argv[1]) : 1000000;
+    const int frames = argc > 2 ? std::stoi(argv[2]) : 60;
+    const std::size_t frameBytes = points * 3 * sizeof(float);
+
+    initGLFW();
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    auto window = createWindow(256, 256, "StreamBufferBenchmark");
+    // 只测上传与同步，不让点的光栅化影响结果
+    glState().enable(GL_RASTERIZER_DISCARD);
+    std::cout << "OpenGL " << glGetString(GL_VERSION) << "，每帧 " << points << " 个点（" << frameBytes / (1024.0 * 1024.0)
+              << " MiB），" << frames << " 帧" << std::endl;
+
+    bool ok = true;
+    {
+        Shader shader(compileShader(VertexShaderSource(vertexShaderSource), FragmentShaderSource(fragmentShaderSource)));
+        std::vector<float> cpuPoints(points * 3), expected(points * 3), readback(points * 3);
+        producePoints(expected.data(), 0, points, frames - 1);
+
+        unsigned int vao;
+        glGenVertexArrays(1, &vao);
+        glState().bindVertexArray(vao);
+        glEnableVertexAttribArray(0);
+
+        auto report = [&](const char* name, double ms, const StreamBufferStats* stats) {
+            std::cout << name << ": 每帧 " << ms / frames << " ms，" << double(frameBytes) * frames / (ms * 1000.0) << " MB/s";
+            if (stats)
+                std::cout << "，等待 " << stats->stalls << " 次 / " << stats->stallMs << " ms，孤立 " << stats->orphans << " 次";
+            std::cout << std::endl;
+        };
+        auto verify = [&](const char* name, unsigned int buffer, std::size_t offset) {
+            glState().bindBuffer(GL_ARRAY_BUFFER, buffer);
+            glGetBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(frameBytes), readback.data());
+            if (std::memcmp(readback.data(), expected.data(), frameBytes) != 0) {
+                std::cerr << name << ": 回读数据与期望不一致" << std::endl;
+                ok = false;
+            }
+        };
+
+        {
+            unsigned int vbo;
+            glGenBuffers(1, &vbo);
+            glFinish();
+            Stopwatch timer;
+            for (int f = 0; f < frames; ++f) {
+                parallelFor(points, 1 << 16, [&](std::size_t begin, std::size_t end) { producePoints(cpuPoints.data(), begin, end - begin, f); });
+                glState().bindBuffer(GL_ARRAY_BUFFER, vbo);
+                glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(frameBytes), cpuPoints.data(), GL_STREAM_DRAW);
+                glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+                shader.use();
+                glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(points));
+                glfwSwapBuffers(window);
+            }
+            glFinish();
+            report("每帧 glBufferData", timer.milliseconds(), nullptr);
+            verify("每帧 glBufferData", vbo, 0);
+            glState().deleteBuffer(vbo);
+        }
+
+        auto runRing = [&](const char* name, StreamMode mode, std::size_t framesInRing) {
+            if (mode == StreamMode::Persistent && !GLAD_GL_VERSION_4_4) {
+                std::cout << name << ": 需要 OpenGL 4.4，跳过" << std::endl;
+                return;
+            }
+            StreamBuffer ring(GL_ARRAY_BUFFER, frameBytes * framesInRing, mode);
+            std::size_t lastOffset = 0;
+            glFinish();
+            Stopwatch timer;
+            for (int f = 0; f < frames; ++f) {
+                // 起始偏移对齐到顶点跨度，绘制时用 first 而不是重新设置属性指针
+                StreamAllocation allocation = ring.allocate(frameBytes, 3 * sizeof(float));
+                if (!allocation) {
+                    ok = false;
+                    return;
+                }
+                float* out = static_cast<float*>(allocation.data);
+                parallelFor(points, 1 << 16, [&](std::size_t begin, std::size_t end) { producePoints(out, begin, end - begin, f); });
+                ring.commit(allocation);
+
+                glState().bindBuffer(GL_ARRAY_BUFFER, ring.buffer());
+                glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+                shader.use();
+                glDrawArrays(GL_POINTS, static_cast<GLint>(allocation.offset / (3 * sizeof(float))), static_cast<GLsizei>(points));
+                ring.fence();
+                glfwSwapBuffers(window);
+                lastOffset = allocation.offset;
+            }
+            glFinish();
+            report(name, timer.milliseconds(), &ring.stats());
+            verify(name, ring.buffer(), lastOffset);
+        };
+        runRing("StreamBuffer Orphan", StreamMode::Orphan, 3);
+        runRing("StreamBuffer Unsynchronized", StreamMode::Unsynchronized, 3);
+        runRing("StreamBuffer Persistent", StreamMode::Persistent, 3);
+        runRing("StreamBuffer Persistent（环容量一帧）", StreamMode::Persistent, 1);
+
+        glState().deleteVertexArray(vao);
+    }
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    std::cout << (ok ? "所有方式的数据一致" : "存在数据不一致的方式") << std::endl;
+    return ok ? 0 : 1;
+}
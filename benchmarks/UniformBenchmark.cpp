@@ -0,0 +1,156 @@
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include "BenchUtils.hpp"
+#include "GLUtils.hpp"
+#include "Profiler.hpp"
+
+// 绘制大量物体时 uniform 提交方式的 CPU 开销对比：
+// 1. 每次绘制 glGetUniformLocation + glUniform*（示例原来的写法）
+// 2. Shader::setUniform：链接时内省、编译期哈希查表、值未变化时跳过
+// 3. 每帧公共数据放进 std140 UBO 一次上传，每个物体只设置 model
+// 用法：UniformBenchmark [物体数，默认 20000] [帧数，默认 30]
+
+const char* locationVertex = R"(#version 330 core
+layout(location=0) in vec3 aPos;
+uniform mat4 projection;
+uniform mat4 view;
+uniform mat4 model;
+uniform vec3 lightDir;
+uniform vec4 tint;
+out vec4 vColor;
+void main(){
+    vColor = tint * (0.5 + 0.5 * max(dot(normalize(mat3(model) * aPos), lightDir), 0.0));
+    gl_Position = projection * view * model * vec4(aPos, 1.0);
+})";
+
+const char* blockVertex = R"(#version 330 core
+layout(location=0) in vec3 aPos;
+layout(std140) uniform PerFrame {
+    mat4 projection;
+    mat4 view;
+    vec3 lightDir;
+};
+uniform mat4 model;
+uniform vec4 tint;
+out vec4 vColor;
+void main(){
+    vColor = tint * (0.5 + 0.5 * max(dot(normalize(mat3(model) * aPos), lightDir), 0.0));
+    gl_Position = projection * view * model * vec4(aPos, 1.0);
+})";
+
+const char* fragment = R"(#version 330 core
+in vec4 vColor;
+out vec4 FragColor;
+void main(){ FragColor = vColor; })";
+
+int main(int argc, char** argv) {
+    using namespace glutils;
+    const int objects = argc > 1 ? std::stoi(argv[1]) : 20000;
+    const int frames = argc > 2 ? std::stoi(argv[2]) : 30;
+
+    initGLFW();
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    auto window = createWindow(64, 64, "UniformBenchmark");
+
+    float triangle[] = { -0.5f, -0.5f, 0.0f, 0.5f, -0.5f, 0.0f, 0.0f, 0.5f, 0.0f };
+    unsigned int VAO, VBO;
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(triangle), triangle, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    // 只测提交开销，不让光栅化影响结果
+    glEnable(GL_RASTERIZER_DISCARD);
+
+    std::vector<glm::mat4> models(objects);
+    std::vector<glm::vec4> tints(objects);
+    for (int i = 0; i < objects; ++i) {
+        models[i] = glm::translate(glm::mat4(1.0f), glm::vec3(float(i % 100) - 50.0f, float(i / 100 % 100) - 50.0f, -float(i / 10000) * 2.0f));
+        // 物体只有 8 种颜色，大部分 tint 上传都是重复的
+        tints[i] = glm::vec4(float(i % 2), float(i / 2 % 2), float(i / 4 % 2), 1.0f);
+    }
+    const glm::mat4 projection = glm::perspective(glm::radians(45.0f), 1.0f, 0.1f, 500.0f);
+    const glm::vec3 lightDir = glm::normalize(glm::vec3(0.3f, 1.0f, 0.5f));
+
+    auto run = [&](const char* name, auto&& frame) {
+        glFinish();
+        Stopwatch timer;
+        for (int f = 0; f < frames; ++f) {
+            const glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 120.0f + float(f)), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+            frame(view);
+            GLUTILS_PROFILE_FRAME();
+        }
+        glFinish();
+        const double ms = timer.milliseconds() / frames;
+        std::cout << name << ": 每帧 " << ms << " ms，每个物体 " << ms * 1.0e6 / objects << " ns";
+#if GLUTILS_PROFILING
+        std::cout << "，上一帧上传 " << Profiler::instance().lastFrame().uploadBytes / 1024.0 << " KiB";
+#endif
+        std::cout << std::endl;
+    };
+
+    const unsigned int rawProgram = compileShader(VertexShaderSource(locationVertex), FragmentShaderSource(fragment));
+    run("逐次 glGetUniformLocation", [&](const glm::mat4& view) {
+        glUseProgram(rawProgram);
+        for (int i = 0; i < objects; ++i) {
+            glUniformMatrix4fv(glGetUniformLocation(rawProgram, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+            glUniformMatrix4fv(glGetUniformLocation(rawProgram, "view"), 1, GL_FALSE, glm::value_ptr(view));
+            glUniform3fv(glGetUniformLocation(rawProgram, "lightDir"), 1, glm::value_ptr(lightDir));
+            glUniformMatrix4fv(glGetUniformLocation(rawProgram, "model"), 1, GL_FALSE, glm::value_ptr(models[i]));
+            glUniform4fv(glGetUniformLocation(rawProgram, "tint"), 1, glm::value_ptr(tints[i]));
+            GLUTILS_COUNT_UPLOAD(2 * sizeof(glm::mat4) + sizeof(glm::vec3) + sizeof(glm::mat4) + sizeof(glm::vec4));
+            glDrawArrays(GL_TRIANGLES, 0, 3);
+        }
+    });
+    glDeleteProgram(rawProgram);
+
+    {
+        Shader shader(compileShader(VertexShaderSource(locationVertex), FragmentShaderSource(fragment)));
+        run("Shader::setUniform 缓存", [&](const glm::mat4& view) {
+            shader.use();
+            for (int i = 0; i < objects; ++i) {
+                shader.setUniform("projection", projection);
+                shader.setUniform("view", view);
+                shader.setUniform("lightDir", lightDir);
+                shader.setUniform("model", models[i]);
+                shader.setUniform("tint", tints[i]);
+                glDrawArrays(GL_TRIANGLES, 0, 3);
+            }
+        });
+    }
+
+    {
+        Shader shader(compileShader(VertexShaderSource(blockVertex), FragmentShaderSource(fragment)));
+        const UniformBlockInfo* block = shader.uniformBlock("PerFrame");
+        if (!block) {
+            std::cerr << "PerFrame 块不存在" << std::endl;
+            return 1;
+        }
+        shader.bindUniformBlock("PerFrame", 0);
+        UniformBuffer perFrame(*block, 0);
+        run("std140 UBO + setUniform", [&](const glm::mat4& view) {
+            perFrame.set("projection", projection);
+            perFrame.set("view", view);
+            perFrame.set("lightDir", lightDir);
+            perFrame.flush();
+            shader.use();
+            for (int i = 0; i < objects; ++i) {
+                shader.setUniform("model", models[i]);
+                shader.setUniform("tint", tints[i]);
+                glDrawArrays(GL_TRIANGLES, 0, 3);
+            }
+        });
+    }
+
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    glfwDestroyWindow(window);
+    glfwTerminate();
+}
@@ -1,4 +1,6 @@
 #include "GLUtils.hpp"
+#include "GLHandles.hpp"
+#include "FrameLoop.hpp"
 
 void processInput(GLFWwindow* window){
     if(glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
@@ -32,8 +34,8 @@ int main(){
     // 创建窗口，设置OpenGL上下文，并加载 GLAD 激活 OpenGL 的函数指针。
     auto window = createWindow(800, 600, "OpenGL Triangle");
 
-    // 编译链接着色器程序
-    auto shaderProgram = compileShader(VertexShaderSource{vertexShaderSource}, FragmentShaderSource{fragmentShaderSource});
+    // 编译链接着色器程序；与缓冲和顶点数组一样由句柄持有，离开作用域时交给对象池延迟删除
+    ShaderProgramHandle shaderProgram(compileShader(VertexShaderSource{vertexShaderSource}, FragmentShaderSource{fragmentShaderSource}));
 
     // 三角形顶点数据
     std::array vertices {
@@ -41,12 +43,11 @@ int main(){
         -0.5f, -0.5f, 0.0f,  // 顶点2 (左下)
         0.5f, -0.5f, 0.0f   // 顶点3 (右下)
     };
-    // 创建顶点缓冲对象和顶点数组对象并绑定
-    unsigned int VBO, VAO;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    // 创建顶点缓冲对象和顶点数组对象并绑定；句柄离开作用域时自动交给对象池删除
+    auto VBO = BufferHandle::create();
+    auto VAO = VertexArrayHandle::create();
+    glutils::glState().bindVertexArray(VAO.get());
+    glutils::glState().bindBuffer(GL_ARRAY_BUFFER, VBO.get());
     // 顶点数据上传到显存，GL_STATIC_DRAW 选项表示数据不会频繁改变
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), std::data(vertices), GL_STATIC_DRAW);
     // 告诉 OpenGL 如何解析刚才上传到显存的数据：从 0 号位置开始，每三个 float 为一个顶点
@@ -54,29 +55,35 @@ int main(){
     // 启用顶点属性；0 是索引，表示对应 glVertexAttribPointer 中的第一个参数，三角形的坐标数据关联到了 0 号槽位。所以必须开启 0 号槽位显卡才能读取这里的坐标
     glEnableVertexAttribArray(0);
 
-    // 循环渲染
-    while (!glfwWindowShouldClose(window)) {
+    // 循环渲染；设置 GLUTILS_BENCH_FRAMES 时按固定帧数运行并输出帧时间报告
+    FrameLoop loop(window, "DrawTriangle");
+    while (loop.next()) {
+        GLUTILS_PROFILE_GPU_ZONE("draw triangle");
         glClearColor(0.2f, 0.3f, 0.3f, 1.0f); // 设置清屏颜色，四个参数代表 RGBA
         glClear(GL_COLOR_BUFFER_BIT);         // 执行清屏操作
 
-        // 激活着色器程序
-        glUseProgram(shaderProgram);
+        // 激活着色器程序；经过状态缓存，和上一帧相同的状态不会再次提交给驱动
+        glutils::glState().useProgram(shaderProgram.get());
 
         // 重复绑定 顶点数组对象（只绘制这一个图形，可有可无）
-        glBindVertexArray(VAO);
+        glutils::glState().bindVertexArray(VAO.get());
         // 使用线框模式绘制 默认是填充模式
-        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+        glutils::glState().polygonMode(GL_LINE);
         // 绘图指令：通知 GPU 按照“三角形”规则，处理当前绑定的 VAO 里的前 3 个顶点数据，在后台绘制三角形
         glDrawArrays(GL_TRIANGLES, 0, 3);
+        GLUTILS_COUNT_DRAW(1);
         // GLFW 检查是否按下了 ESC 键
         processInput(window);
-        // 交换缓冲：把画好的后台图像推到前台显示（双缓冲机制）
-        glfwSwapBuffers(window);
+        // 交换缓冲：把画好的后台图像推到前台显示（双缓冲机制）；设置 GLUTILS_CAPTURE 时先读取后台图像
+        loop.present();
         // GLFW 处理窗口事件，比如键盘鼠标输入等
         glfwPollEvents();
     }
-    // 清理着色器程序资源
-    glDeleteProgram(shaderProgram);
+    // 清理着色器程序、顶点数组和缓冲；对象池在上下文销毁前删除所有待删对象
+    shaderProgram.reset();
+    VAO.reset();
+    VBO.reset();
+    glObjects().flush();
     // 释放 GLFW 资源
     glfwTerminate();
 }
\ No newline at end of file
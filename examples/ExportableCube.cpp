@@ -4,10 +4,26 @@
 #include <fstream>
 #include <cmath>
 #include <filesystem>
-
-void exportSceneToSTL(float* vertices, unsigned int* indices, int indexCount, const char* filename) {
-    std::ofstream file(filename);
-    if (!file.is_open()) {
+#include <memory>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include "FrameCapture.hpp"
+#include "FrameLoop.hpp"
+#include "GLHandles.hpp"
+#include "GLUtils.hpp"
+#include "MeshExporter.hpp"
+
+void exportScene(float* vertices, unsigned int* indices, int indexCount, const char* filename, bool ply) {
+    // 顶点为 位置(3) + 颜色(3) 交错存放，导出器只读取位置
+    glutils::MeshView mesh{
+        .vertices = vertices,
+        .vertexCount = 8,
+        .indices = indices,
+        .indexCount = static_cast<std::size_t>(indexCount),
+        .layout = { 6 * sizeof(float), 0 },
+    };
+    bool ok = ply ? glutils::exportPLY(mesh, filename) : glutils::exportSTL(mesh, filename);
+    if (!ok) {
         std::cerr << "错误：无法创建导出文件！" << std::endl;
         return;
     }
@@ -15,23 +31,6 @@ void exportSceneToSTL(float* vertices, unsigned int* indices, int indexCount, co
     // 获取当前绝对路径
     std::filesystem::path absolutePath = std::filesystem::absolute(filename);
 
-    file << "solid ExportedCube" << std::endl;
-    for (int i = 0; i < indexCount; i += 3) {
-        int i0 = indices[i] * 6;
-        int i1 = indices[i + 1] * 6;
-        int i2 = indices[i + 2] * 6;
-
-        file << "  facet normal 0 0 0" << std::endl;
-        file << "    outer loop" << std::endl;
-        file << "      vertex " << vertices[i0] << " " << vertices[i0 + 1] << " " << vertices[i0 + 2] << std::endl;
-        file << "      vertex " << vertices[i1] << " " << vertices[i1 + 1] << " " << vertices[i1 + 2] << std::endl;
-        file << "      vertex " << vertices[i2] << " " << vertices[i2 + 1] << " " << vertices[i2 + 2] << std::endl;
-        file << "    endloop" << std::endl;
-        file << "  endfacet" << std::endl;
-    }
-    file << "endsolid ExportedCube" << std::endl;
-    file.close();
-
     std::cout << "\n========================================" << std::endl;
     std::cout << "导出成功！" << std::endl;
     std::cout << "文件名: " << filename << std::endl;
@@ -45,10 +44,17 @@ void processInput(GLFWwindow* window, float* vertices, unsigned int* indices) {
 
     static bool sPressed = false;
     if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS && !sPressed) {
-        exportSceneToSTL(vertices, indices, 36, "my_cool_cube.stl");
+        exportScene(vertices, indices, 36, "my_cool_cube.stl", false);
         sPressed = true;
     }
     if (glfwGetKey(window, GLFW_KEY_S) == GLFW_RELEASE) sPressed = false;
+
+    static bool pPressed = false;
+    if (glfwGetKey(window, GLFW_KEY_P) == GLFW_PRESS && !pPressed) {
+        exportScene(vertices, indices, 36, "my_cool_cube.ply", true);
+        pPressed = true;
+    }
+    if (glfwGetKey(window, GLFW_KEY_P) == GLFW_RELEASE) pPressed = false;
 }
 
 // 着色器保持 3.3 标准
@@ -72,17 +78,10 @@ void main() {
 })";
 
 int main() {
-    glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-    GLFWwindow* window = glfwCreateWindow(800, 600, "Press 'S' to Save", NULL, NULL);
-    if (!window) return -1;
-    glfwMakeContextCurrent(window);
-    gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+    glutils::initGLFW();
+    GLFWwindow* window = glutils::createWindow(800, 600, "Press 'S' (STL) or 'P' (PLY) to Save, 'C' for a screenshot");
 
-    glEnable(GL_DEPTH_TEST);
+    glutils::glState().enable(GL_DEPTH_TEST);
 
     float vertices[] = {
         -0.5f,-0.5f,-0.5f,  1.0f,0.0f,0.0f,  0.5f,-0.5f,-0.5f,  0.0f,1.0f,0.0f,
@@ -95,15 +94,14 @@ int main() {
         1,5,6, 6,2,1, 3,2,6, 6,7,3, 0,1,5, 5,4,0
     };
 
-    unsigned int VBO, VAO, EBO;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
+    auto VAO = glutils::VertexArrayHandle::create();
+    auto VBO = glutils::BufferHandle::create();
+    auto EBO = glutils::BufferHandle::create();
 
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glutils::glState().bindVertexArray(VAO.get());
+    glutils::glState().bindBuffer(GL_ARRAY_BUFFER, VBO.get());
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glutils::glState().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO.get());
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
 
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
@@ -111,27 +109,31 @@ int main() {
     glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
     glEnableVertexAttribArray(1);
 
-    unsigned int vs = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vs, 1, &vertexShaderSource, NULL);
-    glCompileShader(vs);
-    unsigned int fs = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fs, 1, &fragmentShaderSource, NULL);
-    glCompileShader(fs);
-    unsigned int shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vs);
-    glAttachShader(shaderProgram, fs);
-    glLinkProgram(shaderProgram);
-
-    while (!glfwWindowShouldClose(window)) {
+    // 链接后一次性查询所有 uniform，循环里不再按字符串查位置
+    auto shader = std::make_unique<glutils::Shader>(glutils::compileShader(
+        glutils::VertexShaderSource{vertexShaderSource}, glutils::FragmentShaderSource{fragmentShaderSource}));
+
+    // 'C' 键截图：异步读回，编码线程写 PNG，不卡住渲染
+    int framebufferWidth = 0, framebufferHeight = 0;
+    glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+    auto screenshots = std::make_unique<glutils::FrameCapture>(framebufferWidth, framebufferHeight,
+                                                               glutils::FrameCaptureOptions{ .output = "screenshots", .prefix = "cube_" });
+    bool cPressed = false;
+
+    glutils::FrameLoop loop(window, "ExportableCube");
+    while (loop.next()) {
         processInput(window, vertices, indices);
+        const bool takeScreenshot = glfwGetKey(window, GLFW_KEY_C) == GLFW_PRESS && !cPressed;
+        cPressed = glfwGetKey(window, GLFW_KEY_C) == GLFW_PRESS;
 
+        GLUTILS_PROFILE_GPU_ZONE("draw cube");
         glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        glUseProgram(shaderProgram);
+        shader->use();
 
         // --- 恢复炫酷旋转矩阵 ---
-        float t = (float)glfwGetTime();
+        float t = (float)loop.time();
         float s = sin(t), c = cos(t);
         // 一个包含 X 和 Y 轴旋转的复合矩阵，并缩小一点 (0.5倍) 方便观察
         float model[16] = {
@@ -141,18 +143,31 @@ int main() {
             0,      0,        0,        1
         };
 
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, model);
+        shader->setUniform("model", glm::make_mat4(model));
 
-        glBindVertexArray(VAO);
+        glutils::glState().bindVertexArray(VAO.get());
         glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-
-        glfwSwapBuffers(window);
+        GLUTILS_COUNT_DRAW(1);
+
+        // 交换缓冲之前读取后缓冲；没有截图时也要 poll，及时写出之前的截图
+        if (takeScreenshot) {
+            const GLuint framebuffer = glutils::offscreenFramebuffer();
+            if (screenshots->capture(loop.frame(), framebuffer, framebuffer ? GL_COLOR_ATTACHMENT0 : GL_BACK))
+                std::cout << "截图: " << std::filesystem::absolute("screenshots").string() << std::endl;
+        } else {
+            screenshots->poll();
+        }
+
+        loop.present();
         glfwPollEvents();
     }
 
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteBuffers(1, &EBO);
+    screenshots.reset();
+    VAO.reset();
+    VBO.reset();
+    EBO.reset();
+    shader.reset();
+    glutils::glObjects().flush();
     glfwTerminate();
     return 0;
 }
\ No newline at end of file
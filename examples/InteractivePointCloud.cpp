@@ -3,21 +3,94 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <cctype>
+#include <filesystem>
 #include <iostream>
+#include <memory>
+#include <string>
 #include <vector>
-#include <random>
+#include "BenchUtils.hpp"
+#include "FrameLoop.hpp"
+#include "FramePipeline.hpp"
+#include "GLHandles.hpp"
+#include "GLUtils.hpp"
+#include "GpuPointCloud.hpp"
+#include "Octree.hpp"
+#include "PointCloudFile.hpp"
+#include "PointStreamer.hpp"
 
 // --- 全局配置 ---
-const unsigned int POINT_COUNT = 10000000; 
+// 默认 1000 万个点，可以通过第一个命令行参数修改，例如 InteractivePointCloud 100000000
+// 第一个参数也可以是点云文件：.gpc 直接映射加载；.xyz/.ply 先转换为同目录下的 <文件名>.gpc 再加载
+// 第二个参数为 octree 时先建八叉树，每帧只绘制视锥内的叶子并按屏幕尺寸抽稀
+// 第二个参数为 gpu 时用计算着色器生成随机点，并且每帧在 GPU 上做动画、视锥剔除和紧缩（需要 OpenGL 4.3）
+// 每帧的矩阵计算和八叉树选择在 FramePipeline 的模拟线程上进行，渲染线程只上传和绘制上一帧算好的结果
+std::size_t POINT_COUNT = 10000000;
+std::filesystem::path POINT_FILE;
+bool USE_OCTREE = false;
+bool USE_GPU = false;
+// 每个分块的点数，后台逐块生成上传，已完成的分块立刻参与绘制
+const std::size_t CHUNK_POINTS = 1 << 20;
 float lastX = 400, lastY = 300;
 float yaw = -90.0f, pitch = 0.0f;
 bool firstMouse = true;
 
 // 相机：初始位置调远到 10.0f
+// 这些全局变量只在渲染线程上（鼠标回调、processInput）读写，模拟线程只读每帧拷贝的 FrameInput 快照
 glm::vec3 cameraPos   = glm::vec3(0.0f, 0.0f, 10.0f);
 glm::vec3 cameraFront = glm::vec3(0.0f, 0.0f, -1.0f);
 glm::vec3 cameraUp    = glm::vec3(0.0f, 1.0f, 0.0f);
 
+// 模拟线程的输入快照
+struct FrameInput {
+    glm::vec3 cameraPos{ 0.0f };
+    glm::vec3 cameraFront{ 0.0f, 0.0f, -1.0f };
+    glm::vec3 cameraUp{ 0.0f, 1.0f, 0.0f };
+    float time = 0.0f;
+    int width = 800, height = 600;
+    // 八叉树模式下所有分块都已上传，可以按叶子选择绘制区间
+    bool selectLeaves = false;
+};
+
+// 模拟线程的计算结果
+struct FrameOutput {
+    glm::mat4 mvp{ 1.0f };
+    // 计算 mvp 时用的动画时间，GPU 模式的点动画与它保持一致
+    float time = 0.0f;
+    bool useDrawList = false;
+    glutils::OctreeDrawList drawList;
+};
+
+// 在渲染线程上拷贝当前相机和窗口状态
+FrameInput captureInput(GLFWwindow* window, float time, bool selectLeaves) {
+    FrameInput input;
+    input.cameraPos = cameraPos;
+    input.cameraFront = cameraFront;
+    input.cameraUp = cameraUp;
+    input.time = time;
+    glfwGetFramebufferSize(window, &input.width, &input.height);
+    input.height = input.height > 0 ? input.height : 1;
+    input.selectLeaves = selectLeaves;
+    return input;
+}
+
+// 模拟线程：只读快照和构建完成后不再修改的八叉树
+void simulateFrame(const FrameInput& input, FrameOutput& frame, const glutils::Octree* octree) {
+    glm::mat4 proj = glm::perspective(glm::radians(45.0f), (float)input.width / input.height, 0.1f, 100.0f);
+    glm::mat4 view = glm::lookAt(input.cameraPos, input.cameraPos + input.cameraFront, input.cameraUp);
+    glm::mat4 model = glm::rotate(glm::mat4(1.0f), input.time * 0.2f, glm::vec3(0.0f, 1.0f, 0.0f));
+    frame.mvp = proj * view * model;
+    frame.time = input.time;
+    frame.useDrawList = octree && input.selectLeaves;
+    if (frame.useDrawList) {
+        glutils::OctreeLod lod;
+        lod.viewportHeight = static_cast<float>(input.height);
+        lod.projScale = proj[1][1];
+        GLUTILS_PROFILE_ZONE("octree select");
+        octree->select(frame.mvp, lod, frame.drawList);
+    }
+}
+
 // 鼠标回调
 void mouse_callback(GLFWwindow* window, double xposIn, double yposIn) {
     float xpos = static_cast<float>(xposIn);
@@ -46,64 +119,185 @@ void processInput(GLFWwindow* window, float deltaTime) {
     if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS) glfwSetWindowShouldClose(window, true);
 }
 
+// 打开点云文件，非 .gpc 文件先导入、按 Morton 序重排并量化缓存，源文件更新后重新生成
+std::unique_ptr<glutils::PointCloudFile> openPointCloud(std::filesystem::path path) {
+    if (path.extension() != ".gpc") {
+        std::filesystem::path cached = path;
+        cached += ".gpc";
+        std::error_code ec;
+        if (!std::filesystem::exists(cached) || std::filesystem::last_write_time(cached, ec) < std::filesystem::last_write_time(path, ec)) {
+            std::vector<float> points;
+            if (!glutils::importPointCloud(path, points))
+                return nullptr;
+            glutils::Octree().build(points.data(), points.size() / 3);
+            if (!glutils::writePointCloudFile(cached, points.data(), points.size() / 3))
+                return nullptr;
+        }
+        path = cached;
+    }
+    auto file = std::make_unique<glutils::PointCloudFile>();
+    if (!file->open(path))
+        return nullptr;
+    return file;
+}
+
 // 着色器
 const char* vertexShaderSource = "#version 330 core\n layout (location = 0) in vec3 aPos; uniform mat4 mvp; out vec3 vColor; void main() { gl_Position = mvp * vec4(aPos, 1.0); vColor = vec3(aPos.y + 0.5, 0.5, 1.0 - aPos.y); }";
 const char* fragmentShaderSource = "#version 330 core\n in vec3 vColor; out vec4 FragColor; void main() { FragColor = vec4(vColor, 1.0); }";
 
-int main() {
-    glfwInit();
-    GLFWwindow* window = glfwCreateWindow(800, 600, "Auto-Rotate & Manual Control", NULL, NULL);
-    glfwMakeContextCurrent(window);
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        std::string arg = argv[1];
+        if (std::isdigit(static_cast<unsigned char>(arg[0]))) POINT_COUNT = std::stoull(arg);
+        else POINT_FILE = arg;
+    }
+    if (argc > 2) USE_OCTREE = std::string(argv[2]) == "octree";
+    if (argc > 2) USE_GPU = std::string(argv[2]) == "gpu";
+    glutils::Stopwatch startup;
+
+    glutils::initGLFW();
+    GLFWwindow* window = glutils::createWindow(800, 600, "Auto-Rotate & Manual Control");
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
     glfwSetCursorPosCallback(window, mouse_callback);
-    gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
-    glEnable(GL_DEPTH_TEST);
-
-    unsigned int vs = glCreateShader(GL_VERTEX_SHADER); glShaderSource(vs, 1, &vertexShaderSource, NULL); glCompileShader(vs);
-    unsigned int fs = glCreateShader(GL_FRAGMENT_SHADER); glShaderSource(fs, 1, &fragmentShaderSource, NULL); glCompileShader(fs);
-    unsigned int program = glCreateProgram(); glAttachShader(program, vs); glAttachShader(program, fs); glLinkProgram(program);
-
-    std::vector<float> vertices;
-    std::mt19937 rng(42);
-    std::uniform_real_distribution<float> dist(-3.0f, 3.0f); // 稍微散开一点
-    for (int i = 0; i < POINT_COUNT * 3; ++i) vertices.push_back(dist(rng));
-
-    unsigned int VAO, VBO;
-    glGenVertexArrays(1, &VAO); glGenBuffers(1, &VBO);
-    glBindVertexArray(VAO); glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+    glutils::glState().enable(GL_DEPTH_TEST);
+
+    // 程序持有 GL 对象，同样在 glfwTerminate 之前释放
+    auto shader = std::make_unique<glutils::Shader>(glutils::compileShader(
+        glutils::VertexShaderSource{vertexShaderSource}, glutils::FragmentShaderSource{fragmentShaderSource}));
+
+    if (USE_GPU && (!POINT_FILE.empty() || !glutils::GpuPointCloud::supported())) {
+        std::cout << (POINT_FILE.empty() ? "计算着色器需要 OpenGL 4.3" : "GPU 模式只支持随机点") << "，改用 CPU 生成" << std::endl;
+        USE_GPU = false;
+    }
+    if (USE_GPU && !glutils::GpuPointCloud::supported(POINT_COUNT)) {
+        std::cout << "点数超出 GPU 模式上限 " << glutils::GpuPointCloud::maxPoints() << "，改用 CPU 生成" << std::endl;
+        USE_GPU = false;
+    }
+    if (USE_GPU) {
+        // 点在 GPU 上生成，与 CPU 模式的点完全相同，但不需要上传
+        auto points = std::make_unique<glutils::GpuPointCloud>(POINT_COUNT, 42, -3.0f, 3.0f);
+        glutils::FramePipeline<FrameInput, FrameOutput> pipeline(
+            [](const FrameInput& input, FrameOutput& frame, glutils::JobSystem&) { simulateFrame(input, frame, nullptr); });
+        glutils::FrameLoop loop(window, "InteractivePointCloud/gpu");
+        // 先提交一帧，之后每帧绘制的都是上一帧输入的结果，模拟与渲染重叠
+        pipeline.submit(captureInput(window, 0.0f, false));
+        bool firstFrame = true;
+        while (loop.next()) {
+            processInput(window, loop.deltaTime());
+            pipeline.submit(captureInput(window, (float)loop.time(), false));
+            const FrameOutput& frame = pipeline.acquire();
+            const glm::mat4& mvp = frame.mvp;
+
+            points->update(mvp, frame.time);
+
+            GLUTILS_PROFILE_GPU_ZONE("render points");
+            glClearColor(0.02f, 0.02f, 0.02f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            shader->use();
+            shader->setUniform("mvp", mvp);
+            points->draw();
+            pipeline.release();
+
+            loop.present();
+            glfwPollEvents();
+            if (firstFrame) {
+                std::cout << "首帧耗时: " << startup.milliseconds() << " ms（" << POINT_COUNT << " 个点在 GPU 上生成，可见 "
+                          << points->readVisibleCount() << " 个）" << std::endl;
+                firstFrame = false;
+            }
+        }
+        points.reset();
+        shader.reset();
+        glfwTerminate();
+        return 0;
+    }
+
+    // 计数器随机数：第 i 个点只由 (i, 种子) 决定，多线程分块生成结果确定
+    std::unique_ptr<glutils::PointSource> pointSource;
+    if (POINT_FILE.empty()) {
+        pointSource = std::make_unique<glutils::RandomPointSource>(POINT_COUNT, 42, -3.0f, 3.0f); // 稍微散开一点
+    } else {
+        pointSource = openPointCloud(POINT_FILE);
+        if (!pointSource) {
+            glfwTerminate();
+            return -1;
+        }
+        POINT_COUNT = pointSource->size();
+    }
+    const glutils::PointSource& source = *pointSource;
+
+    // 八叉树模式需要先在 CPU 上拿到全部点并按八叉树顺序重排，再从重排后的数组流式上传
+    std::vector<float> octreePoints;
+    glutils::Octree octree;
+    std::unique_ptr<glutils::ArrayPointSource> octreeSource;
+    if (USE_OCTREE) {
+        glutils::Stopwatch buildTimer;
+        octreePoints.resize(POINT_COUNT * 3);
+        glutils::readParallel(source, 0, POINT_COUNT, octreePoints.data());
+        octree.build(octreePoints.data(), POINT_COUNT);
+        octreeSource = std::make_unique<glutils::ArrayPointSource>(octreePoints.data(), POINT_COUNT);
+        std::cout << "八叉树构建耗时: " << buildTimer.milliseconds() << " ms，节点数: " << octree.nodes().size() << std::endl;
+    }
+    // streamer 持有 GL 缓冲，必须在 glfwTerminate 之前析构
+    auto streamer = std::make_unique<glutils::PointStreamer>(
+        USE_OCTREE ? static_cast<const glutils::PointSource&>(*octreeSource) : source, CHUNK_POINTS);
+
+    auto VAO = glutils::VertexArrayHandle::create();
+    glutils::glState().bindVertexArray(VAO.get());
+    glutils::glState().bindBuffer(GL_ARRAY_BUFFER, streamer->buffer());
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
 
-    float deltaTime = 0.0f, lastFrame = 0.0f;
+    bool firstFrame = true, reported = false;
 
-    while (!glfwWindowShouldClose(window)) {
-        float currentFrame = (float)glfwGetTime();
-        deltaTime = currentFrame - lastFrame;
-        lastFrame = currentFrame;
-
-        processInput(window, deltaTime);
+    // 八叉树在这之前已经构建完成，模拟线程只读它；流水线先于八叉树析构
+    const glutils::Octree* selectTree = USE_OCTREE ? &octree : nullptr;
+    glutils::FramePipeline<FrameInput, FrameOutput> pipeline(
+        [selectTree](const FrameInput& input, FrameOutput& frame, glutils::JobSystem&) { simulateFrame(input, frame, selectTree); });
+    glutils::FrameLoop loop(window, USE_OCTREE ? "InteractivePointCloud/octree" : "InteractivePointCloud");
+    // 先提交一帧，之后每帧绘制的都是上一帧输入的结果，模拟与渲染重叠
+    pipeline.submit(captureInput(window, 0.0f, false));
+    while (loop.next()) {
+        processInput(window, loop.deltaTime());
+        pipeline.submit(captureInput(window, (float)loop.time(), USE_OCTREE && streamer->finished()));
+        const FrameOutput& frame = pipeline.acquire();
 
+        GLUTILS_PROFILE_GPU_ZONE("render points");
         glClearColor(0.02f, 0.02f, 0.02f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        glUseProgram(program);
-
-        int w, h; glfwGetFramebufferSize(window, &w, &h);
-        glm::mat4 proj = glm::perspective(glm::radians(45.0f), (float)w / h, 0.1f, 100.0f);
-        
-        glm::mat4 view = glm::lookAt(cameraPos, cameraPos + cameraFront, cameraUp);
-        
-        glm::mat4 model = glm::rotate(glm::mat4(1.0f), (float)glfwGetTime() * 0.2f, glm::vec3(0.0f, 1.0f, 0.0f));
-        
-        glm::mat4 mvp = proj * view * model;
-        glUniformMatrix4fv(glGetUniformLocation(program, "mvp"), 1, GL_FALSE, glm::value_ptr(mvp));
+        shader->use();
+        shader->setUniform("mvp", frame.mvp);
 
-        glBindVertexArray(VAO);
-        glDrawArrays(GL_POINTS, 0, POINT_COUNT);
+        // 只绘制已经上传完成的分块
+        std::size_t readyPoints = streamer->pump();
+        glutils::glState().bindVertexArray(VAO.get());
+        if (frame.useDrawList) {
+            const glutils::OctreeDrawList& drawList = frame.drawList;
+            glMultiDrawArrays(GL_POINTS, drawList.first.data(), drawList.count.data(), static_cast<GLsizei>(drawList.first.size()));
+        } else {
+            glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(readyPoints));
+        }
+        GLUTILS_COUNT_DRAW(1);
+        pipeline.release();
 
-        glfwSwapBuffers(window);
+        loop.present();
         glfwPollEvents();
+
+        if (firstFrame) {
+            std::cout << "首帧耗时: " << startup.milliseconds() << " ms（" << readyPoints << " 个点已就绪，"
+                      << (streamer->isPersistent() ? "持久映射" : "暂存上传") << "）" << std::endl;
+            firstFrame = false;
+        }
+        if (!reported && streamer->finished()) {
+            std::cout << POINT_COUNT << " 个点全部上传耗时: " << startup.milliseconds() << " ms，峰值内存: "
+                      << glutils::peakResidentBytes() / (1024.0 * 1024.0) << " MiB" << std::endl;
+            reported = true;
+        }
     }
+    VAO.reset();
+    shader.reset();
+    streamer.reset();
+    glutils::glObjects().flush();
     glfwTerminate();
 }
\ No newline at end of file
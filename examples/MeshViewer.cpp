@@ -0,0 +1,146 @@
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "AsyncShader.hpp"
+#include "BenchUtils.hpp"
+#include "FrameLoop.hpp"
+#include "GLHandles.hpp"
+#include "GLUtils.hpp"
+#include "MeshLoader.hpp"
+#include "Parallel.hpp"
+#include "Transforms.hpp"
+
+// 用 MilkWhite 着色器显示大网格（.stl / .ply / .obj），模型绕 Y 轴旋转
+// 用法：MeshViewer [网格文件，默认 res/meshes/cube.obj] [legacy]
+// 加载时报告并行解析和平滑法线的耗时与吞吐量；STL 的三角形汤先按位置合并顶点再计算平滑法线。
+// 法线矩阵每次绘制在 CPU 上算一次，作为 uniform 传入；第二个参数为 legacy 时改用旧版着色器 MilkWhiteLegacy.vert
+// （顶点着色器里逐顶点 transpose(inverse(model))），配合 GLUTILS_BENCH_FRAMES 比较两者的 GPU 帧时间。
+// 运行中按 N 键在两种着色器之间切换。
+
+void processInput(GLFWwindow* window, bool& legacy) {
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, true);
+
+    static bool nPressed = false;
+    if (glfwGetKey(window, GLFW_KEY_N) == GLFW_PRESS && !nPressed) {
+        legacy = !legacy;
+        std::cout << (legacy ? "逐顶点求逆（旧版）" : "uniform 法线矩阵") << std::endl;
+        nPressed = true;
+    }
+    if (glfwGetKey(window, GLFW_KEY_N) == GLFW_RELEASE) nPressed = false;
+}
+
+int main(int argc, char** argv) {
+    const std::filesystem::path meshPath = argc > 1 ? argv[1] : "res/meshes/cube.obj";
+    bool legacy = argc > 2 && std::string(argv[2]) == "legacy";
+
+    glutils::initGLFW();
+    GLFWwindow* window = glutils::createWindow(1280, 720, "Mesh Viewer (N: toggle normal matrix)");
+    glutils::glState().enable(GL_DEPTH_TEST);
+
+    glutils::Mesh mesh;
+    glutils::Stopwatch timer;
+    if (!glutils::loadMesh(meshPath, mesh)) {
+        glfwTerminate();
+        return -1;
+    }
+    const double parseMs = timer.milliseconds();
+    const double fileMB = double(std::filesystem::file_size(meshPath)) / (1024.0 * 1024.0);
+    std::cout << meshPath.string() << "：" << fileMB << " MiB，" << mesh.triangleCount() << " 个三角形，" << mesh.vertexCount() << " 个顶点，"
+              << glutils::workerCount() << " 个线程解析 " << parseMs << " ms（" << fileMB / (parseMs / 1000.0) << " MiB/s，"
+              << double(mesh.triangleCount()) / (parseMs * 1000.0) << " M 三角形/s）" << std::endl;
+    std::string ext = meshPath.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (ext == ".stl") {
+        timer.reset();
+        glutils::smoothMeshNormals(mesh);
+        std::cout << "合并顶点并计算平滑法线 " << timer.milliseconds() << " ms，合并后 " << mesh.vertexCount() << " 个顶点" << std::endl;
+    }
+
+    // 按包围盒把模型移到原点并缩放到单位大小
+    glm::vec3 lower(1e30f), upper(-1e30f);
+    for (std::size_t v = 0; v < mesh.vertexCount(); ++v) {
+        const glm::vec3 p(mesh.vertices[v * 6], mesh.vertices[v * 6 + 1], mesh.vertices[v * 6 + 2]);
+        lower = glm::min(lower, p);
+        upper = glm::max(upper, p);
+    }
+    const glm::vec3 center = (lower + upper) * 0.5f;
+    const glm::vec3 extent = upper - lower;
+    const float scale = 1.0f / std::max({ extent.x, extent.y, extent.z, 1e-6f });
+    const glm::mat4 fit = glm::translate(glm::scale(glm::mat4(1.0f), glm::vec3(scale)), -center);
+
+    auto VAO = glutils::VertexArrayHandle::create();
+    auto VBO = glutils::BufferHandle::create();
+    auto EBO = glutils::BufferHandle::create();
+    glutils::glState().bindVertexArray(VAO.get());
+    glutils::glState().bindBuffer(GL_ARRAY_BUFFER, VBO.get());
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(mesh.vertexBytes()), mesh.vertices.data(), GL_STATIC_DRAW);
+    glutils::glState().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO.get());
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(mesh.indexBytes()), mesh.indices.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    GLUTILS_COUNT_UPLOAD(mesh.vertexBytes() + mesh.indexBytes());
+    const GLsizei indexCount = static_cast<GLsizei>(mesh.indices.size());
+    mesh = glutils::Mesh();
+
+    std::vector<std::string> sources;
+    if (!glutils::loadShaderFiles({ "res/shaders/MilkWhite.vert", "res/shaders/MilkWhite.frag", "res/shaders/MilkWhiteLegacy.vert" }, sources)) {
+        glfwTerminate();
+        return -1;
+    }
+    auto shader = std::make_unique<glutils::Shader>(glutils::compileShader(
+        glutils::VertexShaderSource{ sources[0] }, glutils::FragmentShaderSource{ sources[1] }));
+    auto legacyShader = std::make_unique<glutils::Shader>(glutils::compileShader(
+        glutils::VertexShaderSource{ sources[2] }, glutils::FragmentShaderSource{ sources[1] }));
+
+    const glm::vec3 eye(0.0f, 0.8f, 2.2f);
+    glutils::FrameLoop loop(window, legacy ? "MeshViewer (legacy)" : "MeshViewer");
+    while (loop.next()) {
+        processInput(window, legacy);
+
+        GLUTILS_PROFILE_GPU_ZONE("draw mesh");
+        glClearColor(0.08f, 0.08f, 0.1f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        int w, h;
+        glfwGetFramebufferSize(window, &w, &h);
+        const glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)w / (float)std::max(h, 1), 0.1f, 100.0f);
+        const glm::mat4 view = glm::lookAt(eye, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        const glm::mat4 model = glm::rotate(glm::mat4(1.0f), (float)loop.time() * 0.5f, glm::vec3(0.0f, 1.0f, 0.0f)) * fit;
+
+        glutils::Shader& program = legacy ? *legacyShader : *shader;
+        program.use();
+        program.setUniform("mvp", projection * view * model);
+        if (legacy)
+            program.setUniform("model", model);
+        else
+            program.setUniform("normalMatrix", glutils::normalMatrix(model));
+        program.setUniform("viewPos", eye);
+
+        glutils::glState().bindVertexArray(VAO.get());
+        glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
+        GLUTILS_COUNT_DRAW(1);
+
+        loop.present();
+        glfwPollEvents();
+    }
+
+    VAO.reset();
+    VBO.reset();
+    EBO.reset();
+    shader.reset();
+    legacyShader.reset();
+    glutils::glObjects().flush();
+    glfwTerminate();
+    return 0;
+}
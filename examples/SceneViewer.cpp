@@ -0,0 +1,100 @@
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include "BenchUtils.hpp"
+#include "FrameLoop.hpp"
+#include "GLHandles.hpp"
+#include "GLUtils.hpp"
+#include "Scene.hpp"
+#include "ShaderCache.hpp"
+
+// 从 JSON 场景描述加载并显示场景，相机绕观察目标自动旋转
+// 用法：SceneViewer [场景文件，默认 res/scenes/demo.json] [json]
+// 默认使用烘焙缓存（场景文件名 + .gsc）：不存在，或者场景文件、着色器、网格、点云中任何一个的修改时间或大小
+// 与烘焙时记录的不同，就先从 JSON 加载并重新烘焙，之后启动只需映射文件和上传。
+// 第二个参数为 json 时跳过缓存，每次都解析 JSON。
+
+void processInput(GLFWwindow* window) {
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, true);
+}
+
+int main(int argc, char** argv) {
+    const std::filesystem::path scenePath = argc > 1 ? argv[1] : "res/scenes/demo.json";
+    const bool forceJson = argc > 2 && std::string(argv[2]) == "json";
+    glutils::Stopwatch startup;
+
+    glutils::initGLFW();
+    GLFWwindow* window = glutils::createWindow(800, 600, "Scene Viewer");
+    glutils::glState().enable(GL_DEPTH_TEST);
+
+    // 烘焙场景的数组直接指向映射内存，上传完成之前必须保持打开
+    glutils::Scene scene;
+    glutils::BakedScene baked;
+    glutils::SceneView view;
+    std::filesystem::path bakedPath = scenePath;
+    bakedPath += ".gsc";
+    if (!forceJson && std::filesystem::exists(bakedPath) && baked.open(bakedPath)) {
+        if (glutils::sceneDependenciesChanged(baked.view())) {
+            std::cout << "烘焙缓存已过期: " << bakedPath.string() << std::endl;
+            // 关闭映射，下面重新烘焙时要覆盖这个文件
+            baked.close();
+        }
+    }
+    if (baked.isOpen()) {
+        view = baked.view();
+        std::cout << "使用烘焙缓存: " << bakedPath.string() << "（" << baked.fileBytes() / 1024 << " KiB）" << std::endl;
+    } else {
+        if (!glutils::loadScene(scenePath, scene)) {
+            glfwTerminate();
+            return -1;
+        }
+        view = scene.view();
+        if (!forceJson && glutils::bakeScene(view, bakedPath))
+            std::cout << "已烘焙场景缓存: " << bakedPath.string() << std::endl;
+    }
+
+    glutils::ProgramCache programCache;
+    auto renderer = std::make_unique<glutils::SceneRenderer>(view, &programCache);
+    std::cout << "启动耗时: " << startup.milliseconds() << " ms（" << view.meshes.size() << " 个网格，" << view.pointClouds.size()
+              << " 个点云，" << renderer->instanceCount() << " 个实例，" << renderer->programCount() << " 个着色器）" << std::endl;
+
+    const glm::vec3 target = glm::make_vec3(view.camera.target);
+    const glm::vec3 offset = glm::make_vec3(view.camera.position) - target;
+    const float radius = std::sqrt(offset.x * offset.x + offset.z * offset.z);
+    const float startAngle = std::atan2(offset.z, offset.x);
+
+    glutils::FrameLoop loop(window, "SceneViewer");
+    while (loop.next()) {
+        processInput(window);
+
+        GLUTILS_PROFILE_GPU_ZONE("draw scene");
+        glClearColor(0.08f, 0.08f, 0.1f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        const float angle = startAngle + (float)loop.time() * 0.3f;
+        const glm::vec3 eye = target + glm::vec3(std::cos(angle) * radius, offset.y, std::sin(angle) * radius);
+        int w, h;
+        glfwGetFramebufferSize(window, &w, &h);
+        glutils::SceneCamera camera = view.camera;
+        camera.position[0] = eye.x;
+        camera.position[1] = eye.y;
+        camera.position[2] = eye.z;
+        renderer->draw(camera.viewMatrix(), camera.projectionMatrix((float)w / (float)std::max(h, 1)), eye);
+
+        loop.present();
+        glfwPollEvents();
+    }
+
+    renderer.reset();
+    glutils::glObjects().flush();
+    glfwTerminate();
+    return 0;
+}
@@ -0,0 +1,165 @@
+#include <cmath>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include "BenchUtils.hpp"
+#include "Scene.hpp"
+#include "SoftRasterizer.hpp"
+
+// 不需要 GPU 和窗口：用软件光栅化器渲染各示例的画面并保存为 PPM，可以和参考图逐像素比较，用于没有显卡的 CI
+// 用法：SoftRender [输出目录，默认 soft_render] [参考图目录] [单通道容差，默认 0]
+// 给出参考图目录时，任何一幅图有超出容差的像素就返回非零退出码；首次运行不带参考目录，把输出目录存为参考图即可。
+// 画面：
+//   triangle  - DrawTriangle：橘黄色三角形，线框模式
+//   cube      - ExportableCube：顶点色立方体，t = 1 秒时的旋转
+//   milkwhite - res/scenes/demo.json：网格用 MilkWhite 着色器的移植版本，点云用实例颜色
+
+// DrawTriangle 的着色器：位置直接作为裁剪坐标，片段为固定颜色
+struct FlatProgram {
+    static constexpr int kVaryings = 0;
+    glm::mat4 mvp{ 1.0f };
+    glm::vec4 color{ 1.0f, 0.5f, 0.2f, 1.0f };
+
+    glm::vec4 vertex(const float* attributes, float*) const { return mvp * glm::vec4(attributes[0], attributes[1], attributes[2], 1.0f); }
+    glm::vec4 fragment(const float*) const { return color; }
+};
+
+// ExportableCube 的着色器：gl_Position = model * aPos，颜色插值
+struct VertexColorProgram {
+    static constexpr int kVaryings = 3;
+    glm::mat4 model{ 1.0f };
+
+    glm::vec4 vertex(const float* attributes, float* varyings) const {
+        varyings[0] = attributes[3];
+        varyings[1] = attributes[4];
+        varyings[2] = attributes[5];
+        return model * glm::vec4(attributes[0], attributes[1], attributes[2], 1.0f);
+    }
+    glm::vec4 fragment(const float* varyings) const { return { varyings[0], varyings[1], varyings[2], 1.0f }; }
+};
+
+constexpr int kWidth = 800;
+constexpr int kHeight = 600;
+
+void renderTriangle(glutils::SoftRasterizer& rasterizer, glutils::SoftFramebuffer& target) {
+    const float vertices[] = { 0.0f, 0.5f, 0.0f, -0.5f, -0.5f, 0.0f, 0.5f, -0.5f, 0.0f };
+    target.clear({ 0.2f, 0.3f, 0.3f, 1.0f });
+    glutils::SoftDrawState state;
+    state.polygonMode = glutils::SoftPolygonMode::Line;
+    rasterizer.drawArrays(target, FlatProgram{}, state, glutils::SoftPrimitive::Triangles, vertices, 3);
+}
+
+void renderCube(glutils::SoftRasterizer& rasterizer, glutils::SoftFramebuffer& target) {
+    const float vertices[] = {
+        -0.5f,-0.5f,-0.5f,  1.0f,0.0f,0.0f,  0.5f,-0.5f,-0.5f,  0.0f,1.0f,0.0f,
+         0.5f, 0.5f,-0.5f,  0.0f,0.0f,1.0f, -0.5f, 0.5f,-0.5f,  1.0f,1.0f,0.0f,
+        -0.5f,-0.5f, 0.5f,  1.0f,0.0f,1.0f,  0.5f,-0.5f, 0.5f,  0.0f,1.0f,1.0f,
+         0.5f, 0.5f, 0.5f,  1.0f,1.0f,1.0f, -0.5f, 0.5f, 0.5f,  0.5f,0.5f,0.5f
+    };
+    const std::uint32_t indices[] = {
+        0,1,2, 2,3,0, 4,5,6, 6,7,4, 0,4,7, 7,3,0,
+        1,5,6, 6,2,1, 3,2,6, 6,7,3, 0,1,5, 5,4,0
+    };
+    // 与 ExportableCube 的旋转矩阵相同
+    const float t = 1.0f, s = std::sin(t), c = std::cos(t);
+    const float model[16] = {
+        c*0.5f, s*s*0.5f, s*c*0.5f, 0,
+        0,      c*0.5f,   -s*0.5f,  0,
+        -s*0.5f,c*s*0.5f, c*c*0.5f, 0,
+        0,      0,        0,        1
+    };
+    VertexColorProgram program;
+    program.model = glm::make_mat4(model);
+    target.clear({ 0.1f, 0.1f, 0.1f, 1.0f });
+    glutils::SoftDrawState state;
+    state.depthTest = true;
+    rasterizer.drawElements(target, program, state, glutils::SoftPrimitive::Triangles, vertices, 6, indices);
+}
+
+bool renderMilkWhite(glutils::SoftRasterizer& rasterizer, glutils::SoftFramebuffer& target) {
+    glutils::Scene scene;
+    if (!glutils::loadScene("res/scenes/demo.json", scene))
+        return false;
+    const glutils::SceneView view = scene.view();
+    const glm::mat4 viewMatrix = view.camera.viewMatrix();
+    const glm::mat4 projection = view.camera.projectionMatrix(static_cast<float>(kWidth) / static_cast<float>(kHeight));
+
+    target.clear({ 0.08f, 0.08f, 0.1f, 1.0f });
+    glutils::SoftDrawState state;
+    state.depthTest = true;
+    for (const glutils::SceneInstance& instance : view.instances) {
+        const glm::mat4 model = glm::make_mat4(instance.model);
+        if (instance.kind == glutils::SceneGeometry::Mesh) {
+            const glutils::SceneMeshRange& mesh = view.meshes[instance.geometry];
+            glutils::SoftMilkWhiteProgram program;
+            program.setModel(model);
+            program.mvp = projection * viewMatrix * model;
+            program.viewPos = glm::make_vec3(view.camera.position);
+            rasterizer.drawElements(target, program, state, glutils::SoftPrimitive::Triangles,
+                                    view.vertices.subspan(mesh.baseVertex * glutils::kSceneVertexFloats, mesh.vertexCount * glutils::kSceneVertexFloats),
+                                    glutils::kSceneVertexFloats, view.indices.subspan(mesh.firstIndex, mesh.indexCount));
+        } else {
+            const glutils::ScenePointRange& cloud = view.pointClouds[instance.geometry];
+            FlatProgram program;
+            program.mvp = projection * viewMatrix * model;
+            program.color = glm::make_vec4(instance.color);
+            rasterizer.drawArrays(target, program, state, glutils::SoftPrimitive::Points,
+                                  view.points.subspan(std::size_t{cloud.firstPoint} * 3, std::size_t{cloud.pointCount} * 3), 3);
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const std::filesystem::path outputDir = argc > 1 ? argv[1] : "soft_render";
+    const std::filesystem::path referenceDir = argc > 2 ? argv[2] : "";
+    const int tolerance = argc > 3 ? std::stoi(argv[3]) : 0;
+    std::filesystem::create_directories(outputDir);
+
+    struct Job {
+        const char* name;
+        std::function<bool(glutils::SoftRasterizer&, glutils::SoftFramebuffer&)> render;
+    };
+    const std::vector<Job> jobs = {
+        { "triangle", [](auto& r, auto& t) { renderTriangle(r, t); return true; } },
+        { "cube", [](auto& r, auto& t) { renderCube(r, t); return true; } },
+        { "milkwhite", renderMilkWhite },
+    };
+
+    glutils::SoftRasterizer rasterizer;
+    std::cout << "软件光栅化：" << glutils::simdLevelName(rasterizer.simdLevel()) << "，" << glutils::JobSystem::global().threadCount() + 1
+              << " 个线程" << std::endl;
+    bool ok = true;
+    for (const Job& job : jobs) {
+        glutils::SoftFramebuffer target(kWidth, kHeight);
+        rasterizer.resetStats();
+        glutils::Stopwatch timer;
+        if (!job.render(rasterizer, target)) {
+            ok = false;
+            continue;
+        }
+        const double ms = timer.milliseconds();
+        const std::filesystem::path output = outputDir / (std::string(job.name) + ".ppm");
+        ok &= target.writePPM(output);
+        std::cout << job.name << ": " << ms << " ms，" << rasterizer.stats().rasterized << " 个图元，" << rasterizer.stats().fragments
+                  << " 个片段 -> " << output.string();
+
+        if (!referenceDir.empty()) {
+            glutils::SoftFramebuffer reference;
+            const std::filesystem::path referencePath = referenceDir / output.filename();
+            if (!reference.readPPM(referencePath)) {
+                ok = false;
+            } else {
+                const glutils::SoftImageDiff diff = glutils::compareImages(target, reference, tolerance);
+                std::cout << "，与参考图相差 " << diff.differingPixels << " 个像素（最大通道差 " << diff.maxChannelDelta << "）";
+                ok &= diff.differingPixels == 0;
+            }
+        }
+        std::cout << std::endl;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,381 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "GLUtils.hpp"
+#include "Parallel.hpp"
+
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+namespace glutils {
+
+// 一个着色器阶段：类型 + 源码（拷贝保存，提交后调用者的源码对象可以立即释放）
+struct ShaderStage {
+    int type;
+    std::string source;
+};
+
+using ProgramStages = std::vector<ShaderStage>;
+
+inline ProgramStages makeStages(const is_shader_source auto&... sources) {
+    return { ShaderStage{ static_cast<int>(sources.getType()), sources.source }... };
+}
+
+/**
+ * @brief 批量读取着色器文件
+ *
+ * 各文件在多个线程上并行读取，每个文件整块读入一次，不经过 stringstream。
+ * 任一文件打开失败时打印路径并返回 false，对应的输出为空串。
+ */
+inline bool loadShaderFiles(const std::vector<std::string>& paths, std::vector<std::string>& sources) {
+    sources.assign(paths.size(), std::string());
+    std::vector<char> ok(paths.size(), 0);
+    parallelFor(paths.size(), 1, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i)
+            ok[i] = detail::readWholeFile(paths[i], sources[i]);
+    });
+    bool all = true;
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        if (!ok[i]) {
+            std::cerr << "Failed to open shader file: " << paths[i] << std::endl;
+            all = false;
+        }
+    }
+    return all;
+}
+
+/// @brief 异步编译的方式
+enum class AsyncCompileMode {
+    /// @brief 优先 KHR_parallel_shader_compile，其次共享上下文的工作线程，都不可用时同步编译
+    Auto,
+    /// @brief 驱动内部并行编译（GL_KHR/ARB_parallel_shader_compile），主线程每帧轮询完成状态
+    DriverParallel,
+    /// @brief 在共享上下文的工作线程上编译链接
+    Worker,
+    /// @brief 提交时直接在当前线程编译（对照用）
+    Sync
+};
+
+namespace detail {
+
+enum class AsyncProgramStatus : int { Pending, Ready, Failed };
+
+struct AsyncProgramState {
+    std::atomic<AsyncProgramStatus> status{ AsyncProgramStatus::Pending };
+    unsigned int program = 0;
+    // 仅 DriverParallel 模式使用：链接完成前保留的着色器对象
+    std::vector<unsigned int> shaders;
+};
+
+// 编译链接一组阶段并等待完成；失败时删除程序并返回 0
+inline unsigned int buildProgram(const ProgramStages& stages) {
+    std::vector<unsigned int> shaders;
+    shaders.reserve(stages.size());
+    for (const auto& stage : stages)
+        shaders.push_back(compileStage(stage.source.c_str(), stage.type));
+    unsigned int program = glCreateProgram();
+    for (unsigned int shader : shaders)
+        glAttachShader(program, shader);
+    glLinkProgram(program);
+    bool linked = checkLinkStatus(program);
+    for (unsigned int shader : shaders)
+        glDeleteShader(shader);
+    if (!linked) {
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+}
+
+/**
+ * @brief 异步编译的着色器程序句柄，类似 std::shared_future
+ *
+ * ready() / failed() 不阻塞；DriverParallel 模式下状态由 AsyncShaderCompiler::poll() 推进。
+ * 程序就绪后由调用者负责 glDeleteProgram，失败的程序由编译器删除。
+ */
+class ProgramHandle {
+public:
+    ProgramHandle() = default;
+
+    bool valid() const { return state != nullptr; }
+    bool ready() const { return state && state->status.load(std::memory_order_acquire) == detail::AsyncProgramStatus::Ready; }
+    bool failed() const { return state && state->status.load(std::memory_order_acquire) == detail::AsyncProgramStatus::Failed; }
+    bool done() const { return ready() || failed(); }
+
+    // 就绪时返回程序 ID，否则返回 0
+    unsigned int program() const { return ready() ? state->program : 0; }
+
+    // 就绪时返回程序 ID，否则返回 fallback，渲染循环可先用占位程序绘制
+    unsigned int programOr(unsigned int fallback) const { return ready() ? state->program : fallback; }
+
+private:
+    friend class AsyncShaderCompiler;
+    explicit ProgramHandle(std::shared_ptr<detail::AsyncProgramState> state) : state(std::move(state)) {}
+
+    std::shared_ptr<detail::AsyncProgramState> state;
+};
+
+/**
+ * @brief 异步着色器编译器
+ *
+ * submit() 一次提交多组着色器源码，立即返回句柄，不等待编译和链接：
+ * - 驱动支持 GL_KHR_parallel_shader_compile（或 ARB 版本）时，先提交全部阶段的编译再提交全部链接，
+ *   由驱动的编译线程并行完成，主线程每帧调用 poll() 查询 GL_COMPLETION_STATUS_KHR；
+ * - 否则创建一个与主窗口共享对象的隐藏窗口，在工作线程上逐个编译链接。
+ *
+ * 构造、submit()、poll()、wait() 和析构都必须在主窗口上下文所在的线程调用。
+ */
+class AsyncShaderCompiler {
+public:
+    explicit AsyncShaderCompiler(GLFWwindow* mainWindow, AsyncCompileMode requested = AsyncCompileMode::Auto) {
+        bool parallel = glfwExtensionSupported("GL_KHR_parallel_shader_compile") || glfwExtensionSupported("GL_ARB_parallel_shader_compile");
+        if (parallel && (requested == AsyncCompileMode::Auto || requested == AsyncCompileMode::DriverParallel)) {
+            using MaxThreadsFn = void (*)(GLuint);
+            auto maxThreads = reinterpret_cast<MaxThreadsFn>(glfwGetProcAddress("glMaxShaderCompilerThreadsKHR"));
+            if (!maxThreads)
+                maxThreads = reinterpret_cast<MaxThreadsFn>(glfwGetProcAddress("glMaxShaderCompilerThreadsARB"));
+            // 0xFFFFFFFF 表示由驱动决定线程数
+            if (maxThreads)
+                maxThreads(0xFFFFFFFFu);
+            activeMode = AsyncCompileMode::DriverParallel;
+            return;
+        }
+        if (requested == AsyncCompileMode::Auto || requested == AsyncCompileMode::Worker) {
+            if (startWorker(mainWindow))
+                return;
+        }
+        if (requested != AsyncCompileMode::Sync && requested != AsyncCompileMode::Auto)
+            std::cerr << "AsyncShaderCompiler: requested mode unavailable, compiling synchronously" << std::endl;
+        activeMode = AsyncCompileMode::Sync;
+    }
+
+    AsyncShaderCompiler(const AsyncShaderCompiler&) = delete;
+    AsyncShaderCompiler& operator=(const AsyncShaderCompiler&) = delete;
+
+    ~AsyncShaderCompiler() {
+        if (worker.joinable()) {
+            {
+                std::lock_guard lock(mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            worker.join();
+        }
+        if (sharedWindow)
+            glfwDestroyWindow(sharedWindow);
+        // 仍在驱动中编译的程序：等待完成后释放着色器对象，程序本身交给句柄持有者
+        for (auto& state : pending)
+            finishDriverParallel(*state);
+    }
+
+    AsyncCompileMode mode() const { return activeMode; }
+
+    /**
+     * @brief 一次提交多组程序
+     *
+     * @return 与 programs 一一对应的句柄
+     */
+    std::vector<ProgramHandle> submit(std::vector<ProgramStages> programs) {
+        std::vector<ProgramHandle> handles;
+        handles.reserve(programs.size());
+        std::vector<std::shared_ptr<detail::AsyncProgramState>> states;
+        states.reserve(programs.size());
+        for (std::size_t i = 0; i < programs.size(); ++i) {
+            states.push_back(std::make_shared<detail::AsyncProgramState>());
+            handles.push_back(ProgramHandle(states.back()));
+        }
+
+        switch (activeMode) {
+        case AsyncCompileMode::DriverParallel:
+            // 先把所有阶段都交给驱动编译，再统一链接，避免第一个链接阻塞在尚未开始的编译上
+            for (std::size_t i = 0; i < programs.size(); ++i) {
+                for (const auto& stage : programs[i]) {
+                    unsigned int shader = glCreateShader(stage.type);
+                    const char* source = stage.source.c_str();
+                    glShaderSource(shader, 1, &source, NULL);
+                    glCompileShader(shader);
+                    states[i]->shaders.push_back(shader);
+                }
+            }
+            for (auto& state : states) {
+                state->program = glCreateProgram();
+                for (unsigned int shader : state->shaders)
+                    glAttachShader(state->program, shader);
+                glLinkProgram(state->program);
+                pending.push_back(state);
+            }
+            break;
+        case AsyncCompileMode::Worker: {
+            {
+                std::lock_guard lock(mutex);
+                for (std::size_t i = 0; i < programs.size(); ++i)
+                    jobs.push_back({ states[i], std::move(programs[i]) });
+            }
+            wake.notify_one();
+            break;
+        }
+        default:
+            for (std::size_t i = 0; i < programs.size(); ++i)
+                publish(*states[i], detail::buildProgram(programs[i]));
+            break;
+        }
+        return handles;
+    }
+
+    ProgramHandle submit(const is_shader_source auto&... sources) {
+        std::vector<ProgramStages> programs;
+        programs.push_back(makeStages(sources...));
+        return submit(std::move(programs)).front();
+    }
+
+    /**
+     * @brief 推进未完成的程序，每帧调用一次
+     *
+     * @return 仍未完成的程序数
+     */
+    std::size_t poll() {
+        if (activeMode == AsyncCompileMode::Worker) {
+            std::lock_guard lock(mutex);
+            return jobs.size() + (busy ? 1 : 0);
+        }
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < pending.size(); ++i) {
+            GLint complete = GL_FALSE;
+            glGetProgramiv(pending[i]->program, GL_COMPLETION_STATUS_KHR, &complete);
+            if (complete)
+                finishDriverParallel(*pending[i]);
+            else
+                pending[kept++] = std::move(pending[i]);
+        }
+        pending.resize(kept);
+        return kept;
+    }
+
+    /**
+     * @brief 阻塞等待某个程序完成
+     *
+     * @return 链接好的程序 ID，失败返回 0
+     */
+    unsigned int wait(const ProgramHandle& handle) {
+        if (!handle.valid())
+            return 0;
+        if (activeMode == AsyncCompileMode::Worker) {
+            std::unique_lock lock(mutex);
+            finished.wait(lock, [&] { return handle.done(); });
+        } else if (!handle.done()) {
+            for (std::size_t i = 0; i < pending.size(); ++i) {
+                if (pending[i] == handle.state) {
+                    finishDriverParallel(*pending[i]);
+                    pending.erase(pending.begin() + static_cast<std::ptrdiff_t>(i));
+                    break;
+                }
+            }
+        }
+        return handle.program();
+    }
+
+    // 阻塞等待全部已提交的程序完成
+    void waitAll() {
+        if (activeMode == AsyncCompileMode::Worker) {
+            std::unique_lock lock(mutex);
+            finished.wait(lock, [&] { return jobs.empty() && !busy; });
+            return;
+        }
+        for (auto& state : pending)
+            finishDriverParallel(*state);
+        pending.clear();
+    }
+
+private:
+    struct Job {
+        std::shared_ptr<detail::AsyncProgramState> state;
+        ProgramStages stages;
+    };
+
+    static void publish(detail::AsyncProgramState& state, unsigned int program) {
+        state.program = program;
+        state.status.store(program ? detail::AsyncProgramStatus::Ready : detail::AsyncProgramStatus::Failed, std::memory_order_release);
+    }
+
+    // 查询链接结果（未完成时会阻塞到完成），释放着色器对象并发布状态
+    static void finishDriverParallel(detail::AsyncProgramState& state) {
+        bool linked = detail::checkLinkStatus(state.program);
+        if (!linked) {
+            for (unsigned int shader : state.shaders)
+                detail::checkCompileStatus(shader);
+        }
+        for (unsigned int shader : state.shaders)
+            glDeleteShader(shader);
+        state.shaders.clear();
+        if (!linked) {
+            glDeleteProgram(state.program);
+            publish(state, 0);
+        } else {
+            publish(state, state.program);
+        }
+    }
+
+    bool startWorker(GLFWwindow* mainWindow) {
+        // 隐藏窗口只为持有一个与主窗口共享对象的上下文；窗口必须在主线程创建
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        sharedWindow = glfwCreateWindow(1, 1, "AsyncShaderCompiler", nullptr, mainWindow);
+        glfwWindowHint(GLFW_VISIBLE, isHeadless() ? GLFW_FALSE : GLFW_TRUE);
+        if (!sharedWindow)
+            return false;
+        activeMode = AsyncCompileMode::Worker;
+        worker = std::thread([this] { run(); });
+        return true;
+    }
+
+    void run() {
+        glfwMakeContextCurrent(sharedWindow);
+        for (;;) {
+            Job job;
+            {
+                std::unique_lock lock(mutex);
+                wake.wait(lock, [&] { return stopping || !jobs.empty(); });
+                if (jobs.empty())
+                    break;
+                job = std::move(jobs.front());
+                jobs.pop_front();
+                busy = true;
+            }
+            unsigned int program = detail::buildProgram(job.stages);
+            // 确保链接结果对主上下文可见后再发布
+            glFinish();
+            {
+                std::lock_guard lock(mutex);
+                publish(*job.state, program);
+                busy = false;
+            }
+            finished.notify_all();
+        }
+        glfwMakeContextCurrent(nullptr);
+    }
+
+    AsyncCompileMode activeMode = AsyncCompileMode::Sync;
+    std::vector<std::shared_ptr<detail::AsyncProgramState>> pending;
+
+    GLFWwindow* sharedWindow = nullptr;
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    std::deque<Job> jobs;
+    bool busy = false;
+    bool stopping = false;
+};
+
+}
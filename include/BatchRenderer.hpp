@@ -0,0 +1,418 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "GLState.hpp"
+#include "Parallel.hpp"
+#include "Profiler.hpp"
+
+namespace glutils {
+
+// 与 glMultiDrawElementsIndirect 要求的内存布局一致
+struct DrawElementsIndirectCommand {
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLuint baseInstance;
+};
+
+// 网格在共享顶点 / 索引缓冲中的位置
+struct BatchMesh {
+    GLuint firstIndex = 0;
+    GLuint indexCount = 0;
+    GLint baseVertex = 0;
+    // 模型空间包围球半径（以原点为中心），用于视锥剔除
+    float radius = 0.0f;
+};
+
+/**
+ * @brief 实例变换，按字段分开存放（SoA）
+ *
+ * 旋转为单位四元数 (x, y, z, w)，缩放为统一缩放。
+ * 各数组按同一实例编号对齐，直接对应 GPU 上的各实例属性流。
+ */
+struct InstanceTransforms {
+    std::vector<glm::vec3> position;
+    std::vector<glm::vec4> rotation;
+    std::vector<float> scale;
+    std::vector<std::uint32_t> mesh;
+
+    std::size_t size() const { return position.size(); }
+};
+
+// 绕单位轴 axis 旋转 angle 弧度的四元数 (x, y, z, w)
+inline glm::vec4 axisAngle(const glm::vec3& axis, float angle) {
+    const float s = std::sin(angle * 0.5f);
+    return glm::vec4(axis.x * s, axis.y * s, axis.z * s, std::cos(angle * 0.5f));
+}
+
+// 批量渲染使用的着色器：顶点布局与 ExportableCube 相同（位置 + 颜色），实例属性在着色器中组合成模型矩阵
+inline constexpr const char* kBatchVertexShader = R"(#version 330 core
+layout(location=0) in vec3 aPos;
+layout(location=1) in vec3 aColor;
+layout(location=2) in vec3 iPosition;
+layout(location=3) in vec4 iRotation;
+layout(location=4) in float iScale;
+uniform mat4 viewProjection;
+out vec3 vColor;
+void main(){
+    vec3 p = aPos * iScale;
+    p += 2.0 * cross(iRotation.xyz, cross(iRotation.xyz, p) + iRotation.w * p);
+    vColor = aColor;
+    gl_Position = viewProjection * vec4(p + iPosition, 1.0);
+})";
+
+inline constexpr const char* kBatchFragmentShader = R"(#version 330 core
+in vec3 vColor;
+out vec4 FragColor;
+void main(){ FragColor = vec4(vColor, 1.0); })";
+
+/**
+ * @brief 实例化 / 多重间接绘制的批量渲染器
+ *
+ * 所有网格共用一个顶点缓冲和一个索引缓冲，实例变换以 SoA 形式放在一个实例缓冲中（每个字段一段）。
+ * prepare() 按网格排序实例、并行做视锥剔除并紧凑写出可见实例，同时按分块并行生成
+ * DrawElementsIndirectCommand，再合并为每个网格一条命令；draw() 提交：
+ *
+ * - OpenGL 4.3+：一次 glMultiDrawElementsIndirect 绘制所有网格；
+ * - 更低版本（至少 3.3）：每个网格一次 glDrawElementsInstancedBaseVertex，
+ *   4.2 以下没有 baseInstance，改为重新指定实例属性的起始偏移。
+ *
+ * 顶点布局：每个顶点 6 个 float（位置 + 颜色），与 ExportableCube 相同。
+ * 所有 GL 调用都必须在持有上下文的线程进行。
+ */
+class BatchRenderer {
+public:
+    enum class SubmitMode { Auto, MultiDrawIndirect, Instanced };
+
+    // 每个并行分块处理的实例数
+    static constexpr std::size_t kChunkInstances = 4096;
+    static constexpr std::size_t kVertexFloats = 6;
+
+    explicit BatchRenderer(SubmitMode mode = SubmitMode::Auto) {
+        const bool indirect = GLAD_GL_VERSION_4_3;
+        submitMode = mode == SubmitMode::Auto || (mode == SubmitMode::MultiDrawIndirect && !indirect)
+            ? (indirect ? SubmitMode::MultiDrawIndirect : SubmitMode::Instanced)
+            : mode;
+        glGenVertexArrays(1, &vao);
+        glGenBuffers(1, &vbo);
+        glGenBuffers(1, &ebo);
+        glGenBuffers(1, &instanceBuffer);
+        if (submitMode == SubmitMode::MultiDrawIndirect)
+            glGenBuffers(1, &indirectBuffer);
+
+        glState().bindVertexArray(vao);
+        glState().bindBuffer(GL_ARRAY_BUFFER, vbo);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, kVertexFloats * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, kVertexFloats * sizeof(float), (void*)(3 * sizeof(float)));
+        glEnableVertexAttribArray(1);
+        glState().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+        for (GLuint attribute = 2; attribute <= 4; ++attribute) {
+            glEnableVertexAttribArray(attribute);
+            glVertexAttribDivisor(attribute, 1);
+        }
+    }
+
+    BatchRenderer(const BatchRenderer&) = delete;
+    BatchRenderer& operator=(const BatchRenderer&) = delete;
+
+    ~BatchRenderer() {
+        glState().deleteVertexArray(vao);
+        glState().deleteBuffer(vbo);
+        glState().deleteBuffer(ebo);
+        glState().deleteBuffer(instanceBuffer);
+        if (indirectBuffer)
+            glState().deleteBuffer(indirectBuffer);
+    }
+
+    SubmitMode mode() const { return submitMode; }
+
+    /**
+     * @brief 添加网格
+     *
+     * @param vertices 每个顶点 kVertexFloats 个 float
+     * @param indices 相对本网格第一个顶点的索引
+     * @return 网格编号
+     */
+    std::uint32_t addMesh(const float* vertices, std::size_t vertexCount, const std::uint32_t* indices, std::size_t indexCount) {
+        BatchMesh mesh;
+        mesh.firstIndex = static_cast<GLuint>(meshIndices.size());
+        mesh.indexCount = static_cast<GLuint>(indexCount);
+        mesh.baseVertex = static_cast<GLint>(meshVertices.size() / kVertexFloats);
+        for (std::size_t v = 0; v < vertexCount; ++v) {
+            const float* p = vertices + v * kVertexFloats;
+            mesh.radius = std::max(mesh.radius, std::sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]));
+        }
+        meshVertices.insert(meshVertices.end(), vertices, vertices + vertexCount * kVertexFloats);
+        meshIndices.insert(meshIndices.end(), indices, indices + indexCount);
+        meshes.push_back(mesh);
+        meshesDirty = true;
+        return static_cast<std::uint32_t>(meshes.size() - 1);
+    }
+
+    // 添加实例，返回实例编号（之后不变）
+    std::uint32_t addInstance(std::uint32_t mesh, const glm::vec3& position, const glm::vec4& rotation = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f), float scale = 1.0f) {
+        instances.position.push_back(position);
+        instances.rotation.push_back(rotation);
+        instances.scale.push_back(scale);
+        instances.mesh.push_back(mesh);
+        orderDirty = true;
+        return static_cast<std::uint32_t>(instances.size() - 1);
+    }
+
+    void setTransform(std::uint32_t instance, const glm::vec3& position, const glm::vec4& rotation, float scale) {
+        instances.position[instance] = position;
+        instances.rotation[instance] = rotation;
+        instances.scale[instance] = scale;
+        transformsDirty = true;
+    }
+
+    // 直接修改变换（不能增删实例或修改 mesh），改完后调用 markTransformsDirty()
+    InstanceTransforms& transforms() { return instances; }
+    const InstanceTransforms& transforms() const { return instances; }
+    void markTransformsDirty() { transformsDirty = true; }
+
+    void clearInstances() {
+        instances = {};
+        orderDirty = true;
+    }
+
+    /**
+     * @brief 剔除视锥外的实例并生成绘制命令
+     *
+     * @param viewProjection 用于视锥剔除的投影 * 视图矩阵
+     */
+    void prepare(const glm::mat4& viewProjection) {
+        GLUTILS_PROFILE_ZONE("BatchRenderer::prepare");
+        build(frustumPlanes(viewProjection), true);
+    }
+
+    // 不剔除：变换和实例都没有变化时直接复用上次的结果
+    void prepare() {
+        GLUTILS_PROFILE_ZONE("BatchRenderer::prepare");
+        if (!orderDirty && !transformsDirty && !meshesDirty && !lastCulled)
+            return;
+        build({}, false);
+    }
+
+    // 提交 prepare() 生成的命令
+    void draw() {
+        if (commandList.empty())
+            return;
+        glState().bindVertexArray(vao);
+        if (submitMode == SubmitMode::MultiDrawIndirect) {
+            glState().bindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+            glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(commandList.size()), 0);
+            GLUTILS_COUNT_DRAW(1);
+            return;
+        }
+        for (const auto& command : commandList) {
+            const void* indexOffset = (const void*)(std::uintptr_t(command.firstIndex) * sizeof(std::uint32_t));
+            if (GLAD_GL_VERSION_4_2) {
+                glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, command.count, GL_UNSIGNED_INT, indexOffset,
+                                                              command.instanceCount, command.baseVertex, command.baseInstance);
+            } else {
+                pointInstanceAttributes(command.baseInstance);
+                glDrawElementsInstancedBaseVertex(GL_TRIANGLES, command.count, GL_UNSIGNED_INT, indexOffset,
+                                                  command.instanceCount, command.baseVertex);
+            }
+        }
+        if (!GLAD_GL_VERSION_4_2)
+            pointInstanceAttributes(0);
+        GLUTILS_COUNT_DRAW(commandList.size());
+    }
+
+    const std::vector<DrawElementsIndirectCommand>& commands() const { return commandList; }
+    const std::vector<BatchMesh>& meshList() const { return meshes; }
+    std::size_t instanceCount() const { return instances.size(); }
+    // 上一次 prepare() 之后的可见实例数
+    std::size_t visibleCount() const { return visible; }
+
+private:
+    using Planes = std::array<glm::vec4, 6>;
+
+    // 从投影 * 视图矩阵提取六个视锥平面（法线朝内，已归一化）
+    static Planes frustumPlanes(const glm::mat4& m) {
+        const glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+        const glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+        const glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+        const glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+        Planes planes = { row3 + row0, row3 - row0, row3 + row1, row3 - row1, row3 + row2, row3 - row2 };
+        for (auto& plane : planes)
+            plane /= glm::length(glm::vec3(plane));
+        return planes;
+    }
+
+    // 按网格编号计数排序，相同网格的实例连续，每个网格才能只用一条命令
+    void sortByMesh() {
+        std::vector<std::size_t> offsets(meshes.size() + 1, 0);
+        for (std::uint32_t mesh : instances.mesh)
+            ++offsets[mesh + 1];
+        for (std::size_t m = 1; m < offsets.size(); ++m)
+            offsets[m] += offsets[m - 1];
+        order.resize(instances.size());
+        for (std::uint32_t i = 0; i < instances.size(); ++i)
+            order[offsets[instances.mesh[i]]++] = i;
+        orderDirty = false;
+    }
+
+    void build(const Planes& planes, bool cull) {
+        if (meshesDirty)
+            uploadMeshes();
+        if (orderDirty)
+            sortByMesh();
+        transformsDirty = false;
+        lastCulled = cull;
+
+        const std::size_t count = order.size();
+        const std::size_t chunks = (count + kChunkInstances - 1) / kChunkInstances;
+        chunkVisible.assign(chunks, 0);
+        chunkCommands.resize(chunks);
+        mask.resize(count);
+        stagingPosition.resize(count);
+        stagingRotation.resize(count);
+        stagingScale.resize(count);
+
+        // 第一遍：每块独立判断可见性并计数
+        parallelFor(chunks, 1, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t c = begin; c < end; ++c) {
+                std::uint32_t n = 0;
+                for (std::size_t k = c * kChunkInstances; k < std::min(count, (c + 1) * kChunkInstances); ++k) {
+                    const std::uint32_t i = order[k];
+                    bool inside = true;
+                    if (cull) {
+                        const glm::vec3& p = instances.position[i];
+                        const float r = meshes[instances.mesh[i]].radius * std::abs(instances.scale[i]);
+                        for (const auto& plane : planes)
+                            inside = inside && plane.x * p.x + plane.y * p.y + plane.z * p.z + plane.w >= -r;
+                    }
+                    mask[k] = inside;
+                    n += inside;
+                }
+                chunkVisible[c] = n;
+            }
+        });
+
+        std::vector<std::uint32_t> chunkBase(chunks + 1, 0);
+        for (std::size_t c = 0; c < chunks; ++c)
+            chunkBase[c + 1] = chunkBase[c] + chunkVisible[c];
+        visible = chunkBase[chunks];
+
+        // 第二遍：按前缀和偏移紧凑写出可见实例，同时为块内每段连续的同网格实例生成一条命令
+        parallelFor(chunks, 1, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t c = begin; c < end; ++c) {
+                auto& commands = chunkCommands[c];
+                commands.clear();
+                std::uint32_t out = chunkBase[c];
+                for (std::size_t k = c * kChunkInstances; k < std::min(count, (c + 1) * kChunkInstances); ++k) {
+                    if (!mask[k])
+                        continue;
+                    const std::uint32_t i = order[k];
+                    const std::uint32_t meshId = instances.mesh[i];
+                    stagingPosition[out] = instances.position[i];
+                    stagingRotation[out] = instances.rotation[i];
+                    stagingScale[out] = instances.scale[i];
+                    const BatchMesh& mesh = meshes[meshId];
+                    if (commands.empty() || commands.back().firstIndex != mesh.firstIndex || commands.back().baseVertex != mesh.baseVertex)
+                        commands.push_back({ mesh.indexCount, 0, mesh.firstIndex, mesh.baseVertex, out });
+                    ++commands.back().instanceCount;
+                    ++out;
+                }
+            }
+        });
+
+        // 输出按网格有序且连续，相邻块的同网格命令可以直接合并
+        commandList.clear();
+        for (const auto& commands : chunkCommands) {
+            for (const auto& command : commands) {
+                auto* last = commandList.empty() ? nullptr : &commandList.back();
+                if (last && last->firstIndex == command.firstIndex && last->baseVertex == command.baseVertex &&
+                    last->baseInstance + last->instanceCount == command.baseInstance)
+                    last->instanceCount += command.instanceCount;
+                else
+                    commandList.push_back(command);
+            }
+        }
+        uploadInstances();
+    }
+
+    void uploadMeshes() {
+        glState().bindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(meshVertices.size() * sizeof(float)), meshVertices.data(), GL_STATIC_DRAW);
+        // 元素缓冲属于 VAO 状态，先绑定 VAO
+        glState().bindVertexArray(vao);
+        glState().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(meshIndices.size() * sizeof(std::uint32_t)), meshIndices.data(), GL_STATIC_DRAW);
+        GLUTILS_COUNT_UPLOAD(meshVertices.size() * sizeof(float) + meshIndices.size() * sizeof(std::uint32_t));
+        meshesDirty = false;
+    }
+
+    // 实例缓冲按容量分三段：位置 | 旋转 | 缩放，只上传可见的前 visible 个
+    void uploadInstances() {
+        const std::size_t capacity = order.size();
+        glState().bindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+        // 整体重新分配（孤立旧存储），避免等待上一帧仍在使用的数据
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(capacity * kInstanceBytes), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(visible * sizeof(glm::vec3)), stagingPosition.data());
+        glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(capacity * sizeof(glm::vec3)),
+                        static_cast<GLsizeiptr>(visible * sizeof(glm::vec4)), stagingRotation.data());
+        glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(capacity * (sizeof(glm::vec3) + sizeof(glm::vec4))),
+                        static_cast<GLsizeiptr>(visible * sizeof(float)), stagingScale.data());
+        GLUTILS_COUNT_UPLOAD(visible * kInstanceBytes);
+        instanceCapacity = capacity;
+        glState().bindVertexArray(vao);
+        pointInstanceAttributes(0);
+
+        if (submitMode == SubmitMode::MultiDrawIndirect) {
+            glState().bindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+            glBufferData(GL_DRAW_INDIRECT_BUFFER, static_cast<GLsizeiptr>(commandList.size() * sizeof(DrawElementsIndirectCommand)),
+                         commandList.data(), GL_STREAM_DRAW);
+            GLUTILS_COUNT_UPLOAD(commandList.size() * sizeof(DrawElementsIndirectCommand));
+        }
+    }
+
+    // 让实例属性从第 first 个实例开始读取（VAO 必须已绑定）
+    void pointInstanceAttributes(std::size_t first) {
+        const std::size_t capacity = instanceCapacity;
+        glState().bindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+        glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)(first * sizeof(glm::vec3)));
+        glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), (void*)(capacity * sizeof(glm::vec3) + first * sizeof(glm::vec4)));
+        glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, sizeof(float), (void*)(capacity * (sizeof(glm::vec3) + sizeof(glm::vec4)) + first * sizeof(float)));
+    }
+
+    static constexpr std::size_t kInstanceBytes = sizeof(glm::vec3) + sizeof(glm::vec4) + sizeof(float);
+
+    SubmitMode submitMode;
+    GLuint vao = 0, vbo = 0, ebo = 0, instanceBuffer = 0, indirectBuffer = 0;
+
+    std::vector<float> meshVertices;
+    std::vector<std::uint32_t> meshIndices;
+    std::vector<BatchMesh> meshes;
+    InstanceTransforms instances;
+
+    std::vector<std::uint32_t> order;
+    std::vector<unsigned char> mask;
+    std::vector<std::uint32_t> chunkVisible;
+    std::vector<std::vector<DrawElementsIndirectCommand>> chunkCommands;
+    std::vector<glm::vec3> stagingPosition;
+    std::vector<glm::vec4> stagingRotation;
+    std::vector<float> stagingScale;
+    std::vector<DrawElementsIndirectCommand> commandList;
+    std::size_t visible = 0;
+    std::size_t instanceCapacity = 0;
+
+    bool meshesDirty = false;
+    bool orderDirty = false;
+    bool transformsDirty = false;
+    bool lastCulled = false;
+};
+
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace glutils {
+
+/**
+ * @brief 每帧临时数据用的线性分配器
+ *
+ * allocate 只移动一个偏移量，没有逐个释放；每帧开始调用 reset() 一次性作废上一帧的全部分配。
+ * 当前块用完时追加新块；reset() 时若用过多个块，就把它们合并成一个容量等于本帧总用量的块，
+ * 所以过了最初几帧之后（用量不再创新高），每帧不再有任何堆分配。
+ *
+ * 只适合析构函数平凡的类型：reset() 不会调用析构函数。不是线程安全的，多线程各用各的 arena。
+ */
+class FrameArena {
+public:
+    explicit FrameArena(std::size_t initialBytes = 1 << 20) {
+        if (initialBytes)
+            addBlock(initialBytes);
+    }
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+    FrameArena(FrameArena&&) = default;
+    FrameArena& operator=(FrameArena&&) = default;
+
+    // alignment 必须是 2 的幂
+    void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t)) {
+        if (!blocks.empty())
+            if (void* p = bump(blocks.back(), bytes, alignment))
+                return p;
+        // 新块至少是上一个块的两倍，避免用量缓慢增长时频繁追加小块
+        const std::size_t previous = blocks.empty() ? 0 : blocks.back().size;
+        return bump(addBlock(std::max(bytes + alignment, previous * 2)), bytes, alignment);
+    }
+
+    // count 个未初始化的 T
+    template<typename T>
+    std::span<T> allocateArray(std::size_t count) {
+        static_assert(std::is_trivially_destructible_v<T>, "FrameArena 不调用析构函数");
+        return { static_cast<T*>(allocate(count * sizeof(T), alignof(T))), count };
+    }
+
+    template<typename T, typename... Args>
+    T* create(Args&&... args) {
+        static_assert(std::is_trivially_destructible_v<T>, "FrameArena 不调用析构函数");
+        return ::new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    // 作废本帧的全部分配；用过多个块时合并成一个
+    void reset() {
+        highWater = std::max(highWater, frameBytes);
+        if (blocks.size() > 1) {
+            std::size_t total = 0;
+            for (const Block& block : blocks)
+                total += block.size;
+            blocks.clear();
+            addBlock(total);
+        }
+        if (!blocks.empty())
+            blocks.back().used = 0;
+        frameBytes = 0;
+    }
+
+    // 本帧已分配的字节数（不含对齐填充）
+    std::size_t used() const { return frameBytes; }
+    // 历次 reset() 前单帧用量的最大值
+    std::size_t peak() const { return std::max(highWater, frameBytes); }
+    std::size_t capacity() const {
+        std::size_t total = 0;
+        for (const Block& block : blocks)
+            total += block.size;
+        return total;
+    }
+    // 向系统申请块的次数，稳定后不再增长
+    std::size_t blockAllocations() const { return allocations; }
+
+private:
+    struct Block {
+        std::unique_ptr<std::byte[]> data;
+        std::size_t size = 0;
+        std::size_t used = 0;
+    };
+
+    // 在块内按地址对齐分配，放不下时返回 nullptr
+    void* bump(Block& block, std::size_t bytes, std::size_t alignment) {
+        const auto base = reinterpret_cast<std::uintptr_t>(block.data.get());
+        const std::size_t start = ((base + block.used + alignment - 1) & ~(alignment - 1)) - base;
+        if (start + bytes > block.size)
+            return nullptr;
+        block.used = start + bytes;
+        frameBytes += bytes;
+        return block.data.get() + start;
+    }
+
+    Block& addBlock(std::size_t bytes) {
+        Block block;
+        block.data = std::make_unique_for_overwrite<std::byte[]>(bytes);
+        block.size = bytes;
+        ++allocations;
+        blocks.push_back(std::move(block));
+        return blocks.back();
+    }
+
+    std::vector<Block> blocks;
+    std::size_t frameBytes = 0;
+    std::size_t highWater = 0;
+    std::size_t allocations = 0;
+};
+
+/**
+ * @brief 从 FrameArena 分配的标准库分配器，deallocate 什么也不做
+ *
+ * 容器必须在 arena reset() 之前销毁或不再使用；扩容时旧存储直到 reset() 才回收，最好先 reserve。
+ */
+template<typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    ArenaAllocator(FrameArena& arena) : arena(&arena) {}
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(std::size_t count) { return static_cast<T*>(arena->allocate(count * sizeof(T), alignof(T))); }
+    void deallocate(T*, std::size_t) {}
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+
+private:
+    template<typename U>
+    friend class ArenaAllocator;
+
+    FrameArena* arena;
+};
+
+// 元素存放在 FrameArena 里的 vector：FrameVector<int> v(arena); v.reserve(n);
+template<typename T>
+using FrameVector = std::vector<T, ArenaAllocator<T>>;
+
+}
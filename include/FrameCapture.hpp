@@ -0,0 +1,326 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <glad/glad.h>
+
+#include "GLHandles.hpp"
+#include "GLState.hpp"
+#include "ImageIO.hpp"
+#include "Profiler.hpp"
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+namespace glutils {
+
+enum class CaptureFormat {
+    // 每帧一个文件
+    PNG,
+    PPM,
+    // 所有帧连续写进一个 I420 原始视频文件（或标准输出），可以直接交给 ffmpeg
+    YUV,
+};
+
+struct FrameCaptureOptions {
+    CaptureFormat format = CaptureFormat::PNG;
+    // PNG / PPM：输出目录，文件名为 prefix + 6 位帧号；YUV：输出文件，"-" 表示标准输出
+    std::filesystem::path output = "capture";
+    std::string prefix = "frame_";
+    // 像素缓冲（PBO）个数：同时在 GPU 读回或在编码线程里的帧数上限
+    std::size_t ringSize = 4;
+    // 没有空闲 PBO 时丢弃这一帧而不是等待：交互时保证帧率；生成参考图等不能丢帧的场合设为 false
+    bool dropWhenBusy = true;
+};
+
+struct FrameCaptureStats {
+    std::size_t captured = 0;
+    std::size_t dropped = 0;
+    std::size_t encoded = 0;
+    std::size_t failed = 0;
+    // capture() 在 GL 线程上等待空闲 PBO 的总时间
+    double stallMs = 0.0;
+};
+
+/**
+ * @brief 异步帧捕获：PBO 环形缓冲读回 + 后台编码线程
+ *
+ * capture() 只发出 glReadPixels 到一个 PBO 并插入栅栏，立即返回；之后每次 capture() / poll()
+ * 检查栅栏，已完成的 PBO 被映射后把指针直接交给编码线程（不做额外拷贝），编码线程写完文件后
+ * 再由 GL 线程取消映射、放回环中。GL 线程从不等待 GPU，除非环已满且 dropWhenBusy 为 false。
+ *
+ * 用法（capture / poll / finish 必须在 GL 线程调用，对象必须在 GL 上下文销毁前析构）：
+ *
+ *     FrameCapture capture(width, height, { .format = CaptureFormat::YUV, .output = "out.yuv" });
+ *     // 每帧画完、交换缓冲之前：
+ *     capture.capture(frame);
+ *     // 结束时（析构函数也会做）：
+ *     capture.finish();
+ *
+ * YUV 输出可以这样编码：ffmpeg -f rawvideo -pix_fmt yuv420p -s WxH -r 60 -i out.yuv out.mp4，
+ * 输出为 "-" 时可以直接用管道：Example | ffmpeg -f rawvideo ... -i - out.mp4。
+ */
+class FrameCapture {
+public:
+    FrameCapture(int width, int height, FrameCaptureOptions options = {})
+        : width(width), height(height), options(std::move(options)) {
+        const std::size_t bytes = static_cast<std::size_t>(width) * height * 4;
+        slots.resize(std::max<std::size_t>(this->options.ringSize, 1));
+        for (Slot& slot : slots) {
+            slot.buffer = BufferHandle::create();
+            glState().bindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer.get());
+            glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(bytes), nullptr, GL_STREAM_READ);
+        }
+        glState().bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        if (this->options.format == CaptureFormat::YUV) {
+            if (this->options.output == "-") {
+#ifdef _WIN32
+                _setmode(_fileno(stdout), _O_BINARY);
+#endif
+                stream = stdout;
+            } else {
+                if (this->options.output.has_parent_path())
+                    std::filesystem::create_directories(this->options.output.parent_path());
+                stream = std::fopen(this->options.output.string().c_str(), "wb");
+                if (!stream)
+                    std::cerr << "无法创建捕获文件: " << this->options.output.string() << std::endl;
+            }
+        } else {
+            std::error_code ec;
+            std::filesystem::create_directories(this->options.output, ec);
+        }
+        encoder = std::thread([this] { encoderLoop(); });
+    }
+
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    ~FrameCapture() {
+        finish();
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        encoder.join();
+        if (stream && stream != stdout)
+            std::fclose(stream);
+        else if (stream)
+            std::fflush(stream);
+    }
+
+    /**
+     * @brief 异步读取 framebuffer 的颜色缓冲作为第 frame 帧
+     *
+     * @param readBuffer 不为 GL_NONE 时先调用 glReadBuffer；默认帧缓冲在交换之后读取时传 GL_FRONT
+     * @return false 表示没有空闲 PBO，这一帧被丢弃
+     */
+    bool capture(long long frame, GLuint framebuffer = 0, GLenum readBuffer = GL_NONE) {
+        GLUTILS_PROFILE_ZONE("FrameCapture::capture");
+        poll();
+        Slot* slot = freeSlot();
+        if (!slot) {
+            if (options.dropWhenBusy) {
+                ++counters.dropped;
+                return false;
+            }
+            const auto start = std::chrono::steady_clock::now();
+            while (!(slot = freeSlot()))
+                waitForProgress();
+            counters.stallMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        glState().bindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+        if (readBuffer != GL_NONE)
+            glReadBuffer(readBuffer);
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        glState().bindBuffer(GL_PIXEL_PACK_BUFFER, slot->buffer.get());
+        // 目标是 PBO 时 glReadPixels 只是排进命令队列，不会等待 GPU
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glState().bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        if (framebuffer == 0 && readBuffer != GL_NONE && readBuffer != GL_BACK)
+            glReadBuffer(GL_BACK);
+        slot->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        slot->frame = frame;
+        slot->state = SlotState::Reading;
+        reading.push_back(static_cast<std::size_t>(slot - slots.data()));
+        ++counters.captured;
+        return true;
+    }
+
+    /**
+     * @brief 把已读回的帧交给编码线程，回收编码完成的 PBO；不阻塞
+     *
+     * capture() 会自动调用；不是每帧都捕获时，建议每帧调用一次，及时释放 PBO。
+     */
+    void poll() {
+        // 按捕获顺序交接，YUV 流里的帧顺序与捕获顺序一致
+        while (!reading.empty()) {
+            Slot& slot = slots[reading.front()];
+            const GLenum status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+            if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+                break;
+            handOff(slot);
+            reading.pop_front();
+        }
+        for (Slot& slot : slots) {
+            if (slot.state == SlotState::Encoding && slot.encoded.load(std::memory_order_acquire)) {
+                glState().bindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer.get());
+                glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+                glState().bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+                slot.state = SlotState::Free;
+            }
+        }
+    }
+
+    // 等待所有已捕获的帧读回并编码完成
+    void finish() {
+        GLUTILS_PROFILE_ZONE("FrameCapture::finish");
+        poll();
+        while (std::any_of(slots.begin(), slots.end(), [](const Slot& slot) { return slot.state != SlotState::Free; }))
+            waitForProgress();
+        if (stream)
+            std::fflush(stream);
+    }
+
+    // 编码线程更新的计数在 finish() 之后才完整
+    FrameCaptureStats stats() const {
+        FrameCaptureStats result = counters;
+        result.encoded = encodedFrames.load(std::memory_order_relaxed);
+        result.failed = failedFrames.load(std::memory_order_relaxed);
+        return result;
+    }
+
+    int frameWidth() const { return width; }
+    int frameHeight() const { return height; }
+
+private:
+    enum class SlotState { Free, Reading, Encoding };
+
+    struct Slot {
+        BufferHandle buffer;
+        GLsync fence = nullptr;
+        long long frame = 0;
+        SlotState state = SlotState::Free;
+        const void* mapped = nullptr;
+        std::atomic<bool> encoded{ false };
+
+        Slot() = default;
+        // vector::resize 需要，只在构造时（环为空）发生
+        Slot(Slot&& other) noexcept : buffer(std::move(other.buffer)) {}
+    };
+
+    Slot* freeSlot() {
+        for (Slot& slot : slots)
+            if (slot.state == SlotState::Free)
+                return &slot;
+        return nullptr;
+    }
+
+    void handOff(Slot& slot) {
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+        glState().bindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer.get());
+        slot.mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(width) * height * 4, GL_MAP_READ_BIT);
+        glState().bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        slot.encoded.store(false, std::memory_order_relaxed);
+        slot.state = SlotState::Encoding;
+        {
+            std::lock_guard lock(mutex);
+            queue.push_back(&slot);
+        }
+        wake.notify_one();
+    }
+
+    // 阻塞到至少有一个 PBO 前进一步：最早的读回完成，或者编码线程完成一帧
+    void waitForProgress() {
+        if (!reading.empty()) {
+            glClientWaitSync(slots[reading.front()].fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000'000);
+        } else {
+            std::unique_lock lock(mutex);
+            done.wait_for(lock, std::chrono::milliseconds(10), [&] {
+                return std::any_of(slots.begin(), slots.end(), [](const Slot& slot) {
+                    return slot.state == SlotState::Encoding && slot.encoded.load(std::memory_order_acquire);
+                });
+            });
+        }
+        poll();
+    }
+
+    void encoderLoop() {
+        std::vector<std::uint8_t> yuv;
+        while (true) {
+            Slot* slot;
+            {
+                std::unique_lock lock(mutex);
+                wake.wait(lock, [&] { return stopping || !queue.empty(); });
+                if (queue.empty())
+                    return;
+                slot = queue.front();
+                queue.pop_front();
+            }
+            bool ok = slot->mapped != nullptr;
+            if (ok) {
+                GLUTILS_PROFILE_ZONE("FrameCapture::encode");
+                const ImageView image = flippedImage(slot->mapped, width, height);
+                ok = encode(image, slot->frame, yuv);
+            }
+            (ok ? encodedFrames : failedFrames).fetch_add(1, std::memory_order_relaxed);
+            {
+                std::lock_guard lock(mutex);
+                slot->encoded.store(true, std::memory_order_release);
+            }
+            done.notify_all();
+        }
+    }
+
+    bool encode(const ImageView& image, long long frame, std::vector<std::uint8_t>& yuv) {
+        if (options.format == CaptureFormat::YUV) {
+            if (!stream)
+                return false;
+            convertToI420(image, yuv);
+            return std::fwrite(yuv.data(), 1, yuv.size(), stream) == yuv.size();
+        }
+        char number[32];
+        std::snprintf(number, sizeof(number), "%06lld", frame);
+        const bool png = options.format == CaptureFormat::PNG;
+        const std::filesystem::path path = options.output / (options.prefix + number + (png ? ".png" : ".ppm"));
+        return png ? writePNG(path, image) : writePPM(path, image);
+    }
+
+    int width;
+    int height;
+    FrameCaptureOptions options;
+    std::vector<Slot> slots;
+    // 等待读回完成的槽位，按捕获顺序
+    std::deque<std::size_t> reading;
+    FrameCaptureStats counters;
+    std::atomic<std::size_t> encodedFrames{ 0 };
+    std::atomic<std::size_t> failedFrames{ 0 };
+    std::FILE* stream = nullptr;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    std::deque<Slot*> queue;
+    bool stopping = false;
+    std::thread encoder;
+};
+
+}
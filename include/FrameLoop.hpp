@@ -0,0 +1,325 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "BenchUtils.hpp"
+#include "FrameCapture.hpp"
+#include "GLHandles.hpp"
+#include "GLUtils.hpp"
+#include "Profiler.hpp"
+
+namespace glutils {
+
+namespace detail {
+
+// 已排序样本的线性插值分位数，p ∈ [0, 1]
+inline double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty())
+        return 0.0;
+    const double position = p * double(sorted.size() - 1);
+    const std::size_t lower = static_cast<std::size_t>(position);
+    const std::size_t upper = std::min(lower + 1, sorted.size() - 1);
+    return sorted[lower] + (sorted[upper] - sorted[lower]) * (position - double(lower));
+}
+
+inline std::size_t envCount(const char* name, std::size_t fallback) {
+    const char* value = std::getenv(name);
+    return value && *value ? std::strtoull(value, nullptr, 10) : fallback;
+}
+
+}
+
+/**
+ * @brief 帧时间样本的统计摘要（毫秒）
+ *
+ * @return {"mean", "min", "p50", "p90", "p95", "p99", "max"}
+ */
+inline nlohmann::json summarizeFrameTimes(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    double sum = 0.0;
+    for (double v : samples)
+        sum += v;
+    return {
+        { "mean", samples.empty() ? 0.0 : sum / double(samples.size()) },
+        { "min", samples.empty() ? 0.0 : samples.front() },
+        { "p50", detail::percentile(samples, 0.50) },
+        { "p90", detail::percentile(samples, 0.90) },
+        { "p95", detail::percentile(samples, 0.95) },
+        { "p99", detail::percentile(samples, 0.99) },
+        { "max", samples.empty() ? 0.0 : samples.back() },
+    };
+}
+
+/**
+ * @brief 示例程序的主循环，同时充当帧时间基准
+ *
+ * 用 while (loop.next()) 代替 while (!glfwWindowShouldClose(window))，用 loop.time() 代替 glfwGetTime()，
+ * 用 loop.present() 代替 glfwSwapBuffers(window)。
+ * 平时行为不变；设置环境变量 GLUTILS_BENCH_FRAMES=N 后进入基准模式：
+ * - 关闭垂直同步，时间按固定步长 1/60 s 推进，画面只取决于帧号，结果可复现；
+ * - 先跑 GLUTILS_BENCH_WARMUP 帧（默认 10）预热，再统计 N 帧的 CPU 帧时间和 GL_TIME_ELAPSED 测得的 GPU 时间；
+ * - 结束后把 JSON 报告写到 GLUTILS_BENCH_OUTPUT 指定的文件，未指定时打印到标准输出。
+ *
+ * 每帧结束时调用 glObjects().endFrame() 和 GLUTILS_PROFILE_FRAME()；设置 GLUTILS_TRACE_OUTPUT 时，循环结束后导出 Chrome trace。
+ *
+ * 设置 GLUTILS_CAPTURE=<路径> 时用 FrameCapture 异步捕获每一帧：PNG / PPM 序列写到该目录，
+ * 路径以 .yuv 结尾或为 "-" 时写 I420 原始视频；GLUTILS_CAPTURE_FORMAT=png|ppm|yuv 可显式指定格式。
+ * 输出为 "-" 时标准输出只留给视频流：std::cout 被重定向到 std::cerr，基准报告也写到 std::cerr。
+ * 基准模式下不丢帧，例如生成无窗口回归测试的参考图：
+ *     GLUTILS_HEADLESS=1 GLUTILS_BENCH_FRAMES=1 GLUTILS_BENCH_WARMUP=0 GLUTILS_CAPTURE=golden/ExportableCube ExportableCube
+ * 捕获在 present() 里、交换缓冲之前进行：有窗口时读取后缓冲，无窗口时读取离屏帧缓冲。
+ * 交换之后前缓冲的内容在合成器和 EGL 下不可靠（往往根本没有可读的前缓冲），所以不在交换之后读取。
+ *
+ * GPU 查询使用环形缓冲，读取几帧之前的结果，不会让 CPU 等待 GPU。
+ * 持有查询对象和 FrameCapture（PBO、fence、编码线程），必须在 glfwTerminate 之前析构或调用 finish()。
+ */
+class FrameLoop {
+public:
+    static constexpr double kFixedTimestep = 1.0 / 60.0;
+
+    FrameLoop(GLFWwindow* window, std::string name) : window(window), name(std::move(name)) {
+        benchFrames = detail::envCount("GLUTILS_BENCH_FRAMES", 0);
+        warmupFrames = benchFrames ? detail::envCount("GLUTILS_BENCH_WARMUP", 10) : 0;
+        if (const char* output = std::getenv("GLUTILS_BENCH_OUTPUT"))
+            outputPath = output;
+        if (const char* trace = std::getenv("GLUTILS_TRACE_OUTPUT"))
+            tracePath = trace;
+        if (benchFrames) {
+            glfwSwapInterval(0);
+            glGenQueries(static_cast<GLsizei>(queries.size()), queries.data());
+        }
+        if (const char* path = std::getenv("GLUTILS_CAPTURE"); path && *path)
+            startCapture(path);
+    }
+
+    ~FrameLoop() { finish(); }
+
+    FrameLoop(const FrameLoop&) = delete;
+    FrameLoop& operator=(const FrameLoop&) = delete;
+
+    /**
+     * @brief 结束上一帧并开始新的一帧
+     *
+     * @return false 表示应退出循环（窗口关闭或基准帧数已满）
+     */
+    bool next() {
+        if (frameIndex >= 0)
+            endFrame();
+        if (benchFrames ? recordedFrames() >= warmupFrames + benchFrames : glfwWindowShouldClose(window)) {
+            finish();
+            return false;
+        }
+        ++frameIndex;
+        const double now = glfwGetTime();
+        delta = frameIndex == 0 ? 0.0 : now - lastTime;
+        lastTime = now;
+        frameTimer.reset();
+        if (benchFrames) {
+            // 该槽位的旧查询必须先取回，环形缓冲足够长时这里不会阻塞
+            collect(slot(frameIndex));
+            glBeginQuery(GL_TIME_ELAPSED, queries[slot(frameIndex)]);
+            queryFrame[slot(frameIndex)] = frameIndex;
+        }
+        frameOpen = true;
+        return true;
+    }
+
+    // 捕获当前帧（设置了 GLUTILS_CAPTURE 时）并交换缓冲；代替 glfwSwapBuffers，每帧调用一次
+    void present() {
+        if (capture) {
+            const GLuint framebuffer = offscreenFramebuffer();
+            capture->capture(frameIndex, framebuffer, framebuffer ? GL_COLOR_ATTACHMENT0 : GL_BACK);
+            captured = true;
+        }
+        glfwSwapBuffers(window);
+    }
+
+    // 当前帧的动画时间（秒）：基准模式下为帧号 × 固定步长
+    double time() const { return benchFrames ? double(frameIndex) * kFixedTimestep : glfwGetTime(); }
+
+    // 与上一帧的间隔（秒）：基准模式下为固定步长
+    float deltaTime() const { return float(benchFrames ? kFixedTimestep : delta); }
+
+    long long frame() const { return frameIndex; }
+
+    bool benchmarking() const { return benchFrames != 0; }
+
+    /**
+     * @brief 结束捕获和基准：等待编码线程、释放 PBO 和查询，输出报告
+     *
+     * next() 返回 false 时已自动调用，重复调用无效；break 或提前 return 离开循环时由析构函数调用。
+     */
+    void finish() {
+        if (finished)
+            return;
+        finished = true;
+        if (capture) {
+            // 必须在 GL 上下文销毁之前释放 PBO
+            capture->finish();
+            const FrameCaptureStats stats = capture->stats();
+            std::cerr << "Captured " << stats.encoded << " frames (" << stats.dropped << " dropped, " << stats.failed << " failed)" << std::endl;
+            capture.reset();
+        }
+#if GLUTILS_PROFILING
+        if (!tracePath.empty())
+            Profiler::instance().writeChromeTrace(tracePath);
+#endif
+        if (!benchFrames)
+            return;
+        if (std::exchange(frameOpen, false)) {
+            // 循环中途退出：结束这一帧的查询，不计入统计
+            glEndQuery(GL_TIME_ELAPSED);
+            queryFrame[slot(frameIndex)] = -1;
+        }
+        for (std::size_t i = 0; i < kQueryRing; ++i)
+            collect(i);
+        glDeleteQueries(static_cast<GLsizei>(queries.size()), queries.data());
+
+        const std::string text = report().dump(2);
+        if (outputPath.empty()) {
+            (captureToStdout ? std::cerr : std::cout) << text << std::endl;
+        } else {
+            std::ofstream file(outputPath, std::ios::trunc);
+            if (!file.is_open()) {
+                std::cerr << "Failed to write benchmark report: " << outputPath << std::endl;
+                return;
+            }
+            file << text << std::endl;
+        }
+    }
+
+    // 基准报告；GPU 时间不可用时 gpu_ms 为 null
+    nlohmann::json report() const {
+        int width = 0, height = 0;
+        glfwGetFramebufferSize(window, &width, &height);
+        auto str = [](GLenum what) {
+            const GLubyte* value = glGetString(what);
+            return value ? std::string(reinterpret_cast<const char*>(value)) : std::string();
+        };
+        return {
+            { "name", name },
+            { "frames", cpuMs.size() },
+            { "warmup", warmupFrames },
+            { "timestep", kFixedTimestep },
+            { "width", width },
+            { "height", height },
+            { "headless", isHeadless() },
+            { "renderer", str(GL_RENDERER) },
+            { "version", str(GL_VERSION) },
+            { "cpu_ms", summarizeFrameTimes(cpuMs) },
+            { "gpu_ms", gpuMs.empty() ? nlohmann::json() : summarizeFrameTimes(gpuMs) },
+#if GLUTILS_PROFILING
+            { "per_frame", {
+                { "draw_calls", cpuMs.empty() ? 0.0 : double(counterSums.drawCalls) / double(cpuMs.size()) },
+                { "state_changes", cpuMs.empty() ? 0.0 : double(counterSums.stateChanges) / double(cpuMs.size()) },
+                { "upload_bytes", cpuMs.empty() ? 0.0 : double(counterSums.uploadBytes) / double(cpuMs.size()) },
+            } },
+#endif
+        };
+    }
+
+private:
+    static constexpr std::size_t kQueryRing = 4;
+
+    static std::size_t slot(long long frame) { return static_cast<std::size_t>(frame) % kQueryRing; }
+
+    std::size_t recordedFrames() const { return static_cast<std::size_t>(frameIndex + 1); }
+
+    void endFrame() {
+        frameOpen = false;
+        if (capture && !std::exchange(captured, false)) {
+            // 调用者自己交换了缓冲：离屏帧缓冲不受交换影响，仍可读取；窗口的后缓冲在交换后内容未定义，只能跳过
+            if (const GLuint framebuffer = offscreenFramebuffer()) {
+                capture->capture(frameIndex, framebuffer, GL_COLOR_ATTACHMENT0);
+            } else if (!warnedUncaptured) {
+                std::cerr << "GLUTILS_CAPTURE: 有窗口时需要用 FrameLoop::present() 代替 glfwSwapBuffers，未捕获的帧被跳过" << std::endl;
+                warnedUncaptured = true;
+            }
+        }
+        glObjects().endFrame();
+        GLUTILS_PROFILE_FRAME();
+        if (!benchFrames)
+            return;
+        glEndQuery(GL_TIME_ELAPSED);
+        // present() 在 next() 之前调用，CPU 帧时间包含交换缓冲
+        if (static_cast<std::size_t>(frameIndex) >= warmupFrames) {
+            cpuMs.push_back(frameTimer.milliseconds());
+#if GLUTILS_PROFILING
+            const FrameCounters& counters = Profiler::instance().lastFrame();
+            counterSums.drawCalls += counters.drawCalls;
+            counterSums.stateChanges += counters.stateChanges;
+            counterSums.uploadBytes += counters.uploadBytes;
+#endif
+        }
+    }
+
+    // 取回某个槽位的查询结果
+    void collect(std::size_t index) {
+        if (queryFrame[index] < 0)
+            return;
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(queries[index], GL_QUERY_RESULT, &elapsed);
+        if (static_cast<std::size_t>(queryFrame[index]) >= warmupFrames)
+            gpuMs.push_back(double(elapsed) / 1.0e6);
+        queryFrame[index] = -1;
+    }
+
+    void startCapture(const std::string& path) {
+        FrameCaptureOptions options;
+        options.output = path;
+        const char* format = std::getenv("GLUTILS_CAPTURE_FORMAT");
+        const std::string formatName = format ? format : "";
+        if (formatName == "yuv" || (formatName.empty() && (path == "-" || options.output.extension() == ".yuv")))
+            options.format = CaptureFormat::YUV;
+        else if (formatName == "ppm")
+            options.format = CaptureFormat::PPM;
+        options.dropWhenBusy = benchFrames == 0;
+        if (options.format == CaptureFormat::YUV && path == "-") {
+            // 视频帧直接写 stdout，示例里的 std::cout 文字混进去会破坏码流；在写出第一帧之前改道
+            std::cout.flush();
+            std::cout.rdbuf(std::cerr.rdbuf());
+            captureToStdout = true;
+        }
+        int width = 0, height = 0;
+        glfwGetFramebufferSize(window, &width, &height);
+        capture = std::make_unique<FrameCapture>(width, height, std::move(options));
+    }
+
+    GLFWwindow* window;
+    std::string name;
+    std::string outputPath;
+    std::string tracePath;
+    std::size_t benchFrames = 0;
+    std::size_t warmupFrames = 0;
+    long long frameIndex = -1;
+    double lastTime = 0.0;
+    double delta = 0.0;
+    bool finished = false;
+    // next() 已开始、endFrame() 尚未结束的帧
+    bool frameOpen = false;
+    // 本帧已在 present() 中捕获
+    bool captured = false;
+    bool warnedUncaptured = false;
+    // 捕获输出为 "-"：标准输出被视频流占用
+    bool captureToStdout = false;
+    Stopwatch frameTimer;
+    std::unique_ptr<FrameCapture> capture;
+
+    std::array<GLuint, kQueryRing> queries{};
+    std::array<long long, kQueryRing> queryFrame{ -1, -1, -1, -1 };
+    std::vector<double> cpuMs;
+    std::vector<double> gpuMs;
+    FrameCounters counterSums;
+};
+
+}
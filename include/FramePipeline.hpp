@@ -0,0 +1,196 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <utility>
+
+#include "BenchUtils.hpp"
+#include "JobSystem.hpp"
+#include "Profiler.hpp"
+
+namespace glutils {
+
+/**
+ * @brief 单生产者单消费者的无锁环形队列
+ *
+ * 只用两个原子下标，不加锁；pop / push 在队列空 / 满时用 C++20 原子等待休眠，而不是忙等。
+ */
+template<typename T, std::size_t Capacity>
+class SpscQueue {
+public:
+    bool tryPush(T value) {
+        const std::size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == Capacity)
+            return false;
+        items[t % Capacity] = std::move(value);
+        tail.store(t + 1, std::memory_order_release);
+        tail.notify_one();
+        return true;
+    }
+
+    bool tryPop(T& value) {
+        const std::size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire))
+            return false;
+        value = std::move(items[h % Capacity]);
+        head.store(h + 1, std::memory_order_release);
+        head.notify_one();
+        return true;
+    }
+
+    void push(T value) {
+        while (true) {
+            const std::size_t h = head.load(std::memory_order_acquire);
+            if (tail.load(std::memory_order_relaxed) - h < Capacity)
+                break;
+            head.wait(h, std::memory_order_acquire);
+        }
+        tryPush(std::move(value));
+    }
+
+    T pop() {
+        while (true) {
+            const std::size_t t = tail.load(std::memory_order_acquire);
+            if (head.load(std::memory_order_relaxed) != t)
+                break;
+            tail.wait(t, std::memory_order_acquire);
+        }
+        T value;
+        tryPop(value);
+        return value;
+    }
+
+private:
+    std::array<T, Capacity> items{};
+    alignas(64) std::atomic<std::size_t> head{ 0 };
+    alignas(64) std::atomic<std::size_t> tail{ 0 };
+};
+
+// 流水线统计（毫秒，累计值）
+struct FramePipelineStats {
+    std::size_t frames = 0;
+    // 模拟线程计算各帧的总耗时
+    double simulateMs = 0.0;
+    // 渲染线程在 acquire() 中等待模拟结果的总耗时，越接近 0 说明 CPU 工作越完整地藏在了渲染后面
+    double renderWaitMs = 0.0;
+};
+
+/**
+ * @brief 把每帧的 CPU 工作（剔除、变换、命令生成）和渲染提交拆到两个线程上的帧流水线
+ *
+ * 渲染线程（持有 GL 上下文、处理窗口事件的线程）每帧：
+ *     pipeline.submit(input);          // 第 N + 1 帧的输入快照（相机、时间等），模拟线程立即开始计算
+ *     Frame& frame = pipeline.acquire(); // 第 N 帧的结果，通常早已算好
+ *     ...只根据 frame 上传和绘制...
+ *     pipeline.release();
+ * 启动时先多 submit 一次，让流水线里始终有一帧在计算。
+ *
+ * 帧数据双缓冲：模拟线程写一个槽位的同时渲染线程读另一个，槽位下标通过 SpscQueue 传递，
+ * 两个线程从不同时访问同一个 Frame，Frame 本身不需要任何同步。
+ * simulate(input, frame, jobs) 在模拟线程上调用，内部可以用 jobs.parallelFor 把工作分给所有核心；
+ * 它只能读 input 和只读的共享数据（场景、八叉树等），不能调用 GL，也不能读被回调修改的全局变量。
+ */
+template<typename Input, typename Frame>
+class FramePipeline {
+public:
+    static constexpr std::size_t kFrames = 2;
+
+    using SimulateFn = std::function<void(const Input&, Frame&, JobSystem&)>;
+
+    explicit FramePipeline(SimulateFn simulate, JobSystem& jobs = JobSystem::global())
+        : simulate(std::move(simulate)), jobs(jobs) {
+        for (std::size_t i = 0; i < kFrames; ++i)
+            freeSlots.tryPush(i);
+        worker = std::thread([this] { simulationLoop(); });
+    }
+
+    ~FramePipeline() {
+        // 提交了却没有取走的帧占着槽位，模拟线程可能正等空闲槽位而不再取请求，
+        // 所以停止请求排进队列之前也要一边把就绪槽位还回去
+        auto recycle = [this] {
+            std::size_t slot;
+            if (!readySlots.tryPop(slot))
+                return false;
+            freeSlots.tryPush(slot);
+            return true;
+        };
+        while (!requests.tryPush(Request{ Input{}, true }))
+            if (!recycle())
+                std::this_thread::yield();
+        while (!finished.load(std::memory_order_acquire))
+            if (!recycle())
+                std::this_thread::yield();
+        worker.join();
+    }
+
+    FramePipeline(const FramePipeline&) = delete;
+    FramePipeline& operator=(const FramePipeline&) = delete;
+
+    // 渲染线程：提交下一帧的输入。流水线里已有 kFrames 帧未取走时阻塞
+    void submit(const Input& input) {
+        requests.push(Request{ input, false });
+    }
+
+    // 渲染线程：取得最早提交的一帧，尚未算完时等待
+    Frame& acquire() {
+        GLUTILS_PROFILE_ZONE("FramePipeline::acquire");
+        Stopwatch timer;
+        current = readySlots.pop();
+        counters.renderWaitMs += timer.milliseconds();
+        ++counters.frames;
+        return frames[current];
+    }
+
+    // 渲染线程：这一帧已经提交完毕（GL 命令已发出即可，不必等 GPU），槽位交还给模拟线程
+    void release() {
+        freeSlots.push(current);
+    }
+
+    // 渲染线程读取；simulateMs 由模拟线程写入，两者通过槽位队列同步，读到的是已完成帧的累计值
+    FramePipelineStats stats() const {
+        FramePipelineStats result = counters;
+        result.simulateMs = simulateMs.load(std::memory_order_acquire);
+        return result;
+    }
+
+private:
+    struct Request {
+        Input input;
+        bool stop = false;
+    };
+
+    void simulationLoop() {
+        while (true) {
+            Request request = requests.pop();
+            if (request.stop) {
+                finished.store(true, std::memory_order_release);
+                return;
+            }
+            const std::size_t slot = freeSlots.pop();
+            {
+                GLUTILS_PROFILE_ZONE("FramePipeline::simulate");
+                Stopwatch timer;
+                simulate(request.input, frames[slot], jobs);
+                simulateMs.store(simulateMs.load(std::memory_order_relaxed) + timer.milliseconds(), std::memory_order_release);
+            }
+            readySlots.push(slot);
+        }
+    }
+
+    SimulateFn simulate;
+    JobSystem& jobs;
+    std::array<Frame, kFrames> frames{};
+    SpscQueue<Request, kFrames> requests;
+    SpscQueue<std::size_t, kFrames> freeSlots;
+    SpscQueue<std::size_t, kFrames> readySlots;
+    std::size_t current = 0;
+    FramePipelineStats counters;
+    std::atomic<double> simulateMs{ 0.0 };
+    std::atomic<bool> finished{ false };
+    std::thread worker;
+};
+
+}
@@ -0,0 +1,251 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <utility>
+#include <vector>
+#include <glad/glad.h>
+
+#include "GLState.hpp"
+#include "Profiler.hpp"
+
+namespace glutils {
+
+enum class GLObjectType { Buffer, VertexArray, Program };
+
+// 对象池的累计统计
+struct GLObjectPoolStats {
+    // glGen* / glDelete* 的调用次数与涉及的对象数
+    std::size_t genCalls = 0;
+    std::size_t generated = 0;
+    std::size_t deleteCalls = 0;
+    std::size_t deleted = 0;
+    // 延迟删除的批次太多、不得不等待最旧一批的栅栏的次数
+    std::size_t stalls = 0;
+};
+
+/**
+ * @brief GL 对象的分配与延迟删除
+ *
+ * 缓冲和 VAO 的名字用 glGen*(kBatch, ...) 成批预取，之后逐个取出；程序只能逐个 glCreateProgram。
+ * 句柄析构时对象不立即删除，而是记入当前帧的待删列表；endFrame() 给这一帧的列表插入栅栏，
+ * 栅栏触发（GPU 执行完这一帧之前的所有命令）后再成批 glDelete*，删除不会与仍在使用它们的绘制竞争，
+ * 删除调用也从每个对象一次变成每帧每类一次。
+ *
+ * 与 glState() 一样只对持有上下文的线程有效。release() 不调用 GL，上下文销毁后析构的句柄也是安全的；
+ * 但上下文销毁前应调用 flush()，否则待删的对象随上下文一起释放（不会出错，只是统计不再准确）。
+ */
+class GLObjectPool {
+public:
+    static constexpr std::size_t kBatch = 32;
+    // 同时等待栅栏的帧数上限，超过时等待最旧的一帧
+    static constexpr std::size_t kMaxPendingFrames = 8;
+
+    GLObjectPool() {
+        for (auto& frame : pending)
+            for (auto& names : frame.names)
+                names.reserve(kBatch);
+    }
+
+    GLObjectPool(const GLObjectPool&) = delete;
+    GLObjectPool& operator=(const GLObjectPool&) = delete;
+
+    GLuint acquire(GLObjectType type) {
+        if (type == GLObjectType::Program)
+            return glCreateProgram();
+        std::vector<GLuint>& names = fresh[index(type)];
+        if (names.empty()) {
+            names.resize(kBatch);
+            if (type == GLObjectType::Buffer)
+                glGenBuffers(static_cast<GLsizei>(kBatch), names.data());
+            else
+                glGenVertexArrays(static_cast<GLsizei>(kBatch), names.data());
+            ++counters.genCalls;
+            counters.generated += kBatch;
+        }
+        const GLuint name = names.back();
+        names.pop_back();
+        return name;
+    }
+
+    // 记入当前帧的待删列表，不调用 GL
+    void release(GLObjectType type, GLuint name) {
+        if (name)
+            current().names[index(type)].push_back(name);
+    }
+
+    /**
+     * @brief 每帧在最后一条绘制命令之后调用一次（FrameLoop 会自动调用）
+     *
+     * 给本帧释放的对象插入栅栏，并删除栅栏已经触发的各帧的对象。
+     */
+    void endFrame() {
+        GLUTILS_PROFILE_ZONE("GLObjectPool::endFrame");
+        PendingFrame& frame = current();
+        if (!frame.empty()) {
+            if (count == kMaxPendingFrames - 1) {
+                // 最后一个槽位留给下一帧的待删列表，这里必须先腾出最旧的一帧
+                ++counters.stalls;
+                wait(pending[first]);
+                retire();
+            }
+            frame.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            ++count;
+        }
+        while (count > 0 && signaled(pending[first]))
+            retire();
+    }
+
+    // 立即删除所有待删对象和预取但未使用的名字；上下文销毁前调用
+    void flush() {
+        PendingFrame& frame = current();
+        if (!frame.empty()) {
+            frame.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            ++count;
+        }
+        // glDelete* 本身会等 GPU 用完再释放存储，这里不必等待栅栏
+        while (count > 0)
+            retire();
+        for (std::size_t type = 0; type < fresh.size(); ++type) {
+            deleteNames(static_cast<GLObjectType>(type), fresh[type]);
+            fresh[type].clear();
+        }
+    }
+
+    // 等待删除的对象数（不含当前帧尚未 endFrame 的）
+    std::size_t pendingObjects() const {
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < count; ++i)
+            for (const auto& names : pending[(first + i) % kMaxPendingFrames].names)
+                total += names.size();
+        return total;
+    }
+
+    const GLObjectPoolStats& stats() const { return counters; }
+
+private:
+    struct PendingFrame {
+        std::array<std::vector<GLuint>, 3> names;
+        GLsync fence = nullptr;
+
+        bool empty() const { return names[0].empty() && names[1].empty() && names[2].empty(); }
+    };
+
+    static std::size_t index(GLObjectType type) { return static_cast<std::size_t>(type); }
+
+    PendingFrame& current() { return pending[(first + count) % kMaxPendingFrames]; }
+
+    static bool signaled(const PendingFrame& frame) {
+        const GLenum result = glClientWaitSync(frame.fence, 0, 0);
+        return result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+    }
+
+    static void wait(const PendingFrame& frame) {
+        GLenum result;
+        do {
+            result = glClientWaitSync(frame.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+        } while (result == GL_TIMEOUT_EXPIRED);
+        if (result == GL_WAIT_FAILED)
+            std::cerr << "GLObjectPool: glClientWaitSync 失败" << std::endl;
+    }
+
+    // 删除最旧一帧的对象；列表只清空不释放，稳定后不再有堆分配
+    void retire() {
+        PendingFrame& frame = pending[first];
+        for (std::size_t type = 0; type < frame.names.size(); ++type) {
+            deleteNames(static_cast<GLObjectType>(type), frame.names[type]);
+            frame.names[type].clear();
+        }
+        glDeleteSync(frame.fence);
+        frame.fence = nullptr;
+        first = (first + 1) % kMaxPendingFrames;
+        --count;
+    }
+
+    void deleteNames(GLObjectType type, const std::vector<GLuint>& names) {
+        if (names.empty())
+            return;
+        const GLsizei n = static_cast<GLsizei>(names.size());
+        switch (type) {
+        case GLObjectType::Buffer:
+            glState().deleteBuffers(n, names.data());
+            break;
+        case GLObjectType::VertexArray:
+            glState().deleteVertexArrays(n, names.data());
+            break;
+        default:
+            // 程序没有批量删除接口
+            for (GLuint name : names)
+                glState().deleteProgram(name);
+            break;
+        }
+        ++counters.deleteCalls;
+        counters.deleted += names.size();
+    }
+
+    std::array<std::vector<GLuint>, 2> fresh;
+    std::array<PendingFrame, kMaxPendingFrames> pending;
+    // pending 中等待栅栏的帧：[first, first + count)，其后一个槽位收集当前帧
+    std::size_t first = 0;
+    std::size_t count = 0;
+    GLObjectPoolStats counters;
+};
+
+// 当前 GL 上下文（主线程）的对象池
+inline GLObjectPool& glObjects() {
+    static GLObjectPool pool;
+    return pool;
+}
+
+/**
+ * @brief 只能移动的 GL 对象句柄，析构时交给 glObjects() 延迟删除
+ *
+ *     auto vbo = BufferHandle::create();
+ *     glState().bindBuffer(GL_ARRAY_BUFFER, vbo.get());
+ */
+template<GLObjectType Type>
+class GLHandle {
+public:
+    GLHandle() = default;
+    // 接管一个已有的对象
+    explicit GLHandle(GLuint name) : name(name) {}
+
+    static GLHandle create() { return GLHandle(glObjects().acquire(Type)); }
+
+    GLHandle(const GLHandle&) = delete;
+    GLHandle& operator=(const GLHandle&) = delete;
+
+    GLHandle(GLHandle&& other) noexcept : name(std::exchange(other.name, 0)) {}
+    GLHandle& operator=(GLHandle&& other) noexcept {
+        if (this != &other)
+            reset(std::exchange(other.name, 0));
+        return *this;
+    }
+
+    ~GLHandle() { reset(); }
+
+    GLuint get() const { return name; }
+    explicit operator bool() const { return name != 0; }
+
+    // 释放当前对象（延迟删除）并接管 replacement
+    void reset(GLuint replacement = 0) {
+        if (name)
+            glObjects().release(Type, name);
+        name = replacement;
+    }
+
+    // 放弃所有权，返回名字，由调用者负责删除
+    GLuint detach() { return std::exchange(name, 0); }
+
+private:
+    GLuint name = 0;
+};
+
+using BufferHandle = GLHandle<GLObjectType::Buffer>;
+using VertexArrayHandle = GLHandle<GLObjectType::VertexArray>;
+// AsyncShader.hpp 的 ProgramHandle 是异步编译结果，与这里的所有权句柄无关
+using ShaderProgramHandle = GLHandle<GLObjectType::Program>;
+
+}
@@ -0,0 +1,418 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <glad/glad.h>
+
+#include "Profiler.hpp"
+
+// 定义为 1 时，每次因"状态未变"而跳过调用前都先用 glGet* 核对影子状态，失配时打印并照常发出调用
+#ifndef GLUTILS_STATE_VALIDATION
+#define GLUTILS_STATE_VALIDATION 0
+#endif
+
+namespace glutils {
+
+/**
+ * @brief GL 状态缓存
+ *
+ * 影子记录当前程序、VAO、各目标的缓冲、各纹理单元的纹理、帧缓冲和常用光栅化状态，
+ * 与影子相同的调用直接跳过，不进入驱动。初始时所有状态为"未知"，第一次调用总会发出。
+ *
+ * 只对持有上下文的线程有效；绕过缓存直接调用 glUseProgram / glBind* / glEnable 等之后，
+ * 必须调用 invalidate()，否则后续调用可能被错误地跳过。validate() 可随时核对影子与实际状态。
+ */
+class GLStateCache {
+public:
+    static constexpr std::size_t kTextureUnits = 32;
+
+    // 调用统计：发出的与被跳过的
+    struct Stats {
+        std::uint64_t issued = 0;
+        std::uint64_t skipped = 0;
+    };
+
+    void useProgram(GLuint program) {
+        if (!changed(program_, program, GL_CURRENT_PROGRAM))
+            return;
+        glUseProgram(program);
+    }
+
+    void bindVertexArray(GLuint vao) {
+        if (!changed(vertexArray, vao, GL_VERTEX_ARRAY_BINDING))
+            return;
+        glBindVertexArray(vao);
+        // GL_ELEMENT_ARRAY_BUFFER 属于 VAO 状态，切换 VAO 后不再可知
+        buffers[bufferSlot(GL_ELEMENT_ARRAY_BUFFER)] = kUnknown;
+    }
+
+    void bindBuffer(GLenum target, GLuint buffer) {
+        const std::size_t slot = bufferSlot(target);
+        if (slot == kNoSlot) {
+            issue();
+            glBindBuffer(target, buffer);
+            return;
+        }
+        if (!changed(buffers[slot], buffer, bufferBindingQuery(slot)))
+            return;
+        glBindBuffer(target, buffer);
+    }
+
+    // glBindBufferBase 同时修改通用绑定点，这里同步影子；索引绑定点本身不缓存
+    void bindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+        issue();
+        glBindBufferBase(target, index, buffer);
+        const std::size_t slot = bufferSlot(target);
+        if (slot != kNoSlot)
+            buffers[slot] = buffer;
+    }
+
+    void bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) {
+        issue();
+        glBindBufferRange(target, index, buffer, offset, size);
+        const std::size_t slot = bufferSlot(target);
+        if (slot != kNoSlot)
+            buffers[slot] = buffer;
+    }
+
+    void activeTexture(GLuint unit) {
+        if (unit >= kTextureUnits) {
+            issue();
+            glActiveTexture(GL_TEXTURE0 + unit);
+            activeUnit = kUnknown;
+            return;
+        }
+        if (!changed(activeUnit, unit, GL_ACTIVE_TEXTURE, GL_TEXTURE0))
+            return;
+        glActiveTexture(GL_TEXTURE0 + unit);
+    }
+
+    // 绑定到指定纹理单元（会在需要时切换活动单元）
+    void bindTexture(GLuint unit, GLenum target, GLuint texture) {
+        const std::size_t slot = textureSlot(target);
+        if (unit >= kTextureUnits || slot == kNoSlot) {
+            activeTexture(unit);
+            issue();
+            glBindTexture(target, texture);
+            return;
+        }
+        GLuint& shadow = textures[unit][slot];
+        if (shadow == texture && !desynced(shadow, [&] {
+                GLint active = 0, bound = 0;
+                glGetIntegerv(GL_ACTIVE_TEXTURE, &active);
+                glActiveTexture(GL_TEXTURE0 + unit);
+                glGetIntegerv(textureBindingQuery(slot), &bound);
+                glActiveTexture(static_cast<GLenum>(active));
+                return static_cast<GLuint>(bound);
+            }, "texture binding")) {
+            skip();
+            return;
+        }
+        activeTexture(unit);
+        issue();
+        glBindTexture(target, texture);
+        shadow = texture;
+    }
+
+    void bindFramebuffer(GLenum target, GLuint framebuffer) {
+        if (target == GL_FRAMEBUFFER) {
+            if (drawFramebuffer == framebuffer && readFramebuffer == framebuffer && !GLUTILS_STATE_VALIDATION) {
+                skip();
+                return;
+            }
+            issue();
+            glBindFramebuffer(target, framebuffer);
+            drawFramebuffer = readFramebuffer = framebuffer;
+            return;
+        }
+        GLuint& shadow = target == GL_READ_FRAMEBUFFER ? readFramebuffer : drawFramebuffer;
+        if (!changed(shadow, framebuffer, target == GL_READ_FRAMEBUFFER ? GL_READ_FRAMEBUFFER_BINDING : GL_DRAW_FRAMEBUFFER_BINDING))
+            return;
+        glBindFramebuffer(target, framebuffer);
+    }
+
+    // 开关某项能力；不在缓存范围内的能力直接透传
+    void setEnabled(GLenum capability, bool enabled) {
+        const std::size_t slot = capabilitySlot(capability);
+        if (slot == kNoSlot) {
+            issue();
+            enabled ? glEnable(capability) : glDisable(capability);
+            return;
+        }
+        const GLuint value = enabled ? 1u : 0u;
+        if (capabilities[slot] == value && !desynced(capabilities[slot], [&] { return static_cast<GLuint>(glIsEnabled(capability)); }, "capability")) {
+            skip();
+            return;
+        }
+        issue();
+        enabled ? glEnable(capability) : glDisable(capability);
+        capabilities[slot] = value;
+    }
+
+    void enable(GLenum capability) { setEnabled(capability, true); }
+    void disable(GLenum capability) { setEnabled(capability, false); }
+
+    // 核心模式下只能对 GL_FRONT_AND_BACK 设置
+    void polygonMode(GLenum mode) {
+        if (!changed(polygonMode_, mode, GL_POLYGON_MODE))
+            return;
+        glPolygonMode(GL_FRONT_AND_BACK, mode);
+    }
+
+    void depthFunc(GLenum func) {
+        if (!changed(depthFunc_, func, GL_DEPTH_FUNC))
+            return;
+        glDepthFunc(func);
+    }
+
+    void depthMask(bool write) {
+        if (!changed(depthMask_, write ? 1u : 0u, GL_DEPTH_WRITEMASK))
+            return;
+        glDepthMask(write ? GL_TRUE : GL_FALSE);
+    }
+
+    void cullFace(GLenum face) {
+        if (!changed(cullFace_, face, GL_CULL_FACE_MODE))
+            return;
+        glCullFace(face);
+    }
+
+    void blendFunc(GLenum source, GLenum destination) {
+        if (blendSource == source && blendDestination == destination && !GLUTILS_STATE_VALIDATION) {
+            skip();
+            return;
+        }
+        issue();
+        glBlendFunc(source, destination);
+        blendSource = source;
+        blendDestination = destination;
+    }
+
+    void viewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+        const std::array<GLint, 4> value{ x, y, width, height };
+        if (viewportKnown && viewport_ == value && !GLUTILS_STATE_VALIDATION) {
+            skip();
+            return;
+        }
+        issue();
+        glViewport(x, y, width, height);
+        viewport_ = value;
+        viewportKnown = true;
+    }
+
+    // 删除对象时同步影子：GL 会把当前上下文中绑定的被删对象解绑为 0
+    void deleteBuffer(GLuint buffer) {
+        for (auto& bound : buffers)
+            bound = bound == buffer ? 0 : bound;
+        glDeleteBuffers(1, &buffer);
+    }
+
+    void deleteVertexArray(GLuint vao) {
+        if (vertexArray == vao)
+            vertexArray = 0;
+        glDeleteVertexArrays(1, &vao);
+    }
+
+    // 批量删除，一次驱动调用
+    void deleteBuffers(GLsizei count, const GLuint* names) {
+        for (auto& bound : buffers)
+            if (std::find(names, names + count, bound) != names + count)
+                bound = 0;
+        glDeleteBuffers(count, names);
+    }
+
+    void deleteVertexArrays(GLsizei count, const GLuint* names) {
+        if (std::find(names, names + count, vertexArray) != names + count)
+            vertexArray = 0;
+        glDeleteVertexArrays(count, names);
+    }
+
+    void deleteTexture(GLuint texture) {
+        for (auto& unit : textures)
+            for (auto& bound : unit)
+                bound = bound == texture ? 0 : bound;
+        glDeleteTextures(1, &texture);
+    }
+
+    // 正在使用的程序删除后仍保持绑定，直到切换到别的程序，所以这里不改影子
+    void deleteProgram(GLuint program) { glDeleteProgram(program); }
+
+    // 放弃所有影子状态，之后的每类调用第一次都会发出
+    void invalidate() {
+        const Stats kept = statistics;
+        *this = GLStateCache();
+        statistics = kept;
+    }
+
+    /**
+     * @brief 用 glGet* 核对所有已知的影子状态
+     *
+     * @return 全部一致时返回 true；失配项打印到 std::cerr
+     */
+    bool validate() const {
+        bool ok = true;
+        auto check = [&](const char* what, GLuint shadow, GLuint actual) {
+            if (shadow == kUnknown || shadow == actual)
+                return;
+            std::cerr << "GLStateCache desync: " << what << " shadow=" << shadow << " actual=" << actual << std::endl;
+            ok = false;
+        };
+        check("program", program_, queryInt(GL_CURRENT_PROGRAM));
+        check("vertex array", vertexArray, queryInt(GL_VERTEX_ARRAY_BINDING));
+        // 影子未知的槽位不查询：3.3 核心上下文里间接绘制 / SSBO 的绑定枚举会产生 GL_INVALID_ENUM
+        for (std::size_t slot = 0; slot < buffers.size(); ++slot)
+            if (buffers[slot] != kUnknown)
+                check("buffer binding", buffers[slot], queryInt(bufferBindingQuery(slot)));
+        if (activeUnit != kUnknown)
+            check("active texture", activeUnit, queryInt(GL_ACTIVE_TEXTURE) - GL_TEXTURE0);
+        const GLuint currentUnit = queryInt(GL_ACTIVE_TEXTURE);
+        for (GLuint unit = 0; unit < kTextureUnits; ++unit) {
+            for (std::size_t slot = 0; slot < kTextureTargets; ++slot) {
+                if (textures[unit][slot] == kUnknown)
+                    continue;
+                glActiveTexture(GL_TEXTURE0 + unit);
+                check("texture binding", textures[unit][slot], queryInt(textureBindingQuery(slot)));
+            }
+        }
+        glActiveTexture(currentUnit);
+        check("draw framebuffer", drawFramebuffer, queryInt(GL_DRAW_FRAMEBUFFER_BINDING));
+        check("read framebuffer", readFramebuffer, queryInt(GL_READ_FRAMEBUFFER_BINDING));
+        for (std::size_t slot = 0; slot < kCapabilities.size(); ++slot)
+            check("capability", capabilities[slot], glIsEnabled(kCapabilities[slot]) ? 1u : 0u);
+        check("polygon mode", polygonMode_, queryInt(GL_POLYGON_MODE));
+        check("depth func", depthFunc_, queryInt(GL_DEPTH_FUNC));
+        check("depth mask", depthMask_, queryInt(GL_DEPTH_WRITEMASK));
+        check("cull face", cullFace_, queryInt(GL_CULL_FACE_MODE));
+        check("blend src", blendSource, queryInt(GL_BLEND_SRC_RGB));
+        check("blend dst", blendDestination, queryInt(GL_BLEND_DST_RGB));
+        if (viewportKnown) {
+            GLint actual[4]{};
+            glGetIntegerv(GL_VIEWPORT, actual);
+            for (int i = 0; i < 4; ++i)
+                check("viewport", static_cast<GLuint>(viewport_[i]), static_cast<GLuint>(actual[i]));
+        }
+        return ok;
+    }
+
+    const Stats& stats() const { return statistics; }
+    void resetStats() { statistics = {}; }
+
+private:
+    static constexpr GLuint kUnknown = 0xFFFFFFFFu;
+    static constexpr std::size_t kNoSlot = ~std::size_t{0};
+
+    static constexpr std::array<GLenum, 9> kBufferTargets = {
+        GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER, GL_UNIFORM_BUFFER, GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+        GL_PIXEL_PACK_BUFFER, GL_PIXEL_UNPACK_BUFFER, GL_DRAW_INDIRECT_BUFFER, GL_SHADER_STORAGE_BUFFER,
+    };
+    static constexpr std::array<GLenum, 9> kBufferBindings = {
+        GL_ARRAY_BUFFER_BINDING, GL_ELEMENT_ARRAY_BUFFER_BINDING, GL_UNIFORM_BUFFER_BINDING, GL_COPY_READ_BUFFER_BINDING, GL_COPY_WRITE_BUFFER_BINDING,
+        GL_PIXEL_PACK_BUFFER_BINDING, GL_PIXEL_UNPACK_BUFFER_BINDING, GL_DRAW_INDIRECT_BUFFER_BINDING, GL_SHADER_STORAGE_BUFFER_BINDING,
+    };
+    static constexpr std::size_t kTextureTargets = 5;
+    static constexpr std::array<GLenum, kTextureTargets> kTextureTargetList = {
+        GL_TEXTURE_2D, GL_TEXTURE_CUBE_MAP, GL_TEXTURE_2D_ARRAY, GL_TEXTURE_3D, GL_TEXTURE_BUFFER,
+    };
+    static constexpr std::array<GLenum, kTextureTargets> kTextureBindings = {
+        GL_TEXTURE_BINDING_2D, GL_TEXTURE_BINDING_CUBE_MAP, GL_TEXTURE_BINDING_2D_ARRAY, GL_TEXTURE_BINDING_3D, GL_TEXTURE_BINDING_BUFFER,
+    };
+    static constexpr std::array<GLenum, 10> kCapabilities = {
+        GL_DEPTH_TEST, GL_BLEND, GL_CULL_FACE, GL_SCISSOR_TEST, GL_STENCIL_TEST,
+        GL_RASTERIZER_DISCARD, GL_PROGRAM_POINT_SIZE, GL_POLYGON_OFFSET_FILL, GL_MULTISAMPLE, GL_FRAMEBUFFER_SRGB,
+    };
+
+    template<std::size_t N>
+    static std::size_t find(const std::array<GLenum, N>& list, GLenum value) {
+        for (std::size_t i = 0; i < N; ++i)
+            if (list[i] == value)
+                return i;
+        return kNoSlot;
+    }
+    static std::size_t bufferSlot(GLenum target) { return find(kBufferTargets, target); }
+    static GLenum bufferBindingQuery(std::size_t slot) { return kBufferBindings[slot]; }
+    static std::size_t textureSlot(GLenum target) { return find(kTextureTargetList, target); }
+    static GLenum textureBindingQuery(std::size_t slot) { return kTextureBindings[slot]; }
+    static std::size_t capabilitySlot(GLenum capability) { return find(kCapabilities, capability); }
+
+    static GLuint queryInt(GLenum name) {
+        // 部分实现对 GL_POLYGON_MODE 返回正反两面两个值
+        GLint value[4]{};
+        glGetIntegerv(name, value);
+        return static_cast<GLuint>(value[0]);
+    }
+
+    void issue() {
+        ++statistics.issued;
+        GLUTILS_COUNT_STATE_CHANGES(1);
+    }
+    void skip() { ++statistics.skipped; }
+
+    // 验证模式下核对将被跳过的状态；返回 true 表示失配，调用需要照常发出
+    template<typename Query>
+    static bool desynced(GLuint shadow, Query&& query, const char* what) {
+#if GLUTILS_STATE_VALIDATION
+        const GLuint actual = query();
+        if (actual != shadow) {
+            std::cerr << "GLStateCache desync: " << what << " shadow=" << shadow << " actual=" << actual << std::endl;
+            return true;
+        }
+#else
+        (void)shadow;
+        (void)query;
+        (void)what;
+#endif
+        return false;
+    }
+
+    // 值与影子相同时记为跳过并返回 false；否则更新影子、记为发出并返回 true
+    bool changed(GLuint& shadow, GLuint value, GLenum query, GLuint bias = 0) {
+        if (shadow == value && !desynced(shadow, [&] { return queryInt(query) - bias; }, "state")) {
+            skip();
+            return false;
+        }
+        shadow = value;
+        issue();
+        return true;
+    }
+
+    GLuint program_ = kUnknown;
+    GLuint vertexArray = kUnknown;
+    std::array<GLuint, kBufferTargets.size()> buffers = filled<kBufferTargets.size()>();
+    GLuint activeUnit = kUnknown;
+    std::array<std::array<GLuint, kTextureTargets>, kTextureUnits> textures = filledTextures();
+    GLuint drawFramebuffer = kUnknown;
+    GLuint readFramebuffer = kUnknown;
+    std::array<GLuint, kCapabilities.size()> capabilities = filled<kCapabilities.size()>();
+    GLuint polygonMode_ = kUnknown;
+    GLuint depthFunc_ = kUnknown;
+    GLuint depthMask_ = kUnknown;
+    GLuint cullFace_ = kUnknown;
+    GLuint blendSource = kUnknown;
+    GLuint blendDestination = kUnknown;
+    std::array<GLint, 4> viewport_{};
+    bool viewportKnown = false;
+    Stats statistics;
+
+    template<std::size_t N>
+    static constexpr std::array<GLuint, N> filled() {
+        std::array<GLuint, N> values{};
+        values.fill(kUnknown);
+        return values;
+    }
+    static constexpr std::array<std::array<GLuint, kTextureTargets>, kTextureUnits> filledTextures() {
+        std::array<std::array<GLuint, kTextureTargets>, kTextureUnits> values{};
+        for (auto& unit : values)
+            unit.fill(kUnknown);
+        return values;
+    }
+};
+
+// 当前 GL 上下文（主线程）的状态缓存
+inline GLStateCache& glState() {
+    static GLStateCache cache;
+    return cache;
+}
+
+}
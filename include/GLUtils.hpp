@@ -2,23 +2,84 @@
 
 #include <iostream>
 #include <fstream>
-#include <sstream>
+#include <string>
 #include <array>
+#include <utility>
 #include <vector>
+#include <cstdlib>
 #include <cstring>
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+#include "GLState.hpp"
+#include "Uniforms.hpp"
+
 namespace glutils {
 
-inline void initGLFW(){
-    if (!glfwInit()) {
+namespace detail {
+
+// 无窗口模式下的离屏渲染目标
+struct OffscreenTarget {
+    bool headless = false;
+    unsigned int framebuffer = 0;
+    unsigned int color = 0;
+    unsigned int depthStencil = 0;
+};
+
+inline OffscreenTarget& offscreenTarget() {
+    static OffscreenTarget target;
+    return target;
+}
+
+// 环境变量存在且不为 "0" 时视为开启
+inline bool envFlag(const char* name) {
+    const char* value = std::getenv(name);
+    return value && *value && std::strcmp(value, "0") != 0;
+}
+
+}
+
+/**
+ * @brief 初始化 GLFW，使用 OpenGL 3.3 核心模式
+ *
+ * @param headless 无窗口模式：窗口不可见，createWindow 额外创建并绑定一个离屏 FBO。
+ *                 设置环境变量 GLUTILS_HEADLESS=1 也会开启，示例程序无需改动即可在 CI 中运行。
+ *                 没有显示服务器时，若 GLFW >= 3.4 则退回 null 平台 + EGL（例如 Mesa llvmpipe 的无表面上下文）。
+ */
+inline void initGLFW(bool headless = false){
+    headless = headless || detail::envFlag("GLUTILS_HEADLESS");
+    detail::offscreenTarget().headless = headless;
+    bool initialized = glfwInit();
+#ifdef GLFW_PLATFORM_NULL
+    bool nullPlatform = false;
+    if (!initialized && headless) {
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+        initialized = nullPlatform = glfwInit();
+    }
+#endif
+    if (!initialized) {
         std::cerr << "Failed to initialize GLFW" << std::endl;
         exit(-1);
     }
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (headless)
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+#ifdef GLFW_PLATFORM_NULL
+    if (nullPlatform)
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+#endif
+}
+
+// 是否处于无窗口模式
+inline bool isHeadless() {
+    return detail::offscreenTarget().headless;
+}
+
+// 无窗口模式下的离屏 FBO，普通模式返回 0（默认帧缓冲）
+inline unsigned int offscreenFramebuffer() {
+    return detail::offscreenTarget().framebuffer;
 }
 
 inline GLFWwindow* createWindow(std::size_t width, std::size_t height, const char* title){
@@ -35,6 +96,28 @@ inline GLFWwindow* createWindow(std::size_t width, std::size_t height, const cha
         std::cerr << "Failed to initialize GLAD" << std::endl;
         exit(-1);
     }
+
+    // 无窗口模式：渲染到离屏 FBO，不可见窗口（或无表面上下文）的默认帧缓冲可能不存在
+    auto& target = detail::offscreenTarget();
+    if (target.headless) {
+        glGenRenderbuffers(1, &target.color);
+        glBindRenderbuffer(GL_RENDERBUFFER, target.color);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+        glGenRenderbuffers(1, &target.depthStencil);
+        glBindRenderbuffer(GL_RENDERBUFFER, target.depthStencil);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+        glGenFramebuffers(1, &target.framebuffer);
+        glState().bindFramebuffer(GL_FRAMEBUFFER, target.framebuffer);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, target.color);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, target.depthStencil);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::cerr << "Failed to create offscreen framebuffer" << std::endl;
+            glfwTerminate();
+            exit(-1);
+        }
+    }
     glViewport(0, 0, width, height);
     return window;
 }
@@ -108,6 +191,57 @@ struct TessEvaluationShaderSource : ShaderSource {
 template<typename T>
 concept is_shader_source = std::is_base_of_v<ShaderSource, T>;
 
+namespace detail {
+
+// 检查着色器编译状态，失败时打印日志
+inline bool checkCompileStatus(unsigned int shader) {
+    char infoLog[512]{};
+    int success{};
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (!success) {
+        glGetShaderInfoLog(shader, std::size(infoLog), nullptr, infoLog);
+        std::cerr << "ERROR::SHADER::COMPILATION_FAILED\n" << infoLog << std::endl;
+    }
+    return success != 0;
+}
+
+// 编译单个着色器阶段，失败时打印日志；返回的着色器对象由调用者负责删除
+inline unsigned int compileStage(const char* source, int type) {
+    unsigned int shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, NULL);
+    glCompileShader(shader);
+    checkCompileStatus(shader);
+    return shader;
+}
+
+// 一次性把整个文件读入 out：先取文件大小再整块读取，不经过 stringstream 的额外拷贝
+inline bool readWholeFile(const std::string& path, std::string& out) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+        return false;
+    const std::streamoff size = file.tellg();
+    if (size < 0)
+        return false;
+    out.resize(static_cast<std::size_t>(size));
+    file.seekg(0);
+    file.read(out.data(), size);
+    return file.gcount() == size;
+}
+
+// 检查程序链接状态，失败时打印日志
+inline bool checkLinkStatus(unsigned int program) {
+    char infoLog[512]{};
+    int success{};
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        glGetProgramInfoLog(program, std::size(infoLog), nullptr, infoLog);
+        std::cerr << "ERROR::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+    }
+    return success != 0;
+}
+
+}
+
 /**
  * @brief 编译并链接多个着色器程序
  * 
@@ -115,30 +249,15 @@ concept is_shader_source = std::is_base_of_v<ShaderSource, T>;
  * @return unsigned int 返回链接好的着色器程序 ID
  */
 unsigned int compileShader(const is_shader_source auto&... ShaderObjects) {
-    auto compileIndividualShader = [](const char* source,int type) {
-        static char infoLog[512]{};
-        static int success{};
-
-        unsigned int shader = glCreateShader(type);
-        glShaderSource(shader, 1, &source, NULL);
-        glCompileShader(shader);
-        
-        glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-        if (!success) {
-            glGetShaderInfoLog(shader, std::size(infoLog), nullptr, infoLog);
-            std::cerr << "ERROR::SHADER::COMPILATION_FAILED\n" << infoLog << std::endl;
-            std::memset(infoLog, 0, std::size(infoLog));
-        }
-        return shader;
-    };
     // 解包参数并编译每个着色器
-    std::array array = { compileIndividualShader(ShaderObjects.source.c_str(), ShaderObjects.getType())... };
+    std::array array = { detail::compileStage(ShaderObjects.source.c_str(), ShaderObjects.getType())... };
     // 链接
     unsigned int shaderProgram  = glCreateProgram();
     for(const auto& shader : array)
         glAttachShader(shaderProgram, shader);
 
     glLinkProgram(shaderProgram);
+    detail::checkLinkStatus(shaderProgram);
     // 释放
     for(const auto& shader : array)
         glDeleteShader(shader);
@@ -150,14 +269,12 @@ class Shader{
 public:
     // 加载着色器文件返回 std::string
     static inline std::string loadShaderFromFile(const as_string auto& shaderPath) {
-        std::ifstream shaderFile(shaderPath);
-        if (!shaderFile.is_open()) {
+        std::string source;
+        if (!detail::readWholeFile(shaderPath, source)) {
             std::cerr << "Failed to open shader file: " << shaderPath << std::endl;
             exit(-1);
         }
-        std::stringstream buffer;
-        buffer << shaderFile.rdbuf();
-        return buffer.str();
+        return source;
     }
 
     // 单独编译链接一个着色器程序 编译成功与失败检查
@@ -188,23 +305,163 @@ public:
     Shader(const as_string auto& shaderPath, int shaderType) {
         std::string shaderSource = loadShaderFromFile(shaderPath);
         programID = compileShader(shaderSource.c_str(), shaderType);
+        uniformTable.introspect(programID);
     }
-    Shader() {
-        
+    // 接管一个已经链接好的程序（例如 glutils::compileShader 或 ProgramCache 的结果）
+    explicit Shader(unsigned int program) : programID(program) {
+        uniformTable.introspect(programID);
     }
+    // 空程序（getID() 为 0），之后用 reset() 或移动赋值得到真正的程序
+    Shader() = default;
     ~Shader() {
-        glDeleteProgram(programID);
+        if (programID)
+            glState().deleteProgram(programID);
+    }
+
+    // 程序对象只能有一个所有者：只能移动，移动后原对象变为空程序
+    Shader(const Shader&) = delete;
+    Shader& operator=(const Shader&) = delete;
+    Shader(Shader&& other) noexcept
+        : programID(std::exchange(other.programID, 0)), uniformTable(std::move(other.uniformTable)) {}
+    Shader& operator=(Shader&& other) noexcept {
+        if (this != &other) {
+            if (programID)
+                glState().deleteProgram(programID);
+            programID = std::exchange(other.programID, 0);
+            uniformTable = std::move(other.uniformTable);
+        }
+        return *this;
     }
+    // 经过状态缓存，程序已经在用时不重复调用 glUseProgram
     void use() const {
-        glUseProgram(programID);
+        glState().useProgram(programID);
     }
     unsigned int getID() const {
         return programID;
     }
 
+    // 换成另一个已经链接好的程序并删除旧程序（热重载用）；uniform 表重新内省，已缓存的值全部作废
+    void reset(unsigned int program) {
+        if (programID)
+            glState().deleteProgram(programID);
+        programID = program;
+        uniformTable.introspect(programID);
+    }
+
+    /**
+     * @brief 设置 uniform，名称在编译期求哈希，值未变化时不调用驱动
+     *
+     * 调用前必须先 use()。
+     * @return 实际上传时返回 true
+     */
+    template<uniform_value T>
+    bool setUniform(UniformName name, const T& value) {
+        return uniformTable.set(name, &value);
+    }
+
+    template<uniform_value T>
+    bool setUniformArray(UniformName name, const T* values, std::size_t count) {
+        return uniformTable.set(name, values, count);
+    }
+
+    // 查询 uniform 块布局，用于构造 UniformBuffer；块不存在时返回 nullptr
+    const UniformBlockInfo* uniformBlock(UniformName name) const {
+        return uniformTable.block(name);
+    }
+
+    // 把 uniform 块绑定到指定的 UBO 绑定点
+    bool bindUniformBlock(UniformName name, GLuint binding) const {
+        const UniformBlockInfo* block = uniformTable.block(name);
+        if (!block)
+            return false;
+        glUniformBlockBinding(programID, block->index, binding);
+        return true;
+    }
+
+    const UniformTable& uniforms() const { return uniformTable; }
+
+    // 外部直接调用过 glUniform* 时，丢弃已缓存的 uniform 值
+    void invalidateUniforms() { uniformTable.invalidate(); }
+
 private:
     
-    unsigned int programID;
+    unsigned int programID = 0;
+    UniformTable uniformTable;
+};
+
+/**
+ * @brief 计算着色器程序：分派工作组、绑定 SSBO、插入内存屏障
+ *
+ * 需要 OpenGL 4.3，使用前先检查 supported()。
+ * dispatchThreads 在一维工作组数超过上限时改用二维分派，着色器中应这样求线性下标并与总数比较：
+ *     uint i = gl_GlobalInvocationID.y * gl_NumWorkGroups.x * gl_WorkGroupSize.x + gl_GlobalInvocationID.x;
+ */
+class ComputeProgram {
+public:
+    static bool supported() { return GLAD_GL_VERSION_4_3; }
+
+    explicit ComputeProgram(const ComputeShaderSource& source) : shader(compileShader(source)) {
+        if (shader.getID()) {
+            GLint size[3]{};
+            glGetProgramiv(shader.getID(), GL_COMPUTE_WORK_GROUP_SIZE, size);
+            localSize = static_cast<GLuint>(size[0]) * static_cast<GLuint>(size[1]) * static_cast<GLuint>(size[2]);
+        }
+        GLint maxGroups = 65535;
+        glGetIntegeri_v(GL_MAX_COMPUTE_WORK_GROUP_COUNT, 0, &maxGroups);
+        maxGroupsX = static_cast<GLuint>(maxGroups);
+    }
+
+    Shader& program() { return shader; }
+    void use() const { shader.use(); }
+
+    template<uniform_value T>
+    bool setUniform(UniformName name, const T& value) {
+        return shader.setUniform(name, value);
+    }
+
+    // 把 buffer（或其中 [offset, offset + size) 一段）绑定到 std430 块的 binding 点
+    static void bindStorage(GLuint binding, GLuint buffer) {
+        glState().bindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, buffer);
+    }
+    static void bindStorage(GLuint binding, GLuint buffer, GLintptr offset, GLsizeiptr size) {
+        glState().bindBufferRange(GL_SHADER_STORAGE_BUFFER, binding, buffer, offset, size);
+    }
+
+    // 按工作组数分派，调用前必须先 use()
+    void dispatch(GLuint x, GLuint y = 1, GLuint z = 1) const {
+        glDispatchCompute(x, y, z);
+    }
+
+    // 至少启动 count 个调用（按工作组大小向上取整）
+    void dispatchThreads(std::size_t count) const {
+        if (count == 0)
+            return;
+        const std::size_t groups = (count + localSize - 1) / localSize;
+        if (groups <= maxGroupsX) {
+            glDispatchCompute(static_cast<GLuint>(groups), 1, 1);
+            return;
+        }
+        const std::size_t rows = (groups + maxGroupsX - 1) / maxGroupsX;
+        glDispatchCompute(static_cast<GLuint>((groups + rows - 1) / rows), static_cast<GLuint>(rows), 1);
+    }
+
+    /**
+     * @brief 让之前计算着色器的写入对后续操作可见
+     *
+     * @param bits 后续的使用方式，例如 GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT（作为顶点属性读取）、
+     *             GL_COMMAND_BARRIER_BIT（作为间接绘制命令）、GL_BUFFER_UPDATE_BARRIER_BIT（glGetBufferSubData 回读）
+     */
+    static void barrier(GLbitfield bits) {
+        glMemoryBarrier(bits);
+    }
+
+    // 工作组内的调用数
+    GLuint workGroupSize() const { return localSize; }
+
+private:
+    Shader shader;
+    GLuint localSize = 1;
+    GLuint maxGroupsX = 65535;
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,284 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "GLUtils.hpp"
+#include "Profiler.hpp"
+
+namespace glutils {
+
+// 与 glDrawArraysIndirect 的命令格式一致
+struct DrawArraysIndirectCommand {
+    std::uint32_t count;
+    std::uint32_t instanceCount;
+    std::uint32_t first;
+    std::uint32_t baseInstance;
+};
+
+// 逐帧的点动画参数：y += amplitude * sin(frequency * x + time)
+struct PointAnimation {
+    float amplitude = 0.05f;
+    float frequency = 2.0f;
+};
+
+// CPU 上的同一个动画公式，用于校验 GPU 结果
+inline glm::vec3 animatePoint(glm::vec3 p, const PointAnimation& animation, float time) {
+    p.y += animation.amplitude * std::sin(animation.frequency * p.x + time);
+    return p;
+}
+
+namespace detail {
+
+// 与 PointCloud.hpp 中的 philox4x32 / uintToUnitFloat 逐位一致；precise 禁止编译器把乘加合并为 fma
+inline const char* kGpuPointGenerateShader = R"(#version 430 core
+layout(local_size_x = 256) in;
+layout(std430, binding = 0) writeonly buffer Points { float points[]; };
+uniform uint pointCount;
+uniform uint seedLow;
+uniform uint seedHigh;
+uniform float minValue;
+uniform float range;
+
+uvec4 philox4x32(uvec4 ctr, uvec2 key) {
+    for (int round = 0; round < 10; ++round) {
+        uint hi0, lo0, hi1, lo1;
+        umulExtended(0xD2511F53u, ctr.x, hi0, lo0);
+        umulExtended(0xCD9E8D57u, ctr.z, hi1, lo1);
+        ctr = uvec4(hi1 ^ ctr.y ^ key.x, lo1, hi0 ^ ctr.w ^ key.y, lo0);
+        key += uvec2(0x9E3779B9u, 0xBB67AE85u);
+    }
+    return ctr;
+}
+
+float unitFloat(uint x) {
+    return float(x >> 8u) * (1.0 / 16777216.0);
+}
+
+void main() {
+    uint i = gl_GlobalInvocationID.y * gl_NumWorkGroups.x * gl_WorkGroupSize.x + gl_GlobalInvocationID.x;
+    if (i >= pointCount)
+        return;
+    uvec4 r = philox4x32(uvec4(i, 0u, 0u, 0u), uvec2(seedLow, seedHigh));
+    precise float x = minValue + range * unitFloat(r.x);
+    precise float y = minValue + range * unitFloat(r.y);
+    precise float z = minValue + range * unitFloat(r.z);
+    points[i * 3u + 0u] = x;
+    points[i * 3u + 1u] = y;
+    points[i * 3u + 2u] = z;
+})";
+
+// 动画 + 视锥剔除 + 紧缩：可见点先在工作组内用共享内存计数，每组只做一次全局 atomicAdd
+inline const char* kGpuPointCompactShader = R"(#version 430 core
+layout(local_size_x = 256) in;
+layout(std430, binding = 0) readonly buffer Source { float source[]; };
+layout(std430, binding = 1) writeonly buffer Visible { float visible[]; };
+layout(std430, binding = 2) buffer Command { uint count; uint instanceCount; uint first; uint baseInstance; };
+uniform uint pointCount;
+uniform mat4 mvp;
+uniform float time;
+uniform float amplitude;
+uniform float frequency;
+
+shared uint groupCount;
+shared uint groupBase;
+
+void main() {
+    uint i = gl_GlobalInvocationID.y * gl_NumWorkGroups.x * gl_WorkGroupSize.x + gl_GlobalInvocationID.x;
+    if (gl_LocalInvocationIndex == 0u)
+        groupCount = 0u;
+    barrier();
+
+    bool keep = false;
+    vec3 p = vec3(0.0);
+    if (i < pointCount) {
+        p = vec3(source[i * 3u + 0u], source[i * 3u + 1u], source[i * 3u + 2u]);
+        p.y += amplitude * sin(frequency * p.x + time);
+        vec4 clip = mvp * vec4(p, 1.0);
+        keep = all(lessThanEqual(abs(clip.xyz), vec3(clip.w)));
+    }
+    uint local = 0u;
+    if (keep)
+        local = atomicAdd(groupCount, 1u);
+    barrier();
+    if (gl_LocalInvocationIndex == 0u)
+        groupBase = atomicAdd(count, groupCount);
+    barrier();
+
+    if (keep) {
+        uint o = (groupBase + local) * 3u;
+        visible[o + 0u] = p.x;
+        visible[o + 1u] = p.y;
+        visible[o + 2u] = p.z;
+    }
+})";
+
+}
+
+/**
+ * @brief 完全在 GPU 上生成、动画、剔除点云（需要 OpenGL 4.3）
+ *
+ * 生成：计算着色器按与 RandomPointSource 相同的 Philox 计数器随机数直接写入 SSBO，不经过 CPU 和上传。
+ * 每帧 update()：对每个点做动画和视锥测试，把可见点紧缩到另一个缓冲，
+ * 可见数量由着色器原子累加进间接绘制命令，draw() 用 glDrawArraysIndirect 绘制，CPU 不需要回读。
+ * 紧缩后点的顺序不确定，不影响点精灵的绘制结果。
+ *
+ * 顶点格式与 CPU 路径相同（location 0，紧密排列的 vec3），可以直接沿用原来的着色器。
+ * 着色器用 uint 计算浮点下标 i * 3，点数不能超过 (2^32 - 1) / 3；
+ * 点缓冲整个绑定为一个 SSBO，字节数还受 GL_MAX_SHADER_STORAGE_BLOCK_SIZE 限制（规范最低只保证 128 MiB）。
+ * 超出 maxPoints() 时构造失败，valid() 返回 false，调用方应改用 CPU 生成。
+ * 持有 GL 对象，必须在 glfwTerminate 之前析构。
+ */
+class GpuPointCloud {
+public:
+    static bool supported() { return ComputeProgram::supported(); }
+
+    // 当前上下文能处理的最大点数，需要在 supported() 为 true 的上下文上调用
+    static std::size_t maxPoints() {
+        GLint64 blockSize = 0;
+        glGetInteger64v(GL_MAX_SHADER_STORAGE_BLOCK_SIZE, &blockSize);
+        const std::size_t byIndex = std::numeric_limits<std::uint32_t>::max() / 3;
+        const std::size_t byBlock = static_cast<std::size_t>(std::max<GLint64>(blockSize, 0)) / (3 * sizeof(float));
+        return std::min(byIndex, byBlock);
+    }
+
+    static bool supported(std::size_t count) { return supported() && count <= maxPoints(); }
+
+    GpuPointCloud(std::size_t count, std::uint64_t seed = 42, float minValue = -3.0f, float maxValue = 3.0f)
+        : count(count), seed(seed), minValue(minValue), range(maxValue - minValue),
+          generator(ComputeShaderSource(detail::kGpuPointGenerateShader)),
+          compactor(ComputeShaderSource(detail::kGpuPointCompactShader)) {
+        if (count > maxPoints()) {
+            std::cerr << "GpuPointCloud: " << count << " 个点超出上限 " << maxPoints() << std::endl;
+            this->count = 0;
+            return;
+        }
+        const GLsizeiptr bytes = static_cast<GLsizeiptr>(std::max<std::size_t>(count, 1) * 3 * sizeof(float));
+        glGenBuffers(1, &sourceBuffer);
+        glState().bindBuffer(GL_SHADER_STORAGE_BUFFER, sourceBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, bytes, nullptr, GL_STATIC_DRAW);
+        glGenBuffers(1, &visibleBuffer);
+        glState().bindBuffer(GL_SHADER_STORAGE_BUFFER, visibleBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, bytes, nullptr, GL_DYNAMIC_COPY);
+
+        // 初始命令绘制 0 个点，首次 update() 之前调用 draw() 也是安全的
+        const DrawArraysIndirectCommand command{ 0, 1, 0, 0 };
+        glGenBuffers(1, &commandBuffer);
+        glState().bindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(command), &command, GL_DYNAMIC_COPY);
+
+        glGenVertexArrays(1, &vao);
+        glState().bindVertexArray(vao);
+        glState().bindBuffer(GL_ARRAY_BUFFER, visibleBuffer);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
+
+        generate();
+    }
+
+    ~GpuPointCloud() {
+        glState().deleteVertexArray(vao);
+        glState().deleteBuffer(sourceBuffer);
+        glState().deleteBuffer(visibleBuffer);
+        glState().deleteBuffer(commandBuffer);
+    }
+
+    GpuPointCloud(const GpuPointCloud&) = delete;
+    GpuPointCloud& operator=(const GpuPointCloud&) = delete;
+
+    // 重新生成全部点（构造时已经调用过一次）
+    void generate() {
+        GLUTILS_PROFILE_GPU_ZONE("generate points");
+        generator.use();
+        generator.setUniform("pointCount", static_cast<unsigned int>(count));
+        generator.setUniform("seedLow", static_cast<unsigned int>(seed));
+        generator.setUniform("seedHigh", static_cast<unsigned int>(seed >> 32));
+        generator.setUniform("minValue", minValue);
+        generator.setUniform("range", range);
+        ComputeProgram::bindStorage(0, sourceBuffer);
+        generator.dispatchThreads(count);
+        ComputeProgram::barrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+    }
+
+    // 动画 + 剔除 + 紧缩，结果留在 GPU 上供 draw() 使用
+    void update(const glm::mat4& mvp, float time) {
+        GLUTILS_PROFILE_GPU_ZONE("compact points");
+        const std::uint32_t zero = 0;
+        glState().bindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+        glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, sizeof(zero), &zero);
+
+        compactor.use();
+        compactor.setUniform("pointCount", static_cast<unsigned int>(count));
+        compactor.setUniform("mvp", mvp);
+        compactor.setUniform("time", time);
+        compactor.setUniform("amplitude", animation.amplitude);
+        compactor.setUniform("frequency", animation.frequency);
+        ComputeProgram::bindStorage(0, sourceBuffer);
+        ComputeProgram::bindStorage(1, visibleBuffer);
+        ComputeProgram::bindStorage(2, commandBuffer);
+        compactor.dispatchThreads(count);
+        ComputeProgram::barrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_COMMAND_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+    }
+
+    // 绘制最近一次 update() 的可见点，调用前先 use() 绘制用的着色器
+    void draw() const {
+        glState().bindVertexArray(vao);
+        glState().bindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+        glDrawArraysIndirect(GL_POINTS, nullptr);
+        GLUTILS_COUNT_DRAW(1);
+    }
+
+    // 回读可见点数（会等待 GPU，只用于统计和校验）
+    std::size_t readVisibleCount() const {
+        DrawArraysIndirectCommand command{};
+        glState().bindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+        glGetBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, sizeof(command), &command);
+        return command.count;
+    }
+
+    // 回读生成的点 [first, first + n)，out 为紧密的 xyz（会等待 GPU，只用于校验）
+    void readPoints(std::size_t first, std::size_t n, std::vector<float>& out) const {
+        readBuffer(sourceBuffer, first, n, out);
+    }
+
+    // 回读紧缩后的可见点（前 readVisibleCount() 个有效）
+    void readVisiblePoints(std::size_t n, std::vector<float>& out) const {
+        readBuffer(visibleBuffer, 0, n, out);
+    }
+
+    // 点数超出 maxPoints() 时为 false，此时不持有缓冲，不能 update() / draw()
+    bool valid() const { return vao != 0; }
+    std::size_t size() const { return count; }
+    unsigned int pointBuffer() const { return sourceBuffer; }
+    unsigned int visiblePointBuffer() const { return visibleBuffer; }
+    unsigned int indirectBuffer() const { return commandBuffer; }
+
+    PointAnimation animation;
+
+private:
+    void readBuffer(unsigned int buffer, std::size_t first, std::size_t n, std::vector<float>& out) const {
+        out.resize(n * 3);
+        glState().bindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+        glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, static_cast<GLintptr>(first * 3 * sizeof(float)),
+                           static_cast<GLsizeiptr>(n * 3 * sizeof(float)), out.data());
+    }
+
+    std::size_t count;
+    std::uint64_t seed;
+    float minValue;
+    float range;
+    ComputeProgram generator;
+    ComputeProgram compactor;
+    unsigned int sourceBuffer = 0;
+    unsigned int visibleBuffer = 0;
+    unsigned int commandBuffer = 0;
+    unsigned int vao = 0;
+};
+
+}
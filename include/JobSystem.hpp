@@ -0,0 +1,347 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Parallel.hpp"
+#include "Profiler.hpp"
+
+namespace glutils {
+
+// 一组任务的完成计数：提交时加一，任务执行完减一，JobSystem::wait 等到归零
+struct JobCounter {
+    std::atomic<std::size_t> pending{ 0 };
+
+    bool done() const { return pending.load(std::memory_order_acquire) == 0; }
+};
+
+namespace detail {
+
+// 任务闭包的内联存储字节数；parallelFor 的闭包是一个引用加两个下标，只占 24 字节
+inline constexpr std::size_t kJobStorage = 48;
+
+struct Job {
+    alignas(std::max_align_t) unsigned char storage[kJobStorage];
+    // 调用并析构 storage 里的闭包
+    void (*invoke)(Job&) = nullptr;
+    JobCounter* counter = nullptr;
+    // 空闲链表中下一个任务的下标
+    std::atomic<std::uint32_t> next{ 0 };
+};
+
+/**
+ * @brief 构造时一次分配好的任务池，提交和执行任务都不再访问堆
+ *
+ * 空闲链表是无锁栈，栈顶把下标和版本号打包在一个 64 位原子变量里：
+ * 取出时读到的 next 可能已经过期，但期间只要有过任何入栈 / 出栈，版本号就变了，CAS 会失败重试（避免 ABA）。
+ */
+class JobPool {
+public:
+    static constexpr std::uint32_t kCapacity = 4096;
+
+    JobPool() : jobs(std::make_unique<Job[]>(kCapacity)) {
+        for (std::uint32_t i = 0; i < kCapacity; ++i)
+            jobs[i].next.store(i + 1 < kCapacity ? i + 1 : kNone, std::memory_order_relaxed);
+        head.store(pack(0, 0), std::memory_order_release);
+    }
+
+    // 池已用完时返回 nullptr
+    Job* acquire() {
+        std::uint64_t old = head.load(std::memory_order_acquire);
+        while (true) {
+            const std::uint32_t index = indexOf(old);
+            if (index == kNone)
+                return nullptr;
+            const std::uint32_t next = jobs[index].next.load(std::memory_order_relaxed);
+            if (head.compare_exchange_weak(old, pack(next, tagOf(old) + 1), std::memory_order_acquire, std::memory_order_acquire))
+                return &jobs[index];
+        }
+    }
+
+    void release(Job* job) {
+        const std::uint32_t index = static_cast<std::uint32_t>(job - jobs.get());
+        std::uint64_t old = head.load(std::memory_order_relaxed);
+        do {
+            job->next.store(indexOf(old), std::memory_order_relaxed);
+        } while (!head.compare_exchange_weak(old, pack(index, tagOf(old) + 1), std::memory_order_release, std::memory_order_relaxed));
+    }
+
+private:
+    static constexpr std::uint32_t kNone = ~std::uint32_t{ 0 };
+
+    static std::uint64_t pack(std::uint32_t index, std::uint32_t tag) { return std::uint64_t{ tag } << 32 | index; }
+    static std::uint32_t indexOf(std::uint64_t value) { return static_cast<std::uint32_t>(value); }
+    static std::uint32_t tagOf(std::uint64_t value) { return static_cast<std::uint32_t>(value >> 32); }
+
+    std::unique_ptr<Job[]> jobs;
+    alignas(64) std::atomic<std::uint64_t> head{ 0 };
+};
+
+/**
+ * @brief Chase-Lev 工作窃取双端队列（固定容量）
+ *
+ * 所属线程在底部 push / pop（后进先出，缓存热），其他线程从顶部 steal（先进先出，拿走较大的旧任务）。
+ * 只有队列剩最后一个元素时 pop 和 steal 才通过 CAS 竞争，其余情况无锁、无竞争。
+ */
+class WorkStealingDeque {
+public:
+    static constexpr std::int64_t kCapacity = 4096;
+
+    // 仅所属线程调用；满了返回 false，由调用者就地执行
+    bool push(Job* job) {
+        const std::int64_t b = bottom.load(std::memory_order_relaxed);
+        const std::int64_t t = top.load(std::memory_order_acquire);
+        if (b - t >= kCapacity)
+            return false;
+        slots[static_cast<std::size_t>(b & (kCapacity - 1))].store(job, std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 仅所属线程调用
+    Job* pop() {
+        const std::int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t t = top.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        Job* job = slots[static_cast<std::size_t>(b & (kCapacity - 1))].load(std::memory_order_relaxed);
+        if (t == b) {
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                job = nullptr;
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    // 任意线程调用
+    Job* steal() {
+        std::int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b)
+            return nullptr;
+        Job* job = slots[static_cast<std::size_t>(t & (kCapacity - 1))].load(std::memory_order_acquire);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr;
+        return job;
+    }
+
+private:
+    alignas(64) std::atomic<std::int64_t> top{ 0 };
+    alignas(64) std::atomic<std::int64_t> bottom{ 0 };
+    std::array<std::atomic<Job*>, kCapacity> slots{};
+};
+
+}
+
+/**
+ * @brief 工作窃取任务系统
+ *
+ * 每个工作线程有自己的双端队列；工作线程内提交的任务进自己的队列，
+ * 其他线程（主线程、模拟线程等）提交的任务进一个共享的注入队列。
+ * 空闲线程先取自己的队列，再随机窃取其他线程，最后取注入队列，都没有时在原子变量上休眠。
+ * wait() 的调用线程不会闲等，而是一起执行任务，所以任务里可以嵌套 parallelFor。
+ *
+ * 与 Parallel.hpp 的 parallelFor 不同，线程只在构造时创建一次，适合每帧都要调用的小任务。
+ * 任务从预先分配的 JobPool 中取出，闭包就地存放在任务里（不超过 kJobStorage 字节），
+ * 注入队列也是固定容量的环，所以稳态下提交和执行任务都没有堆分配；池用完时任务在提交线程上直接执行。
+ */
+class JobSystem {
+public:
+    // threads 为工作线程数，默认比核心数少一个：等待中的调用线程也会执行任务
+    explicit JobSystem(unsigned int threads = std::max(1u, workerCount() - 1)) : injected(detail::JobPool::kCapacity) {
+        deques.reserve(threads);
+        for (unsigned int i = 0; i < threads; ++i)
+            deques.push_back(std::make_unique<detail::WorkStealingDeque>());
+        workers.reserve(threads);
+        for (unsigned int i = 0; i < threads; ++i)
+            workers.emplace_back([this, i] { workerLoop(i); });
+    }
+
+    ~JobSystem() {
+        stopping.store(true, std::memory_order_release);
+        wakeEpoch.fetch_add(1, std::memory_order_release);
+        wakeEpoch.notify_all();
+        for (auto& worker : workers)
+            worker.join();
+    }
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // 进程共享的默认实例
+    static JobSystem& global() {
+        static JobSystem system;
+        return system;
+    }
+
+    // 提交一个任务，counter 在任务完成后减一；较大的状态请按引用捕获，闭包要放得进 kJobStorage
+    template<typename Fn>
+    void run(JobCounter& counter, Fn&& fn) {
+        using Closure = std::decay_t<Fn>;
+        static_assert(sizeof(Closure) <= detail::kJobStorage && alignof(Closure) <= alignof(std::max_align_t),
+                      "任务闭包超过 kJobStorage，请按引用捕获");
+        detail::Job* job = pool.acquire();
+        if (!job) {
+            fn();
+            return;
+        }
+        ::new (static_cast<void*>(job->storage)) Closure(std::forward<Fn>(fn));
+        job->invoke = [](detail::Job& slot) {
+            Closure* closure = std::launder(reinterpret_cast<Closure*>(slot.storage));
+            (*closure)();
+            closure->~Closure();
+        };
+        job->counter = &counter;
+        counter.pending.fetch_add(1, std::memory_order_relaxed);
+        const int self = currentWorker();
+        if (self >= 0) {
+            if (!deques[static_cast<std::size_t>(self)]->push(job)) {
+                execute(job);
+                return;
+            }
+        } else {
+            // 注入队列里的任务都占着池中的槽位，所以环的容量等于池容量就不会溢出
+            std::lock_guard lock(injectMutex);
+            injected[injectTail++ % injected.size()] = job;
+            injectedCount.fetch_add(1, std::memory_order_release);
+        }
+        wakeEpoch.fetch_add(1, std::memory_order_release);
+        wakeEpoch.notify_one();
+    }
+
+    // 等待 counter 归零，期间执行其他任务
+    void wait(JobCounter& counter) {
+        GLUTILS_PROFILE_ZONE("JobSystem::wait");
+        const int self = currentWorker();
+        unsigned int spins = 0;
+        while (!counter.done()) {
+            if (detail::Job* job = findJob(self)) {
+                execute(job);
+                spins = 0;
+            } else if (++spins > 64) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    /**
+     * @brief 把 [0, count) 切成 grain 大小的块并行执行 fn(begin, end)，返回时全部完成
+     *
+     * 最后一块在调用线程执行；只有一块时不提交任务。
+     */
+    template<typename Fn>
+    void parallelFor(std::size_t count, std::size_t grain, Fn&& fn) {
+        if (count == 0)
+            return;
+        grain = std::max<std::size_t>(grain, 1);
+        const std::size_t chunks = (count + grain - 1) / grain;
+        JobCounter counter;
+        for (std::size_t c = 0; c + 1 < chunks; ++c) {
+            const std::size_t begin = c * grain;
+            run(counter, [&fn, begin, end = std::min(begin + grain, count)] { fn(begin, end); });
+        }
+        const std::size_t last = (chunks - 1) * grain;
+        fn(last, count);
+        wait(counter);
+    }
+
+    unsigned int threadCount() const { return static_cast<unsigned int>(workers.size()); }
+
+private:
+    // 当前线程在本系统中的工作线程编号，不是工作线程时为 -1
+    int currentWorker() const {
+        return workerOwner == this ? workerIndex : -1;
+    }
+
+    detail::Job* findJob(int self) {
+        if (self >= 0)
+            if (detail::Job* job = deques[static_cast<std::size_t>(self)]->pop())
+                return job;
+        const std::size_t n = deques.size();
+        // 从随机位置开始依次尝试窃取，避免所有线程都盯着同一个受害者
+        thread_local std::uint32_t seed = static_cast<std::uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id())) | 1u;
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        for (std::size_t k = 0; k < n; ++k) {
+            const std::size_t victim = (seed + k) % n;
+            if (static_cast<int>(victim) == self)
+                continue;
+            if (detail::Job* job = deques[victim]->steal())
+                return job;
+        }
+        if (injectedCount.load(std::memory_order_acquire) > 0) {
+            std::lock_guard lock(injectMutex);
+            if (injectHead != injectTail) {
+                detail::Job* job = injected[injectHead++ % injected.size()];
+                injectedCount.fetch_sub(1, std::memory_order_relaxed);
+                return job;
+            }
+        }
+        return nullptr;
+    }
+
+    void execute(detail::Job* job) {
+        job->invoke(*job);
+        JobCounter* counter = job->counter;
+        pool.release(job);
+        counter->pending.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    void workerLoop(unsigned int index) {
+        workerOwner = this;
+        workerIndex = static_cast<int>(index);
+        unsigned int spins = 0;
+        while (true) {
+            // 先读纪元再找任务：找不到时在这个纪元上休眠，期间的任何提交都会改变纪元，不会丢失唤醒
+            const std::uint32_t epoch = wakeEpoch.load(std::memory_order_acquire);
+            if (stopping.load(std::memory_order_acquire))
+                return;
+            if (detail::Job* job = findJob(workerIndex)) {
+                execute(job);
+                spins = 0;
+                continue;
+            }
+            if (++spins < 64) {
+                std::this_thread::yield();
+                continue;
+            }
+            wakeEpoch.wait(epoch, std::memory_order_acquire);
+            spins = 0;
+        }
+    }
+
+    detail::JobPool pool;
+    std::vector<std::unique_ptr<detail::WorkStealingDeque>> deques;
+    std::vector<std::thread> workers;
+
+    std::mutex injectMutex;
+    std::vector<detail::Job*> injected;
+    std::size_t injectHead = 0;
+    std::size_t injectTail = 0;
+    std::atomic<std::size_t> injectedCount{ 0 };
+
+    std::atomic<std::uint32_t> wakeEpoch{ 0 };
+    std::atomic<bool> stopping{ false };
+
+    static inline thread_local const JobSystem* workerOwner = nullptr;
+    static inline thread_local int workerIndex = -1;
+};
+
+}
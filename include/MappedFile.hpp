@@ -0,0 +1,193 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace glutils {
+
+/**
+ * @brief 内存映射文件（只移动）
+ *
+ * openRead 以只读方式映射已有文件；create 创建/截断文件到指定大小并以读写方式映射，
+ * 多个线程可以直接往映射内存里写各自的区间，析构时由操作系统回写磁盘。
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept { swap(other); }
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            swap(other);
+        }
+        return *this;
+    }
+    ~MappedFile() { close(); }
+
+    bool openRead(const std::filesystem::path& path) {
+        close();
+#ifdef _WIN32
+        file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+        LARGE_INTEGER fileSize{};
+        GetFileSizeEx(file, &fileSize);
+        length = static_cast<std::size_t>(fileSize.QuadPart);
+        if (length == 0)
+            return true;
+        mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) {
+            close();
+            return false;
+        }
+        bytes = static_cast<char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat st{};
+        fstat(fd, &st);
+        length = static_cast<std::size_t>(st.st_size);
+        if (length == 0)
+            return true;
+        void* p = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        bytes = p == MAP_FAILED ? nullptr : static_cast<char*>(p);
+        if (bytes)
+            madvise(bytes, length, MADV_SEQUENTIAL);
+#endif
+        if (!bytes) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    bool create(const std::filesystem::path& path, std::size_t size) {
+        close();
+#ifdef _WIN32
+        file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+        length = size;
+        if (length == 0)
+            return true;
+        LARGE_INTEGER li{};
+        li.QuadPart = static_cast<LONGLONG>(size);
+        mapping = CreateFileMappingW(file, nullptr, PAGE_READWRITE, li.HighPart, li.LowPart, nullptr);
+        if (!mapping) {
+            close();
+            return false;
+        }
+        bytes = static_cast<char*>(MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, size));
+#else
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+            return false;
+        length = size;
+        if (length == 0)
+            return true;
+        if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            close();
+            return false;
+        }
+        void* p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        bytes = p == MAP_FAILED ? nullptr : static_cast<char*>(p);
+#endif
+        if (!bytes) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (bytes)
+            UnmapViewOfFile(bytes);
+        if (mapping)
+            CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE)
+            CloseHandle(file);
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (bytes)
+            munmap(bytes, length);
+        if (fd >= 0)
+            ::close(fd);
+        fd = -1;
+#endif
+        bytes = nullptr;
+        length = 0;
+    }
+
+    bool isOpen() const { return bytes != nullptr || (length == 0 && isFileOpen()); }
+    char* data() { return bytes; }
+    const char* data() const { return bytes; }
+    std::size_t size() const { return length; }
+
+private:
+    void swap(MappedFile& other) noexcept {
+        std::swap(bytes, other.bytes);
+        std::swap(length, other.length);
+#ifdef _WIN32
+        std::swap(file, other.file);
+        std::swap(mapping, other.mapping);
+#else
+        std::swap(fd, other.fd);
+#endif
+    }
+#ifdef _WIN32
+    bool isFileOpen() const { return file != INVALID_HANDLE_VALUE; }
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    bool isFileOpen() const { return fd >= 0; }
+    int fd = -1;
+#endif
+    char* bytes = nullptr;
+    std::size_t length = 0;
+};
+
+/**
+ * @brief 把一个已知大小的文件交给 fill 并行填充
+ *
+ * 优先映射输出文件让各线程直接写入；映射失败时退化为一整块内存缓冲，再一次性写出。
+ */
+template<typename Fill>
+bool writeSizedFile(const std::filesystem::path& path, std::size_t size, Fill&& fill) {
+    MappedFile mapped;
+    if (mapped.create(path, size)) {
+        fill(mapped.data());
+        return true;
+    }
+    std::vector<char> buffer(size);
+    fill(buffer.data());
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+        return false;
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    return static_cast<bool>(file);
+}
+
+}
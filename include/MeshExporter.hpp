@@ -0,0 +1,209 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+#include "MappedFile.hpp"
+#include "Parallel.hpp"
+#include "Simd.hpp"
+
+namespace glutils {
+
+/**
+ * @brief 顶点缓冲的内存布局，语义与 glVertexAttribPointer 的 stride / pointer 一致
+ *
+ * stride 与 positionOffset 都以字节为单位，位置属性固定为 3 个 float。
+ */
+struct VertexLayout {
+    std::size_t stride = 3 * sizeof(float);
+    std::size_t positionOffset = 0;
+};
+
+/**
+ * @brief 只读的网格视图，不拥有数据
+ *
+ * indices 为 nullptr 时按顶点顺序每三个组成一个三角形。
+ */
+struct MeshView {
+    const void* vertices = nullptr;
+    std::size_t vertexCount = 0;
+    const unsigned int* indices = nullptr;
+    std::size_t indexCount = 0;
+    VertexLayout layout{};
+
+    std::size_t triangleCount() const { return (indices ? indexCount : vertexCount) / 3; }
+
+    unsigned int index(std::size_t i) const { return indices ? indices[i] : static_cast<unsigned int>(i); }
+
+    void position(unsigned int vertex, float out[3]) const {
+        const char* base = static_cast<const char*>(vertices) + vertex * layout.stride + layout.positionOffset;
+        std::memcpy(out, base, 3 * sizeof(float));
+    }
+};
+
+namespace detail {
+
+// 二进制 STL：80 字节头 + uint32 三角形数 + 每个三角形 50 字节
+inline constexpr std::size_t kStlHeaderSize = 84;
+inline constexpr std::size_t kStlFacetSize = 50;
+// 每个任务处理的三角形数量
+inline constexpr std::size_t kExportGrain = 1 << 16;
+
+// 计算 [begin, end) 范围内三角形的单位面法线并写入二进制 STL 记录
+inline void writeStlFacets(const MeshView& mesh, std::size_t begin, std::size_t end, char* out) {
+    std::size_t t = begin;
+#ifdef GLUTILS_SSE2
+    // 一次处理 4 个三角形：先把顶点转置成 SoA，再用 SSE 计算叉积与归一化
+    alignas(16) float p[9][4];
+    alignas(16) float n[3][4];
+    for (; t + 4 <= end; t += 4) {
+        for (int lane = 0; lane < 4; ++lane) {
+            for (int k = 0; k < 3; ++k) {
+                float v[3];
+                mesh.position(mesh.index((t + lane) * 3 + k), v);
+                p[k * 3 + 0][lane] = v[0];
+                p[k * 3 + 1][lane] = v[1];
+                p[k * 3 + 2][lane] = v[2];
+            }
+        }
+        __m128 ax = _mm_load_ps(p[0]), ay = _mm_load_ps(p[1]), az = _mm_load_ps(p[2]);
+        __m128 e1x = _mm_sub_ps(_mm_load_ps(p[3]), ax);
+        __m128 e1y = _mm_sub_ps(_mm_load_ps(p[4]), ay);
+        __m128 e1z = _mm_sub_ps(_mm_load_ps(p[5]), az);
+        __m128 e2x = _mm_sub_ps(_mm_load_ps(p[6]), ax);
+        __m128 e2y = _mm_sub_ps(_mm_load_ps(p[7]), ay);
+        __m128 e2z = _mm_sub_ps(_mm_load_ps(p[8]), az);
+        __m128 nx = _mm_sub_ps(_mm_mul_ps(e1y, e2z), _mm_mul_ps(e1z, e2y));
+        __m128 ny = _mm_sub_ps(_mm_mul_ps(e1z, e2x), _mm_mul_ps(e1x, e2z));
+        __m128 nz = _mm_sub_ps(_mm_mul_ps(e1x, e2y), _mm_mul_ps(e1y, e2x));
+        __m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, nx), _mm_mul_ps(ny, ny)), _mm_mul_ps(nz, nz)));
+        // 退化三角形的法线写 0，避免除零产生 NaN
+        __m128 valid = _mm_cmpgt_ps(len, _mm_setzero_ps());
+        __m128 inv = _mm_and_ps(_mm_div_ps(_mm_set1_ps(1.0f), len), valid);
+        _mm_store_ps(n[0], _mm_mul_ps(nx, inv));
+        _mm_store_ps(n[1], _mm_mul_ps(ny, inv));
+        _mm_store_ps(n[2], _mm_mul_ps(nz, inv));
+
+        for (int lane = 0; lane < 4; ++lane) {
+            float record[12] = {
+                n[0][lane], n[1][lane], n[2][lane],
+                p[0][lane], p[1][lane], p[2][lane],
+                p[3][lane], p[4][lane], p[5][lane],
+                p[6][lane], p[7][lane], p[8][lane],
+            };
+            char* dst = out + (t + lane) * kStlFacetSize;
+            std::memcpy(dst, record, sizeof(record));
+            std::memset(dst + sizeof(record), 0, 2);
+        }
+    }
+#endif
+    for (; t < end; ++t) {
+        float record[12];
+        mesh.position(mesh.index(t * 3 + 0), record + 3);
+        mesh.position(mesh.index(t * 3 + 1), record + 6);
+        mesh.position(mesh.index(t * 3 + 2), record + 9);
+        float e1[3] = { record[6] - record[3], record[7] - record[4], record[8] - record[5] };
+        float e2[3] = { record[9] - record[3], record[10] - record[4], record[11] - record[5] };
+        record[0] = e1[1] * e2[2] - e1[2] * e2[1];
+        record[1] = e1[2] * e2[0] - e1[0] * e2[2];
+        record[2] = e1[0] * e2[1] - e1[1] * e2[0];
+        float len = std::sqrt(record[0] * record[0] + record[1] * record[1] + record[2] * record[2]);
+        float inv = len > 0.0f ? 1.0f / len : 0.0f;
+        record[0] *= inv;
+        record[1] *= inv;
+        record[2] *= inv;
+        char* dst = out + t * kStlFacetSize;
+        std::memcpy(dst, record, sizeof(record));
+        std::memset(dst + sizeof(record), 0, 2);
+    }
+}
+
+}
+
+/**
+ * @brief 导出二进制 STL，面法线由顶点实际计算
+ *
+ * @param mesh 网格视图，支持任意 stride / offset 的交错顶点
+ * @param path 输出文件路径
+ * @return 是否写入成功
+ */
+inline bool exportSTL(const MeshView& mesh, const std::filesystem::path& path) {
+    const std::size_t triangles = mesh.triangleCount();
+    if (triangles > UINT32_MAX) {
+        std::cerr << "STL 最多支持 2^32-1 个三角形: " << path.string() << std::endl;
+        return false;
+    }
+    const std::size_t size = detail::kStlHeaderSize + triangles * detail::kStlFacetSize;
+    bool ok = writeSizedFile(path, size, [&](char* out) {
+        char header[80]{};
+        std::memcpy(header, "glutils binary STL", 18);
+        std::memcpy(out, header, sizeof(header));
+        auto count = static_cast<std::uint32_t>(triangles);
+        std::memcpy(out + 80, &count, sizeof(count));
+        char* facets = out + detail::kStlHeaderSize;
+        parallelFor(triangles, detail::kExportGrain, [&](std::size_t begin, std::size_t end) {
+            detail::writeStlFacets(mesh, begin, end, facets);
+        });
+    });
+    if (!ok)
+        std::cerr << "无法写入 STL 文件: " << path.string() << std::endl;
+    return ok;
+}
+
+/**
+ * @brief 导出二进制（小端）PLY：顶点只含位置，面为 uchar 计数 + int 索引列表
+ *
+ * 没有索引的网格按三角形汤处理，顶点按原顺序输出。
+ */
+inline bool exportPLY(const MeshView& mesh, const std::filesystem::path& path) {
+    const std::size_t triangles = mesh.triangleCount();
+    const std::size_t vertices = mesh.indices ? mesh.vertexCount : triangles * 3;
+    const std::string header =
+        "ply\n"
+        "format binary_little_endian 1.0\n"
+        "comment glutils\n"
+        "element vertex " + std::to_string(vertices) + "\n"
+        "property float x\n"
+        "property float y\n"
+        "property float z\n"
+        "element face " + std::to_string(triangles) + "\n"
+        "property list uchar int vertex_indices\n"
+        "end_header\n";
+    constexpr std::size_t vertexSize = 3 * sizeof(float);
+    constexpr std::size_t faceSize = 1 + 3 * sizeof(std::int32_t);
+    const std::size_t size = header.size() + vertices * vertexSize + triangles * faceSize;
+
+    bool ok = writeSizedFile(path, size, [&](char* out) {
+        std::memcpy(out, header.data(), header.size());
+        char* vertexOut = out + header.size();
+        char* faceOut = vertexOut + vertices * vertexSize;
+        parallelFor(vertices, detail::kExportGrain, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t v = begin; v < end; ++v) {
+                float p[3];
+                mesh.position(static_cast<unsigned int>(v), p);
+                std::memcpy(vertexOut + v * vertexSize, p, vertexSize);
+            }
+        });
+        parallelFor(triangles, detail::kExportGrain, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t t = begin; t < end; ++t) {
+                char* dst = faceOut + t * faceSize;
+                dst[0] = 3;
+                std::int32_t face[3] = {
+                    static_cast<std::int32_t>(mesh.index(t * 3 + 0)),
+                    static_cast<std::int32_t>(mesh.index(t * 3 + 1)),
+                    static_cast<std::int32_t>(mesh.index(t * 3 + 2)),
+                };
+                std::memcpy(dst + 1, face, sizeof(face));
+            }
+        });
+    });
+    if (!ok)
+        std::cerr << "无法写入 PLY 文件: " << path.string() << std::endl;
+    return ok;
+}
+
+}
@@ -0,0 +1,746 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "MappedFile.hpp"
+#include "MeshExporter.hpp"
+#include "MeshOptimizer.hpp"
+#include "Parallel.hpp"
+
+namespace glutils {
+
+// 加载得到的网格统一为 { Position(3), Normal(3) } 交错顶点
+inline Mesh makePositionNormalMesh() {
+    Mesh mesh;
+    mesh.vertexFloats = 6;
+    mesh.attributes = { { AttributeKind::Position, 3, 0 }, { AttributeKind::Normal, 3, 3 } };
+    return mesh;
+}
+
+namespace detail {
+
+// 小于该大小的文本不切分；每段至少这么大，线程领取的开销可以忽略
+inline constexpr std::size_t kParseChunkBytes = 1 << 20;
+inline constexpr std::size_t kMeshGrain = 1 << 15;
+
+// 叉积长度是三角形面积的两倍，不归一化即为面积加权
+inline void faceNormal(const float* a, const float* b, const float* c, float out[3]) {
+    const float e1[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+    const float e2[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+    out[0] = e1[1] * e2[2] - e1[2] * e2[1];
+    out[1] = e1[2] * e2[0] - e1[0] * e2[2];
+    out[2] = e1[0] * e2[1] - e1[1] * e2[0];
+}
+
+}
+
+/**
+ * @brief 按面积加权累加相邻三角形的面法线，得到平滑顶点法线
+ *
+ * mesh 必须带 Position 和 Normal 属性；没有被任何三角形引用的顶点法线为 (0, 0, 1)。
+ * 面法线和逐顶点求和并行计算；顶点到三角形的邻接表按三角形序号排列，每个顶点的累加顺序固定，
+ * 结果与线程数无关，也与逐三角形累加的串行写法逐位一致。
+ */
+inline void computeSmoothNormals(Mesh& mesh) {
+    const MeshAttribute* position = mesh.find(AttributeKind::Position);
+    const MeshAttribute* normal = mesh.find(AttributeKind::Normal);
+    if (!position || !normal)
+        return;
+    const std::size_t stride = mesh.vertexFloats, p = position->offset, n = normal->offset;
+    const std::size_t vertexCount = mesh.vertexCount(), triangles = mesh.indices.size() / 3;
+    float* vertices = mesh.vertices.data();
+    const std::uint32_t* indices = mesh.indices.data();
+
+    std::vector<float> faces(triangles * 3);
+    parallelFor(triangles, detail::kMeshGrain, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t t = begin; t < end; ++t)
+            detail::faceNormal(&vertices[indices[t * 3 + 0] * stride + p], &vertices[indices[t * 3 + 1] * stride + p],
+                               &vertices[indices[t * 3 + 2] * stride + p], &faces[t * 3]);
+    });
+
+    // 顶点 -> 三角形邻接表（CSR）：两趟计数 + 填充，只是顺序读写索引
+    std::vector<std::uint32_t> offsets(vertexCount + 1, 0);
+    for (std::size_t i = 0; i < triangles * 3; ++i)
+        ++offsets[indices[i] + 1];
+    for (std::size_t v = 0; v < vertexCount; ++v)
+        offsets[v + 1] += offsets[v];
+    std::vector<std::uint32_t> adjacent(triangles * 3), cursor(offsets.begin(), offsets.end() - 1);
+    for (std::size_t i = 0; i < triangles * 3; ++i)
+        adjacent[cursor[indices[i]]++] = static_cast<std::uint32_t>(i / 3);
+
+    parallelFor(vertexCount, detail::kMeshGrain, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t v = begin; v < end; ++v) {
+            float* dst = &vertices[v * stride + n];
+            float sum[3] = { 0.0f, 0.0f, 0.0f };
+            for (std::uint32_t k = offsets[v]; k < offsets[v + 1]; ++k) {
+                const float* face = &faces[adjacent[k] * 3];
+                sum[0] += face[0];
+                sum[1] += face[1];
+                sum[2] += face[2];
+            }
+            const float length = std::sqrt(sum[0] * sum[0] + sum[1] * sum[1] + sum[2] * sum[2]);
+            if (length > 0.0f) {
+                dst[0] = sum[0] / length;
+                dst[1] = sum[1] / length;
+                dst[2] = sum[2] / length;
+            } else {
+                dst[0] = dst[1] = 0.0f;
+                dst[2] = 1.0f;
+            }
+        }
+    });
+}
+
+/**
+ * @brief 丢弃文件中的法线，按位置合并顶点后重新计算平滑法线
+ *
+ * STL 之类的三角形汤每个三角形有独立的顶点和面法线，直接渲染是平直着色；合并后相邻三角形共享顶点，
+ * 法线才能平滑过渡。mesh 必须是 makePositionNormalMesh 的布局。
+ */
+inline void smoothMeshNormals(Mesh& mesh) {
+    const MeshAttribute* normal = mesh.find(AttributeKind::Normal);
+    if (!normal)
+        return;
+    const std::size_t stride = mesh.vertexFloats, n = normal->offset;
+    parallelFor(mesh.vertexCount(), detail::kMeshGrain, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t v = begin; v < end; ++v)
+            std::fill_n(&mesh.vertices[v * stride + n], 3, 0.0f);
+    });
+    weldVertices(mesh);
+    computeSmoothNormals(mesh);
+}
+
+namespace detail {
+
+inline const char* skipSpaces(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+        ++p;
+    return p;
+}
+
+inline bool parseFloats(const char*& p, const char* end, float* out, int count) {
+    for (int i = 0; i < count; ++i) {
+        p = skipSpaces(p, end);
+        if (p < end && *p == '+')
+            ++p;
+        auto [next, ec] = std::from_chars(p, end, out[i]);
+        if (ec != std::errc())
+            return false;
+        p = next;
+    }
+    return true;
+}
+
+/**
+ * @brief 把 [begin, end) 切成若干段，切分点向后对齐到行首，段数随文件大小和线程数增加
+ *
+ * isBoundary 不为空时，切分点继续向后移到它接受的第一行（例如 STL 的 "facet" 行），保证记录不跨段。
+ */
+template<typename Boundary>
+std::vector<const char*> splitLines(const char* begin, const char* end, Boundary&& isBoundary) {
+    const std::size_t bytes = static_cast<std::size_t>(end - begin);
+    const std::size_t parts = std::max<std::size_t>(1, std::min<std::size_t>(workerCount() * 4, bytes / kParseChunkBytes));
+    std::vector<const char*> cuts(parts + 1);
+    cuts[0] = begin;
+    cuts[parts] = end;
+    for (std::size_t i = 1; i < parts; ++i) {
+        const char* cut = std::max(cuts[i - 1], begin + bytes * i / parts);
+        while (cut < end) {
+            const char* nl = static_cast<const char*>(std::memchr(cut, '\n', static_cast<std::size_t>(end - cut)));
+            cut = nl ? nl + 1 : end;
+            if (cut < end && isBoundary(cut, end))
+                break;
+        }
+        cuts[i] = cut;
+    }
+    return cuts;
+}
+
+inline std::vector<const char*> splitLines(const char* begin, const char* end) {
+    return splitLines(begin, end, [](const char*, const char*) { return true; });
+}
+
+// OBJ 面的一个角：位置 / 法线下标（从 0 开始，法线为 -1 表示没有）；负下标先按本段已读的数量解析，标记为相对
+struct ObjCorner {
+    std::int64_t position = 0;
+    std::int64_t normal = -1;
+    bool positionRelative = false;
+    bool normalRelative = false;
+};
+
+struct ObjChunk {
+    std::vector<float> positions;
+    std::vector<float> normals;
+    // 扇形三角化后的角，每三个一个三角形
+    std::vector<ObjCorner> corners;
+    bool ok = true;
+};
+
+inline bool parseObjChunk(const char* p, const char* end, ObjChunk& chunk) {
+    std::vector<ObjCorner> polygon;
+    auto resolve = [](long long index, std::size_t count, bool& relative) -> std::int64_t {
+        relative = index < 0;
+        return index < 0 ? static_cast<std::int64_t>(count) + index : index - 1;
+    };
+    while (p < end) {
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', static_cast<std::size_t>(end - p)));
+        const char* lineEnd = nl ? nl : end;
+        const char* cursor = skipSpaces(p, lineEnd);
+        if (lineEnd - cursor >= 2 && cursor[0] == 'v' && (cursor[1] == ' ' || cursor[1] == '\t')) {
+            float xyz[3];
+            cursor += 2;
+            if (!parseFloats(cursor, lineEnd, xyz, 3))
+                return false;
+            chunk.positions.insert(chunk.positions.end(), xyz, xyz + 3);
+        } else if (lineEnd - cursor >= 3 && cursor[0] == 'v' && cursor[1] == 'n') {
+            float xyz[3];
+            cursor += 2;
+            if (!parseFloats(cursor, lineEnd, xyz, 3))
+                return false;
+            chunk.normals.insert(chunk.normals.end(), xyz, xyz + 3);
+        } else if (lineEnd - cursor >= 2 && cursor[0] == 'f' && (cursor[1] == ' ' || cursor[1] == '\t')) {
+            cursor += 2;
+            polygon.clear();
+            // 解析 "v"、"v/t"、"v//n"、"v/t/n"，下标可以为负（相对末尾）
+            while ((cursor = skipSpaces(cursor, lineEnd)) < lineEnd) {
+                long long v = 0, n = 0;
+                auto [next, ec] = std::from_chars(cursor, lineEnd, v);
+                if (ec != std::errc() || v == 0)
+                    return false;
+                cursor = next;
+                if (cursor < lineEnd && *cursor == '/') {
+                    ++cursor;
+                    long long ignored = 0;
+                    if (cursor < lineEnd && *cursor != '/')
+                        cursor = std::from_chars(cursor, lineEnd, ignored).ptr;
+                    if (cursor < lineEnd && *cursor == '/')
+                        cursor = std::from_chars(cursor + 1, lineEnd, n).ptr;
+                }
+                ObjCorner corner;
+                corner.position = resolve(v, chunk.positions.size() / 3, corner.positionRelative);
+                if (n)
+                    corner.normal = resolve(n, chunk.normals.size() / 3, corner.normalRelative);
+                polygon.push_back(corner);
+                while (cursor < lineEnd && *cursor != ' ' && *cursor != '\t' && *cursor != '\r')
+                    ++cursor;
+            }
+            for (std::size_t k = 2; k < polygon.size(); ++k)
+                chunk.corners.insert(chunk.corners.end(), { polygon[0], polygon[k - 1], polygon[k] });
+        }
+        p = lineEnd + 1;
+    }
+    return true;
+}
+
+/**
+ * @brief 并行解析 Wavefront OBJ 的 v / vn / f 行，多边形按扇形三角化
+ *
+ * 文本按行切段并行解析，各段的相对下标在拼接时按前面各段的数量修正。
+ * 顶点按 (位置下标, 法线下标) 去重，编号按第一次被面引用的顺序，与逐行串行解析的结果相同；
+ * 文件没有法线时计算平滑法线。纹理坐标、材质、分组被忽略。
+ */
+inline bool loadObj(const char* data, std::size_t size, Mesh& out) {
+    const std::vector<const char*> cuts = splitLines(data, data + size);
+    std::vector<ObjChunk> chunks(cuts.size() - 1);
+    parallelFor(chunks.size(), 1, [&](std::size_t first, std::size_t last) {
+        for (std::size_t c = first; c < last; ++c)
+            chunks[c].ok = parseObjChunk(cuts[c], cuts[c + 1], chunks[c]);
+    });
+
+    std::vector<float> positions, normals;
+    std::vector<ObjCorner> corners;
+    std::size_t positionTotal = 0, normalTotal = 0, cornerTotal = 0;
+    for (const ObjChunk& chunk : chunks) {
+        if (!chunk.ok)
+            return false;
+        positionTotal += chunk.positions.size();
+        normalTotal += chunk.normals.size();
+        cornerTotal += chunk.corners.size();
+    }
+    positions.reserve(positionTotal);
+    normals.reserve(normalTotal);
+    corners.reserve(cornerTotal);
+    for (ObjChunk& chunk : chunks) {
+        const std::int64_t positionBase = static_cast<std::int64_t>(positions.size() / 3);
+        const std::int64_t normalBase = static_cast<std::int64_t>(normals.size() / 3);
+        for (ObjCorner& corner : chunk.corners) {
+            corner.position += corner.positionRelative ? positionBase : 0;
+            corner.normal += corner.normalRelative ? normalBase : 0;
+        }
+        positions.insert(positions.end(), chunk.positions.begin(), chunk.positions.end());
+        normals.insert(normals.end(), chunk.normals.begin(), chunk.normals.end());
+        corners.insert(corners.end(), chunk.corners.begin(), chunk.corners.end());
+        chunk = ObjChunk();
+    }
+
+    const std::int64_t positionCount = static_cast<std::int64_t>(positions.size() / 3);
+    const std::int64_t normalCount = static_cast<std::int64_t>(normals.size() / 3);
+    bool missingNormals = false;
+    for (const ObjCorner& corner : corners) {
+        if (corner.position < 0 || corner.position >= positionCount || corner.normal >= normalCount || (corner.normalRelative && corner.normal < 0))
+            return false;
+        missingNormals |= corner.normal < 0;
+    }
+
+    // 去重：第一次出现时分配新编号，顶点数据随后并行拷贝
+    std::vector<std::uint32_t> sources;
+    out.indices.resize(corners.size());
+    if (normals.empty()) {
+        // 只有位置时键就是位置下标，用平铺数组代替哈希表
+        std::vector<std::uint32_t> remap(static_cast<std::size_t>(positionCount), UINT32_MAX);
+        for (std::size_t i = 0; i < corners.size(); ++i) {
+            std::uint32_t& id = remap[static_cast<std::size_t>(corners[i].position)];
+            if (id == UINT32_MAX) {
+                id = static_cast<std::uint32_t>(sources.size());
+                sources.push_back(static_cast<std::uint32_t>(i));
+            }
+            out.indices[i] = id;
+        }
+    } else {
+        std::unordered_map<std::uint64_t, std::uint32_t> remap;
+        for (std::size_t i = 0; i < corners.size(); ++i) {
+            const std::uint64_t key = (static_cast<std::uint64_t>(corners[i].position) << 32) | static_cast<std::uint32_t>(corners[i].normal + 1);
+            auto [it, inserted] = remap.try_emplace(key, static_cast<std::uint32_t>(sources.size()));
+            if (inserted)
+                sources.push_back(static_cast<std::uint32_t>(i));
+            out.indices[i] = it->second;
+        }
+    }
+    out.vertices.resize(sources.size() * 6);
+    parallelFor(sources.size(), kMeshGrain, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t v = begin; v < end; ++v) {
+            const ObjCorner& corner = corners[sources[v]];
+            float* dst = &out.vertices[v * 6];
+            std::memcpy(dst, &positions[static_cast<std::size_t>(corner.position) * 3], 3 * sizeof(float));
+            if (corner.normal >= 0)
+                std::memcpy(dst + 3, &normals[static_cast<std::size_t>(corner.normal) * 3], 3 * sizeof(float));
+            else
+                std::fill_n(dst + 3, 3, 0.0f);
+        }
+    });
+    if (missingNormals)
+        computeSmoothNormals(out);
+    return true;
+}
+
+// STL 三角形的三个顶点写到 dst（18 个 float）；面法线为零向量时（不少导出器如此）由顶点重新计算
+inline void writeStlTriangle(const float normal[3], const float* v0, const float* v1, const float* v2, float* dst) {
+    float n[3] = { normal[0], normal[1], normal[2] };
+    if (n[0] == 0.0f && n[1] == 0.0f && n[2] == 0.0f) {
+        faceNormal(v0, v1, v2, n);
+        const float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        for (float& c : n)
+            c = length > 0.0f ? c / length : 0.0f;
+    }
+    for (const float* v : { v0, v1, v2 }) {
+        std::memcpy(dst, v, 3 * sizeof(float));
+        std::memcpy(dst + 3, n, 3 * sizeof(float));
+        dst += 6;
+    }
+}
+
+inline bool parseAsciiStl(const char* p, const char* end, std::vector<float>& out) {
+    float normal[3] = {}, corners[9];
+    int corner = 0;
+    while (p < end) {
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', static_cast<std::size_t>(end - p)));
+        const char* lineEnd = nl ? nl : end;
+        const char* cursor = skipSpaces(p, lineEnd);
+        const std::string_view line(cursor, static_cast<std::size_t>(lineEnd - cursor));
+        if (line.starts_with("facet normal")) {
+            cursor += 12;
+            if (!parseFloats(cursor, lineEnd, normal, 3))
+                return false;
+            corner = 0;
+        } else if (line.starts_with("vertex")) {
+            cursor += 6;
+            if (corner >= 3 || !parseFloats(cursor, lineEnd, corners + corner * 3, 3))
+                return false;
+            if (++corner == 3) {
+                out.resize(out.size() + 18);
+                writeStlTriangle(normal, corners, corners + 3, corners + 6, &out[out.size() - 18]);
+            }
+        }
+        p = lineEnd + 1;
+    }
+    return true;
+}
+
+/**
+ * @brief 并行解析 STL（二进制或 ASCII），每个三角形三个独立顶点，法线取文件中的面法线
+ *
+ * 二进制按三角形并行解码；ASCII 按 "facet" 行切段并行解析后按顺序拼接。
+ */
+inline bool loadStl(const char* data, std::size_t size, Mesh& out) {
+    std::uint32_t triangles = 0;
+    if (size >= kStlHeaderSize)
+        std::memcpy(&triangles, data + 80, sizeof(triangles));
+    // ASCII 文件同样以 "solid" 开头，所以按长度判断是否为二进制
+    if (size >= kStlHeaderSize && size == kStlHeaderSize + std::size_t{triangles} * kStlFacetSize) {
+        out.vertices.resize(std::size_t{triangles} * 18);
+        parallelFor(triangles, kMeshGrain, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t t = begin; t < end; ++t) {
+                float facet[12];
+                std::memcpy(facet, data + kStlHeaderSize + t * kStlFacetSize, sizeof(facet));
+                writeStlTriangle(facet, facet + 3, facet + 6, facet + 9, &out.vertices[t * 18]);
+            }
+        });
+    } else {
+        const std::vector<const char*> cuts = splitLines(data, data + size, [](const char* line, const char* end) {
+            line = skipSpaces(line, end);
+            return std::string_view(line, static_cast<std::size_t>(end - line)).starts_with("facet");
+        });
+        std::vector<std::vector<float>> partial(cuts.size() - 1);
+        std::vector<char> ok(partial.size(), 1);
+        parallelFor(partial.size(), 1, [&](std::size_t first, std::size_t last) {
+            for (std::size_t c = first; c < last; ++c)
+                ok[c] = parseAsciiStl(cuts[c], cuts[c + 1], partial[c]);
+        });
+        std::size_t total = 0;
+        for (std::size_t c = 0; c < partial.size(); ++c) {
+            if (!ok[c])
+                return false;
+            total += partial[c].size();
+        }
+        out.vertices.reserve(total);
+        for (const auto& part : partial)
+            out.vertices.insert(out.vertices.end(), part.begin(), part.end());
+    }
+    out.indices.resize(out.vertexCount());
+    std::iota(out.indices.begin(), out.indices.end(), 0u);
+    return true;
+}
+
+enum class PlyType : std::uint8_t { Invalid, Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32, Float64 };
+
+inline PlyType plyType(std::string_view name) {
+    if (name == "char" || name == "int8") return PlyType::Int8;
+    if (name == "uchar" || name == "uint8") return PlyType::UInt8;
+    if (name == "short" || name == "int16") return PlyType::Int16;
+    if (name == "ushort" || name == "uint16") return PlyType::UInt16;
+    if (name == "int" || name == "int32") return PlyType::Int32;
+    if (name == "uint" || name == "uint32") return PlyType::UInt32;
+    if (name == "float" || name == "float32") return PlyType::Float32;
+    if (name == "double" || name == "float64") return PlyType::Float64;
+    return PlyType::Invalid;
+}
+
+inline std::size_t plySize(PlyType type) {
+    constexpr std::size_t sizes[] = { 0, 1, 1, 2, 2, 4, 4, 4, 8 };
+    return sizes[static_cast<std::size_t>(type)];
+}
+
+// 读取小端二进制标量
+template<typename T>
+T readPly(PlyType type, const char* p) {
+    auto load = [p]<typename U>(U value) {
+        std::memcpy(&value, p, sizeof(U));
+        return static_cast<T>(value);
+    };
+    switch (type) {
+    case PlyType::Int8: return load(std::int8_t{});
+    case PlyType::UInt8: return load(std::uint8_t{});
+    case PlyType::Int16: return load(std::int16_t{});
+    case PlyType::UInt16: return load(std::uint16_t{});
+    case PlyType::Int32: return load(std::int32_t{});
+    case PlyType::UInt32: return load(std::uint32_t{});
+    case PlyType::Float32: return load(float{});
+    case PlyType::Float64: return load(double{});
+    default: return T{};
+    }
+}
+
+struct PlyProperty {
+    std::string name;
+    PlyType type = PlyType::Invalid;
+    // 列表属性：type 为元素类型，countType 为个数类型
+    PlyType countType = PlyType::Invalid;
+};
+
+struct PlyElement {
+    std::string name;
+    std::size_t count = 0;
+    std::vector<PlyProperty> properties;
+
+    int find(std::string_view property) const {
+        for (std::size_t i = 0; i < properties.size(); ++i)
+            if (properties[i].name == property)
+                return static_cast<int>(i);
+        return -1;
+    }
+};
+
+// 二进制 face 元素按块并行解码：串行扫描只读取每个面的个数、记下块起点，然后各块独立写出三角形
+inline constexpr std::size_t kPlyFaceBlock = 1 << 14;
+
+/**
+ * @brief 解析 PLY 网格（ascii / binary_little_endian），vertex 需要 x/y/z，可选 nx/ny/nz；face 为顶点下标列表，按扇形三角化
+ *
+ * 顶点和面都并行解码；文件没有法线时计算平滑法线。其他元素被跳过（二进制时不能含列表属性）。
+ */
+inline bool loadPly(const char* data, std::size_t size, Mesh& out) {
+    const char* end = data + size;
+    const char* p = data;
+    std::string format;
+    std::vector<PlyElement> elements;
+    const char* body = nullptr;
+    while (p < end) {
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', static_cast<std::size_t>(end - p)));
+        std::string_view line(p, static_cast<std::size_t>((nl ? nl : end) - p));
+        if (!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+        p = nl ? nl + 1 : end;
+        if (line == "end_header") {
+            body = p;
+            break;
+        }
+        std::vector<std::string_view> tokens;
+        for (std::size_t i = 0; i < line.size();) {
+            std::size_t j = line.find(' ', i);
+            if (j == std::string_view::npos) j = line.size();
+            if (j > i) tokens.push_back(line.substr(i, j - i));
+            i = j + 1;
+        }
+        if (tokens.empty())
+            continue;
+        if (tokens[0] == "format" && tokens.size() > 1) {
+            format = tokens[1];
+        } else if (tokens[0] == "element" && tokens.size() > 2) {
+            PlyElement& element = elements.emplace_back();
+            element.name = tokens[1];
+            std::from_chars(tokens[2].data(), tokens[2].data() + tokens[2].size(), element.count);
+        } else if (tokens[0] == "property" && !elements.empty()) {
+            PlyProperty property;
+            if (tokens.size() > 4 && tokens[1] == "list") {
+                property.countType = plyType(tokens[2]);
+                property.type = plyType(tokens[3]);
+                property.name = tokens[4];
+            } else if (tokens.size() > 2) {
+                property.type = plyType(tokens[1]);
+                property.name = tokens[2];
+            }
+            if (property.type == PlyType::Invalid || (tokens[1] == "list" && property.countType == PlyType::Invalid))
+                return false;
+            elements.back().properties.push_back(std::move(property));
+        }
+    }
+    const bool binary = format == "binary_little_endian";
+    if (!body || (!binary && format != "ascii"))
+        return false;
+
+    std::vector<float> vertices;
+    bool hasNormals = false;
+    bool ok = true;
+    for (const PlyElement& element : elements) {
+        const bool isVertex = element.name == "vertex", isFace = element.name == "face";
+        if (binary) {
+            std::size_t stride = 0;
+            for (const PlyProperty& property : element.properties)
+                stride += property.countType == PlyType::Invalid ? plySize(property.type) : 0;
+            const bool hasList = std::any_of(element.properties.begin(), element.properties.end(),
+                                             [](const PlyProperty& property) { return property.countType != PlyType::Invalid; });
+            if (isVertex) {
+                if (hasList)
+                    return false;
+                int columns[6];
+                std::size_t offsets[6] = {};
+                constexpr const char* names[6] = { "x", "y", "z", "nx", "ny", "nz" };
+                for (int a = 0; a < 6; ++a) {
+                    columns[a] = element.find(names[a]);
+                    for (int k = 0; k < columns[a]; ++k)
+                        offsets[a] += plySize(element.properties[k].type);
+                }
+                if (columns[0] < 0 || columns[1] < 0 || columns[2] < 0 || static_cast<std::size_t>(end - body) < element.count * stride)
+                    return false;
+                hasNormals = columns[3] >= 0 && columns[4] >= 0 && columns[5] >= 0;
+                const int read = hasNormals ? 6 : 3;
+                vertices.assign(element.count * 6, 0.0f);
+                parallelFor(element.count, kMeshGrain, [&](std::size_t begin, std::size_t last) {
+                    for (std::size_t v = begin; v < last; ++v) {
+                        const char* record = body + v * stride;
+                        for (int a = 0; a < read; ++a)
+                            vertices[v * 6 + a] = readPly<float>(element.properties[columns[a]].type, record + offsets[a]);
+                    }
+                });
+                body += element.count * stride;
+            } else if (isFace) {
+                // 只支持只有一个列表属性的 face（最常见的 vertex_indices / vertex_index）
+                if (element.properties.size() != 1 || !hasList)
+                    return false;
+                const PlyProperty& list = element.properties[0];
+                const std::size_t countBytes = plySize(list.countType), indexBytes = plySize(list.type);
+                std::vector<const char*> blockStarts;
+                std::vector<std::size_t> blockTriangles(1, 0);
+                const char* cursor = body;
+                for (std::size_t f = 0; f < element.count; ++f) {
+                    if (f % kPlyFaceBlock == 0) {
+                        blockStarts.push_back(cursor);
+                        blockTriangles.push_back(blockTriangles.back());
+                    }
+                    if (static_cast<std::size_t>(end - cursor) < countBytes)
+                        return false;
+                    const std::size_t corners = readPly<std::size_t>(list.countType, cursor);
+                    cursor += countBytes + corners * indexBytes;
+                    if (cursor > end)
+                        return false;
+                    blockTriangles.back() += corners > 2 ? corners - 2 : 0;
+                }
+                out.indices.resize(blockTriangles.back() * 3);
+                parallelFor(blockStarts.size(), 1, [&](std::size_t first, std::size_t last) {
+                    for (std::size_t b = first; b < last; ++b) {
+                        const char* face = blockStarts[b];
+                        std::uint32_t* dst = &out.indices[blockTriangles[b] * 3];
+                        const std::size_t faces = std::min(kPlyFaceBlock, element.count - b * kPlyFaceBlock);
+                        for (std::size_t f = 0; f < faces; ++f) {
+                            const std::size_t corners = readPly<std::size_t>(list.countType, face);
+                            const char* indices = face + countBytes;
+                            const std::uint32_t pivot = readPly<std::uint32_t>(list.type, indices);
+                            for (std::size_t k = 2; k < corners; ++k) {
+                                *dst++ = pivot;
+                                *dst++ = readPly<std::uint32_t>(list.type, indices + (k - 1) * indexBytes);
+                                *dst++ = readPly<std::uint32_t>(list.type, indices + k * indexBytes);
+                            }
+                            face = indices + corners * indexBytes;
+                        }
+                    }
+                });
+                body = cursor;
+            } else {
+                if (hasList)
+                    return false;
+                body += element.count * stride;
+            }
+            if (body > end)
+                return false;
+            continue;
+        }
+
+        // ASCII：先找到本元素占据的行，再按行切段并行解析
+        const char* elementEnd = body;
+        for (std::size_t line = 0; line < element.count && elementEnd < end; ++line) {
+            const char* nl = static_cast<const char*>(std::memchr(elementEnd, '\n', static_cast<std::size_t>(end - elementEnd)));
+            elementEnd = nl ? nl + 1 : end;
+        }
+        if (isVertex) {
+            if (element.properties.size() > 16 || element.find("x") < 0 || element.find("y") < 0 || element.find("z") < 0)
+                return false;
+            int columns[6];
+            constexpr const char* names[6] = { "x", "y", "z", "nx", "ny", "nz" };
+            for (int a = 0; a < 6; ++a)
+                columns[a] = element.find(names[a]);
+            hasNormals = columns[3] >= 0 && columns[4] >= 0 && columns[5] >= 0;
+            const std::vector<const char*> cuts = splitLines(body, elementEnd);
+            std::vector<std::vector<float>> partial(cuts.size() - 1);
+            std::vector<char> partOk(partial.size(), 1);
+            parallelFor(partial.size(), 1, [&](std::size_t first, std::size_t last) {
+                for (std::size_t c = first; c < last; ++c) {
+                    for (const char* line = cuts[c]; line < cuts[c + 1];) {
+                        const char* nl = static_cast<const char*>(std::memchr(line, '\n', static_cast<std::size_t>(cuts[c + 1] - line)));
+                        const char* lineEnd = nl ? nl : cuts[c + 1];
+                        float values[16], vertex[6] = {};
+                        const char* cursor = line;
+                        if (!parseFloats(cursor, lineEnd, values, static_cast<int>(element.properties.size()))) {
+                            partOk[c] = 0;
+                            break;
+                        }
+                        for (int a = 0; a < (hasNormals ? 6 : 3); ++a)
+                            vertex[a] = values[columns[a]];
+                        partial[c].insert(partial[c].end(), vertex, vertex + 6);
+                        line = lineEnd + 1;
+                    }
+                }
+            });
+            for (std::size_t c = 0; c < partial.size(); ++c) {
+                ok &= partOk[c] != 0;
+                vertices.insert(vertices.end(), partial[c].begin(), partial[c].end());
+            }
+            ok &= vertices.size() == element.count * 6;
+        } else if (isFace) {
+            if (element.properties.empty() || element.properties[0].countType == PlyType::Invalid)
+                return false;
+            const std::vector<const char*> cuts = splitLines(body, elementEnd);
+            std::vector<std::vector<std::uint32_t>> partial(cuts.size() - 1);
+            std::vector<char> partOk(partial.size(), 1);
+            parallelFor(partial.size(), 1, [&](std::size_t first, std::size_t last) {
+                for (std::size_t c = first; c < last; ++c) {
+                    std::vector<std::uint32_t> polygon;
+                    for (const char* line = cuts[c]; line < cuts[c + 1];) {
+                        const char* nl = static_cast<const char*>(std::memchr(line, '\n', static_cast<std::size_t>(cuts[c + 1] - line)));
+                        const char* lineEnd = nl ? nl : cuts[c + 1];
+                        const char* cursor = skipSpaces(line, lineEnd);
+                        std::size_t corners = 0;
+                        std::from_chars_result result = std::from_chars(cursor, lineEnd, corners);
+                        polygon.resize(corners);
+                        for (std::size_t k = 0; k < corners && result.ec == std::errc(); ++k)
+                            result = std::from_chars(skipSpaces(result.ptr, lineEnd), lineEnd, polygon[k]);
+                        if (result.ec != std::errc()) {
+                            partOk[c] = 0;
+                            break;
+                        }
+                        for (std::size_t k = 2; k < corners; ++k)
+                            partial[c].insert(partial[c].end(), { polygon[0], polygon[k - 1], polygon[k] });
+                        line = lineEnd + 1;
+                    }
+                }
+            });
+            for (std::size_t c = 0; c < partial.size(); ++c) {
+                ok &= partOk[c] != 0;
+                out.indices.insert(out.indices.end(), partial[c].begin(), partial[c].end());
+            }
+        }
+        body = elementEnd;
+    }
+    const std::size_t vertexCount = vertices.size() / 6;
+    if (!ok || std::any_of(out.indices.begin(), out.indices.end(), [&](std::uint32_t index) { return index >= vertexCount; }))
+        return false;
+    out.vertices = std::move(vertices);
+    if (!hasNormals)
+        computeSmoothNormals(out);
+    return true;
+}
+
+}
+
+/**
+ * @brief 加载网格文件（.obj / .stl / .ply），结果为 { Position, Normal } 交错顶点 + 32 位索引
+ *
+ * 解析按文件大小切段并行进行。
+ */
+inline bool loadMesh(const std::filesystem::path& path, Mesh& out) {
+    MappedFile file;
+    if (!file.openRead(path)) {
+        std::cerr << "无法打开网格文件: " << path.string() << std::endl;
+        return false;
+    }
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    out = makePositionNormalMesh();
+    bool ok;
+    if (ext == ".obj") {
+        ok = detail::loadObj(file.data(), file.size(), out);
+    } else if (ext == ".stl") {
+        ok = detail::loadStl(file.data(), file.size(), out);
+    } else if (ext == ".ply") {
+        ok = detail::loadPly(file.data(), file.size(), out);
+    } else {
+        std::cerr << "不支持的网格格式: " << path.string() << std::endl;
+        return false;
+    }
+    if (!ok)
+        std::cerr << "网格文件格式错误: " << path.string() << std::endl;
+    return ok;
+}
+
+}
@@ -0,0 +1,632 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "GLState.hpp"
+#include "MeshExporter.hpp"
+
+namespace glutils {
+
+enum class AttributeKind { Position, Normal, Color, TexCoord, Generic };
+
+// 交错 float 顶点中的一个属性；location 即在 attributes 中的下标
+struct MeshAttribute {
+    AttributeKind kind = AttributeKind::Generic;
+    int components = 3;
+    // 以 float 为单位的偏移
+    std::size_t offset = 0;
+};
+
+/**
+ * @brief 可修改的索引网格：交错 float 顶点 + 32 位索引
+ *
+ * ExportableCube 的格式即 { Position(3), Color(3) }，vertexFloats = 6。
+ */
+struct Mesh {
+    std::vector<float> vertices;
+    std::size_t vertexFloats = 3;
+    std::vector<MeshAttribute> attributes = { { AttributeKind::Position, 3, 0 } };
+    std::vector<std::uint32_t> indices;
+
+    std::size_t vertexCount() const { return vertexFloats ? vertices.size() / vertexFloats : 0; }
+    std::size_t triangleCount() const { return indices.size() / 3; }
+    std::size_t vertexBytes() const { return vertices.size() * sizeof(float); }
+    std::size_t indexBytes() const { return indices.size() * sizeof(std::uint32_t); }
+
+    const MeshAttribute* find(AttributeKind kind) const {
+        for (const auto& attribute : attributes)
+            if (attribute.kind == kind)
+                return &attribute;
+        return nullptr;
+    }
+
+    // 供 exportSTL / exportPLY 使用，网格必须带 Position 属性
+    MeshView view() const {
+        const MeshAttribute* position = find(AttributeKind::Position);
+        return { vertices.data(), vertexCount(), indices.data(), indices.size(),
+                 { vertexFloats * sizeof(float), (position ? position->offset : 0) * sizeof(float) } };
+    }
+};
+
+// 顶点缓存模拟结果
+struct VertexCacheStats {
+    // 平均每个三角形的缓存未命中数（ACMR），理想值约 0.5，最差 3
+    double acmr = 0.0;
+    // 平均每个顶点被变换的次数（ATVR），理想值 1
+    double atvr = 0.0;
+};
+
+/**
+ * @brief 用 FIFO 顶点缓存模拟顶点着色器的调用次数
+ *
+ * @param cacheSize 缓存大小，16 接近多数桌面 GPU 的实际行为
+ */
+inline VertexCacheStats analyzeVertexCache(const std::vector<std::uint32_t>& indices, std::size_t vertexCount, std::size_t cacheSize = 16) {
+    VertexCacheStats stats;
+    if (indices.empty() || vertexCount == 0)
+        return stats;
+    // 顶点进入缓存时的序号；当前序号与它相差不少于 cacheSize 即已被挤出
+    std::vector<std::size_t> inserted(vertexCount, ~std::size_t{0});
+    std::size_t misses = 0;
+    for (std::uint32_t index : indices) {
+        if (inserted[index] == ~std::size_t{0} || misses - inserted[index] >= cacheSize)
+            inserted[index] = misses++;
+    }
+    stats.acmr = double(misses) / double(indices.size() / 3);
+    stats.atvr = double(misses) / double(vertexCount);
+    return stats;
+}
+
+/**
+ * @brief 估算顶点读取的内存带宽：每次顶点缓存未命中按 64 字节缓存行读取顶点数据
+ *
+ * 读取缓存用 cacheBytes 大小的直接映射缓存模拟。
+ * @return 读取字节数 / 顶点缓冲字节数（overfetch），理想值 1
+ */
+inline double analyzeVertexFetch(const std::vector<std::uint32_t>& indices, std::size_t vertexCount, std::size_t vertexBytes,
+                                 std::size_t cacheSize = 16, std::size_t cacheBytes = 16 * 1024) {
+    constexpr std::size_t kLine = 64;
+    if (indices.empty() || vertexCount == 0 || vertexBytes == 0)
+        return 0.0;
+    std::vector<std::size_t> inserted(vertexCount, ~std::size_t{0});
+    std::vector<std::size_t> lines(cacheBytes / kLine, ~std::size_t{0});
+    std::size_t misses = 0, fetched = 0;
+    for (std::uint32_t index : indices) {
+        if (inserted[index] != ~std::size_t{0} && misses - inserted[index] < cacheSize)
+            continue;
+        inserted[index] = misses++;
+        const std::size_t first = index * vertexBytes / kLine, last = ((index + 1) * vertexBytes - 1) / kLine;
+        for (std::size_t line = first; line <= last; ++line) {
+            std::size_t& slot = lines[line % lines.size()];
+            if (slot != line) {
+                slot = line;
+                fetched += kLine;
+            }
+        }
+    }
+    return double(fetched) / double(vertexCount * vertexBytes);
+}
+
+/**
+ * @brief 合并逐字节相同的顶点（-0.0 与 0.0 视为相同），重写索引
+ *
+ * 没有索引时把顶点按顺序视为三角形列表（STL 之类的三角形汤）。
+ * @return 合并后的顶点数
+ */
+inline std::size_t weldVertices(Mesh& mesh) {
+    const std::size_t count = mesh.vertexCount();
+    const std::size_t stride = mesh.vertexFloats;
+    if (mesh.indices.empty()) {
+        mesh.indices.resize(count);
+        std::iota(mesh.indices.begin(), mesh.indices.end(), 0u);
+    }
+    const float* data = mesh.vertices.data();
+    auto bits = [](float value) {
+        std::uint32_t b;
+        std::memcpy(&b, &value, sizeof(b));
+        return b == 0x80000000u ? 0u : b;
+    };
+    auto hash = [&](std::uint32_t vertex) {
+        std::uint64_t h = 14695981039346656037ull;
+        for (std::size_t k = 0; k < stride; ++k)
+            h = (h ^ bits(data[vertex * stride + k])) * 1099511628211ull;
+        return static_cast<std::size_t>(h ^ (h >> 29));
+    };
+    auto equal = [&](std::uint32_t a, std::uint32_t b) {
+        for (std::size_t k = 0; k < stride; ++k)
+            if (bits(data[a * stride + k]) != bits(data[b * stride + k]))
+                return false;
+        return true;
+    };
+    std::unordered_map<std::uint32_t, std::uint32_t, decltype(hash), decltype(equal)> unique(count, hash, equal);
+
+    std::vector<std::uint32_t> remap(count);
+    std::vector<float> welded;
+    welded.reserve(mesh.vertices.size());
+    for (std::uint32_t v = 0; v < count; ++v) {
+        const auto [it, added] = unique.try_emplace(v, static_cast<std::uint32_t>(welded.size() / stride));
+        if (added)
+            welded.insert(welded.end(), data + v * stride, data + (v + 1) * stride);
+        remap[v] = it->second;
+    }
+    for (auto& index : mesh.indices)
+        index = remap[index];
+    mesh.vertices.swap(welded);
+    return mesh.vertexCount();
+}
+
+namespace detail {
+
+// Forsyth 线性时间顶点缓存优化的打分参数
+inline constexpr std::size_t kForsythCacheSize = 32;
+inline constexpr std::size_t kForsythMaxValence = 32;
+
+struct ForsythScores {
+    float cache[kForsythCacheSize + 3];
+    float valence[kForsythMaxValence + 1];
+
+    ForsythScores() {
+        for (std::size_t i = 0; i < kForsythCacheSize + 3; ++i) {
+            // 最近一个三角形的三个顶点得固定分，避免立刻重复使用同一条边产生长条带
+            cache[i] = i < 3 ? 0.75f
+                : i < kForsythCacheSize ? std::pow(1.0f - float(i - 3) / float(kForsythCacheSize - 3), 1.5f) : 0.0f;
+        }
+        valence[0] = 0.0f;
+        for (std::size_t i = 1; i <= kForsythMaxValence; ++i)
+            valence[i] = 2.0f / std::sqrt(float(i));
+    }
+
+    float score(int cachePosition, std::uint32_t remaining) const {
+        if (remaining == 0)
+            return -1.0f;
+        return (cachePosition >= 0 ? cache[cachePosition] : 0.0f) + valence[std::min<std::size_t>(remaining, kForsythMaxValence)];
+    }
+};
+
+}
+
+/**
+ * @brief 重排三角形顺序以提高顶点后变换缓存命中率（Forsyth 线性时间算法）
+ *
+ * 每次从缓存中顶点相邻的三角形里选分数最高的输出；缓存外没有候选时按原顺序取下一个未输出的三角形。
+ */
+inline void optimizeVertexCache(std::vector<std::uint32_t>& indices, std::size_t vertexCount) {
+    using detail::kForsythCacheSize;
+    const std::size_t triangles = indices.size() / 3;
+    if (triangles == 0)
+        return;
+    static const detail::ForsythScores scores;
+
+    // 顶点 -> 相邻三角形（CSR），remaining 为尚未输出的相邻三角形数
+    std::vector<std::uint32_t> offsets(vertexCount + 1, 0), remaining(vertexCount, 0);
+    for (std::uint32_t index : indices)
+        ++remaining[index];
+    for (std::size_t v = 0; v < vertexCount; ++v)
+        offsets[v + 1] = offsets[v] + remaining[v];
+    std::vector<std::uint32_t> adjacency(indices.size());
+    {
+        std::vector<std::uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (std::size_t t = 0; t < triangles; ++t)
+            for (int k = 0; k < 3; ++k)
+                adjacency[fill[indices[t * 3 + k]]++] = static_cast<std::uint32_t>(t);
+    }
+
+    std::vector<float> vertexScore(vertexCount);
+    for (std::size_t v = 0; v < vertexCount; ++v)
+        vertexScore[v] = scores.score(-1, remaining[v]);
+    std::vector<float> triangleScore(triangles);
+    for (std::size_t t = 0; t < triangles; ++t)
+        triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+    std::vector<char> emitted(triangles, 0);
+
+    std::vector<std::uint32_t> cache, nextCache;
+    cache.reserve(kForsythCacheSize + 3);
+    nextCache.reserve(kForsythCacheSize + 3);
+    std::vector<std::uint32_t> result;
+    result.reserve(indices.size());
+
+    std::size_t cursor = 0;
+    std::size_t best = ~std::size_t{0};
+    for (std::size_t done = 0; done < triangles; ++done) {
+        if (best == ~std::size_t{0}) {
+            while (emitted[cursor])
+                ++cursor;
+            best = cursor;
+        }
+        const std::uint32_t* tri = &indices[best * 3];
+        result.insert(result.end(), tri, tri + 3);
+        emitted[best] = 1;
+
+        // 新三角形的顶点移到缓存最前面，其余顶点依次后移
+        nextCache.assign(tri, tri + 3);
+        for (std::uint32_t v : cache)
+            if (v != tri[0] && v != tri[1] && v != tri[2])
+                nextCache.push_back(v);
+        for (int k = 0; k < 3; ++k) {
+            const std::uint32_t v = tri[k];
+            // 从相邻列表中删掉已输出的三角形
+            std::uint32_t* begin = &adjacency[offsets[v]];
+            std::uint32_t* end = begin + remaining[v];
+            *std::find(begin, end, static_cast<std::uint32_t>(best)) = *(end - 1);
+            --remaining[v];
+        }
+
+        // 先更新缓存中（以及刚被挤出的）顶点及其相邻三角形的分数
+        for (std::size_t i = 0; i < nextCache.size(); ++i) {
+            const std::uint32_t v = nextCache[i];
+            const int position = i < kForsythCacheSize ? static_cast<int>(i) : -1;
+            const float updated = scores.score(position, remaining[v]);
+            const float delta = updated - vertexScore[v];
+            vertexScore[v] = updated;
+            for (std::uint32_t a = offsets[v]; a < offsets[v] + remaining[v]; ++a)
+                triangleScore[adjacency[a]] += delta;
+        }
+        // 全部更新完再选下一个最佳：一个三角形可能与多个缓存顶点相邻，边更新边比较会用到只加了一部分增量的分数
+        best = ~std::size_t{0};
+        float bestScore = -1.0f;
+        for (std::size_t i = 0; i < nextCache.size(); ++i) {
+            const std::uint32_t v = nextCache[i];
+            for (std::uint32_t a = offsets[v]; a < offsets[v] + remaining[v]; ++a) {
+                const std::uint32_t t = adjacency[a];
+                if (triangleScore[t] > bestScore) {
+                    bestScore = triangleScore[t];
+                    best = t;
+                }
+            }
+        }
+        if (nextCache.size() > kForsythCacheSize)
+            nextCache.resize(kForsythCacheSize);
+        cache.swap(nextCache);
+    }
+    indices.swap(result);
+}
+
+/**
+ * @brief 在保持顶点缓存局部性的前提下按朝外程度重排三角形簇，减少过度绘制
+ *
+ * 先按 FIFO 缓存模拟找出"硬边界"（三个顶点全部未命中，即缓存实际已重新开始），
+ * 再在每段内切"软边界"：从段首清空缓存重新模拟，累计 ACMR 降到该段 ACMR 的 threshold 倍以内就切一刀，
+ * 因此重排后的 ACMR 最多变差约 threshold 倍。
+ * 各簇按 dot(簇中心 - 网格中心, 簇平均法线) 从大到小排列：朝外的簇先画，
+ * 后画的被遮挡部分更容易被深度测试提前剔除。
+ */
+inline void optimizeOverdraw(const Mesh& mesh, std::vector<std::uint32_t>& indices, float threshold = 1.05f, std::size_t cacheSize = 16) {
+    const MeshAttribute* position = mesh.find(AttributeKind::Position);
+    const std::size_t triangles = indices.size() / 3;
+    if (!position || triangles == 0)
+        return;
+    auto vertex = [&](std::uint32_t v) {
+        const float* p = &mesh.vertices[v * mesh.vertexFloats + position->offset];
+        return glm::vec3(p[0], p[1], p[2]);
+    };
+
+    // FIFO 缓存模拟；把 clock 向前拨 cacheSize 即清空缓存
+    std::vector<std::size_t> inserted(mesh.vertexCount(), ~std::size_t{0});
+    std::size_t clock = 0;
+    auto triangleMisses = [&](std::size_t t) {
+        int misses = 0;
+        for (int k = 0; k < 3; ++k) {
+            const std::uint32_t v = indices[t * 3 + k];
+            if (inserted[v] == ~std::size_t{0} || clock - inserted[v] >= cacheSize) {
+                inserted[v] = clock++;
+                ++misses;
+            }
+        }
+        return misses;
+    };
+
+    std::vector<std::size_t> hardStart;
+    for (std::size_t t = 0; t < triangles; ++t)
+        if (triangleMisses(t) == 3 || t == 0)
+            hardStart.push_back(t);
+    hardStart.push_back(triangles);
+
+    std::vector<std::size_t> clusterStart;
+    for (std::size_t h = 0; h + 1 < hardStart.size(); ++h) {
+        const std::size_t begin = hardStart[h], end = hardStart[h + 1];
+        clock += cacheSize;
+        std::size_t misses = 0;
+        for (std::size_t t = begin; t < end; ++t)
+            misses += triangleMisses(t);
+        const float limit = threshold * float(misses) / float(end - begin);
+
+        clusterStart.push_back(begin);
+        clock += cacheSize;
+        std::size_t runningMisses = 0, runningTriangles = 0;
+        for (std::size_t t = begin; t < end; ++t) {
+            runningMisses += triangleMisses(t);
+            ++runningTriangles;
+            if (t + 1 < end && float(runningMisses) <= limit * float(runningTriangles)) {
+                clusterStart.push_back(t + 1);
+                clock += cacheSize;
+                runningMisses = runningTriangles = 0;
+            }
+        }
+    }
+    clusterStart.push_back(triangles);
+
+    glm::vec3 meshCenter(0.0f);
+    float meshArea = 0.0f;
+    struct Cluster {
+        std::size_t begin, end;
+        float sortKey;
+    };
+    std::vector<Cluster> clusters;
+    std::vector<glm::vec3> centers, normals;
+    for (std::size_t c = 0; c + 1 < clusterStart.size(); ++c) {
+        glm::vec3 center(0.0f), normal(0.0f);
+        float area = 0.0f;
+        for (std::size_t t = clusterStart[c]; t < clusterStart[c + 1]; ++t) {
+            const glm::vec3 a = vertex(indices[t * 3]), b = vertex(indices[t * 3 + 1]), d = vertex(indices[t * 3 + 2]);
+            const glm::vec3 n = glm::cross(b - a, d - a);
+            const float triangleArea = glm::length(n);
+            center += (a + b + d) * (triangleArea / 3.0f);
+            normal += n;
+            area += triangleArea;
+        }
+        meshCenter += center;
+        meshArea += area;
+        centers.push_back(area > 0.0f ? center / area : vertex(indices[clusterStart[c] * 3]));
+        normals.push_back(glm::length(normal) > 0.0f ? glm::normalize(normal) : glm::vec3(0.0f));
+        clusters.push_back({ clusterStart[c], clusterStart[c + 1], 0.0f });
+    }
+    if (meshArea > 0.0f)
+        meshCenter = meshCenter / meshArea;
+    for (std::size_t c = 0; c < clusters.size(); ++c)
+        clusters[c].sortKey = glm::dot(centers[c] - meshCenter, normals[c]);
+    std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b) { return a.sortKey > b.sortKey; });
+
+    std::vector<std::uint32_t> result;
+    result.reserve(indices.size());
+    for (const auto& cluster : clusters)
+        result.insert(result.end(), indices.begin() + cluster.begin * 3, indices.begin() + cluster.end * 3);
+    indices.swap(result);
+}
+
+/**
+ * @brief 按索引中第一次出现的顺序重排顶点，使顶点读取基本顺序访问；未被引用的顶点被删除
+ *
+ * @return 重排后的顶点数
+ */
+inline std::size_t optimizeVertexFetch(Mesh& mesh) {
+    const std::size_t stride = mesh.vertexFloats;
+    std::vector<std::uint32_t> remap(mesh.vertexCount(), ~0u);
+    std::vector<float> ordered;
+    ordered.reserve(mesh.vertices.size());
+    std::uint32_t next = 0;
+    for (auto& index : mesh.indices) {
+        if (remap[index] == ~0u) {
+            remap[index] = next++;
+            ordered.insert(ordered.end(), mesh.vertices.begin() + index * stride, mesh.vertices.begin() + (index + 1) * stride);
+        }
+        index = remap[index];
+    }
+    mesh.vertices.swap(ordered);
+    return mesh.vertexCount();
+}
+
+// 完整流程：合并重复顶点 -> 顶点缓存顺序 -> 过度绘制顺序 -> 顶点读取顺序
+inline void optimizeMesh(Mesh& mesh) {
+    weldVertices(mesh);
+    optimizeVertexCache(mesh.indices, mesh.vertexCount());
+    optimizeOverdraw(mesh, mesh.indices);
+    optimizeVertexFetch(mesh);
+}
+
+// ---------------------------------------------------------------------------
+// 紧凑顶点格式
+// ---------------------------------------------------------------------------
+
+namespace detail {
+
+// float -> IEEE 半精度，就近舍入到偶数；超出范围变为无穷大
+inline std::uint16_t floatToHalf(float value) {
+    std::uint32_t x;
+    std::memcpy(&x, &value, sizeof(x));
+    const std::uint32_t sign = (x >> 16) & 0x8000u;
+    const std::uint32_t absolute = x & 0x7FFFFFFFu;
+    if (absolute > 0x7F800000u)
+        return static_cast<std::uint16_t>(sign | 0x7E00u);
+    const int exponent = int(absolute >> 23) - 127 + 15;
+    std::uint32_t mantissa = absolute & 0x7FFFFFu;
+    if (exponent >= 31)
+        return static_cast<std::uint16_t>(sign | 0x7C00u);
+    if (exponent <= 0) {
+        // 非规格化数
+        if (exponent < -10)
+            return static_cast<std::uint16_t>(sign);
+        mantissa |= 0x800000u;
+        const int shift = 14 - exponent;
+        std::uint32_t half = mantissa >> shift;
+        const std::uint32_t rest = mantissa & ((1u << shift) - 1);
+        const std::uint32_t middle = 1u << (shift - 1);
+        if (rest > middle || (rest == middle && (half & 1)))
+            ++half;
+        return static_cast<std::uint16_t>(sign | half);
+    }
+    std::uint32_t half = (std::uint32_t(exponent) << 10) | (mantissa >> 13);
+    const std::uint32_t rest = mantissa & 0x1FFFu;
+    // 进位可能进入指数位，结果仍然正确（最大有限值进位成无穷大）
+    if (rest > 0x1000u || (rest == 0x1000u && (half & 1)))
+        ++half;
+    return static_cast<std::uint16_t>(sign | half);
+}
+
+inline float halfToFloat(std::uint16_t half) {
+    const std::uint32_t sign = std::uint32_t(half & 0x8000u) << 16;
+    std::uint32_t exponent = (half >> 10) & 0x1Fu;
+    std::uint32_t mantissa = half & 0x3FFu;
+    std::uint32_t x;
+    if (exponent == 31) {
+        x = sign | 0x7F800000u | (mantissa << 13);
+    } else if (exponent == 0) {
+        if (mantissa == 0) {
+            x = sign;
+        } else {
+            // 非规格化数：规格化后再组装
+            exponent = 127 - 15 + 1;
+            while (!(mantissa & 0x400u)) {
+                mantissa <<= 1;
+                --exponent;
+            }
+            x = sign | (exponent << 23) | ((mantissa & 0x3FFu) << 13);
+        }
+    } else {
+        x = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+    }
+    float value;
+    std::memcpy(&value, &x, sizeof(value));
+    return value;
+}
+
+inline std::int8_t floatToSnorm8(float value) {
+    return static_cast<std::int8_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 127.0f));
+}
+
+inline std::uint8_t floatToUnorm8(float value) {
+    return static_cast<std::uint8_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+}
+
+}
+
+// 各属性的压缩方式
+struct PackOptions {
+    // 位置用半精度（8 字节，含 1 个填充分量）；默认保持 float，大场景坐标用半精度精度不够
+    bool halfPositions = false;
+    // 法线用 GL_BYTE 归一化（4 字节）
+    bool snormNormals = true;
+    // 颜色用 GL_UNSIGNED_BYTE 归一化（4 字节），要求分量在 [0, 1]
+    bool unormColors = true;
+    // 纹理坐标用半精度
+    bool halfTexCoords = true;
+    // 顶点数不超过 65536 时使用 16 位索引
+    bool shortIndices = true;
+};
+
+// 一个压缩后的属性，字段与 glVertexAttribPointer 的参数一一对应
+struct PackedAttribute {
+    GLuint location;
+    GLint components;
+    GLenum type;
+    GLboolean normalized;
+    std::size_t offset;
+};
+
+/**
+ * @brief 压缩后的网格，顶点为字节数组，索引为 16 / 32 位
+ */
+struct PackedMesh {
+    std::vector<std::uint8_t> vertices;
+    std::size_t stride = 0;
+    std::vector<PackedAttribute> attributes;
+    std::vector<std::uint8_t> indices;
+    GLenum indexType = GL_UNSIGNED_INT;
+    std::size_t indexCount = 0;
+
+    std::size_t vertexCount() const { return stride ? vertices.size() / stride : 0; }
+    std::size_t vertexBytes() const { return vertices.size(); }
+    std::size_t indexBytes() const { return indices.size(); }
+
+    // 按 attributes 设置顶点属性；当前 VAO 与 GL_ARRAY_BUFFER 必须已绑定到本网格的缓冲
+    void setupAttributes() const {
+        for (const auto& attribute : attributes) {
+            glVertexAttribPointer(attribute.location, attribute.components, attribute.type, attribute.normalized,
+                                  static_cast<GLsizei>(stride), (void*)attribute.offset);
+            glEnableVertexAttribArray(attribute.location);
+        }
+    }
+
+    /**
+     * @brief 上传到给定的 VAO / 顶点缓冲 / 索引缓冲并设置属性
+     *
+     * 绘制时：glDrawElements(GL_TRIANGLES, indexCount, indexType, 0)
+     */
+    void upload(GLuint vao, GLuint vbo, GLuint ebo) const {
+        glState().bindVertexArray(vao);
+        glState().bindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertices.size()), vertices.data(), GL_STATIC_DRAW);
+        glState().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(indices.size()), indices.data(), GL_STATIC_DRAW);
+        GLUTILS_COUNT_UPLOAD(vertices.size() + indices.size());
+        setupAttributes();
+    }
+};
+
+/**
+ * @brief 按 options 把网格压缩为紧凑格式
+ *
+ * 每个属性按 4 字节对齐，属性 location 与 mesh.attributes 的下标一致。
+ */
+inline PackedMesh packMesh(const Mesh& mesh, const PackOptions& options = {}) {
+    struct Plan {
+        const MeshAttribute* source;
+        GLenum type;
+        GLboolean normalized;
+        std::size_t bytes;
+    };
+    std::vector<Plan> plans;
+    PackedMesh packed;
+    for (std::size_t i = 0; i < mesh.attributes.size(); ++i) {
+        const MeshAttribute& attribute = mesh.attributes[i];
+        const std::size_t n = static_cast<std::size_t>(attribute.components);
+        Plan plan{ &attribute, GL_FLOAT, GL_FALSE, n * sizeof(float) };
+        if ((attribute.kind == AttributeKind::Position && options.halfPositions) || (attribute.kind == AttributeKind::TexCoord && options.halfTexCoords))
+            plan = { &attribute, GL_HALF_FLOAT, GL_FALSE, (n * 2 + 3) & ~std::size_t{3} };
+        else if (attribute.kind == AttributeKind::Normal && options.snormNormals)
+            plan = { &attribute, GL_BYTE, GL_TRUE, (n + 3) & ~std::size_t{3} };
+        else if (attribute.kind == AttributeKind::Color && options.unormColors)
+            plan = { &attribute, GL_UNSIGNED_BYTE, GL_TRUE, (n + 3) & ~std::size_t{3} };
+        packed.attributes.push_back({ static_cast<GLuint>(i), attribute.components, plan.type, plan.normalized, packed.stride });
+        packed.stride += plan.bytes;
+        plans.push_back(plan);
+    }
+
+    const std::size_t count = mesh.vertexCount();
+    packed.vertices.assign(count * packed.stride, 0);
+    for (std::size_t v = 0; v < count; ++v) {
+        const float* source = &mesh.vertices[v * mesh.vertexFloats];
+        std::uint8_t* out = &packed.vertices[v * packed.stride];
+        for (std::size_t a = 0; a < plans.size(); ++a) {
+            const Plan& plan = plans[a];
+            std::uint8_t* dst = out + packed.attributes[a].offset;
+            for (int k = 0; k < plan.source->components; ++k) {
+                const float value = source[plan.source->offset + k];
+                switch (plan.type) {
+                case GL_HALF_FLOAT: {
+                    const std::uint16_t half = detail::floatToHalf(value);
+                    std::memcpy(dst + k * 2, &half, 2);
+                    break;
+                }
+                case GL_BYTE: dst[k] = static_cast<std::uint8_t>(detail::floatToSnorm8(value)); break;
+                case GL_UNSIGNED_BYTE: dst[k] = detail::floatToUnorm8(value); break;
+                default: std::memcpy(dst + k * 4, &value, 4); break;
+                }
+            }
+        }
+    }
+
+    packed.indexCount = mesh.indices.size();
+    if (options.shortIndices && count <= 65536) {
+        packed.indexType = GL_UNSIGNED_SHORT;
+        packed.indices.resize(packed.indexCount * sizeof(std::uint16_t));
+        for (std::size_t i = 0; i < packed.indexCount; ++i) {
+            const std::uint16_t index = static_cast<std::uint16_t>(mesh.indices[i]);
+            std::memcpy(&packed.indices[i * 2], &index, 2);
+        }
+    } else {
+        packed.indexType = GL_UNSIGNED_INT;
+        packed.indices.resize(packed.indexCount * sizeof(std::uint32_t));
+        std::memcpy(packed.indices.data(), mesh.indices.data(), packed.indices.size());
+    }
+    return packed;
+}
+
+}
@@ -0,0 +1,339 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Parallel.hpp"
+
+namespace glutils {
+
+/**
+ * @brief 八叉树节点，所有节点存放在一个按层序排列的扁平数组里
+ *
+ * 节点的点在重排后的点缓冲中占据连续区间 [first, first + count)，
+ * 子节点在数组中连续存放：[firstChild, firstChild + childCount)。
+ */
+struct OctreeNode {
+    float boundsMin[3];
+    float boundsMax[3];
+    std::uint32_t first;
+    std::uint32_t count;
+    std::uint32_t firstChild;
+    std::uint8_t childCount;
+    std::uint8_t level;
+};
+
+/**
+ * @brief 细节层次参数
+ *
+ * 叶子投影到屏幕上的近似面积（像素）乘以 pointsPerPixel 即为要绘制的点数，
+ * 叶内点在构建时已经打乱，所以取区间前缀就是均匀抽样。
+ */
+struct OctreeLod {
+    // 视口高度（像素）
+    float viewportHeight = 600.0f;
+    // 投影矩阵的 proj[1][1]，即 1 / tan(fovy / 2)
+    float projScale = 1.0f;
+    // 每像素绘制的点数，越小越稀疏
+    float pointsPerPixel = 1.0f;
+    // 每个可见叶子至少绘制的点数
+    std::uint32_t minPoints = 64;
+    bool enabled = true;
+};
+
+// 一帧要提交的绘制区间，可以直接传给 glMultiDrawArrays
+struct OctreeDrawList {
+    std::vector<int> first;
+    std::vector<int> count;
+    std::size_t points = 0;
+
+    void clear() {
+        first.clear();
+        count.clear();
+        points = 0;
+    }
+};
+
+namespace detail {
+
+// 把 10 位整数的每一位之间插入两个 0
+inline std::uint32_t expandBits(std::uint32_t v) {
+    v = (v | (v << 16)) & 0x030000FFu;
+    v = (v | (v << 8)) & 0x0300F00Fu;
+    v = (v | (v << 4)) & 0x030C30C3u;
+    v = (v | (v << 2)) & 0x09249249u;
+    return v;
+}
+
+inline constexpr int kMortonLevels = 10;
+
+/**
+ * @brief 多线程归并排序
+ *
+ * 每个线程先排序自己的一段，然后两两归并，归并轮次内各对之间也并行。
+ */
+inline void parallelSort(std::vector<std::uint64_t>& keys) {
+    const std::size_t n = keys.size();
+    const std::size_t parts = std::min<std::size_t>(workerCount(), std::max<std::size_t>(1, n / 65536));
+    if (parts <= 1) {
+        std::sort(keys.begin(), keys.end());
+        return;
+    }
+    std::vector<std::size_t> bounds(parts + 1);
+    for (std::size_t i = 0; i <= parts; ++i)
+        bounds[i] = n * i / parts;
+    parallelFor(parts, 1, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t p = begin; p < end; ++p)
+            std::sort(keys.begin() + bounds[p], keys.begin() + bounds[p + 1]);
+    });
+
+    std::vector<std::uint64_t> scratch(n);
+    for (std::size_t width = 1; width < parts; width *= 2) {
+        const std::size_t groups = (parts + 2 * width - 1) / (2 * width);
+        parallelFor(groups, 1, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t g = begin; g < end; ++g) {
+                std::size_t lo = bounds[g * 2 * width];
+                std::size_t mid = bounds[std::min(parts, g * 2 * width + width)];
+                std::size_t hi = bounds[std::min(parts, g * 2 * width + 2 * width)];
+                std::merge(keys.begin() + lo, keys.begin() + mid, keys.begin() + mid, keys.begin() + hi, scratch.begin() + lo);
+            }
+        });
+        keys.swap(scratch);
+    }
+}
+
+}
+
+/**
+ * @brief 点云八叉树：Morton 排序构建，支持视锥剔除与屏幕空间 LOD
+ *
+ * build 会按 Morton 序原地重排点缓冲，所以必须在上传到 GPU 之前调用，
+ * 之后每帧调用 select 得到可见叶子的绘制区间，用一次 glMultiDrawArrays 提交。
+ */
+class Octree {
+public:
+    /**
+     * @brief 并行构建八叉树
+     *
+     * @param points 紧密排列的 xyz，构建后被重排为八叉树顺序
+     * @param count 点数，不超过 2^32 - 1
+     * @param leafSize 叶子节点最多容纳的点数（最深 10 层时可能超过）
+     */
+    void build(float* points, std::size_t count, std::uint32_t leafSize = 16384) {
+        nodeArray.clear();
+        if (count == 0)
+            return;
+
+        // 1. 并行计算包围盒
+        const unsigned int threads = workerCount();
+        std::vector<glm::vec3> partMin(threads, glm::vec3(std::numeric_limits<float>::max()));
+        std::vector<glm::vec3> partMax(threads, glm::vec3(std::numeric_limits<float>::lowest()));
+        const std::size_t partSize = (count + threads - 1) / threads;
+        parallelFor(threads, 1, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t t = begin; t < end; ++t) {
+                std::size_t last = std::min(count, (t + 1) * partSize);
+                for (std::size_t i = t * partSize; i < last; ++i) {
+                    glm::vec3 p(points[i * 3], points[i * 3 + 1], points[i * 3 + 2]);
+                    partMin[t] = glm::min(partMin[t], p);
+                    partMax[t] = glm::max(partMax[t], p);
+                }
+            }
+        });
+        glm::vec3 lo = partMin[0], hi = partMax[0];
+        for (unsigned int t = 1; t < threads; ++t) {
+            lo = glm::min(lo, partMin[t]);
+            hi = glm::max(hi, partMax[t]);
+        }
+        // 根节点取立方体，使每一层的格子在三个轴上等长
+        glm::vec3 extent = hi - lo;
+        float side = std::max({ extent.x, extent.y, extent.z, 1e-6f });
+        const float cells = float(1 << detail::kMortonLevels);
+        const float scale = (cells - 1.0f) / side;
+
+        // 2. 并行计算 Morton 码，高 32 位存码、低 32 位存原始下标
+        std::vector<std::uint64_t> keys(count);
+        parallelFor(count, 1 << 16, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                auto q = [&](int axis) {
+                    return static_cast<std::uint32_t>((points[i * 3 + axis] - lo[axis]) * scale);
+                };
+                std::uint32_t code = (detail::expandBits(q(0)) << 2) | (detail::expandBits(q(1)) << 1) | detail::expandBits(q(2));
+                keys[i] = (std::uint64_t{code} << 32) | static_cast<std::uint32_t>(i);
+            }
+        });
+        detail::parallelSort(keys);
+
+        // 3. 自顶向下按层序建立节点，子节点区间通过二分查找 Morton 前缀得到
+        nodeArray.push_back(OctreeNode{ {}, {}, 0, static_cast<std::uint32_t>(count), 0, 0, 0 });
+        std::vector<std::uint32_t> leaves;
+        for (std::size_t i = 0; i < nodeArray.size(); ++i) {
+            OctreeNode node = nodeArray[i];
+            if (node.count <= leafSize || node.level == detail::kMortonLevels) {
+                leaves.push_back(static_cast<std::uint32_t>(i));
+                continue;
+            }
+            const int shift = 3 * (detail::kMortonLevels - node.level - 1);
+            nodeArray[i].firstChild = static_cast<std::uint32_t>(nodeArray.size());
+            std::size_t begin = node.first;
+            const std::size_t end = std::size_t{node.first} + node.count;
+            for (std::uint32_t child = 0; child < 8 && begin < end; ++child) {
+                auto split = std::partition_point(keys.begin() + begin, keys.begin() + end, [&](std::uint64_t key) {
+                    return ((static_cast<std::uint32_t>(key >> 32) >> shift) & 7u) <= child;
+                });
+                std::size_t childEnd = static_cast<std::size_t>(split - keys.begin());
+                if (childEnd > begin) {
+                    nodeArray.push_back(OctreeNode{ {}, {}, static_cast<std::uint32_t>(begin), static_cast<std::uint32_t>(childEnd - begin),
+                                                    0, 0, static_cast<std::uint8_t>(node.level + 1) });
+                    ++nodeArray[i].childCount;
+                }
+                begin = childEnd;
+            }
+        }
+
+        // 4. 叶内打乱（确定性），让区间前缀成为均匀抽样；然后按新顺序搬运点并计算叶子包围盒
+        std::vector<float> sorted(count * 3);
+        parallelFor(leaves.size(), 1, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t l = begin; l < end; ++l) {
+                OctreeNode& leaf = nodeArray[leaves[l]];
+                auto first = keys.begin() + leaf.first;
+                std::minstd_rand rng(static_cast<std::uint32_t>(leaves[l]) + 1);
+                std::shuffle(first, first + leaf.count, rng);
+
+                glm::vec3 bmin(std::numeric_limits<float>::max()), bmax(std::numeric_limits<float>::lowest());
+                for (std::size_t i = leaf.first; i < std::size_t{leaf.first} + leaf.count; ++i) {
+                    const float* src = points + static_cast<std::uint32_t>(keys[i]) * std::size_t{3};
+                    glm::vec3 p(src[0], src[1], src[2]);
+                    sorted[i * 3 + 0] = p.x;
+                    sorted[i * 3 + 1] = p.y;
+                    sorted[i * 3 + 2] = p.z;
+                    bmin = glm::min(bmin, p);
+                    bmax = glm::max(bmax, p);
+                }
+                for (int a = 0; a < 3; ++a) {
+                    leaf.boundsMin[a] = bmin[a];
+                    leaf.boundsMax[a] = bmax[a];
+                }
+            }
+        });
+        std::copy(sorted.begin(), sorted.end(), points);
+
+        // 5. 子节点总在父节点之后，倒序合并包围盒即可
+        for (std::size_t i = nodeArray.size(); i-- > 0;) {
+            OctreeNode& node = nodeArray[i];
+            if (node.childCount == 0)
+                continue;
+            for (int a = 0; a < 3; ++a) {
+                node.boundsMin[a] = std::numeric_limits<float>::max();
+                node.boundsMax[a] = std::numeric_limits<float>::lowest();
+            }
+            for (std::uint32_t c = node.firstChild; c < node.firstChild + node.childCount; ++c) {
+                for (int a = 0; a < 3; ++a) {
+                    node.boundsMin[a] = std::min(node.boundsMin[a], nodeArray[c].boundsMin[a]);
+                    node.boundsMax[a] = std::max(node.boundsMax[a], nodeArray[c].boundsMax[a]);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief 选出当前视锥内的叶子，并按屏幕尺寸决定每个叶子绘制的点数
+     *
+     * @param mvp proj * view * model，视锥平面直接在模型空间中提取
+     * @param lod 细节层次参数
+     * @param out 输出的绘制区间，相邻且完整绘制的叶子会被合并
+     */
+    void select(const glm::mat4& mvp, const OctreeLod& lod, OctreeDrawList& out) const {
+        out.clear();
+        if (nodeArray.empty())
+            return;
+
+        // Gribb-Hartmann：clip = mvp * p，平面为第 4 行加减第 1~3 行
+        glm::vec4 rows[4];
+        for (int r = 0; r < 4; ++r)
+            rows[r] = glm::vec4(mvp[0][r], mvp[1][r], mvp[2][r], mvp[3][r]);
+        const glm::vec4 planes[6] = {
+            rows[3] + rows[0], rows[3] + rows[0] * -1.0f,
+            rows[3] + rows[1], rows[3] + rows[1] * -1.0f,
+            rows[3] + rows[2], rows[3] + rows[2] * -1.0f,
+        };
+        const float pixelScale = lod.projScale * 0.5f * lod.viewportHeight;
+
+        struct Entry { std::uint32_t node; bool inside; };
+        Entry stack[8 * (detail::kMortonLevels + 2)];
+        int top = 0;
+        stack[top++] = { 0, false };
+        while (top > 0) {
+            Entry entry = stack[--top];
+            const OctreeNode& node = nodeArray[entry.node];
+            bool inside = entry.inside;
+            if (!inside) {
+                inside = true;
+                bool outside = false;
+                for (const glm::vec4& p : planes) {
+                    // p 顶点：沿平面法线方向最远的角；n 顶点：最近的角
+                    float farthest = p.w, nearest = p.w;
+                    for (int a = 0; a < 3; ++a) {
+                        float hiDot = p[a] * node.boundsMax[a], loDot = p[a] * node.boundsMin[a];
+                        farthest += std::max(hiDot, loDot);
+                        nearest += std::min(hiDot, loDot);
+                    }
+                    if (farthest < 0.0f) {
+                        outside = true;
+                        break;
+                    }
+                    if (nearest < 0.0f)
+                        inside = false;
+                }
+                if (outside)
+                    continue;
+            }
+            if (node.childCount > 0) {
+                // 倒序入栈，保证叶子按缓冲顺序输出，方便合并相邻区间
+                for (std::uint32_t c = node.firstChild + node.childCount; c-- > node.firstChild;)
+                    stack[top++] = { c, inside };
+                continue;
+            }
+            emit(node, rows[3], pixelScale, lod, out);
+        }
+    }
+
+    const std::vector<OctreeNode>& nodes() const { return nodeArray; }
+
+private:
+    static void emit(const OctreeNode& leaf, const glm::vec4& wRow, float pixelScale, const OctreeLod& lod, OctreeDrawList& out) {
+        std::uint32_t drawCount = leaf.count;
+        if (lod.enabled) {
+            glm::vec3 center, half;
+            for (int a = 0; a < 3; ++a) {
+                center[a] = 0.5f * (leaf.boundsMin[a] + leaf.boundsMax[a]);
+                half[a] = 0.5f * (leaf.boundsMax[a] - leaf.boundsMin[a]);
+            }
+            float radius = glm::length(half);
+            // 对透视投影，clip.w 即视空间深度
+            float w = glm::dot(glm::vec4(center, 1.0f), wRow);
+            if (w > radius) {
+                float pixelRadius = radius * pixelScale / w;
+                float target = 3.14159265f * pixelRadius * pixelRadius * lod.pointsPerPixel;
+                drawCount = static_cast<std::uint32_t>(std::clamp(target, float(std::min(lod.minPoints, leaf.count)), float(leaf.count)));
+            }
+        }
+        if (drawCount == 0)
+            return;
+        if (!out.count.empty() && std::uint32_t(out.first.back() + out.count.back()) == leaf.first)
+            out.count.back() += static_cast<int>(drawCount);
+        else {
+            out.first.push_back(static_cast<int>(leaf.first));
+            out.count.push_back(static_cast<int>(drawCount));
+        }
+        out.points += drawCount;
+    }
+
+    std::vector<OctreeNode> nodeArray;
+};
+
+}
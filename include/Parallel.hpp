@@ -0,0 +1,51 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace glutils {
+
+// 可用的工作线程数，至少为 1
+inline unsigned int workerCount() {
+    unsigned int n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+}
+
+/**
+ * @brief 把 [0, count) 切成大小为 grain 的块，分发给所有核心执行
+ *
+ * 每个线程从原子计数器里领取下一块，fn(begin, end) 处理一个半开区间。
+ * 块数不足两块时直接在调用线程执行，不创建线程。
+ */
+template<typename Fn>
+void parallelFor(std::size_t count, std::size_t grain, Fn&& fn) {
+    if (count == 0)
+        return;
+    grain = std::max<std::size_t>(grain, 1);
+    const std::size_t chunks = (count + grain - 1) / grain;
+    const std::size_t threads = std::min<std::size_t>(workerCount(), chunks);
+    if (threads <= 1) {
+        fn(std::size_t{0}, count);
+        return;
+    }
+
+    std::atomic<std::size_t> next{0};
+    auto worker = [&] {
+        for (std::size_t c = next.fetch_add(1); c < chunks; c = next.fetch_add(1)) {
+            std::size_t begin = c * grain;
+            fn(begin, std::min(begin + grain, count));
+        }
+    };
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (std::size_t i = 1; i < threads; ++i)
+        pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool)
+        t.join();
+}
+
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "Parallel.hpp"
+
+namespace glutils {
+
+/**
+ * @brief Philox4x32-10 计数器随机数生成器
+ *
+ * 输出只取决于 (counter, key)，不存在内部状态，所以第 i 个点可以在任意线程、
+ * 以任意顺序生成，结果与单线程顺序生成完全一致。
+ */
+inline std::array<std::uint32_t, 4> philox4x32(std::array<std::uint32_t, 4> ctr, std::array<std::uint32_t, 2> key) {
+    for (int round = 0; round < 10; ++round) {
+        std::uint64_t p0 = std::uint64_t{0xD2511F53u} * ctr[0];
+        std::uint64_t p1 = std::uint64_t{0xCD9E8D57u} * ctr[2];
+        ctr = {
+            static_cast<std::uint32_t>(p1 >> 32) ^ ctr[1] ^ key[0],
+            static_cast<std::uint32_t>(p1),
+            static_cast<std::uint32_t>(p0 >> 32) ^ ctr[3] ^ key[1],
+            static_cast<std::uint32_t>(p0),
+        };
+        key[0] += 0x9E3779B9u;
+        key[1] += 0xBB67AE85u;
+    }
+    return ctr;
+}
+
+// 取高 24 位转换为 [0, 1) 的 float
+inline float uintToUnitFloat(std::uint32_t x) {
+    return static_cast<float>(x >> 8) * (1.0f / 16777216.0f);
+}
+
+/**
+ * @brief 点云数据源：按区间产出紧密排列的 xyz float
+ *
+ * read 必须可以被多个线程同时调用（区间互不重叠），
+ * 这样数据可以被分块、并行地直接写进 GPU 映射内存或暂存缓冲。
+ */
+class PointSource {
+public:
+    virtual ~PointSource() = default;
+    // 点的总数
+    virtual std::size_t size() const = 0;
+    // 把 [first, first + count) 的点写入 out，out 至少有 count * 3 个 float
+    virtual void read(std::size_t first, std::size_t count, float* out) const = 0;
+};
+
+/**
+ * @brief 在轴对齐立方体 [minValue, maxValue]^3 中均匀分布的随机点
+ *
+ * 第 i 个点由 philox4x32({i, i >> 32, 0, 0}, seed) 决定。
+ */
+class RandomPointSource : public PointSource {
+public:
+    RandomPointSource(std::size_t count, std::uint64_t seed = 42, float minValue = -3.0f, float maxValue = 3.0f)
+        : count(count), minValue(minValue), range(maxValue - minValue),
+          key{ static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32) } {}
+
+    std::size_t size() const override { return count; }
+
+    void read(std::size_t first, std::size_t n, float* out) const override {
+        for (std::size_t i = 0; i < n; ++i) {
+            std::uint64_t index = first + i;
+            auto r = philox4x32({ static_cast<std::uint32_t>(index), static_cast<std::uint32_t>(index >> 32), 0, 0 }, key);
+            out[i * 3 + 0] = minValue + range * uintToUnitFloat(r[0]);
+            out[i * 3 + 1] = minValue + range * uintToUnitFloat(r[1]);
+            out[i * 3 + 2] = minValue + range * uintToUnitFloat(r[2]);
+        }
+    }
+
+private:
+    std::size_t count;
+    float minValue;
+    float range;
+    std::array<std::uint32_t, 2> key;
+};
+
+// 已经在内存中的紧密 xyz 数组，不拥有数据
+class ArrayPointSource : public PointSource {
+public:
+    ArrayPointSource(const float* points, std::size_t count) : points(points), count(count) {}
+
+    std::size_t size() const override { return count; }
+
+    void read(std::size_t first, std::size_t n, float* out) const override {
+        std::copy(points + first * 3, points + (first + n) * 3, out);
+    }
+
+private:
+    const float* points;
+    std::size_t count;
+};
+
+// 并行读取一个分块：块内再切成小段分给所有核心
+inline void readParallel(const PointSource& source, std::size_t first, std::size_t count, float* out,
+                         std::size_t grain = 1 << 16) {
+    parallelFor(count, grain, [&](std::size_t begin, std::size_t end) {
+        source.read(first + begin, end - begin, out + begin * 3);
+    });
+}
+
+}
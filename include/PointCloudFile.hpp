@@ -0,0 +1,479 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "MappedFile.hpp"
+#include "Parallel.hpp"
+#include "PointCloud.hpp"
+#include "Simd.hpp"
+
+namespace glutils {
+
+/**
+ * @brief 量化点云文件（.gpc）
+ *
+ * 布局：文件头 | 块索引 PointBlock[blockCount] | 各块数据（16 字节对齐）。
+ * 每块最多 blockPoints 个点，坐标相对块包围盒量化为 3 个 uint16（每点 6 字节，
+ * float32 需要 12 字节）。量化误差不超过块包围盒边长的 1/131070。
+ * 文件按小端序存储，加载时直接映射，按块解码到调用者给出的目标内存。
+ */
+struct PointCloudFileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t blockPoints;
+    std::uint64_t pointCount;
+    std::uint64_t blockCount;
+    float boundsMin[3];
+    float boundsMax[3];
+};
+
+struct PointBlock {
+    float boundsMin[3];
+    float boundsMax[3];
+    // 块数据相对文件起始的字节偏移
+    std::uint64_t offset;
+    std::uint32_t count;
+    std::uint32_t reserved;
+};
+
+static_assert(sizeof(PointCloudFileHeader) == 56, "PointCloudFileHeader 布局不能改变");
+static_assert(sizeof(PointBlock) == 40, "PointBlock 布局不能改变");
+
+inline constexpr char kPointCloudMagic[8] = { 'G', 'L', 'U', 'T', 'P', 'C', 'Q', '\0' };
+inline constexpr std::uint32_t kPointCloudVersion = 1;
+
+namespace detail {
+
+inline constexpr float kQuantMax = 65535.0f;
+
+// 量化步长：包围盒边长 / 65535，边长为 0 时步长为 0
+inline void quantStep(const float bmin[3], const float bmax[3], float step[3]) {
+    for (int a = 0; a < 3; ++a)
+        step[a] = (bmax[a] - bmin[a]) / kQuantMax;
+}
+
+}
+
+// 标量解码：n 个点，每点 3 个 uint16 -> 3 个 float
+inline void decodeQuantizedScalar(const std::uint16_t* q, std::size_t n, const float bmin[3], const float step[3], float* out) {
+    for (std::size_t i = 0; i < n * 3; i += 3) {
+        out[i + 0] = bmin[0] + float(q[i + 0]) * step[0];
+        out[i + 1] = bmin[1] + float(q[i + 1]) * step[1];
+        out[i + 2] = bmin[2] + float(q[i + 2]) * step[2];
+    }
+}
+
+/**
+ * @brief SIMD 解码
+ *
+ * 4 个点正好是 12 个分量 = 3 个 __m128，xyz 交错的缩放/偏移向量按 3 为周期轮转，
+ * 所以不需要转置，直接整段加载、扩展、换算、写出。
+ */
+inline void decodeQuantized(const std::uint16_t* q, std::size_t n, const float bmin[3], const float step[3], float* out) {
+    std::size_t i = 0;
+#ifdef GLUTILS_SSE2
+    const __m128 s0 = _mm_setr_ps(step[0], step[1], step[2], step[0]);
+    const __m128 s1 = _mm_setr_ps(step[1], step[2], step[0], step[1]);
+    const __m128 s2 = _mm_setr_ps(step[2], step[0], step[1], step[2]);
+    const __m128 m0 = _mm_setr_ps(bmin[0], bmin[1], bmin[2], bmin[0]);
+    const __m128 m1 = _mm_setr_ps(bmin[1], bmin[2], bmin[0], bmin[1]);
+    const __m128 m2 = _mm_setr_ps(bmin[2], bmin[0], bmin[1], bmin[2]);
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 4 <= n; i += 4) {
+        const std::uint16_t* src = q + i * 3;
+        float* dst = out + i * 3;
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        __m128i b = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + 8));
+        __m128 v0 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(a, zero));
+        __m128 v1 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(a, zero));
+        __m128 v2 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(b, zero));
+        _mm_storeu_ps(dst + 0, _mm_add_ps(_mm_mul_ps(v0, s0), m0));
+        _mm_storeu_ps(dst + 4, _mm_add_ps(_mm_mul_ps(v1, s1), m1));
+        _mm_storeu_ps(dst + 8, _mm_add_ps(_mm_mul_ps(v2, s2), m2));
+    }
+#endif
+    decodeQuantizedScalar(q + i * 3, n - i, bmin, step, out + i * 3);
+}
+
+/**
+ * @brief 写出 .gpc 文件
+ *
+ * 块包围盒决定量化精度，输入最好已经按空间顺序排列（例如先调用 Octree::build 重排），
+ * 否则每块都会覆盖整个点云，精度退化为整体包围盒的 1/65535。
+ */
+inline bool writePointCloudFile(const std::filesystem::path& path, const float* points, std::size_t count,
+                                std::uint32_t blockPoints = 1 << 16) {
+    blockPoints = std::max<std::uint32_t>(blockPoints, 1);
+    const std::size_t blockCount = (count + blockPoints - 1) / blockPoints;
+    std::vector<PointBlock> blocks(blockCount);
+
+    parallelFor(blockCount, 1, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t b = begin; b < end; ++b) {
+            PointBlock& block = blocks[b];
+            const std::size_t first = b * blockPoints;
+            block.count = static_cast<std::uint32_t>(std::min<std::size_t>(blockPoints, count - first));
+            for (int a = 0; a < 3; ++a) {
+                block.boundsMin[a] = std::numeric_limits<float>::max();
+                block.boundsMax[a] = std::numeric_limits<float>::lowest();
+            }
+            for (std::size_t i = first; i < first + block.count; ++i) {
+                for (int a = 0; a < 3; ++a) {
+                    block.boundsMin[a] = std::min(block.boundsMin[a], points[i * 3 + a]);
+                    block.boundsMax[a] = std::max(block.boundsMax[a], points[i * 3 + a]);
+                }
+            }
+            block.reserved = 0;
+        }
+    });
+
+    PointCloudFileHeader header{};
+    std::memcpy(header.magic, kPointCloudMagic, sizeof(header.magic));
+    header.version = kPointCloudVersion;
+    header.blockPoints = blockPoints;
+    header.pointCount = count;
+    header.blockCount = blockCount;
+    for (int a = 0; a < 3; ++a) {
+        header.boundsMin[a] = count ? std::numeric_limits<float>::max() : 0.0f;
+        header.boundsMax[a] = count ? std::numeric_limits<float>::lowest() : 0.0f;
+    }
+    std::size_t offset = sizeof(header) + blockCount * sizeof(PointBlock);
+    for (PointBlock& block : blocks) {
+        offset = (offset + 15) & ~std::size_t{15};
+        block.offset = offset;
+        offset += std::size_t{block.count} * 3 * sizeof(std::uint16_t);
+        for (int a = 0; a < 3; ++a) {
+            header.boundsMin[a] = std::min(header.boundsMin[a], block.boundsMin[a]);
+            header.boundsMax[a] = std::max(header.boundsMax[a], block.boundsMax[a]);
+        }
+    }
+
+    bool ok = writeSizedFile(path, offset, [&](char* out) {
+        std::memcpy(out, &header, sizeof(header));
+        if (!blocks.empty())
+            std::memcpy(out + sizeof(header), blocks.data(), blocks.size() * sizeof(PointBlock));
+        parallelFor(blockCount, 1, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t b = begin; b < end; ++b) {
+                const PointBlock& block = blocks[b];
+                float scale[3];
+                for (int a = 0; a < 3; ++a) {
+                    float extent = block.boundsMax[a] - block.boundsMin[a];
+                    scale[a] = extent > 0.0f ? detail::kQuantMax / extent : 0.0f;
+                }
+                // 对齐填充字节清零，保证输出可复现
+                std::size_t dataEnd = block.offset + std::size_t{block.count} * 3 * sizeof(std::uint16_t);
+                std::size_t padEnd = b + 1 < blocks.size() ? blocks[b + 1].offset : dataEnd;
+                std::memset(out + dataEnd, 0, padEnd - dataEnd);
+
+                const float* src = points + b * std::size_t{blockPoints} * 3;
+                std::vector<std::uint16_t> q(std::size_t{block.count} * 3);
+                for (std::size_t i = 0; i < q.size(); ++i) {
+                    int a = static_cast<int>(i % 3);
+                    float v = std::round((src[i] - block.boundsMin[a]) * scale[a]);
+                    q[i] = static_cast<std::uint16_t>(std::clamp(v, 0.0f, detail::kQuantMax));
+                }
+                std::memcpy(out + block.offset, q.data(), q.size() * sizeof(std::uint16_t));
+            }
+        });
+        // 块索引之后、第一块之前的对齐填充
+        std::size_t indexEnd = sizeof(header) + blocks.size() * sizeof(PointBlock);
+        if (!blocks.empty())
+            std::memset(out + indexEnd, 0, blocks[0].offset - indexEnd);
+    });
+    if (!ok)
+        std::cerr << "无法写入点云文件: " << path.string() << std::endl;
+    return ok;
+}
+
+/**
+ * @brief 映射打开的 .gpc 文件，作为 PointSource 使用
+ *
+ * read 直接从映射内存按块解码到 out，out 可以是 PointStreamer 的持久映射显存，
+ * 整个加载过程没有中间 float 缓冲。
+ */
+class PointCloudFile : public PointSource {
+public:
+    bool open(const std::filesystem::path& path) {
+        hdr = nullptr;
+        blockIndex = nullptr;
+        if (!file.openRead(path)) {
+            std::cerr << "无法打开点云文件: " << path.string() << std::endl;
+            return false;
+        }
+        const char* bytes = file.data();
+        const std::size_t size = file.size();
+        auto fail = [&](const char* reason) {
+            std::cerr << "点云文件无效（" << reason << "）: " << path.string() << std::endl;
+            file.close();
+            return false;
+        };
+        if (size < sizeof(PointCloudFileHeader))
+            return fail("文件过短");
+        auto header = reinterpret_cast<const PointCloudFileHeader*>(bytes);
+        if (std::memcmp(header->magic, kPointCloudMagic, sizeof(kPointCloudMagic)) != 0)
+            return fail("文件标识不匹配");
+        if (header->version != kPointCloudVersion)
+            return fail("版本不支持");
+        if (header->blockCount > (size - sizeof(PointCloudFileHeader)) / sizeof(PointBlock))
+            return fail("块索引越界");
+        auto blocks = reinterpret_cast<const PointBlock*>(bytes + sizeof(PointCloudFileHeader));
+        std::uint64_t total = 0;
+        for (std::uint64_t b = 0; b < header->blockCount; ++b) {
+            const PointBlock& block = blocks[b];
+            bool lastBlock = b + 1 == header->blockCount;
+            if (block.count > header->blockPoints || (!lastBlock && block.count != header->blockPoints))
+                return fail("块大小不一致");
+            if (block.offset > size || std::uint64_t{block.count} * 6 > size - block.offset)
+                return fail("块数据越界");
+            // 写入时按 16 字节对齐，read() 直接把偏移当作 uint16_t 数组访问
+            if (block.offset % 16 != 0)
+                return fail("块数据未对齐");
+            total += block.count;
+        }
+        if (total != header->pointCount)
+            return fail("点数不一致");
+        hdr = header;
+        blockIndex = blocks;
+        return true;
+    }
+
+    std::size_t size() const override { return hdr ? static_cast<std::size_t>(hdr->pointCount) : 0; }
+
+    void read(std::size_t first, std::size_t count, float* out) const override {
+        while (count > 0) {
+            const std::size_t b = first / hdr->blockPoints;
+            const std::size_t inBlock = first - b * hdr->blockPoints;
+            const PointBlock& block = blockIndex[b];
+            const std::size_t n = std::min<std::size_t>(count, block.count - inBlock);
+            float step[3];
+            detail::quantStep(block.boundsMin, block.boundsMax, step);
+            auto q = reinterpret_cast<const std::uint16_t*>(file.data() + block.offset) + inBlock * 3;
+            decodeQuantized(q, n, block.boundsMin, step, out);
+            first += n;
+            count -= n;
+            out += n * 3;
+        }
+    }
+
+    const PointCloudFileHeader& header() const { return *hdr; }
+    const PointBlock* blocks() const { return blockIndex; }
+    std::size_t blockCount() const { return hdr ? static_cast<std::size_t>(hdr->blockCount) : 0; }
+    std::size_t fileBytes() const { return file.size(); }
+
+private:
+    MappedFile file;
+    const PointCloudFileHeader* hdr = nullptr;
+    const PointBlock* blockIndex = nullptr;
+};
+
+namespace detail {
+
+// 从一行中依次解析以空白或逗号分隔的数，只保留 columns 指定的三列；失败返回 false
+inline bool parseColumns(const char*& p, const char* lineEnd, const int columns[3], float xyz[3]) {
+    int maxColumn = std::max({ columns[0], columns[1], columns[2] });
+    for (int column = 0; column <= maxColumn; ++column) {
+        while (p < lineEnd && (*p == ' ' || *p == '\t' || *p == ','))
+            ++p;
+        if (p < lineEnd && *p == '+')
+            ++p;
+        double value = 0.0;
+        auto [next, ec] = std::from_chars(p, lineEnd, value);
+        if (ec != std::errc())
+            return false;
+        p = next;
+        for (int a = 0; a < 3; ++a)
+            if (columns[a] == column)
+                xyz[a] = static_cast<float>(value);
+    }
+    return true;
+}
+
+/**
+ * @brief 并行解析 ASCII 点行
+ *
+ * 按线程数切分文本，切分点向后对齐到换行符；各线程解析到自己的缓冲，最后按顺序拼接。
+ * 无法解析的行（注释、表头）被跳过。
+ */
+inline void parseAsciiPoints(const char* begin, const char* end, const int columns[3], std::vector<float>& out) {
+    const std::size_t bytes = static_cast<std::size_t>(end - begin);
+    const std::size_t parts = std::max<std::size_t>(1, std::min<std::size_t>(workerCount() * 4, bytes / (1 << 20)));
+    std::vector<const char*> cuts(parts + 1);
+    cuts[0] = begin;
+    cuts[parts] = end;
+    for (std::size_t i = 1; i < parts; ++i) {
+        const char* cut = std::max(cuts[i - 1], begin + bytes * i / parts);
+        const char* nl = static_cast<const char*>(std::memchr(cut, '\n', static_cast<std::size_t>(end - cut)));
+        cuts[i] = nl ? nl + 1 : end;
+    }
+    std::vector<std::vector<float>> partial(parts);
+    parallelFor(parts, 1, [&](std::size_t first, std::size_t last) {
+        for (std::size_t part = first; part < last; ++part) {
+            std::vector<float>& dst = partial[part];
+            dst.reserve(static_cast<std::size_t>(cuts[part + 1] - cuts[part]) / 8);
+            const char* p = cuts[part];
+            while (p < cuts[part + 1]) {
+                const char* nl = static_cast<const char*>(std::memchr(p, '\n', static_cast<std::size_t>(cuts[part + 1] - p)));
+                const char* lineEnd = nl ? nl : cuts[part + 1];
+                float xyz[3];
+                const char* cursor = p;
+                if (parseColumns(cursor, lineEnd, columns, xyz))
+                    dst.insert(dst.end(), xyz, xyz + 3);
+                p = lineEnd + 1;
+            }
+        }
+    });
+    std::size_t total = out.size();
+    for (const auto& part : partial)
+        total += part.size();
+    out.reserve(total);
+    for (const auto& part : partial)
+        out.insert(out.end(), part.begin(), part.end());
+}
+
+inline std::size_t plyTypeSize(std::string_view type) {
+    if (type == "char" || type == "uchar" || type == "int8" || type == "uint8") return 1;
+    if (type == "short" || type == "ushort" || type == "int16" || type == "uint16") return 2;
+    if (type == "int" || type == "uint" || type == "int32" || type == "uint32" || type == "float" || type == "float32") return 4;
+    if (type == "double" || type == "float64") return 8;
+    return 0;
+}
+
+inline bool importPly(const char* data, std::size_t size, std::vector<float>& out) {
+    const char* end = data + size;
+    const char* p = data;
+    std::string format;
+    std::size_t vertexCount = 0;
+    bool inVertex = false, vertexSeen = false, vertexFirst = true;
+    int columns[3] = { -1, -1, -1 };
+    std::string types[3];
+    std::size_t offsets[3]{};
+    int propertyIndex = 0;
+    std::size_t stride = 0;
+    const char* body = nullptr;
+    while (p < end) {
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', static_cast<std::size_t>(end - p)));
+        std::string_view line(p, static_cast<std::size_t>((nl ? nl : end) - p));
+        if (!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+        p = nl ? nl + 1 : end;
+        if (line == "end_header") {
+            body = p;
+            break;
+        }
+        std::vector<std::string_view> tokens;
+        for (std::size_t i = 0; i < line.size();) {
+            std::size_t j = line.find(' ', i);
+            if (j == std::string_view::npos) j = line.size();
+            if (j > i) tokens.push_back(line.substr(i, j - i));
+            i = j + 1;
+        }
+        if (tokens.empty())
+            continue;
+        if (tokens[0] == "format" && tokens.size() > 1) {
+            format = tokens[1];
+        } else if (tokens[0] == "element" && tokens.size() > 2) {
+            inVertex = tokens[1] == "vertex";
+            if (inVertex) {
+                vertexSeen = true;
+                std::from_chars(tokens[2].data(), tokens[2].data() + tokens[2].size(), vertexCount);
+            } else if (!vertexSeen) {
+                vertexFirst = false;
+            }
+        } else if (tokens[0] == "property" && inVertex) {
+            if (tokens.size() > 2 && tokens[1] == "list")
+                return false;
+            if (tokens.size() < 3)
+                return false;
+            constexpr std::string_view axisNames[3] = { "x", "y", "z" };
+            for (int a = 0; a < 3; ++a) {
+                if (tokens[2] == axisNames[a]) {
+                    columns[a] = propertyIndex;
+                    types[a] = tokens[1];
+                    offsets[a] = stride;
+                }
+            }
+            stride += plyTypeSize(tokens[1]);
+            ++propertyIndex;
+        }
+    }
+    if (!body || !vertexSeen || !vertexFirst || columns[0] < 0 || columns[1] < 0 || columns[2] < 0) {
+        std::cerr << "PLY 需要 vertex 元素位于首位且包含 x/y/z 属性" << std::endl;
+        return false;
+    }
+
+    if (format == "ascii") {
+        // 只解析 vertex 元素占据的前 vertexCount 行
+        const char* vertexEnd = body;
+        for (std::size_t line = 0; line < vertexCount && vertexEnd < end; ++line) {
+            const char* nl = static_cast<const char*>(std::memchr(vertexEnd, '\n', static_cast<std::size_t>(end - vertexEnd)));
+            vertexEnd = nl ? nl + 1 : end;
+        }
+        parseAsciiPoints(body, vertexEnd, columns, out);
+        return true;
+    }
+    if (format != "binary_little_endian") {
+        std::cerr << "不支持的 PLY 格式: " << format << std::endl;
+        return false;
+    }
+    for (int a = 0; a < 3; ++a) {
+        if (types[a] != "float" && types[a] != "float32" && types[a] != "double" && types[a] != "float64") {
+            std::cerr << "PLY 坐标必须是 float 或 double" << std::endl;
+            return false;
+        }
+    }
+    if (static_cast<std::size_t>(end - body) < vertexCount * stride) {
+        std::cerr << "PLY 顶点数据不完整" << std::endl;
+        return false;
+    }
+    const std::size_t base = out.size();
+    out.resize(base + vertexCount * 3);
+    parallelFor(vertexCount, 1 << 16, [&](std::size_t first, std::size_t last) {
+        for (std::size_t v = first; v < last; ++v) {
+            const char* record = body + v * stride;
+            for (int a = 0; a < 3; ++a) {
+                if (plyTypeSize(types[a]) == 8) {
+                    double d;
+                    std::memcpy(&d, record + offsets[a], sizeof(d));
+                    out[base + v * 3 + a] = static_cast<float>(d);
+                } else {
+                    std::memcpy(&out[base + v * 3 + a], record + offsets[a], sizeof(float));
+                }
+            }
+        }
+    });
+    return true;
+}
+
+}
+
+/**
+ * @brief 导入 ASCII XYZ（.xyz/.txt/.pts，前三列为坐标）或 PLY（ascii / binary_little_endian）
+ *
+ * 结果追加到 out（紧密 xyz）。
+ */
+inline bool importPointCloud(const std::filesystem::path& path, std::vector<float>& out) {
+    MappedFile file;
+    if (!file.openRead(path)) {
+        std::cerr << "无法打开点云文件: " << path.string() << std::endl;
+        return false;
+    }
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (ext == ".ply")
+        return detail::importPly(file.data(), file.size(), out);
+    const int columns[3] = { 0, 1, 2 };
+    detail::parseAsciiPoints(file.data(), file.data() + file.size(), columns, out);
+    return true;
+}
+
+}
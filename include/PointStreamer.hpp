@@ -0,0 +1,183 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <glad/glad.h>
+
+#include "GLState.hpp"
+#include "PointCloud.hpp"
+#include "Profiler.hpp"
+
+namespace glutils {
+
+/**
+ * @brief 把 PointSource 分块、后台并行地流式上传到一个顶点缓冲
+ *
+ * 后台线程按顺序生成各个分块，主线程每帧调用 pump() 取回已经就绪的点数，
+ * 只绘制 [0, pump()) 这段，所以第一帧不必等全部数据生成完。
+ *
+ * - OpenGL 4.4+：glBufferStorage 持久 + 一致映射，后台线程直接写入显存映射，
+ *   pump() 只读取进度，没有额外拷贝。
+ * - 更低版本：glBufferData 预分配，后台线程写入少量暂存槽，主线程用
+ *   GL_MAP_UNSYNCHRONIZED_BIT 映射尚未被绘制的区间再拷贝进去；暂存槽用完时后台线程等待，
+ *   CPU 峰值内存只有几个分块大小。
+ *
+ * 所有 GL 调用都发生在构造、pump() 和析构所在的线程（即持有上下文的线程）。
+ */
+class PointStreamer {
+public:
+    PointStreamer(const PointSource& source, std::size_t chunkPoints = 1 << 20)
+        : source(source), total(source.size()), chunkPoints(std::max<std::size_t>(chunkPoints, 1)) {
+        chunkCount = (total + this->chunkPoints - 1) / this->chunkPoints;
+        const GLsizeiptr bytes = static_cast<GLsizeiptr>(total * 3 * sizeof(float));
+
+        glGenBuffers(1, &vbo);
+        glState().bindBuffer(GL_ARRAY_BUFFER, vbo);
+        persistentMapping = GLAD_GL_VERSION_4_4 && total > 0;
+        if (persistentMapping) {
+            constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            glBufferStorage(GL_ARRAY_BUFFER, bytes, nullptr, flags);
+            mapped = static_cast<float*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, bytes, flags));
+            persistentMapping = mapped != nullptr;
+        }
+        if (!persistentMapping) {
+            glBufferData(GL_ARRAY_BUFFER, bytes, nullptr, GL_STATIC_DRAW);
+            for (auto& slot : slots)
+                slot.resize(this->chunkPoints * 3);
+            for (std::size_t i = 0; i < slots.size(); ++i)
+                freeSlots.push_back(i);
+        }
+        producer = std::thread([this] { produce(); });
+    }
+
+    PointStreamer(const PointStreamer&) = delete;
+    PointStreamer& operator=(const PointStreamer&) = delete;
+
+    ~PointStreamer() {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        slotFreed.notify_all();
+        if (producer.joinable())
+            producer.join();
+        if (mapped) {
+            glState().bindBuffer(GL_ARRAY_BUFFER, vbo);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+        }
+        glState().deleteBuffer(vbo);
+    }
+
+    /**
+     * @brief 每帧在 GL 线程调用一次，提交已生成的分块
+     *
+     * @return 可以绘制的点数，从缓冲起始处连续
+     */
+    std::size_t pump() {
+        GLUTILS_PROFILE_ZONE("PointStreamer::pump");
+        if (persistentMapping) {
+            std::size_t ready = readyChunks.load(std::memory_order_acquire);
+            // 后台线程已经直接写进映射，这里只统计新可见的字节数
+            GLUTILS_COUNT_UPLOAD((std::min(ready * chunkPoints, total) - std::min(uploadedChunks * chunkPoints, total)) * 3 * sizeof(float));
+            uploadedChunks = ready;
+        } else {
+            std::deque<std::size_t> ready;
+            {
+                std::lock_guard lock(mutex);
+                ready.swap(readySlots);
+            }
+            if (!ready.empty())
+                glState().bindBuffer(GL_ARRAY_BUFFER, vbo);
+            for (std::size_t slot : ready) {
+                std::size_t first = uploadedChunks * chunkPoints;
+                std::size_t count = std::min(chunkPoints, total - first);
+                GLsizeiptr bytes = static_cast<GLsizeiptr>(count * 3 * sizeof(float));
+                // 这段区间还没有被任何绘制命令引用，可以跳过同步
+                void* dst = glMapBufferRange(GL_ARRAY_BUFFER, static_cast<GLintptr>(first * 3 * sizeof(float)), bytes,
+                                             GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+                if (dst) {
+                    std::memcpy(dst, slots[slot].data(), static_cast<std::size_t>(bytes));
+                    glUnmapBuffer(GL_ARRAY_BUFFER);
+                } else {
+                    glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(first * 3 * sizeof(float)), bytes, slots[slot].data());
+                }
+                GLUTILS_COUNT_UPLOAD(bytes);
+                ++uploadedChunks;
+                {
+                    std::lock_guard lock(mutex);
+                    freeSlots.push_back(slot);
+                }
+                slotFreed.notify_one();
+            }
+        }
+        return std::min(uploadedChunks * chunkPoints, total);
+    }
+
+    bool finished() const { return uploadedChunks == chunkCount; }
+    bool isPersistent() const { return persistentMapping; }
+    unsigned int buffer() const { return vbo; }
+    std::size_t size() const { return total; }
+
+private:
+    void produce() {
+        for (std::size_t chunk = 0; chunk < chunkCount; ++chunk) {
+            std::size_t first = chunk * chunkPoints;
+            std::size_t count = std::min(chunkPoints, total - first);
+            GLUTILS_PROFILE_ZONE("PointStreamer::produce");
+            if (persistentMapping) {
+                if (stopRequested())
+                    return;
+                readParallel(source, first, count, mapped + first * 3);
+                readyChunks.store(chunk + 1, std::memory_order_release);
+                continue;
+            }
+            std::size_t slot;
+            {
+                std::unique_lock lock(mutex);
+                slotFreed.wait(lock, [this] { return stopping || !freeSlots.empty(); });
+                if (stopping)
+                    return;
+                slot = freeSlots.front();
+                freeSlots.pop_front();
+            }
+            readParallel(source, first, count, slots[slot].data());
+            std::lock_guard lock(mutex);
+            readySlots.push_back(slot);
+        }
+    }
+
+    bool stopRequested() {
+        std::lock_guard lock(mutex);
+        return stopping;
+    }
+
+    const PointSource& source;
+    std::size_t total;
+    std::size_t chunkPoints;
+    std::size_t chunkCount = 0;
+    std::size_t uploadedChunks = 0;
+
+    unsigned int vbo = 0;
+    bool persistentMapping = false;
+    float* mapped = nullptr;
+    std::atomic<std::size_t> readyChunks{0};
+
+    // 非持久映射路径使用的暂存槽
+    std::array<std::vector<float>, 3> slots;
+    std::deque<std::size_t> freeSlots;
+    std::deque<std::size_t> readySlots;
+
+    std::mutex mutex;
+    std::condition_variable slotFreed;
+    bool stopping = false;
+    std::thread producer;
+};
+
+}
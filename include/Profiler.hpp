@@ -0,0 +1,286 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include <glad/glad.h>
+
+// 性能分析开关：编译时定义 GLUTILS_PROFILING=0 后所有 GLUTILS_PROFILE_* / GLUTILS_COUNT_* 宏展开为空，
+// 不产生任何调用，可以放心留在发布版代码里
+#ifndef GLUTILS_PROFILING
+#define GLUTILS_PROFILING 1
+#endif
+
+namespace glutils {
+
+// 每帧计数器
+struct FrameCounters {
+    std::uint64_t drawCalls = 0;
+    std::uint64_t stateChanges = 0;
+    std::uint64_t uploadBytes = 0;
+};
+
+namespace detail {
+
+// Chrome trace 的一个完整事件（ph = "X"），时间单位为微秒
+struct ProfileEvent {
+    const char* name;
+    std::uint32_t thread;
+    double startUs;
+    double durationUs;
+};
+
+// 线程的短编号，用作 trace 中的 tid
+inline std::uint32_t profileThreadId() {
+    static std::atomic<std::uint32_t> next{ 1 };
+    thread_local std::uint32_t id = next.fetch_add(1);
+    return id;
+}
+
+}
+
+/**
+ * @brief 帧性能分析器（进程内单例）
+ *
+ * - CPU 区间：ProfileZone 构造到析构之间的耗时，任意线程可用；
+ * - GPU 区间：GpuProfileZone 在命令流中插入一对 GL_TIMESTAMP 查询（可以嵌套，GL_TIME_ELAPSED 不行），
+ *   查询按帧放入 kFrameLatency 个槽位组成的环，endFrame() 只读取 kFrameLatency - 1 帧之前的槽位，
+ *   结果还没出来就丢弃该帧的 GPU 数据而不是等待，因此不会阻塞流水线；
+ * - 计数器：每帧的绘制调用数、状态切换数、上传字节数；
+ * - writeChromeTrace() 导出 chrome://tracing / Perfetto 可以打开的 JSON。
+ *
+ * GPU 区间和 endFrame() 必须在持有 GL 上下文的线程调用。
+ */
+class Profiler {
+public:
+    static constexpr std::size_t kFrameLatency = 3;
+    // 事件数上限，超过后不再记录，避免长时间运行时内存无限增长
+    static constexpr std::size_t kMaxEvents = 1 << 20;
+    // trace 中 GPU 区间使用的 tid
+    static constexpr std::uint32_t kGpuThread = 0;
+
+    static Profiler& instance() {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    // 距离分析器创建的时间（微秒）
+    double nowUs() const {
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - epoch).count();
+    }
+
+    void recordCpu(const char* name, double startUs, double endUs) {
+        std::lock_guard lock(mutex);
+        if (events.size() < kMaxEvents)
+            events.push_back({ name, detail::profileThreadId(), startUs, endUs - startUs });
+    }
+
+    // 在命令流中插入区间起点，返回区间编号
+    std::size_t beginGpu(const char* name) {
+        initGpu();
+        FrameQueries& frame = frames[frameIndex % kFrameLatency];
+        const std::size_t zone = frame.names.size();
+        if (frame.queries.size() < (zone + 1) * 2) {
+            frame.queries.resize((zone + 1) * 2);
+            glGenQueries(2, &frame.queries[zone * 2]);
+        }
+        frame.names.push_back(name);
+        glQueryCounter(frame.queries[zone * 2], GL_TIMESTAMP);
+        return zone;
+    }
+
+    void endGpu(std::size_t zone) {
+        FrameQueries& frame = frames[frameIndex % kFrameLatency];
+        glQueryCounter(frame.queries[zone * 2 + 1], GL_TIMESTAMP);
+    }
+
+    void countDraw(std::uint64_t calls = 1) { current.drawCalls.fetch_add(calls, std::memory_order_relaxed); }
+    void countStateChange(std::uint64_t changes = 1) { current.stateChanges.fetch_add(changes, std::memory_order_relaxed); }
+    void countUpload(std::uint64_t bytes) { current.uploadBytes.fetch_add(bytes, std::memory_order_relaxed); }
+
+    /**
+     * @brief 帧结束标记：收集旧帧的 GPU 结果，保存并清零本帧计数器
+     */
+    void endFrame() {
+        const double now = nowUs();
+        last.drawCalls = current.drawCalls.exchange(0, std::memory_order_relaxed);
+        last.stateChanges = current.stateChanges.exchange(0, std::memory_order_relaxed);
+        last.uploadBytes = current.uploadBytes.exchange(0, std::memory_order_relaxed);
+        {
+            std::lock_guard lock(mutex);
+            if (events.size() < kMaxEvents) {
+                events.push_back({ "frame", detail::profileThreadId(), frameStartUs, now - frameStartUs });
+                counterSamples.push_back({ now, last });
+            }
+        }
+        frameStartUs = now;
+
+        ++frameIndex;
+        // 下一帧要复用的槽位就是最旧的那一帧
+        if (gpuReady)
+            resolve(frames[frameIndex % kFrameLatency]);
+    }
+
+    // 上一帧的计数器
+    const FrameCounters& lastFrame() const { return last; }
+
+    // 因结果未就绪而被丢弃 GPU 数据的帧数
+    std::size_t droppedGpuFrames() const { return dropped; }
+
+    /**
+     * @brief 导出 Chrome trace-event JSON
+     *
+     * CPU 区间按线程分行，GPU 区间在单独的 "GPU" 行，计数器为 "C" 事件。
+     */
+    bool writeChromeTrace(const std::filesystem::path& path) const {
+        nlohmann::json trace = nlohmann::json::array();
+        trace.push_back({ { "name", "thread_name" }, { "ph", "M" }, { "pid", 0 }, { "tid", kGpuThread }, { "args", { { "name", "GPU" } } } });
+        {
+            std::lock_guard lock(mutex);
+            for (const auto& event : events) {
+                trace.push_back({ { "name", event.name }, { "ph", "X" }, { "pid", 0 }, { "tid", event.thread },
+                                  { "ts", event.startUs }, { "dur", event.durationUs } });
+            }
+            for (const auto& [ts, counters] : counterSamples) {
+                trace.push_back({ { "name", "frame counters" }, { "ph", "C" }, { "pid", 0 }, { "ts", ts },
+                                  { "args", { { "drawCalls", counters.drawCalls }, { "stateChanges", counters.stateChanges },
+                                              { "uploadKiB", double(counters.uploadBytes) / 1024.0 } } } });
+            }
+        }
+        std::ofstream file(path, std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Failed to write trace: " << path << std::endl;
+            return false;
+        }
+        file << nlohmann::json{ { "traceEvents", trace }, { "displayTimeUnit", "ms" } }.dump();
+        return static_cast<bool>(file);
+    }
+
+    // 清空已记录的事件
+    void clear() {
+        std::lock_guard lock(mutex);
+        events.clear();
+        counterSamples.clear();
+    }
+
+private:
+    struct FrameQueries {
+        std::vector<GLuint> queries;
+        std::vector<const char*> names;
+    };
+
+    struct AtomicCounters {
+        std::atomic<std::uint64_t> drawCalls{ 0 };
+        std::atomic<std::uint64_t> stateChanges{ 0 };
+        std::atomic<std::uint64_t> uploadBytes{ 0 };
+    };
+
+    Profiler() : epoch(std::chrono::steady_clock::now()) {}
+
+    // 第一次使用 GPU 区间时记录 GPU 时钟与 CPU 时钟的对应关系
+    void initGpu() {
+        if (gpuReady)
+            return;
+        gpuReady = true;
+        GLint64 gpuNow = 0;
+        glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+        gpuOriginNs = gpuNow;
+        cpuOriginUs = nowUs();
+    }
+
+    void resolve(FrameQueries& frame) {
+        if (frame.names.empty())
+            return;
+        // 嵌套区间的结束顺序与编号顺序不同，逐个检查终点查询
+        GLint available = GL_TRUE;
+        for (std::size_t zone = 0; zone < frame.names.size() && available; ++zone)
+            glGetQueryObjectiv(frame.queries[zone * 2 + 1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available) {
+            std::lock_guard lock(mutex);
+            for (std::size_t zone = 0; zone < frame.names.size() && events.size() < kMaxEvents; ++zone) {
+                GLuint64 begin = 0, end = 0;
+                glGetQueryObjectui64v(frame.queries[zone * 2], GL_QUERY_RESULT, &begin);
+                glGetQueryObjectui64v(frame.queries[zone * 2 + 1], GL_QUERY_RESULT, &end);
+                const double startUs = cpuOriginUs + (double(begin) - double(gpuOriginNs)) / 1000.0;
+                events.push_back({ frame.names[zone], kGpuThread, startUs, (double(end) - double(begin)) / 1000.0 });
+            }
+        } else {
+            ++dropped;
+        }
+        frame.names.clear();
+    }
+
+    std::chrono::steady_clock::time_point epoch;
+    mutable std::mutex mutex;
+    std::vector<detail::ProfileEvent> events;
+    std::vector<std::pair<double, FrameCounters>> counterSamples;
+
+    AtomicCounters current;
+    FrameCounters last;
+    double frameStartUs = 0.0;
+
+    std::array<FrameQueries, kFrameLatency> frames;
+    std::size_t frameIndex = 0;
+    std::size_t dropped = 0;
+    bool gpuReady = false;
+    GLint64 gpuOriginNs = 0;
+    double cpuOriginUs = 0.0;
+};
+
+// CPU 区间：构造到析构之间的耗时；name 必须是静态存储期的字符串
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* name) : name(name), startUs(Profiler::instance().nowUs()) {}
+    ~ProfileZone() { Profiler::instance().recordCpu(name, startUs, Profiler::instance().nowUs()); }
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char* name;
+    double startUs;
+};
+
+// CPU + GPU 区间：同时记录 CPU 耗时和命令流中两个时间戳之间的 GPU 耗时
+class GpuProfileZone {
+public:
+    explicit GpuProfileZone(const char* name) : cpu(name), zone(Profiler::instance().beginGpu(name)) {}
+    ~GpuProfileZone() { Profiler::instance().endGpu(zone); }
+    GpuProfileZone(const GpuProfileZone&) = delete;
+    GpuProfileZone& operator=(const GpuProfileZone&) = delete;
+
+private:
+    ProfileZone cpu;
+    std::size_t zone;
+};
+
+}
+
+#define GLUTILS_PROFILE_CONCAT_IMPL(a, b) a##b
+#define GLUTILS_PROFILE_CONCAT(a, b) GLUTILS_PROFILE_CONCAT_IMPL(a, b)
+
+#if GLUTILS_PROFILING
+#define GLUTILS_PROFILE_ZONE(name) ::glutils::ProfileZone GLUTILS_PROFILE_CONCAT(glutilsProfileZone, __LINE__)(name)
+#define GLUTILS_PROFILE_GPU_ZONE(name) ::glutils::GpuProfileZone GLUTILS_PROFILE_CONCAT(glutilsGpuProfileZone, __LINE__)(name)
+#define GLUTILS_PROFILE_FRAME() ::glutils::Profiler::instance().endFrame()
+#define GLUTILS_COUNT_DRAW(calls) ::glutils::Profiler::instance().countDraw(calls)
+#define GLUTILS_COUNT_STATE_CHANGES(changes) ::glutils::Profiler::instance().countStateChange(changes)
+#define GLUTILS_COUNT_UPLOAD(bytes) ::glutils::Profiler::instance().countUpload(static_cast<std::uint64_t>(bytes))
+#else
+#define GLUTILS_PROFILE_ZONE(name) ((void)0)
+#define GLUTILS_PROFILE_GPU_ZONE(name) ((void)0)
+#define GLUTILS_PROFILE_FRAME() ((void)0)
+#define GLUTILS_COUNT_DRAW(calls) ((void)0)
+#define GLUTILS_COUNT_STATE_CHANGES(changes) ((void)0)
+#define GLUTILS_COUNT_UPLOAD(bytes) ((void)0)
+#endif
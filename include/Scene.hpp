@@ -0,0 +1,654 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <nlohmann/json.hpp>
+
+#include "GLHandles.hpp"
+#include "GLUtils.hpp"
+#include "MappedFile.hpp"
+#include "MeshLoader.hpp"
+#include "PointCloud.hpp"
+#include "PointCloudFile.hpp"
+#include "Profiler.hpp"
+#include "ShaderCache.hpp"
+#include "Transforms.hpp"
+
+namespace glutils {
+
+/**
+ * 场景描述（JSON）与烘焙缓存（二进制）
+ *
+ * JSON 格式，路径相对于场景文件所在目录：
+ * {
+ *   "camera": { "position": [0, 1, 4], "target": [0, 0, 0], "up": [0, 1, 0], "fov": 45, "near": 0.1, "far": 100 },
+ *   "shaders": { "milk": { "vertex": "../shaders/MilkWhite.vert", "fragment": "../shaders/MilkWhite.frag" } },
+ *   "meshes": { "cube": "../meshes/cube.obj" },
+ *   "pointClouds": {
+ *     "scan": "scan.xyz",                                                         // .xyz / .ply / .gpc
+ *     "noise": { "random": { "count": 100000, "seed": 42, "min": -3, "max": 3 } }  // RandomPointSource
+ *   },
+ *   "instances": [
+ *     { "mesh": "cube", "shader": "milk", "position": [0, 0, 0], "rotation": [0, 45, 0], "scale": 1, "color": [1, 1, 1, 1] },
+ *     { "points": "noise", "shader": "points" }
+ *   ]
+ * }
+ * rotation 为角度，依次绕 X、Y、Z 轴旋转；scale 可以是一个数或三个数。
+ *
+ * 所有网格的顶点（Position + Normal，6 个 float）和索引分别拼接成一个数组，每个网格记录自己的区间，
+ * 所有点云同样拼接成一个 xyz 数组。这就是 GPU 上的最终布局：烘焙文件把这些数组原样写出，
+ * 加载时映射文件后直接从映射内存上传，不再解析 JSON、读取各个源文件或解析网格文本。
+ * 加载时读过的每个文件（场景本身、着色器、网格、点云）连同修改时间和大小一起记录为依赖，
+ * 写进烘焙文件；任何一个依赖变化后 sceneDependenciesChanged 返回 true，需要重新烘焙。
+ */
+
+// 相机参数（POD，原样写进烘焙文件）
+struct SceneCamera {
+    float position[3] = { 0.0f, 0.0f, 3.0f };
+    float target[3] = { 0.0f, 0.0f, 0.0f };
+    float up[3] = { 0.0f, 1.0f, 0.0f };
+    float fovDegrees = 45.0f;
+    float nearPlane = 0.1f;
+    float farPlane = 100.0f;
+
+    glm::mat4 viewMatrix() const { return glm::lookAt(glm::make_vec3(position), glm::make_vec3(target), glm::make_vec3(up)); }
+    glm::mat4 projectionMatrix(float aspect) const { return glm::perspective(glm::radians(fovDegrees), aspect, nearPlane, farPlane); }
+};
+
+// 网格在拼接后的顶点 / 索引数组中的区间
+struct SceneMeshRange {
+    std::uint32_t baseVertex;
+    std::uint32_t vertexCount;
+    std::uint32_t firstIndex;
+    std::uint32_t indexCount;
+};
+
+// 点云在拼接后的点数组中的区间（以点为单位）
+struct ScenePointRange {
+    std::uint32_t firstPoint;
+    std::uint32_t pointCount;
+};
+
+enum class SceneGeometry : std::uint32_t { Mesh = 0, Points = 1 };
+
+struct SceneInstance {
+    SceneGeometry kind;
+    // meshes 或 pointClouds 中的下标
+    std::uint32_t geometry;
+    std::uint32_t shader;
+    std::uint32_t reserved;
+    float color[4];
+    // 列主序模型矩阵
+    float model[16];
+};
+
+static_assert(sizeof(SceneCamera) == 48, "SceneCamera 布局不能改变");
+static_assert(sizeof(SceneMeshRange) == 16, "SceneMeshRange 布局不能改变");
+static_assert(sizeof(ScenePointRange) == 8, "ScenePointRange 布局不能改变");
+static_assert(sizeof(SceneInstance) == 96, "SceneInstance 布局不能改变");
+
+// 每个网格顶点的 float 数：Position(3) + Normal(3)
+inline constexpr std::size_t kSceneVertexFloats = 6;
+
+struct SceneShaderView {
+    std::string_view vertex;
+    std::string_view fragment;
+};
+
+// 加载场景时读取的文件（绝对路径）及当时的修改时间和大小
+struct SceneDependencyView {
+    std::string_view path;
+    std::int64_t writeTime;
+    std::uint64_t bytes;
+};
+
+/**
+ * @brief 场景数据的只读视图，JSON 加载的 Scene 和映射的 BakedScene 都提供，SceneRenderer 只依赖它
+ */
+struct SceneView {
+    SceneCamera camera;
+    std::span<const float> vertices;
+    std::span<const std::uint32_t> indices;
+    std::span<const float> points;
+    std::span<const SceneMeshRange> meshes;
+    std::span<const ScenePointRange> pointClouds;
+    std::span<const SceneInstance> instances;
+    std::vector<SceneShaderView> shaders;
+    std::vector<SceneDependencyView> dependencies;
+};
+
+struct SceneShader {
+    std::string vertex;
+    std::string fragment;
+};
+
+struct SceneDependency {
+    std::string path;
+    std::int64_t writeTime = 0;
+    std::uint64_t bytes = 0;
+};
+
+// 从 JSON 加载、拥有全部数据的场景
+struct Scene {
+    SceneCamera camera;
+    std::vector<float> vertices;
+    std::vector<std::uint32_t> indices;
+    std::vector<float> points;
+    std::vector<SceneMeshRange> meshes;
+    std::vector<ScenePointRange> pointClouds;
+    std::vector<SceneInstance> instances;
+    std::vector<SceneShader> shaders;
+    std::vector<SceneDependency> dependencies;
+
+    SceneView view() const {
+        SceneView result{ camera, vertices, indices, points, meshes, pointClouds, instances, {}, {} };
+        result.shaders.reserve(shaders.size());
+        for (const SceneShader& shader : shaders)
+            result.shaders.push_back({ shader.vertex, shader.fragment });
+        result.dependencies.reserve(dependencies.size());
+        for (const SceneDependency& dependency : dependencies)
+            result.dependencies.push_back({ dependency.path, dependency.writeTime, dependency.bytes });
+        return result;
+    }
+};
+
+namespace detail {
+
+// 文件当前的修改时间和大小；文件不存在时返回 false
+inline bool statSceneFile(const std::filesystem::path& path, std::int64_t& writeTime, std::uint64_t& bytes) {
+    std::error_code ec;
+    const auto time = std::filesystem::last_write_time(path, ec);
+    if (ec)
+        return false;
+    const auto size = std::filesystem::file_size(path, ec);
+    if (ec)
+        return false;
+    writeTime = static_cast<std::int64_t>(time.time_since_epoch().count());
+    bytes = static_cast<std::uint64_t>(size);
+    return true;
+}
+
+// 记录一个加载时读取的文件，重复引用只记一次
+inline void addSceneDependency(Scene& scene, const std::filesystem::path& path) {
+    std::error_code ec;
+    const std::filesystem::path absolute = std::filesystem::absolute(path, ec).lexically_normal();
+    SceneDependency dependency;
+    dependency.path = (ec ? path : absolute).string();
+    for (const SceneDependency& existing : scene.dependencies)
+        if (existing.path == dependency.path)
+            return;
+    if (statSceneFile(dependency.path, dependency.writeTime, dependency.bytes))
+        scene.dependencies.push_back(std::move(dependency));
+}
+
+inline void readVec3(const nlohmann::json& node, const char* key, float out[3]) {
+    if (!node.contains(key))
+        return;
+    const nlohmann::json& value = node.at(key);
+    if (value.is_number()) {
+        out[0] = out[1] = out[2] = value.get<float>();
+        return;
+    }
+    for (int a = 0; a < 3; ++a)
+        out[a] = value.at(a).get<float>();
+}
+
+// 把一个网格追加到拼接数组，记录区间
+inline void appendSceneMesh(Scene& scene, const Mesh& mesh) {
+    SceneMeshRange range;
+    range.baseVertex = static_cast<std::uint32_t>(scene.vertices.size() / kSceneVertexFloats);
+    range.vertexCount = static_cast<std::uint32_t>(mesh.vertexCount());
+    range.firstIndex = static_cast<std::uint32_t>(scene.indices.size());
+    range.indexCount = static_cast<std::uint32_t>(mesh.indices.size());
+    scene.vertices.insert(scene.vertices.end(), mesh.vertices.begin(), mesh.vertices.end());
+    scene.indices.insert(scene.indices.end(), mesh.indices.begin(), mesh.indices.end());
+    scene.meshes.push_back(range);
+}
+
+inline bool appendScenePoints(Scene& scene, const nlohmann::json& node, const std::filesystem::path& base) {
+    const std::size_t first = scene.points.size() / 3;
+    if (node.is_object() && node.contains("random")) {
+        const nlohmann::json& random = node.at("random");
+        RandomPointSource source(random.value("count", std::size_t{ 100000 }), random.value("seed", std::uint64_t{ 42 }),
+                                 random.value("min", -1.0f), random.value("max", 1.0f));
+        scene.points.resize((first + source.size()) * 3);
+        readParallel(source, 0, source.size(), scene.points.data() + first * 3);
+    } else {
+        const std::filesystem::path path = base / node.get<std::string>();
+        addSceneDependency(scene, path);
+        if (path.extension() == ".gpc") {
+            PointCloudFile file;
+            if (!file.open(path))
+                return false;
+            scene.points.resize((first + file.size()) * 3);
+            readParallel(file, 0, file.size(), scene.points.data() + first * 3);
+        } else if (!importPointCloud(path, scene.points)) {
+            return false;
+        }
+    }
+    scene.pointClouds.push_back({ static_cast<std::uint32_t>(first), static_cast<std::uint32_t>(scene.points.size() / 3 - first) });
+    return true;
+}
+
+}
+
+/**
+ * @brief 加载 JSON 场景：解析描述，读取并解析引用的着色器、网格和点云
+ *
+ * 失败（文件缺失、格式错误、引用了不存在的名字）时打印原因并返回 false。
+ */
+inline bool loadScene(const std::filesystem::path& path, Scene& scene) {
+    GLUTILS_PROFILE_ZONE("loadScene");
+    scene = Scene{};
+    std::string text;
+    if (!detail::readWholeFile(path.string(), text)) {
+        std::cerr << "无法打开场景文件: " << path.string() << std::endl;
+        return false;
+    }
+    const nlohmann::json root = nlohmann::json::parse(text, nullptr, false);
+    if (root.is_discarded() || !root.is_object()) {
+        std::cerr << "场景文件不是有效的 JSON 对象: " << path.string() << std::endl;
+        return false;
+    }
+    detail::addSceneDependency(scene, path);
+    const std::filesystem::path base = path.parent_path();
+    try {
+        if (root.contains("camera")) {
+            const nlohmann::json& camera = root.at("camera");
+            detail::readVec3(camera, "position", scene.camera.position);
+            detail::readVec3(camera, "target", scene.camera.target);
+            detail::readVec3(camera, "up", scene.camera.up);
+            scene.camera.fovDegrees = camera.value("fov", scene.camera.fovDegrees);
+            scene.camera.nearPlane = camera.value("near", scene.camera.nearPlane);
+            scene.camera.farPlane = camera.value("far", scene.camera.farPlane);
+        }
+
+        // value() 返回副本，先存下来再遍历
+        const nlohmann::json shaders = root.value("shaders", nlohmann::json::object());
+        const nlohmann::json meshes = root.value("meshes", nlohmann::json::object());
+        const nlohmann::json pointClouds = root.value("pointClouds", nlohmann::json::object());
+        const nlohmann::json instances = root.value("instances", nlohmann::json::array());
+
+        std::unordered_map<std::string, std::uint32_t> shaderIds, meshIds, pointIds;
+        for (const auto& [name, node] : shaders.items()) {
+            SceneShader shader;
+            for (auto [key, out] : { std::pair{ "vertex", &shader.vertex }, std::pair{ "fragment", &shader.fragment } }) {
+                const std::filesystem::path file = base / node.at(key).get<std::string>();
+                if (!detail::readWholeFile(file.string(), *out)) {
+                    std::cerr << "无法打开着色器文件: " << file.string() << std::endl;
+                    return false;
+                }
+                detail::addSceneDependency(scene, file);
+            }
+            shaderIds[name] = static_cast<std::uint32_t>(scene.shaders.size());
+            scene.shaders.push_back(std::move(shader));
+        }
+        for (const auto& [name, node] : meshes.items()) {
+            Mesh mesh;
+            const std::filesystem::path file = base / node.get<std::string>();
+            if (!loadMesh(file, mesh))
+                return false;
+            detail::addSceneDependency(scene, file);
+            meshIds[name] = static_cast<std::uint32_t>(scene.meshes.size());
+            detail::appendSceneMesh(scene, mesh);
+        }
+        for (const auto& [name, node] : pointClouds.items()) {
+            pointIds[name] = static_cast<std::uint32_t>(scene.pointClouds.size());
+            if (!detail::appendScenePoints(scene, node, base))
+                return false;
+        }
+
+        auto lookup = [&](const std::unordered_map<std::string, std::uint32_t>& ids, const std::string& name, const char* what, std::uint32_t& out) {
+            auto it = ids.find(name);
+            if (it == ids.end()) {
+                std::cerr << "场景引用了不存在的" << what << ": " << name << std::endl;
+                return false;
+            }
+            out = it->second;
+            return true;
+        };
+        for (const nlohmann::json& node : instances) {
+            SceneInstance instance{};
+            const bool isMesh = node.contains("mesh");
+            instance.kind = isMesh ? SceneGeometry::Mesh : SceneGeometry::Points;
+            if (!lookup(isMesh ? meshIds : pointIds, node.at(isMesh ? "mesh" : "points").get<std::string>(), isMesh ? "网格" : "点云", instance.geometry))
+                return false;
+            if (!lookup(shaderIds, node.at("shader").get<std::string>(), "着色器", instance.shader))
+                return false;
+
+            float position[3] = { 0.0f, 0.0f, 0.0f }, rotation[3] = { 0.0f, 0.0f, 0.0f }, scale[3] = { 1.0f, 1.0f, 1.0f };
+            detail::readVec3(node, "position", position);
+            detail::readVec3(node, "rotation", rotation);
+            detail::readVec3(node, "scale", scale);
+            glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::make_vec3(position));
+            model = glm::rotate(model, glm::radians(rotation[2]), glm::vec3(0.0f, 0.0f, 1.0f));
+            model = glm::rotate(model, glm::radians(rotation[1]), glm::vec3(0.0f, 1.0f, 0.0f));
+            model = glm::rotate(model, glm::radians(rotation[0]), glm::vec3(1.0f, 0.0f, 0.0f));
+            model = glm::scale(model, glm::make_vec3(scale));
+            std::memcpy(instance.model, glm::value_ptr(model), sizeof(instance.model));
+
+            const std::vector<float> color = node.value("color", std::vector<float>{ 1.0f, 1.0f, 1.0f, 1.0f });
+            for (std::size_t c = 0; c < 4; ++c)
+                instance.color[c] = c < color.size() ? color[c] : 1.0f;
+            scene.instances.push_back(instance);
+        }
+    } catch (const nlohmann::json::exception& e) {
+        std::cerr << "场景文件格式错误（" << e.what() << "）: " << path.string() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 烘焙文件（.gsc）
+ *
+ * 布局：文件头（含各段的偏移和长度）| 各段数据（64 字节对齐）。
+ * 段依次为：顶点、索引、点、网格区间、点云区间、实例、着色器记录、依赖记录、字符串（着色器源码和依赖路径）。
+ * 文件按小端序存储，数组段直接就是 SceneView 中各 span 的内容。
+ */
+enum class SceneSectionId : std::uint32_t { Vertices, Indices, Points, Meshes, PointClouds, Instances, Shaders, Dependencies, Strings, Count };
+
+struct SceneSection {
+    std::uint64_t offset;
+    std::uint64_t bytes;
+};
+
+// 着色器源码在字符串段中的位置
+struct SceneShaderRecord {
+    std::uint64_t vertexOffset;
+    std::uint64_t vertexBytes;
+    std::uint64_t fragmentOffset;
+    std::uint64_t fragmentBytes;
+};
+
+// 依赖文件的路径在字符串段中的位置，以及烘焙时记录的修改时间和大小
+struct SceneDependencyRecord {
+    std::uint64_t pathOffset;
+    std::uint64_t pathBytes;
+    std::int64_t writeTime;
+    std::uint64_t bytes;
+};
+
+struct SceneFileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t sectionCount;
+    SceneCamera camera;
+    SceneSection sections[static_cast<std::size_t>(SceneSectionId::Count)];
+};
+
+static_assert(sizeof(SceneShaderRecord) == 32, "SceneShaderRecord 布局不能改变");
+static_assert(sizeof(SceneDependencyRecord) == 32, "SceneDependencyRecord 布局不能改变");
+static_assert(sizeof(SceneFileHeader) == 208, "SceneFileHeader 布局不能改变");
+
+inline constexpr char kSceneMagic[8] = { 'G', 'L', 'U', 'T', 'S', 'C', 'N', '\0' };
+inline constexpr std::uint32_t kSceneVersion = 2;
+
+/**
+ * @brief 把场景烘焙为一个可直接映射的二进制文件
+ */
+inline bool bakeScene(const SceneView& scene, const std::filesystem::path& path) {
+    GLUTILS_PROFILE_ZONE("bakeScene");
+    constexpr std::size_t kSections = static_cast<std::size_t>(SceneSectionId::Count);
+
+    std::vector<SceneShaderRecord> records;
+    std::uint64_t stringBytes = 0;
+    for (const SceneShaderView& shader : scene.shaders) {
+        records.push_back({ stringBytes, shader.vertex.size(), stringBytes + shader.vertex.size(), shader.fragment.size() });
+        stringBytes += shader.vertex.size() + shader.fragment.size();
+    }
+    std::vector<SceneDependencyRecord> dependencies;
+    for (const SceneDependencyView& dependency : scene.dependencies) {
+        dependencies.push_back({ stringBytes, dependency.path.size(), dependency.writeTime, dependency.bytes });
+        stringBytes += dependency.path.size();
+    }
+
+    const void* sources[kSections] = { scene.vertices.data(), scene.indices.data(), scene.points.data(), scene.meshes.data(),
+                                       scene.pointClouds.data(), scene.instances.data(), records.data(), dependencies.data(), nullptr };
+    SceneFileHeader header{};
+    std::memcpy(header.magic, kSceneMagic, sizeof(header.magic));
+    header.version = kSceneVersion;
+    header.sectionCount = static_cast<std::uint32_t>(kSections);
+    header.camera = scene.camera;
+    const std::uint64_t bytes[kSections] = { scene.vertices.size_bytes(), scene.indices.size_bytes(), scene.points.size_bytes(),
+                                             scene.meshes.size_bytes(), scene.pointClouds.size_bytes(), scene.instances.size_bytes(),
+                                             records.size() * sizeof(SceneShaderRecord), dependencies.size() * sizeof(SceneDependencyRecord),
+                                             stringBytes };
+    std::size_t offset = sizeof(header);
+    for (std::size_t s = 0; s < kSections; ++s) {
+        offset = (offset + 63) & ~std::size_t{ 63 };
+        header.sections[s] = { offset, bytes[s] };
+        offset += bytes[s];
+    }
+
+    const bool ok = writeSizedFile(path, offset, [&](char* out) {
+        // 对齐填充清零，保证输出可复现
+        std::memset(out, 0, offset);
+        std::memcpy(out, &header, sizeof(header));
+        for (std::size_t s = 0; s + 1 < kSections; ++s)
+            if (bytes[s])
+                std::memcpy(out + header.sections[s].offset, sources[s], bytes[s]);
+        char* strings = out + header.sections[static_cast<std::size_t>(SceneSectionId::Strings)].offset;
+        for (std::size_t i = 0; i < records.size(); ++i) {
+            std::memcpy(strings + records[i].vertexOffset, scene.shaders[i].vertex.data(), records[i].vertexBytes);
+            std::memcpy(strings + records[i].fragmentOffset, scene.shaders[i].fragment.data(), records[i].fragmentBytes);
+        }
+        for (std::size_t i = 0; i < dependencies.size(); ++i)
+            std::memcpy(strings + dependencies[i].pathOffset, scene.dependencies[i].path.data(), dependencies[i].pathBytes);
+    });
+    if (!ok)
+        std::cerr << "无法写入烘焙场景: " << path.string() << std::endl;
+    return ok;
+}
+
+/**
+ * @brief 映射打开的烘焙场景；view() 中的数组直接指向映射内存，对象存活期间有效
+ */
+class BakedScene {
+public:
+    bool open(const std::filesystem::path& path) {
+        GLUTILS_PROFILE_ZONE("BakedScene::open");
+        hdr = nullptr;
+        if (!file.openRead(path)) {
+            std::cerr << "无法打开烘焙场景: " << path.string() << std::endl;
+            return false;
+        }
+        auto fail = [&](const char* reason) {
+            std::cerr << "烘焙场景无效（" << reason << "）: " << path.string() << std::endl;
+            file.close();
+            return false;
+        };
+        const std::size_t size = file.size();
+        if (size < sizeof(SceneFileHeader))
+            return fail("文件过短");
+        auto header = reinterpret_cast<const SceneFileHeader*>(file.data());
+        if (std::memcmp(header->magic, kSceneMagic, sizeof(kSceneMagic)) != 0)
+            return fail("文件标识不匹配");
+        if (header->version != kSceneVersion || header->sectionCount != static_cast<std::uint32_t>(SceneSectionId::Count))
+            return fail("版本不支持");
+        for (const SceneSection& section : header->sections)
+            if (section.offset > size || section.bytes > size - section.offset || section.offset % 16 != 0)
+                return fail("段越界");
+        hdr = header;
+
+        const auto vertexCount = section<float>(SceneSectionId::Vertices).size() / kSceneVertexFloats;
+        const auto indexCount = section<std::uint32_t>(SceneSectionId::Indices).size();
+        const auto pointCount = section<float>(SceneSectionId::Points).size() / 3;
+        for (const SceneMeshRange& mesh : section<SceneMeshRange>(SceneSectionId::Meshes))
+            if (std::uint64_t{ mesh.baseVertex } + mesh.vertexCount > vertexCount || std::uint64_t{ mesh.firstIndex } + mesh.indexCount > indexCount)
+                return fail("网格区间越界");
+        for (const ScenePointRange& cloud : section<ScenePointRange>(SceneSectionId::PointClouds))
+            if (std::uint64_t{ cloud.firstPoint } + cloud.pointCount > pointCount)
+                return fail("点云区间越界");
+        const auto strings = section<char>(SceneSectionId::Strings);
+        for (const SceneShaderRecord& record : section<SceneShaderRecord>(SceneSectionId::Shaders))
+            if (record.vertexOffset + record.vertexBytes > strings.size() || record.fragmentOffset + record.fragmentBytes > strings.size())
+                return fail("着色器源码越界");
+        for (const SceneDependencyRecord& record : section<SceneDependencyRecord>(SceneSectionId::Dependencies))
+            if (record.pathOffset + record.pathBytes > strings.size())
+                return fail("依赖路径越界");
+        const auto shaderCount = section<SceneShaderRecord>(SceneSectionId::Shaders).size();
+        const auto meshCount = section<SceneMeshRange>(SceneSectionId::Meshes).size();
+        const auto cloudCount = section<ScenePointRange>(SceneSectionId::PointClouds).size();
+        for (const SceneInstance& instance : section<SceneInstance>(SceneSectionId::Instances))
+            if (instance.shader >= shaderCount || instance.geometry >= (instance.kind == SceneGeometry::Mesh ? meshCount : cloudCount))
+                return fail("实例引用越界");
+        return true;
+    }
+
+    void close() {
+        file.close();
+        hdr = nullptr;
+    }
+
+    bool isOpen() const { return hdr != nullptr; }
+    std::size_t fileBytes() const { return file.size(); }
+
+    SceneView view() const {
+        SceneView result{ hdr->camera,
+                          section<float>(SceneSectionId::Vertices),
+                          section<std::uint32_t>(SceneSectionId::Indices),
+                          section<float>(SceneSectionId::Points),
+                          section<SceneMeshRange>(SceneSectionId::Meshes),
+                          section<ScenePointRange>(SceneSectionId::PointClouds),
+                          section<SceneInstance>(SceneSectionId::Instances),
+                          {},
+                          {} };
+        const auto strings = section<char>(SceneSectionId::Strings);
+        for (const SceneShaderRecord& record : section<SceneShaderRecord>(SceneSectionId::Shaders))
+            result.shaders.push_back({ std::string_view(strings.data() + record.vertexOffset, record.vertexBytes),
+                                       std::string_view(strings.data() + record.fragmentOffset, record.fragmentBytes) });
+        for (const SceneDependencyRecord& record : section<SceneDependencyRecord>(SceneSectionId::Dependencies))
+            result.dependencies.push_back({ std::string_view(strings.data() + record.pathOffset, record.pathBytes), record.writeTime, record.bytes });
+        return result;
+    }
+
+private:
+    template<typename T>
+    std::span<const T> section(SceneSectionId id) const {
+        const SceneSection& s = hdr->sections[static_cast<std::size_t>(id)];
+        return { reinterpret_cast<const T*>(file.data() + s.offset), static_cast<std::size_t>(s.bytes / sizeof(T)) };
+    }
+
+    MappedFile file;
+    const SceneFileHeader* hdr = nullptr;
+};
+
+/**
+ * @brief 场景记录的依赖文件是否有变化（修改时间或大小不同，或者文件已不存在）
+ *
+ * 用于判断烘焙缓存是否过期；没有任何依赖记录时同样视为已变化。
+ */
+inline bool sceneDependenciesChanged(const SceneView& scene) {
+    if (scene.dependencies.empty())
+        return true;
+    for (const SceneDependencyView& dependency : scene.dependencies) {
+        std::int64_t writeTime = 0;
+        std::uint64_t bytes = 0;
+        if (!detail::statSceneFile(std::filesystem::path(dependency.path), writeTime, bytes) || writeTime != dependency.writeTime || bytes != dependency.bytes)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief 把场景上传到 GPU 并绘制
+ *
+ * 所有网格共用一个 VBO / EBO / VAO，用 glDrawElementsBaseVertex 按区间绘制；所有点云共用一个 VBO / VAO。
+ * 着色器的 uniform 按名称可选：mvp、model、viewPos、color，程序里没有的跳过。
+ * 传入 ProgramCache 时着色器从程序二进制缓存恢复，第二次启动不再编译。
+ */
+class SceneRenderer {
+public:
+    explicit SceneRenderer(const SceneView& scene, ProgramCache* cache = nullptr)
+        : meshes(scene.meshes.begin(), scene.meshes.end()),
+          pointClouds(scene.pointClouds.begin(), scene.pointClouds.end()),
+          instances(scene.instances.begin(), scene.instances.end()) {
+        GLUTILS_PROFILE_ZONE("SceneRenderer upload");
+        programs.reserve(scene.shaders.size());
+        for (const SceneShaderView& shader : scene.shaders) {
+            const VertexShaderSource vertex{ std::string(shader.vertex) };
+            const FragmentShaderSource fragment{ std::string(shader.fragment) };
+            programs.emplace_back(cache ? cache->get(vertex, fragment) : compileShader(vertex, fragment));
+        }
+
+        if (!scene.vertices.empty()) {
+            meshVao = VertexArrayHandle::create();
+            vertexBuffer = BufferHandle::create();
+            indexBuffer = BufferHandle::create();
+            glState().bindVertexArray(meshVao.get());
+            glState().bindBuffer(GL_ARRAY_BUFFER, vertexBuffer.get());
+            glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(scene.vertices.size_bytes()), scene.vertices.data(), GL_STATIC_DRAW);
+            glState().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer.get());
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(scene.indices.size_bytes()), scene.indices.data(), GL_STATIC_DRAW);
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, kSceneVertexFloats * sizeof(float), (void*)0);
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, kSceneVertexFloats * sizeof(float), (void*)(3 * sizeof(float)));
+            glEnableVertexAttribArray(1);
+            GLUTILS_COUNT_UPLOAD(scene.vertices.size_bytes() + scene.indices.size_bytes());
+        }
+        if (!scene.points.empty()) {
+            pointVao = VertexArrayHandle::create();
+            pointBuffer = BufferHandle::create();
+            glState().bindVertexArray(pointVao.get());
+            glState().bindBuffer(GL_ARRAY_BUFFER, pointBuffer.get());
+            glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(scene.points.size_bytes()), scene.points.data(), GL_STATIC_DRAW);
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+            glEnableVertexAttribArray(0);
+            GLUTILS_COUNT_UPLOAD(scene.points.size_bytes());
+        }
+    }
+
+    SceneRenderer(const SceneRenderer&) = delete;
+    SceneRenderer& operator=(const SceneRenderer&) = delete;
+
+    void draw(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& eye) {
+        GLUTILS_PROFILE_ZONE("SceneRenderer::draw");
+        const glm::mat4 viewProjection = projection * view;
+        for (const SceneInstance& instance : instances) {
+            Shader& program = programs[instance.shader];
+            program.use();
+            const glm::mat4 model = glm::make_mat4(instance.model);
+            program.setUniform("mvp", viewProjection * model);
+            program.setUniform("model", model);
+            program.setUniform("normalMatrix", normalMatrix(model));
+            program.setUniform("viewPos", eye);
+            program.setUniform("color", glm::make_vec4(instance.color));
+            if (instance.kind == SceneGeometry::Mesh) {
+                const SceneMeshRange& mesh = meshes[instance.geometry];
+                glState().bindVertexArray(meshVao.get());
+                glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(mesh.indexCount), GL_UNSIGNED_INT,
+                                         (void*)(std::size_t{ mesh.firstIndex } * sizeof(std::uint32_t)), static_cast<GLint>(mesh.baseVertex));
+            } else {
+                const ScenePointRange& cloud = pointClouds[instance.geometry];
+                glState().bindVertexArray(pointVao.get());
+                glDrawArrays(GL_POINTS, static_cast<GLint>(cloud.firstPoint), static_cast<GLsizei>(cloud.pointCount));
+            }
+            GLUTILS_COUNT_DRAW(1);
+        }
+    }
+
+    std::size_t instanceCount() const { return instances.size(); }
+    std::size_t programCount() const { return programs.size(); }
+
+private:
+    std::vector<SceneMeshRange> meshes;
+    std::vector<ScenePointRange> pointClouds;
+    std::vector<SceneInstance> instances;
+    std::vector<Shader> programs;
+    VertexArrayHandle meshVao, pointVao;
+    BufferHandle vertexBuffer, indexBuffer, pointBuffer;
+};
+
+}
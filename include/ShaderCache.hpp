@@ -0,0 +1,234 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "BenchUtils.hpp"
+#include "GLUtils.hpp"
+
+namespace glutils {
+
+// 程序缓存的统计信息，时间单位为毫秒
+struct ProgramCacheStats {
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+    // 缓存文件存在但被驱动拒绝（驱动更新、格式不兼容等），随后回退为源码编译
+    std::size_t rejected = 0;
+    double loadMs = 0.0;
+    double compileMs = 0.0;
+    double linkMs = 0.0;
+    double storeMs = 0.0;
+};
+
+namespace detail {
+
+// 缓存文件头，紧跟着 length 字节的程序二进制
+struct ProgramBinaryHeader {
+    char magic[8];
+    std::uint64_t driverHash;
+    std::uint32_t format;
+    std::uint32_t length;
+};
+
+inline constexpr char kProgramBinaryMagic[8] = { 'G', 'L', 'U', 'T', 'P', 'B', 'N', '\0' };
+
+}
+
+/**
+ * @brief 着色器程序的二进制缓存
+ *
+ * 以 "驱动标识（GL_VENDOR / GL_RENDERER / GL_VERSION）+ 各阶段类型与源码" 的哈希为键，
+ * 链接成功的程序通过 glGetProgramBinary 保存到 directory 下，下次启动用 glProgramBinary 直接恢复，
+ * 跳过编译和链接。驱动不同、文件损坏或驱动拒绝二进制时，自动回退为源码编译并覆盖缓存文件。
+ *
+ * 必须在有 GL 上下文的线程使用；驱动不支持任何程序二进制格式时退化为普通编译。
+ */
+class ProgramCache {
+public:
+    explicit ProgramCache(std::filesystem::path directory = "shader_cache") : directory(std::move(directory)) {}
+
+    /**
+     * @brief 取得（或编译）由给定各阶段源码组成的程序
+     *
+     * @return 链接好的程序 ID，由调用者负责删除
+     */
+    unsigned int get(const is_shader_source auto&... sources) {
+        const ShaderSource* stages[] = { &sources... };
+        return get(stages, sizeof...(sources));
+    }
+
+    unsigned int get(const ShaderSource* const* stages, std::size_t stageCount) {
+        initDriver();
+        std::uint64_t key = driverHash;
+        for (std::size_t i = 0; i < stageCount; ++i) {
+            const int type = stages[i]->getType();
+            key = detail::fnv1a(std::string_view(reinterpret_cast<const char*>(&type), sizeof(type)), key);
+            const std::uint64_t length = stages[i]->source.size();
+            key = detail::fnv1a(std::string_view(reinterpret_cast<const char*>(&length), sizeof(length)), key);
+            key = detail::fnv1a(stages[i]->source, key);
+        }
+        const std::filesystem::path path = entryPath(key);
+
+        if (binarySupported) {
+            Stopwatch timer;
+            unsigned int program = tryLoad(path);
+            if (program) {
+                ++statistics.hits;
+                statistics.loadMs += timer.milliseconds();
+                return program;
+            }
+        }
+
+        ++statistics.misses;
+        Stopwatch timer;
+        std::vector<unsigned int> shaders;
+        shaders.reserve(stageCount);
+        for (std::size_t i = 0; i < stageCount; ++i)
+            shaders.push_back(detail::compileStage(stages[i]->source.c_str(), stages[i]->getType()));
+        statistics.compileMs += timer.milliseconds();
+
+        timer.reset();
+        unsigned int program = glCreateProgram();
+        if (binarySupported)
+            glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        for (unsigned int shader : shaders)
+            glAttachShader(program, shader);
+        glLinkProgram(program);
+        bool linked = detail::checkLinkStatus(program);
+        for (unsigned int shader : shaders)
+            glDeleteShader(shader);
+        statistics.linkMs += timer.milliseconds();
+
+        if (linked && binarySupported) {
+            timer.reset();
+            store(program, path);
+            statistics.storeMs += timer.milliseconds();
+        }
+        return program;
+    }
+
+    const ProgramCacheStats& stats() const { return statistics; }
+
+    void printStats(std::ostream& os = std::cout) const {
+        os << "程序缓存: 命中 " << statistics.hits << "，未命中 " << statistics.misses << "，被驱动拒绝 " << statistics.rejected
+           << "；加载 " << statistics.loadMs << " ms，编译 " << statistics.compileMs << " ms，链接 " << statistics.linkMs
+           << " ms，写缓存 " << statistics.storeMs << " ms" << std::endl;
+    }
+
+    // 删除缓存目录下的所有缓存文件
+    void clear() {
+        std::error_code ec;
+        std::filesystem::remove_all(directory, ec);
+    }
+
+private:
+    void initDriver() {
+        if (driverReady)
+            return;
+        driverReady = true;
+        auto str = [](GLenum name) {
+            const GLubyte* value = glGetString(name);
+            return value ? std::string(reinterpret_cast<const char*>(value)) : std::string();
+        };
+        driverHash = detail::fnv1a(str(GL_VENDOR) + "|" + str(GL_RENDERER) + "|" + str(GL_VERSION));
+
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        binarySupported = formats > 0 && glGetProgramBinary != nullptr && glProgramBinary != nullptr && glProgramParameteri != nullptr;
+        if (binarySupported) {
+            std::error_code ec;
+            std::filesystem::create_directories(directory, ec);
+        }
+    }
+
+    std::filesystem::path entryPath(std::uint64_t key) const {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+        return directory / name;
+    }
+
+    unsigned int tryLoad(const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open())
+            return 0;
+        detail::ProgramBinaryHeader header{};
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        std::vector<char> binary;
+        if (file && std::memcmp(header.magic, detail::kProgramBinaryMagic, sizeof(header.magic)) == 0 && header.driverHash == driverHash) {
+            binary.resize(header.length);
+            file.read(binary.data(), static_cast<std::streamsize>(binary.size()));
+        }
+        file.close();
+        if (binary.empty() || binary.size() != header.length) {
+            reject(path);
+            return 0;
+        }
+
+        unsigned int program = glCreateProgram();
+        glProgramBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+        GLint success = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+        if (!success) {
+            glDeleteProgram(program);
+            reject(path);
+            return 0;
+        }
+        return program;
+    }
+
+    void reject(const std::filesystem::path& path) {
+        ++statistics.rejected;
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }
+
+    void store(unsigned int program, const std::filesystem::path& path) {
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0)
+            return;
+        std::vector<char> binary(static_cast<std::size_t>(length));
+        GLenum format = 0;
+        GLsizei written = 0;
+        glGetProgramBinary(program, length, &written, &format, binary.data());
+        if (written <= 0)
+            return;
+
+        detail::ProgramBinaryHeader header{};
+        std::memcpy(header.magic, detail::kProgramBinaryMagic, sizeof(header.magic));
+        header.driverHash = driverHash;
+        header.format = format;
+        header.length = static_cast<std::uint32_t>(written);
+        // 先写临时文件再改名，避免进程中断留下半个缓存文件
+        std::filesystem::path temp = path;
+        temp += ".tmp";
+        {
+            std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+                return;
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(binary.data(), written);
+            if (!file)
+                return;
+        }
+        std::error_code ec;
+        std::filesystem::rename(temp, path, ec);
+        if (ec)
+            std::filesystem::remove(temp, ec);
+    }
+
+    std::filesystem::path directory;
+    ProgramCacheStats statistics;
+    std::uint64_t driverHash = 0;
+    bool driverReady = false;
+    bool binarySupported = false;
+};
+
+}
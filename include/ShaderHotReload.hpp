@@ -0,0 +1,406 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#define GLUTILS_INOTIFY 1
+#endif
+
+#include "AsyncShader.hpp"
+#include "GLUtils.hpp"
+
+namespace glutils {
+
+// 一次 poll() 的结果，时间单位为毫秒
+struct HotReloadStats {
+    // 成功替换的程序数
+    std::size_t reloaded = 0;
+    // 编译或链接失败、继续沿用旧程序的数量
+    std::size_t failed = 0;
+    // 重新读取的文件数
+    std::size_t filesRead = 0;
+    double milliseconds = 0.0;
+};
+
+/**
+ * @brief 可热重载的着色器程序
+ *
+ * shader() 始终是最后一次成功构建的程序；重载成功时程序 ID 会变化，
+ * 之前用 setUniform 设置的值也随旧程序一起丢弃，需要每帧设置或根据 generation() 的变化重新设置。
+ */
+class ReloadableShader {
+public:
+    Shader& shader() { return program; }
+    unsigned int getID() const { return program.getID(); }
+    void use() const { program.use(); }
+
+    // 至少成功构建过一次
+    bool valid() const { return program.getID() != 0; }
+    // 最近一次构建是否失败（失败时 shader() 仍是上一个可用版本）
+    bool failed() const { return lastFailed; }
+    // 成功构建的次数，首次加载为 1
+    std::size_t generation() const { return builds; }
+
+    // 源文件及其展开的全部 #include 文件
+    const std::vector<std::string>& files() const { return dependencies; }
+
+private:
+    friend class ShaderHotReloader;
+
+    std::vector<std::pair<ShaderType, std::string>> stages;
+    std::vector<std::string> dependencies;
+    Shader program;
+    std::size_t builds = 0;
+    bool lastFailed = false;
+};
+
+/**
+ * @brief 着色器热重载：监视源文件，只重新读取改动的文件、只重建依赖它们的程序
+ *
+ * 源码中的 #include "file" 在提交给驱动前展开：先相对于所在文件的目录查找，再依次查找 includeDirs；
+ * 同一阶段内每个文件只展开一次（相当于隐式 #pragma once），循环包含只报错不展开。
+ * 展开处插入 #line 指令，编译日志中的 "源串号(行号)" 对应 files() 中的下标和文件内行号。
+ *
+ * Linux 上用非阻塞 inotify 监视文件所在目录（编辑器先写临时文件再改名的保存方式同样能捕获），
+ * 其他平台退化为每隔 pollInterval 比较一次文件修改时间。
+ * poll() 必须每帧在 GL 线程调用；新程序构建成功后才删除旧程序，失败时打印日志并保留旧程序。
+ */
+class ShaderHotReloader {
+public:
+    explicit ShaderHotReloader(std::vector<std::filesystem::path> includeDirs = {},
+                               std::chrono::milliseconds pollInterval = std::chrono::milliseconds(250))
+        : includeDirs(std::move(includeDirs)), pollInterval(pollInterval) {
+#ifdef GLUTILS_INOTIFY
+        inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotifyFd < 0)
+            std::cerr << "inotify 初始化失败，改为定时检查文件修改时间" << std::endl;
+#endif
+    }
+
+    ~ShaderHotReloader() {
+#ifdef GLUTILS_INOTIFY
+        if (inotifyFd >= 0)
+            close(inotifyFd);
+#endif
+    }
+
+    ShaderHotReloader(const ShaderHotReloader&) = delete;
+    ShaderHotReloader& operator=(const ShaderHotReloader&) = delete;
+
+    /**
+     * @brief 从文件加载一个程序并开始监视
+     *
+     * 首次构建失败不会退出，返回的程序 valid() 为 false，修好文件后下一次 poll() 自动构建。
+     * 返回的对象由调用者持有，和 Shader 一样必须在 GL 上下文销毁前释放；释放后不再重建。
+     */
+    std::shared_ptr<ReloadableShader> load(const std::vector<std::pair<ShaderType, std::string>>& stages) {
+        auto program = std::make_shared<ReloadableShader>();
+        for (const auto& [type, path] : stages)
+            program->stages.emplace_back(type, normalize(path));
+        build(*program);
+        programs.push_back(program);
+        return program;
+    }
+
+    std::shared_ptr<ReloadableShader> load(const std::string& vertexPath, const std::string& fragmentPath) {
+        return load({ { ShaderType::Vertex, vertexPath }, { ShaderType::Fragment, fragmentPath } });
+    }
+
+    /**
+     * @brief 处理自上次调用以来的文件改动，重建受影响的程序
+     *
+     * 没有改动时只是一次非阻塞 read（或一次时间比较），可以放心每帧调用。
+     */
+    HotReloadStats poll() {
+        HotReloadStats stats;
+        const std::vector<std::string> changed = changedFiles();
+        if (changed.empty())
+            return stats;
+
+        const auto start = std::chrono::steady_clock::now();
+        for (const auto& file : changed)
+            fileCache.erase(file);
+
+        const std::size_t readsBefore = fileReads;
+        programs.erase(std::remove_if(programs.begin(), programs.end(),
+                                      [](const std::weak_ptr<ReloadableShader>& p) { return p.expired(); }),
+                       programs.end());
+        for (const auto& weak : programs) {
+            auto program = weak.lock();
+            const bool affected = std::any_of(program->dependencies.begin(), program->dependencies.end(), [&](const std::string& file) {
+                return std::find(changed.begin(), changed.end(), file) != changed.end();
+            });
+            if (!affected)
+                continue;
+            if (build(*program))
+                ++stats.reloaded;
+            else
+                ++stats.failed;
+        }
+        stats.filesRead = fileReads - readsBefore;
+        stats.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (stats.reloaded || stats.failed)
+            std::cout << "着色器热重载：替换 " << stats.reloaded << " 个程序，失败 " << stats.failed << " 个，耗时 "
+                      << stats.milliseconds << " ms" << std::endl;
+        return stats;
+    }
+
+    // 是否在用 inotify（否则为定时检查修改时间）
+    bool usingInotify() const { return inotifyFd >= 0; }
+
+    /**
+     * @brief 把一组阶段源文件展开 #include 后的完整源码（不编译），失败时返回 false
+     *
+     * 供调试或离线预处理使用；files 接收依赖文件列表，下标即 #line 中的源串号。
+     */
+    bool preprocess(const std::string& path, std::string& out, std::vector<std::string>& files) {
+        std::vector<std::string> stack;
+        std::unordered_set<std::string> included;
+        out.clear();
+        return expand(normalize(path), out, files, stack, included);
+    }
+
+private:
+    static std::string normalize(const std::filesystem::path& path) {
+        std::error_code ec;
+        std::filesystem::path absolute = std::filesystem::weakly_canonical(path, ec);
+        if (ec)
+            absolute = std::filesystem::absolute(path, ec).lexically_normal();
+        return absolute.string();
+    }
+
+    // 先查内容缓存，未命中时读文件并开始监视它
+    const std::string* source(const std::string& path) {
+        if (auto it = fileCache.find(path); it != fileCache.end())
+            return &it->second;
+        std::string text;
+        if (!detail::readWholeFile(path, text)) {
+            std::cerr << "Failed to open shader file: " << path << std::endl;
+            watch(path);
+            return nullptr;
+        }
+        ++fileReads;
+        watch(path);
+        return &fileCache.emplace(path, std::move(text)).first->second;
+    }
+
+    static std::size_t indexOf(std::vector<std::string>& files, const std::string& path) {
+        auto it = std::find(files.begin(), files.end(), path);
+        if (it != files.end())
+            return static_cast<std::size_t>(it - files.begin());
+        files.push_back(path);
+        return files.size() - 1;
+    }
+
+    std::string resolveInclude(const std::string& from, const std::string& name) const {
+        std::error_code ec;
+        const std::filesystem::path local = std::filesystem::path(from).parent_path() / name;
+        if (std::filesystem::exists(local, ec))
+            return normalize(local);
+        for (const auto& dir : includeDirs)
+            if (std::filesystem::exists(dir / name, ec))
+                return normalize(dir / name);
+        return std::string();
+    }
+
+    // 识别 `#include "name"` / `#include <name>`，# 前后允许空白
+    static bool parseInclude(std::string_view line, std::string& name) {
+        auto skip = [&](std::size_t i) {
+            while (i < line.size() && (line[i] == ' ' || line[i] == '\t'))
+                ++i;
+            return i;
+        };
+        std::size_t i = skip(0);
+        if (i >= line.size() || line[i] != '#')
+            return false;
+        i = skip(i + 1);
+        if (line.substr(i, 7) != "include")
+            return false;
+        i = skip(i + 7);
+        if (i >= line.size() || (line[i] != '"' && line[i] != '<'))
+            return false;
+        const char close = line[i] == '"' ? '"' : '>';
+        const std::size_t end = line.find(close, i + 1);
+        if (end == std::string_view::npos)
+            return false;
+        name.assign(line.substr(i + 1, end - i - 1));
+        return true;
+    }
+
+    static bool isPragmaOnce(std::string_view line) {
+        const std::size_t i = line.find_first_not_of(" \t");
+        return i != std::string_view::npos && line.substr(i).starts_with("#pragma once");
+    }
+
+    // GLSL 3.30 起 "#line n s" 之后的下一行行号为 n
+    bool expand(const std::string& path, std::string& out, std::vector<std::string>& files,
+                std::vector<std::string>& stack, std::unordered_set<std::string>& included) {
+        if (std::find(stack.begin(), stack.end(), path) != stack.end()) {
+            std::cerr << "着色器循环包含: " << path << std::endl;
+            return false;
+        }
+        const std::string* text = source(path);
+        const std::size_t fileIndex = indexOf(files, path);
+        if (!text)
+            return false;
+        if (!included.insert(path).second)
+            return true;
+        stack.push_back(path);
+
+        const std::string_view view = *text;
+        std::size_t lineNumber = 1;
+        bool ok = true;
+        std::string name;
+        for (std::size_t pos = 0; pos < view.size(); ++lineNumber) {
+            std::size_t end = view.find('\n', pos);
+            if (end == std::string_view::npos)
+                end = view.size();
+            const std::string_view line = view.substr(pos, end - pos);
+            pos = end + 1;
+
+            if (isPragmaOnce(line)) {
+                out += '\n';
+                continue;
+            }
+            if (!parseInclude(line, name)) {
+                out.append(line);
+                out += '\n';
+                // #line 不能出现在 #version 之前，主文件在 #version 之后补上自己的源串号
+                if (stack.size() == 1 && line.find("#version") != std::string_view::npos)
+                    out += "#line " + std::to_string(lineNumber + 1) + " " + std::to_string(fileIndex) + "\n";
+                continue;
+            }
+            const std::string target = resolveInclude(path, name);
+            if (target.empty()) {
+                std::cerr << path << "(" << lineNumber << "): 找不到包含文件 " << name << std::endl;
+                ok = false;
+                continue;
+            }
+            out += "#line 1 " + std::to_string(indexOf(files, target)) + "\n";
+            ok = expand(target, out, files, stack, included) && ok;
+            out += "#line " + std::to_string(lineNumber + 1) + " " + std::to_string(fileIndex) + "\n";
+        }
+        stack.pop_back();
+        return ok;
+    }
+
+    // 展开全部阶段并构建；成功时原子地替换程序 ID，失败时保留旧程序
+    bool build(ReloadableShader& program) {
+        ProgramStages stages;
+        std::vector<std::string> files;
+        bool ok = true;
+        for (const auto& [type, path] : program.stages) {
+            std::vector<std::string> stack;
+            std::unordered_set<std::string> included;
+            ShaderStage stage{ static_cast<int>(type), std::string() };
+            ok = expand(path, stage.source, files, stack, included) && ok;
+            stages.push_back(std::move(stage));
+        }
+        // 失败时也更新依赖，修好缺失的包含文件同样能触发重建
+        program.dependencies = files;
+
+        const unsigned int built = ok ? detail::buildProgram(stages) : 0;
+        program.lastFailed = built == 0;
+        if (built == 0) {
+            std::cerr << "着色器构建失败";
+            if (program.valid())
+                std::cerr << "，继续使用上一个可用版本";
+            std::cerr << "（源串号:";
+            for (std::size_t i = 0; i < files.size(); ++i)
+                std::cerr << " " << i << "=" << files[i];
+            std::cerr << "）" << std::endl;
+            return false;
+        }
+        program.program.reset(built);
+        ++program.builds;
+        return true;
+    }
+
+    void watch(const std::string& path) {
+#ifdef GLUTILS_INOTIFY
+        if (inotifyFd >= 0) {
+            const std::string dir = std::filesystem::path(path).parent_path().string();
+            if (watchedDirs.contains(dir))
+                return;
+            // 监视目录而不是文件：改名覆盖式保存会让文件级的 watch 失效
+            const int wd = inotify_add_watch(inotifyFd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+            if (wd < 0) {
+                std::cerr << "无法监视目录: " << dir << std::endl;
+                return;
+            }
+            watchedDirs.emplace(dir, wd);
+            watchDescriptors.emplace(wd, dir);
+            return;
+        }
+#endif
+        std::error_code ec;
+        modifiedTimes[path] = std::filesystem::last_write_time(path, ec);
+    }
+
+    std::vector<std::string> changedFiles() {
+        std::vector<std::string> changed;
+#ifdef GLUTILS_INOTIFY
+        if (inotifyFd >= 0) {
+            alignas(inotify_event) char buffer[4096];
+            for (;;) {
+                const ssize_t length = read(inotifyFd, buffer, sizeof(buffer));
+                if (length <= 0)
+                    break;
+                for (ssize_t offset = 0; offset < length;) {
+                    const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                    offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+                    auto dir = watchDescriptors.find(event->wd);
+                    if (dir == watchDescriptors.end() || event->len == 0)
+                        continue;
+                    std::string path = (std::filesystem::path(dir->second) / event->name).string();
+                    if (std::find(changed.begin(), changed.end(), path) == changed.end())
+                        changed.push_back(std::move(path));
+                }
+            }
+            return changed;
+        }
+#endif
+        const auto now = std::chrono::steady_clock::now();
+        if (now - lastCheck < pollInterval)
+            return changed;
+        lastCheck = now;
+        for (auto& [path, time] : modifiedTimes) {
+            std::error_code ec;
+            const auto current = std::filesystem::last_write_time(path, ec);
+            if (!ec && current != time) {
+                time = current;
+                changed.push_back(path);
+            }
+        }
+        return changed;
+    }
+
+    std::vector<std::filesystem::path> includeDirs;
+    std::chrono::milliseconds pollInterval;
+    std::chrono::steady_clock::time_point lastCheck{};
+
+    std::vector<std::weak_ptr<ReloadableShader>> programs;
+    // 规范化路径 -> 文件内容，只有改动过的文件会被丢弃重读
+    std::unordered_map<std::string, std::string> fileCache;
+    std::size_t fileReads = 0;
+
+    int inotifyFd = -1;
+    std::unordered_map<std::string, int> watchedDirs;
+    std::unordered_map<int, std::string> watchDescriptors;
+    // 没有 inotify 时：规范化路径 -> 上次看到的修改时间
+    std::unordered_map<std::string, std::filesystem::file_time_type> modifiedTimes;
+};
+
+}
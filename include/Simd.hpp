@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdlib>
+#include <string_view>
+
+// 编译期 SIMD 能力检测：x86-64 总是带 SSE2，32 位 MSVC 需要 /arch:SSE2
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GLUTILS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// x86 上无论编译选项如何都编译 AVX2 内核，运行时检测 CPU 后才调用；
+// GCC / Clang 用 target 属性单独为这些函数开启 AVX2 + FMA，MSVC 不需要
+#if defined(GLUTILS_SSE2) && (defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86))
+#define GLUTILS_AVX2 1
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define GLUTILS_TARGET_AVX2 __attribute__((target("avx2,fma")))
+// 结果必须与标量路径逐位一致的内核不能开启 FMA：GCC 会把分开的乘法和加法合并成 FMA，舍入结果不同
+#define GLUTILS_TARGET_AVX2_NO_FMA __attribute__((target("avx2")))
+#else
+#include <intrin.h>
+#define GLUTILS_TARGET_AVX2
+#define GLUTILS_TARGET_AVX2_NO_FMA
+#endif
+#endif
+
+namespace glutils {
+
+enum class SimdLevel { Scalar, SSE2, AVX2 };
+
+inline const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::AVX2: return "AVX2";
+    case SimdLevel::SSE2: return "SSE2";
+    default: return "Scalar";
+    }
+}
+
+/**
+ * @brief 运行时检测当前 CPU 可用的最高 SIMD 级别（结果缓存）
+ *
+ * 环境变量 GLUTILS_SIMD=scalar / sse2 可以把级别压低，用于对比和排查问题。
+ */
+inline SimdLevel detectSimdLevel() {
+    static const SimdLevel level = [] {
+        SimdLevel best = SimdLevel::Scalar;
+#ifdef GLUTILS_SSE2
+        best = SimdLevel::SSE2;
+#endif
+#ifdef GLUTILS_AVX2
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+            best = SimdLevel::AVX2;
+#else
+        int info[4];
+        __cpuid(info, 1);
+        const bool fma = (info[2] & (1 << 12)) != 0;
+        // 操作系统必须保存 YMM 寄存器（OSXSAVE + XCR0 的 SSE/AVX 位）
+        const bool osAvx = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 6) == 6;
+        __cpuidex(info, 7, 0);
+        if (fma && osAvx && (info[1] & (1 << 5)) != 0)
+            best = SimdLevel::AVX2;
+#endif
+#endif
+        if (const char* value = std::getenv("GLUTILS_SIMD")) {
+            const std::string_view cap = value;
+            if (cap == "scalar")
+                best = SimdLevel::Scalar;
+            else if (cap == "sse2" && best == SimdLevel::AVX2)
+                best = SimdLevel::SSE2;
+        }
+        return best;
+    }();
+    return level;
+}
+
+}
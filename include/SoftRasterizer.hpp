@@ -0,0 +1,805 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "ImageIO.hpp"
+#include "JobSystem.hpp"
+#include "Profiler.hpp"
+#include "Simd.hpp"
+#include "Transforms.hpp"
+
+namespace glutils {
+
+/**
+ * CPU 软件光栅化，用于没有 GPU 的机器上渲染参考图和做逐像素回归测试
+ *
+ * 绘制接口对应 glDrawArrays / glDrawElements：交错的 float 顶点数组 + 步长、可选的 32 位索引、图元类型，
+ * 以及一个"程序"。程序是一个普通结构体，uniform 就是它的成员：
+ *
+ *   struct MyProgram {
+ *       static constexpr int kVaryings = 3;                             // 顶点到片段插值的 float 个数
+ *       glm::vec4 vertex(const float* attributes, float* varyings) const; // 返回裁剪空间位置
+ *       glm::vec4 fragment(const float* varyings) const;                  // 返回 [0, 1] 的 RGBA
+ *   };
+ *
+ * 流水线：顶点着色（并行）→ 图元装配、近平面裁剪、背面剔除、三角形建立（分块并行，块内保持提交顺序）
+ * → 按 64x64 像素分块（tile）装箱 → 每个 tile 由一个线程独占光栅化，没有任何同步。
+ * 三角形用边函数判断覆盖：一次计算一行里 4 个（SSE2）或 8 个（AVX2）像素的边函数和深度，
+ * 深度测试通过的像素再逐个做透视校正插值并调用片段着色器（early-z）。
+ *
+ * 结果与线程数和 SIMD 级别无关，逐位一致：边函数按顶点的规范顺序建立，共享边两侧的三角形得到严格相反的值，
+ * 配合上-左规则，共享边上的像素只属于一个三角形；每个 tile 内按提交顺序处理图元。
+ * 帧缓冲第 0 行是图像顶部（与 glReadPixels 相反），可以直接保存成图片。
+ */
+
+// 每个顶点最多的 varying 个数
+inline constexpr int kSoftMaxVaryings = 12;
+inline constexpr int kSoftTileSize = 64;
+
+enum class SoftPrimitive { Triangles, Points };
+enum class SoftPolygonMode { Fill, Line };
+
+// 对应 glEnable(GL_DEPTH_TEST) / glDepthMask / glEnable(GL_CULL_FACE) / glPolygonMode，默认值与 GL 相同
+struct SoftDrawState {
+    bool depthTest = false;
+    bool depthWrite = true;
+    // 剔除背面（逆时针为正面）
+    bool cullBackFaces = false;
+    SoftPolygonMode polygonMode = SoftPolygonMode::Fill;
+};
+
+inline std::uint32_t packColor(const glm::vec4& color) {
+    auto channel = [](float c) { return static_cast<std::uint32_t>(std::clamp(c, 0.0f, 1.0f) * 255.0f + 0.5f); };
+    return channel(color.x) | channel(color.y) << 8 | channel(color.z) << 16 | channel(color.w) << 24;
+}
+
+/**
+ * @brief RGBA8 颜色 + float 深度的帧缓冲，第 0 行为图像顶部
+ *
+ * 每行按 8 个像素对齐（stride），SIMD 内核整组读写深度时不会越界。
+ */
+struct SoftFramebuffer {
+    int width = 0;
+    int height = 0;
+    int stride = 0;
+    // 每像素 4 字节，内存顺序为 R, G, B, A
+    std::vector<std::uint32_t> color;
+    std::vector<float> depth;
+
+    SoftFramebuffer() = default;
+    SoftFramebuffer(int w, int h) { resize(w, h); }
+
+    void resize(int w, int h) {
+        width = w;
+        height = h;
+        stride = (w + 7) & ~7;
+        color.assign(static_cast<std::size_t>(stride) * h, 0);
+        depth.assign(static_cast<std::size_t>(stride) * h, 1.0f);
+    }
+
+    // 对应 glClearColor + glClearDepth + glClear
+    void clear(const glm::vec4& rgba, float depthValue = 1.0f) {
+        std::fill(color.begin(), color.end(), packColor(rgba));
+        std::fill(depth.begin(), depth.end(), depthValue);
+    }
+
+    std::uint32_t* colorRow(int y) { return color.data() + static_cast<std::size_t>(y) * stride; }
+    float* depthRow(int y) { return depth.data() + static_cast<std::size_t>(y) * stride; }
+    std::uint32_t pixel(int x, int y) const { return color[static_cast<std::size_t>(y) * stride + x]; }
+
+    ImageView image() const {
+        return { reinterpret_cast<const std::uint8_t*>(color.data()), width, height, static_cast<std::ptrdiff_t>(stride) * 4 };
+    }
+
+    // 保存为二进制 PPM（P6，丢弃 alpha）
+    bool writePPM(const std::filesystem::path& path) const { return glutils::writePPM(path, image()); }
+
+    // 读取 writePPM 写出的图像（alpha 为 255，深度为 1）
+    bool readPPM(const std::filesystem::path& path) {
+        std::vector<std::uint8_t> rgb;
+        int w = 0, h = 0;
+        if (!glutils::readPPM(path, rgb, w, h))
+            return false;
+        resize(w, h);
+        for (int y = 0; y < h; ++y) {
+            const std::uint8_t* row = rgb.data() + static_cast<std::size_t>(y) * w * 3;
+            for (int x = 0; x < w; ++x)
+                colorRow(y)[x] = row[x * 3] | row[x * 3 + 1] << 8 | row[x * 3 + 2] << 16 | 0xFF000000u;
+        }
+        return true;
+    }
+};
+
+struct SoftImageDiff {
+    // 任一通道差值超过容差的像素数；尺寸不同时为两者中较大的像素数
+    std::size_t differingPixels = 0;
+    int maxChannelDelta = 0;
+};
+
+/**
+ * @brief 逐像素比较两幅图像的 RGB 通道，tolerance 为允许的单通道最大差值
+ */
+inline SoftImageDiff compareImages(const SoftFramebuffer& a, const SoftFramebuffer& b, int tolerance = 0) {
+    SoftImageDiff diff;
+    if (a.width != b.width || a.height != b.height) {
+        diff.differingPixels = static_cast<std::size_t>(std::max(a.width * a.height, b.width * b.height));
+        diff.maxChannelDelta = 255;
+        return diff;
+    }
+    for (int y = 0; y < a.height; ++y) {
+        for (int x = 0; x < a.width; ++x) {
+            const std::uint32_t ca = a.pixel(x, y), cb = b.pixel(x, y);
+            int delta = 0;
+            for (int shift = 0; shift < 24; shift += 8)
+                delta = std::max(delta, std::abs(static_cast<int>((ca >> shift) & 0xFF) - static_cast<int>((cb >> shift) & 0xFF)));
+            diff.maxChannelDelta = std::max(diff.maxChannelDelta, delta);
+            diff.differingPixels += delta > tolerance;
+        }
+    }
+    return diff;
+}
+
+struct SoftRasterStats {
+    std::size_t primitives = 0;
+    // 经过裁剪、剔除后进入光栅化的三角形 / 线段 / 点
+    std::size_t rasterized = 0;
+    // 调用片段着色器的次数
+    std::size_t fragments = 0;
+};
+
+namespace detail {
+
+struct SoftScreenVertex {
+    float x, y, z, invW;
+};
+
+struct SoftVertex {
+    glm::vec4 position;
+    // 透视除法 + 视口变换的结果；只有 position 在近平面前方（z >= -w）时有意义
+    SoftScreenVertex screen;
+    float varyings[kSoftMaxVaryings];
+};
+
+// 屏幕空间三角形；边函数 E_i(x, y) = a[i] * x + b[i] * y + c[i] 对应顶点 i 对面的边，三角形内部为正
+struct SoftTriangle {
+    float a[3], b[3], c[3];
+    // 上-左规则：上边和左边上的像素（E == 0）算在三角形内，其余边要求 E > 0，即 E >= bias
+    float bias[3];
+    // 各顶点深度除以 2 倍面积：z = E0 * z[0] + E1 * z[1] + E2 * z[2]
+    float z[3];
+    float invW[3];
+    // 包围盒（闭区间，已裁剪到帧缓冲）
+    int minX, minY, maxX, maxY;
+    float varyings[3][kSoftMaxVaryings];
+};
+
+// 线段（多边形线框模式）或点（两个端点相同）
+struct SoftSegment {
+    float x[2], y[2], z[2], invW[2];
+    int minX, minY, maxX, maxY;
+    float varyings[2][kSoftMaxVaryings];
+};
+
+inline SoftScreenVertex toScreen(const glm::vec4& clip, int width, int height) {
+    const float invW = 1.0f / clip.w;
+    return { (clip.x * invW * 0.5f + 0.5f) * static_cast<float>(width), (0.5f - clip.y * invW * 0.5f) * static_cast<float>(height),
+             clip.z * invW * 0.5f + 0.5f, invW };
+}
+
+inline bool needsNearClip(const SoftVertex& v) {
+    return !(v.position.z + v.position.w >= 0.0f);
+}
+
+inline SoftVertex lerpVertex(const SoftVertex& a, const SoftVertex& b, float t, int varyings, int width, int height) {
+    SoftVertex v;
+    v.position = a.position + (b.position - a.position) * t;
+    v.screen = toScreen(v.position, width, height);
+    for (int k = 0; k < varyings; ++k)
+        v.varyings[k] = a.varyings[k] + (b.varyings[k] - a.varyings[k]) * t;
+    return v;
+}
+
+// 用近平面 z = -w 裁剪三角形，得到最多 4 个顶点的凸多边形；其余平面靠包围盒裁剪到帧缓冲（保护带）
+inline int clipNear(const SoftVertex* const in[3], SoftVertex out[4], int varyings, int width, int height) {
+    int n = 0;
+    for (int i = 0; i < 3; ++i) {
+        const SoftVertex& a = *in[i];
+        const SoftVertex& b = *in[(i + 1) % 3];
+        const float da = a.position.z + a.position.w, db = b.position.z + b.position.w;
+        if (da >= 0.0f)
+            out[n++] = a;
+        if ((da >= 0.0f) != (db >= 0.0f))
+            out[n++] = lerpVertex(a, b, da / (da - db), varyings, width, height);
+    }
+    return n;
+}
+
+// 所有顶点都在同一个裁剪平面外侧时整个图元不可见
+inline bool outsideFrustum(const SoftVertex* const* v, int count) {
+    auto all = [&](auto&& outside) {
+        for (int i = 0; i < count; ++i)
+            if (!outside(v[i]->position))
+                return false;
+        return true;
+    };
+    return all([](const glm::vec4& p) { return p.x > p.w; }) || all([](const glm::vec4& p) { return p.x < -p.w; }) ||
+           all([](const glm::vec4& p) { return p.y > p.w; }) || all([](const glm::vec4& p) { return p.y < -p.w; }) ||
+           all([](const glm::vec4& p) { return p.z > p.w; }) || all([](const glm::vec4& p) { return p.z < -p.w; });
+}
+
+inline bool setupTriangle(const SoftVertex& v0, const SoftVertex& v1, const SoftVertex& v2, int varyings, bool cullBackFaces,
+                          int width, int height, SoftTriangle& tri) {
+    const SoftVertex* v[3] = { &v0, &v1, &v2 };
+    SoftScreenVertex s[3] = { v0.screen, v1.screen, v2.screen };
+    // y 向下的屏幕坐标里，GL 的逆时针（正面）对应 area > 0
+    float area = (s[2].x - s[0].x) * (s[1].y - s[0].y) - (s[2].y - s[0].y) * (s[1].x - s[0].x);
+    if (!(std::abs(area) > 0.0f) || !std::isfinite(area))
+        return false;
+    if (area < 0.0f) {
+        if (cullBackFaces)
+            return false;
+        std::swap(s[1], s[2]);
+        std::swap(v[1], v[2]);
+        area = -area;
+    }
+
+    const float minX = std::min({ s[0].x, s[1].x, s[2].x }), maxX = std::max({ s[0].x, s[1].x, s[2].x });
+    const float minY = std::min({ s[0].y, s[1].y, s[2].y }), maxY = std::max({ s[0].y, s[1].y, s[2].y });
+    // 只保留像素中心落在包围盒内的像素；不覆盖任何像素中心的小三角形在这里就被丢弃
+    auto firstCenter = [](float v, int limit) { return static_cast<int>(std::ceil(std::clamp(v - 0.5f, -1.0f, static_cast<float>(limit)))); };
+    auto lastCenter = [](float v, int limit) { return static_cast<int>(std::floor(std::clamp(v - 0.5f, -1.0f, static_cast<float>(limit)))); };
+    tri.minX = std::max(0, firstCenter(minX, width));
+    tri.minY = std::max(0, firstCenter(minY, height));
+    tri.maxX = std::min(width - 1, lastCenter(maxX, width));
+    tri.maxY = std::min(height - 1, lastCenter(maxY, height));
+    if (tri.minX > tri.maxX || tri.minY > tri.maxY)
+        return false;
+
+    for (int i = 0; i < 3; ++i) {
+        // 边从 p 到 q；总是按 (x, y) 较小的端点起算，共享这条边的两个三角形得到严格相反的系数
+        SoftScreenVertex p = s[(i + 1) % 3], q = s[(i + 2) % 3];
+        const bool flip = q.x < p.x || (q.x == p.x && q.y < p.y);
+        if (flip)
+            std::swap(p, q);
+        float a = q.y - p.y, b = p.x - q.x, c = -(a * p.x + b * p.y);
+        if (flip) {
+            a = -a;
+            b = -b;
+            c = -c;
+        }
+        tri.a[i] = a;
+        tri.b[i] = b;
+        tri.c[i] = c;
+        tri.bias[i] = a > 0.0f || (a == 0.0f && b > 0.0f) ? 0.0f : FLT_MIN;
+        tri.z[i] = s[i].z / area;
+        tri.invW[i] = s[i].invW;
+        std::copy_n(v[i]->varyings, varyings, tri.varyings[i]);
+    }
+    return true;
+}
+
+inline bool setupSegment(const SoftVertex& v0, const SoftVertex& v1, int varyings, int width, int height, SoftSegment& seg) {
+    const SoftScreenVertex s[2] = { v0.screen, v1.screen };
+    for (int i = 0; i < 2; ++i) {
+        seg.x[i] = s[i].x;
+        seg.y[i] = s[i].y;
+        seg.z[i] = s[i].z;
+        seg.invW[i] = s[i].invW;
+    }
+    std::copy_n(v0.varyings, varyings, seg.varyings[0]);
+    std::copy_n(v1.varyings, varyings, seg.varyings[1]);
+    if (!std::isfinite(s[0].x + s[0].y + s[1].x + s[1].y))
+        return false;
+    seg.minX = std::max(0, static_cast<int>(std::floor(std::min(s[0].x, s[1].x))));
+    seg.minY = std::max(0, static_cast<int>(std::floor(std::min(s[0].y, s[1].y))));
+    seg.maxX = std::min(width - 1, static_cast<int>(std::floor(std::min(std::max(s[0].x, s[1].x), static_cast<float>(width)))));
+    seg.maxY = std::min(height - 1, static_cast<int>(std::floor(std::min(std::max(s[0].y, s[1].y), static_cast<float>(height)))));
+    return seg.minX <= seg.maxX && seg.minY <= seg.maxY;
+}
+
+// 一行里通过覆盖测试和深度测试的像素，w 为三个边函数值
+struct SoftRowFragments {
+    int x[kSoftTileSize];
+    float w0[kSoftTileSize], w1[kSoftTileSize], w2[kSoftTileSize];
+};
+
+struct SoftDepthMode {
+    bool test;
+    bool write;
+};
+
+using SoftCoverRowFn = int (*)(const SoftTriangle&, int y, int x0, int x1, float* depthRow, SoftDepthMode depth, SoftRowFragments& out);
+
+/**
+ * @brief 扫描第 y 行的 [x0, x1]：边函数覆盖测试 + 深度测试（和写入），返回通过的像素数
+ *
+ * 三个版本的每一步运算（乘、加的顺序）完全相同，结果逐位一致。
+ */
+inline int coverRowScalar(const SoftTriangle& tri, int y, int x0, int x1, float* depthRow, SoftDepthMode depth, SoftRowFragments& out) {
+    const float py = static_cast<float>(y) + 0.5f;
+    const float r0 = tri.b[0] * py + tri.c[0], r1 = tri.b[1] * py + tri.c[1], r2 = tri.b[2] * py + tri.c[2];
+    int count = 0;
+    for (int x = x0; x <= x1; ++x) {
+        const float px = static_cast<float>(x) + 0.5f;
+        const float w0 = tri.a[0] * px + r0, w1 = tri.a[1] * px + r1, w2 = tri.a[2] * px + r2;
+        if (!(w0 >= tri.bias[0] && w1 >= tri.bias[1] && w2 >= tri.bias[2]))
+            continue;
+        if (depth.test) {
+            const float z = w0 * tri.z[0] + w1 * tri.z[1] + w2 * tri.z[2];
+            if (!(z < depthRow[x]))
+                continue;
+            if (depth.write)
+                depthRow[x] = z;
+        }
+        out.x[count] = x;
+        out.w0[count] = w0;
+        out.w1[count] = w1;
+        out.w2[count] = w2;
+        ++count;
+    }
+    return count;
+}
+
+#ifdef GLUTILS_SSE2
+inline int coverRowSse2(const SoftTriangle& tri, int y, int x0, int x1, float* depthRow, SoftDepthMode depth, SoftRowFragments& out) {
+    const float py = static_cast<float>(y) + 0.5f;
+    const __m128 r0 = _mm_set1_ps(tri.b[0] * py + tri.c[0]), r1 = _mm_set1_ps(tri.b[1] * py + tri.c[1]), r2 = _mm_set1_ps(tri.b[2] * py + tri.c[2]);
+    const __m128 a0 = _mm_set1_ps(tri.a[0]), a1 = _mm_set1_ps(tri.a[1]), a2 = _mm_set1_ps(tri.a[2]);
+    const __m128 bias0 = _mm_set1_ps(tri.bias[0]), bias1 = _mm_set1_ps(tri.bias[1]), bias2 = _mm_set1_ps(tri.bias[2]);
+    const __m128 z0 = _mm_set1_ps(tri.z[0]), z1 = _mm_set1_ps(tri.z[1]), z2 = _mm_set1_ps(tri.z[2]);
+    const __m128 lanes = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+    alignas(16) float w0s[4], w1s[4], w2s[4], zs[4];
+    int count = 0;
+    // 起点对齐到 4 个像素；行宽按 8 对齐，整组读写深度不会越界
+    for (int xb = x0 & ~3; xb <= x1; xb += 4) {
+        const __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(xb)), lanes);
+        const __m128 w0 = _mm_add_ps(_mm_mul_ps(a0, px), r0);
+        const __m128 w1 = _mm_add_ps(_mm_mul_ps(a1, px), r1);
+        const __m128 w2 = _mm_add_ps(_mm_mul_ps(a2, px), r2);
+        const __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(w0, bias0), _mm_cmpge_ps(w1, bias1)), _mm_cmpge_ps(w2, bias2));
+        int mask = _mm_movemask_ps(inside);
+        // 去掉 [x0, x1] 之外的通道
+        mask &= (0xF << std::max(0, x0 - xb)) & (0xF >> std::max(0, xb + 3 - x1));
+        if (!mask)
+            continue;
+        if (depth.test) {
+            const __m128 z = _mm_add_ps(_mm_add_ps(_mm_mul_ps(w0, z0), _mm_mul_ps(w1, z1)), _mm_mul_ps(w2, z2));
+            mask &= _mm_movemask_ps(_mm_cmplt_ps(z, _mm_loadu_ps(depthRow + xb)));
+            if (!mask)
+                continue;
+            if (depth.write) {
+                _mm_store_ps(zs, z);
+                for (int bits = mask; bits; bits &= bits - 1)
+                    depthRow[xb + std::countr_zero(static_cast<unsigned>(bits))] = zs[std::countr_zero(static_cast<unsigned>(bits))];
+            }
+        }
+        _mm_store_ps(w0s, w0);
+        _mm_store_ps(w1s, w1);
+        _mm_store_ps(w2s, w2);
+        for (int bits = mask; bits; bits &= bits - 1) {
+            const int k = std::countr_zero(static_cast<unsigned>(bits));
+            out.x[count] = xb + k;
+            out.w0[count] = w0s[k];
+            out.w1[count] = w1s[k];
+            out.w2[count] = w2s[k];
+            ++count;
+        }
+    }
+    return count;
+}
+#endif
+
+#ifdef GLUTILS_AVX2
+GLUTILS_TARGET_AVX2_NO_FMA inline int coverRowAvx2(const SoftTriangle& tri, int y, int x0, int x1, float* depthRow, SoftDepthMode depth,
+                                                    SoftRowFragments& out) {
+    const float py = static_cast<float>(y) + 0.5f;
+    const __m256 r0 = _mm256_set1_ps(tri.b[0] * py + tri.c[0]), r1 = _mm256_set1_ps(tri.b[1] * py + tri.c[1]),
+                 r2 = _mm256_set1_ps(tri.b[2] * py + tri.c[2]);
+    const __m256 a0 = _mm256_set1_ps(tri.a[0]), a1 = _mm256_set1_ps(tri.a[1]), a2 = _mm256_set1_ps(tri.a[2]);
+    const __m256 bias0 = _mm256_set1_ps(tri.bias[0]), bias1 = _mm256_set1_ps(tri.bias[1]), bias2 = _mm256_set1_ps(tri.bias[2]);
+    const __m256 z0 = _mm256_set1_ps(tri.z[0]), z1 = _mm256_set1_ps(tri.z[1]), z2 = _mm256_set1_ps(tri.z[2]);
+    const __m256 lanes = _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f);
+    alignas(32) float w0s[8], w1s[8], w2s[8];
+    int count = 0;
+    for (int xb = x0 & ~7; xb <= x1; xb += 8) {
+        const __m256 px = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(xb)), lanes);
+        const __m256 w0 = _mm256_add_ps(_mm256_mul_ps(a0, px), r0);
+        const __m256 w1 = _mm256_add_ps(_mm256_mul_ps(a1, px), r1);
+        const __m256 w2 = _mm256_add_ps(_mm256_mul_ps(a2, px), r2);
+        const __m256 inside = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(w0, bias0, _CMP_GE_OQ), _mm256_cmp_ps(w1, bias1, _CMP_GE_OQ)),
+                                            _mm256_cmp_ps(w2, bias2, _CMP_GE_OQ));
+        int mask = _mm256_movemask_ps(inside);
+        mask &= (0xFF << std::max(0, x0 - xb)) & (0xFF >> std::max(0, xb + 7 - x1));
+        if (!mask)
+            continue;
+        if (depth.test) {
+            const __m256 z = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(w0, z0), _mm256_mul_ps(w1, z1)), _mm256_mul_ps(w2, z2));
+            const __m256 stored = _mm256_loadu_ps(depthRow + xb);
+            mask &= _mm256_movemask_ps(_mm256_cmp_ps(z, stored, _CMP_LT_OQ));
+            if (!mask)
+                continue;
+            if (depth.write) {
+                // 由掩码展开成每通道全 1 / 全 0，再整组混合写回
+                const __m256i bit = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+                const __m256i select = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(mask), bit), bit);
+                _mm256_storeu_ps(depthRow + xb, _mm256_blendv_ps(stored, z, _mm256_castsi256_ps(select)));
+            }
+        }
+        _mm256_store_ps(w0s, w0);
+        _mm256_store_ps(w1s, w1);
+        _mm256_store_ps(w2s, w2);
+        for (int bits = mask; bits; bits &= bits - 1) {
+            const int k = std::countr_zero(static_cast<unsigned>(bits));
+            out.x[count] = xb + k;
+            out.w0[count] = w0s[k];
+            out.w1[count] = w1s[k];
+            out.w2[count] = w2s[k];
+            ++count;
+        }
+    }
+    return count;
+}
+#endif
+
+inline SoftCoverRowFn selectCoverRow(SimdLevel level) {
+    level = std::min(level, detectSimdLevel());
+#ifdef GLUTILS_AVX2
+    if (level == SimdLevel::AVX2)
+        return coverRowAvx2;
+#endif
+#ifdef GLUTILS_SSE2
+    if (level >= SimdLevel::SSE2)
+        return coverRowSse2;
+#endif
+    return coverRowScalar;
+}
+
+}
+
+/**
+ * @brief 分块、多线程、SIMD 的三角形 / 线框 / 点光栅化器
+ *
+ * 每次 draw 在返回前完成全部工作（相当于每次绘制后 glFinish），可以紧接着读取帧缓冲。
+ * 中间数组在多次绘制之间复用，不是线程安全的：同时只能有一个线程调用 draw。
+ */
+class SoftRasterizer {
+public:
+    explicit SoftRasterizer(JobSystem& jobs = JobSystem::global(), SimdLevel level = detectSimdLevel())
+        : jobs(jobs), coverRow(detail::selectCoverRow(level)), level(std::min(level, detectSimdLevel())) {}
+
+    SoftRasterizer(const SoftRasterizer&) = delete;
+    SoftRasterizer& operator=(const SoftRasterizer&) = delete;
+
+    // level 高于本机或本次编译支持的级别时自动降级
+    void setSimdLevel(SimdLevel value) {
+        coverRow = detail::selectCoverRow(value);
+        level = std::min(value, detectSimdLevel());
+    }
+    SimdLevel simdLevel() const { return level; }
+
+    // 对应 glDrawArrays：顶点依次组成图元，strideFloats 为每个顶点的 float 数
+    template<typename Program>
+    void drawArrays(SoftFramebuffer& target, const Program& program, const SoftDrawState& state, SoftPrimitive primitive,
+                    std::span<const float> vertices, std::size_t strideFloats) {
+        draw(target, program, state, primitive, vertices, strideFloats, {});
+    }
+
+    // 对应 glDrawElements：索引指向 vertices 中的第几个顶点
+    template<typename Program>
+    void drawElements(SoftFramebuffer& target, const Program& program, const SoftDrawState& state, SoftPrimitive primitive,
+                      std::span<const float> vertices, std::size_t strideFloats, std::span<const std::uint32_t> indices) {
+        draw(target, program, state, primitive, vertices, strideFloats, indices);
+    }
+
+    const SoftRasterStats& stats() const { return counters; }
+    void resetStats() { counters = {}; }
+
+private:
+    // 图元建立每块处理的图元数；每块输出各自的数组，装箱时按块顺序合并，保持提交顺序
+    static constexpr std::size_t kSetupGrain = 2048;
+    static constexpr std::size_t kVertexGrain = 4096;
+
+    struct SetupChunk {
+        std::vector<detail::SoftTriangle> triangles;
+        std::vector<detail::SoftSegment> segments;
+    };
+
+    template<typename Program>
+    void draw(SoftFramebuffer& target, const Program& program, const SoftDrawState& state, SoftPrimitive primitive,
+              std::span<const float> vertices, std::size_t strideFloats, std::span<const std::uint32_t> indices) {
+        static_assert(Program::kVaryings >= 0 && Program::kVaryings <= kSoftMaxVaryings, "varying 个数超过 kSoftMaxVaryings");
+        GLUTILS_PROFILE_ZONE("SoftRasterizer::draw");
+        constexpr int varyings = Program::kVaryings;
+        const std::size_t vertexCount = strideFloats ? vertices.size() / strideFloats : 0;
+        const std::size_t elementCount = indices.empty() ? vertexCount : indices.size();
+        const std::size_t primitiveCount = primitive == SoftPrimitive::Triangles ? elementCount / 3 : elementCount;
+        if (primitiveCount == 0 || target.width <= 0 || target.height <= 0)
+            return;
+
+        // 1. 顶点着色
+        transformed.resize(vertexCount);
+        jobs.parallelFor(vertexCount, kVertexGrain, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                detail::SoftVertex& v = transformed[i];
+                v.position = program.vertex(vertices.data() + i * strideFloats, v.varyings);
+                // 大多数顶点被几个三角形共享，透视除法在这里每个顶点只做一次
+                v.screen = detail::toScreen(v.position, target.width, target.height);
+            }
+        });
+
+        // 2. 图元装配、裁剪、剔除、建立
+        const std::size_t chunkCount = (primitiveCount + kSetupGrain - 1) / kSetupGrain;
+        if (chunks.size() < chunkCount)
+            chunks.resize(chunkCount);
+        const int width = target.width, height = target.height;
+        auto element = [&](std::size_t i) -> const detail::SoftVertex* {
+            const std::size_t index = indices.empty() ? i : indices[i];
+            return index < vertexCount ? &transformed[index] : nullptr;
+        };
+        jobs.parallelFor(primitiveCount, kSetupGrain, [&](std::size_t begin, std::size_t end) {
+            SetupChunk& chunk = chunks[begin / kSetupGrain];
+            chunk.triangles.clear();
+            chunk.segments.clear();
+            for (std::size_t p = begin; p < end; ++p) {
+                if (primitive == SoftPrimitive::Points)
+                    setupPoint(element(p), varyings, width, height, chunk);
+                else
+                    setupTriangle(element(p * 3), element(p * 3 + 1), element(p * 3 + 2), varyings, state, width, height, chunk);
+            }
+        });
+
+        // 3. 装箱：按提交顺序把图元挂到覆盖的 tile 上
+        const int tilesX = (width + kSoftTileSize - 1) / kSoftTileSize, tilesY = (height + kSoftTileSize - 1) / kSoftTileSize;
+        const std::size_t tileCount = static_cast<std::size_t>(tilesX) * tilesY;
+        if (triangleBins.size() < tileCount) {
+            triangleBins.resize(tileCount);
+            segmentBins.resize(tileCount);
+        }
+        activeTiles.clear();
+        auto addToBin = [&](auto& bins, std::size_t tile, const auto* item) {
+            if (triangleBins[tile].empty() && segmentBins[tile].empty())
+                activeTiles.push_back(static_cast<std::uint32_t>(tile));
+            bins[tile].push_back(item);
+        };
+        std::size_t rasterized = 0;
+        for (std::size_t c = 0; c < chunkCount; ++c) {
+            for (const detail::SoftTriangle& tri : chunks[c].triangles) {
+                for (int ty = tri.minY / kSoftTileSize; ty <= tri.maxY / kSoftTileSize; ++ty) {
+                    for (int tx = tri.minX / kSoftTileSize; tx <= tri.maxX / kSoftTileSize; ++tx)
+                        if (overlapsTile(tri, tx, ty))
+                            addToBin(triangleBins, static_cast<std::size_t>(ty) * tilesX + tx, &tri);
+                }
+            }
+            for (const detail::SoftSegment& seg : chunks[c].segments) {
+                for (int ty = seg.minY / kSoftTileSize; ty <= seg.maxY / kSoftTileSize; ++ty)
+                    for (int tx = seg.minX / kSoftTileSize; tx <= seg.maxX / kSoftTileSize; ++tx)
+                        addToBin(segmentBins, static_cast<std::size_t>(ty) * tilesX + tx, &seg);
+            }
+            rasterized += chunks[c].triangles.size() + chunks[c].segments.size();
+        }
+
+        // 4. 光栅化：每个 tile 只由一个线程处理
+        std::atomic<std::size_t> fragments{ 0 };
+        const detail::SoftDepthMode depth{ state.depthTest, state.depthTest && state.depthWrite };
+        jobs.parallelFor(activeTiles.size(), 1, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                const std::size_t tile = activeTiles[i];
+                const int tileX = static_cast<int>(tile % tilesX) * kSoftTileSize, tileY = static_cast<int>(tile / tilesX) * kSoftTileSize;
+                const int tileMaxX = std::min(tileX + kSoftTileSize, width) - 1, tileMaxY = std::min(tileY + kSoftTileSize, height) - 1;
+                std::size_t shaded = 0;
+                for (const detail::SoftTriangle* tri : triangleBins[tile])
+                    shaded += rasterTriangle(program, *tri, target, depth, std::max(tri->minX, tileX), std::max(tri->minY, tileY),
+                                             std::min(tri->maxX, tileMaxX), std::min(tri->maxY, tileMaxY));
+                for (const detail::SoftSegment* seg : segmentBins[tile])
+                    shaded += rasterSegment(program, *seg, target, depth, tileX, tileY, tileMaxX, tileMaxY);
+                fragments.fetch_add(shaded, std::memory_order_relaxed);
+            }
+        });
+        for (std::uint32_t tile : activeTiles) {
+            triangleBins[tile].clear();
+            segmentBins[tile].clear();
+        }
+
+        counters.primitives += primitiveCount;
+        counters.rasterized += rasterized;
+        counters.fragments += fragments.load(std::memory_order_relaxed);
+    }
+
+    static void setupPoint(const detail::SoftVertex* v, int varyings, int width, int height, SetupChunk& chunk) {
+        if (!v)
+            return;
+        const glm::vec4& p = v->position;
+        if (!(p.w > 0.0f) || p.x < -p.w || p.x > p.w || p.y < -p.w || p.y > p.w || p.z < -p.w || p.z > p.w)
+            return;
+        detail::SoftSegment seg;
+        if (detail::setupSegment(*v, *v, varyings, width, height, seg))
+            chunk.segments.push_back(seg);
+    }
+
+    static void setupTriangle(const detail::SoftVertex* v0, const detail::SoftVertex* v1, const detail::SoftVertex* v2, int varyings,
+                              const SoftDrawState& state, int width, int height, SetupChunk& chunk) {
+        if (!v0 || !v1 || !v2)
+            return;
+        const detail::SoftVertex* const in[3] = { v0, v1, v2 };
+        if (detail::outsideFrustum(in, 3))
+            return;
+        // 常见情况：三个顶点都在近平面前方，直接用顶点阶段算好的屏幕坐标，不复制顶点
+        if (state.polygonMode == SoftPolygonMode::Fill && !detail::needsNearClip(*v0) && !detail::needsNearClip(*v1) &&
+            !detail::needsNearClip(*v2)) {
+            detail::SoftTriangle& tri = chunk.triangles.emplace_back();
+            if (!detail::setupTriangle(*v0, *v1, *v2, varyings, state.cullBackFaces, width, height, tri))
+                chunk.triangles.pop_back();
+            return;
+        }
+        detail::SoftVertex clipped[4];
+        const int n = detail::clipNear(in, clipped, varyings, width, height);
+        if (n < 3)
+            return;
+
+        if (state.polygonMode == SoftPolygonMode::Line) {
+            // 线框：按裁剪后多边形的朝向剔除，再画出它的每条边
+            detail::SoftTriangle probe;
+            if (!detail::setupTriangle(clipped[0], clipped[1], clipped[2], 0, state.cullBackFaces, width, height, probe) &&
+                state.cullBackFaces)
+                return;
+            for (int i = 0; i < n; ++i) {
+                detail::SoftSegment seg;
+                if (detail::setupSegment(clipped[i], clipped[(i + 1) % n], varyings, width, height, seg))
+                    chunk.segments.push_back(seg);
+            }
+            return;
+        }
+        for (int i = 2; i < n; ++i) {
+            detail::SoftTriangle& tri = chunk.triangles.emplace_back();
+            if (!detail::setupTriangle(clipped[0], clipped[i - 1], clipped[i], varyings, state.cullBackFaces, width, height, tri))
+                chunk.triangles.pop_back();
+        }
+    }
+
+    // tile 内某个边函数处处为负时不可能有覆盖，避免大三角形的包围盒把空 tile 也装进来；
+    // 留出一个像素的余量，舍入误差只会多装箱，不会漏掉像素
+    static bool overlapsTile(const detail::SoftTriangle& tri, int tx, int ty) {
+        const float x0 = static_cast<float>(tx * kSoftTileSize) + 0.5f, x1 = x0 + static_cast<float>(kSoftTileSize - 1);
+        const float y0 = static_cast<float>(ty * kSoftTileSize) + 0.5f, y1 = y0 + static_cast<float>(kSoftTileSize - 1);
+        for (int i = 0; i < 3; ++i) {
+            const float x = tri.a[i] > 0.0f ? x1 : x0, y = tri.b[i] > 0.0f ? y1 : y0;
+            if (tri.a[i] * x + (tri.b[i] * y + tri.c[i]) < -(std::abs(tri.a[i]) + std::abs(tri.b[i])))
+                return false;
+        }
+        return true;
+    }
+
+    template<typename Program>
+    std::size_t rasterTriangle(const Program& program, const detail::SoftTriangle& tri, SoftFramebuffer& target, detail::SoftDepthMode depth,
+                               int x0, int y0, int x1, int y1) const {
+        detail::SoftRowFragments row;
+        std::size_t shaded = 0;
+        for (int y = y0; y <= y1; ++y) {
+            const int count = coverRow(tri, y, x0, x1, target.depthRow(y), depth, row);
+            std::uint32_t* colors = target.colorRow(y);
+            for (int k = 0; k < count; ++k) {
+                // 透视校正：按 E_i / w_i 加权
+                const float p0 = row.w0[k] * tri.invW[0], p1 = row.w1[k] * tri.invW[1], p2 = row.w2[k] * tri.invW[2];
+                const float scale = 1.0f / (p0 + p1 + p2);
+                float varyings[kSoftMaxVaryings];
+                for (int v = 0; v < Program::kVaryings; ++v)
+                    varyings[v] = (p0 * tri.varyings[0][v] + p1 * tri.varyings[1][v] + p2 * tri.varyings[2][v]) * scale;
+                colors[row.x[k]] = packColor(program.fragment(varyings));
+            }
+            shaded += static_cast<std::size_t>(count);
+        }
+        return shaded;
+    }
+
+    // DDA 逐像素走完整条线段，只写 tile 内的像素
+    template<typename Program>
+    std::size_t rasterSegment(const Program& program, const detail::SoftSegment& seg, SoftFramebuffer& target, detail::SoftDepthMode depth,
+                              int tileX0, int tileY0, int tileX1, int tileY1) const {
+        const float dx = seg.x[1] - seg.x[0], dy = seg.y[1] - seg.y[0];
+        const int steps = static_cast<int>(std::ceil(std::max(std::abs(dx), std::abs(dy))));
+        std::size_t shaded = 0;
+        for (int s = 0; s <= steps; ++s) {
+            const float t = steps ? static_cast<float>(s) / static_cast<float>(steps) : 0.0f;
+            const int x = static_cast<int>(std::floor(seg.x[0] + dx * t)), y = static_cast<int>(std::floor(seg.y[0] + dy * t));
+            if (x < tileX0 || x > tileX1 || y < tileY0 || y > tileY1)
+                continue;
+            if (depth.test) {
+                const float z = seg.z[0] + (seg.z[1] - seg.z[0]) * t;
+                float& stored = target.depthRow(y)[x];
+                if (!(z < stored))
+                    continue;
+                if (depth.write)
+                    stored = z;
+            }
+            const float p0 = (1.0f - t) * seg.invW[0], p1 = t * seg.invW[1];
+            const float scale = 1.0f / (p0 + p1);
+            float varyings[kSoftMaxVaryings];
+            for (int v = 0; v < Program::kVaryings; ++v)
+                varyings[v] = (p0 * seg.varyings[0][v] + p1 * seg.varyings[1][v]) * scale;
+            target.colorRow(y)[x] = packColor(program.fragment(varyings));
+            ++shaded;
+        }
+        return shaded;
+    }
+
+    JobSystem& jobs;
+    detail::SoftCoverRowFn coverRow;
+    SimdLevel level;
+    std::vector<detail::SoftVertex> transformed;
+    std::vector<SetupChunk> chunks;
+    std::vector<std::vector<const detail::SoftTriangle*>> triangleBins;
+    std::vector<std::vector<const detail::SoftSegment*>> segmentBins;
+    std::vector<std::uint32_t> activeTiles;
+    SoftRasterStats counters;
+};
+
+/**
+ * @brief res/shaders/MilkWhite.vert / .frag 的 C++ 移植：半球环境光 + 方向光 + 边缘光，奶白色材质
+ *
+ * 顶点属性为 Position(3) + Normal(3)。与 GLSL 版本一样，vPos 是模型空间位置。
+ * 法线矩阵由 setModel 计算一次，与 GLSL 版本的 normalMatrix uniform（glutils::normalMatrix）相同。
+ */
+struct SoftMilkWhiteProgram {
+    static constexpr int kVaryings = 6;
+
+    glm::mat4 mvp{ 1.0f };
+    glm::mat4 model{ 1.0f };
+    glm::mat3 normalMatrix{ 1.0f };
+    glm::vec3 viewPos{ 0.0f };
+
+    void setModel(const glm::mat4& value) {
+        model = value;
+        normalMatrix = glutils::normalMatrix(value);
+    }
+
+    glm::vec4 vertex(const float* attributes, float* varyings) const {
+        const glm::vec3 position(attributes[0], attributes[1], attributes[2]);
+        const glm::vec3 normal = normalMatrix * glm::vec3(attributes[3], attributes[4], attributes[5]);
+        varyings[0] = normal.x;
+        varyings[1] = normal.y;
+        varyings[2] = normal.z;
+        varyings[3] = position.x;
+        varyings[4] = position.y;
+        varyings[5] = position.z;
+        return mvp * glm::vec4(position, 1.0f);
+    }
+
+    glm::vec4 fragment(const float* varyings) const {
+        const glm::vec3 n = glm::normalize(glm::vec3(varyings[0], varyings[1], varyings[2]));
+        const glm::vec3 v = glm::normalize(viewPos - glm::vec3(varyings[3], varyings[4], varyings[5]));
+
+        // 1. 半球环境光：顶部淡暖色与底部暗冷色按法线朝上的程度混合
+        const glm::vec3 sky(1.0f, 1.0f, 0.95f), ground(0.2f, 0.2f, 0.25f);
+        const float hemi = std::max(0.0f, n.y * 0.5f + 0.5f);
+        const glm::vec3 ambient = (ground + (sky - ground) * hemi) * 0.4f;
+
+        // 2. 主光源（方向光），方向为 normalize(0.5, 1.0, 0.8)
+        const glm::vec3 l(0.3567258f, 0.7134516f, 0.5707613f);
+        const float diff = std::max(glm::dot(n, l), 0.0f);
+        const glm::vec3 diffuse = glm::vec3(0.6f, 0.6f, 0.55f) * diff;
+
+        // 3. 边缘光：pow(1 - N·V, 4)
+        const float facing = 1.0f - std::max(glm::dot(n, v), 0.0f);
+        const float rim = facing * facing * facing * facing * 0.5f;
+
+        // 4. 奶白材质颜色 + gamma 校正
+        const glm::vec3 base(0.95f, 0.94f, 0.88f);
+        const glm::vec3 lit = ambient + diffuse + glm::vec3(rim);
+        const float gamma = 1.0f / 2.2f;
+        return { std::pow(lit.x * base.x, gamma), std::pow(lit.y * base.y, gamma), std::pow(lit.z * base.z, gamma), 1.0f };
+    }
+};
+
+}
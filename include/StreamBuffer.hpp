@@ -0,0 +1,272 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <vector>
+#include <glad/glad.h>
+
+#include "BenchUtils.hpp"
+#include "GLState.hpp"
+#include "Profiler.hpp"
+
+namespace glutils {
+
+/// @brief 流式缓冲的上传方式
+enum class StreamMode {
+    /// @brief 4.4 及以上用 Persistent，否则用 Unsynchronized
+    Auto,
+    /// @brief glBufferStorage 持久 + 一致映射，生产线程直接写入映射内存，栅栏保护正在使用的区间
+    Persistent,
+    /// @brief 每次分配 glMapBufferRange(GL_MAP_UNSYNCHRONIZED_BIT)，提交时取消映射，同样由栅栏保护。
+    /// 同一个缓冲同时只能映射一段，所以 commit 之前不能再次 allocate
+    Unsynchronized,
+    /// @brief 写入 CPU 暂存区，提交时 glBufferSubData；环绕时 glBufferData(nullptr) 孤立旧存储，不需要栅栏。
+    /// 环绕会丢弃旧存储的内容，已提交的分配必须在下一次 allocate 之前发出绘制
+    Orphan
+};
+
+inline const char* streamModeName(StreamMode mode) {
+    switch (mode) {
+    case StreamMode::Persistent: return "Persistent";
+    case StreamMode::Unsynchronized: return "Unsynchronized";
+    case StreamMode::Orphan: return "Orphan";
+    default: return "Auto";
+    }
+}
+
+// 流式缓冲的累计统计，时间单位为毫秒
+struct StreamBufferStats {
+    std::size_t bytes = 0;
+    std::size_t allocations = 0;
+    // 分配时区间仍被 GPU 使用、必须等待栅栏的次数
+    std::size_t stalls = 0;
+    double stallMs = 0.0;
+    std::size_t orphans = 0;
+};
+
+// 一次分配：data 在 commit 之前可以由任意线程写入，offset 是在缓冲中的字节偏移
+struct StreamAllocation {
+    void* data = nullptr;
+    std::size_t offset = 0;
+    std::size_t size = 0;
+
+    explicit operator bool() const { return data != nullptr; }
+};
+
+/**
+ * @brief 每帧都要重新上传的数据（例如实时传感器点云）用的环形顶点 / 索引 / uniform 缓冲
+ *
+ * 用法（allocate / commit / fence 必须在 GL 线程调用）：
+ *     auto a = ring.allocate(bytes);     // 必要时等待栅栏
+ *     ...生产线程把数据写进 a.data...
+ *     ring.commit(a);                    // 之后才能发出引用 [a.offset, a.offset + a.size) 的绘制
+ *     ...绘制...
+ *     ring.fence();                      // 每帧一次，保护本帧分配的区间直到 GPU 用完
+ *
+ * 同时最多只能有一个未提交的分配：Unsynchronized 模式下每次分配都是一次 glMapBufferRange，
+ * 缓冲已映射时再次映射会失败。为了让 4.4 上测试过的调用顺序在 3.3 回退路径上同样可用，
+ * 所有模式都检查这条规则，违反时返回空分配。多个生产线程应共享一次较大的分配，各写其中一段。
+ *
+ * Persistent / Unsynchronized 模式下，只有环绕回来碰到 GPU 还没读完的区间时才等待，
+ * 容量至少应是一帧数据量的 3 倍，正常情况下不会发生等待。
+ */
+class StreamBuffer {
+public:
+    StreamBuffer(GLenum target, std::size_t capacity, StreamMode mode = StreamMode::Auto)
+        : target(target), capacity(capacity), streamMode(mode) {
+        if (streamMode == StreamMode::Auto)
+            streamMode = GLAD_GL_VERSION_4_4 ? StreamMode::Persistent : StreamMode::Unsynchronized;
+        if (streamMode == StreamMode::Persistent && !GLAD_GL_VERSION_4_4) {
+            std::cerr << "glBufferStorage 需要 OpenGL 4.4，改用 Unsynchronized" << std::endl;
+            streamMode = StreamMode::Unsynchronized;
+        }
+
+        glGenBuffers(1, &vbo);
+        glState().bindBuffer(target, vbo);
+        if (streamMode == StreamMode::Persistent) {
+            constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            glBufferStorage(target, static_cast<GLsizeiptr>(capacity), nullptr, flags);
+            mapped = static_cast<std::uint8_t*>(glMapBufferRange(target, 0, static_cast<GLsizeiptr>(capacity), flags));
+            if (!mapped) {
+                // 不可变存储不能再用 glBufferData 重新分配，换一个缓冲
+                std::cerr << "持久映射失败，改用 Unsynchronized" << std::endl;
+                glState().deleteBuffer(vbo);
+                glGenBuffers(1, &vbo);
+                glState().bindBuffer(target, vbo);
+                streamMode = StreamMode::Unsynchronized;
+            }
+        }
+        if (streamMode != StreamMode::Persistent)
+            glBufferData(target, static_cast<GLsizeiptr>(capacity), nullptr, GL_STREAM_DRAW);
+        if (streamMode == StreamMode::Orphan)
+            staging.resize(capacity);
+    }
+
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    ~StreamBuffer() {
+        for (auto& region : inFlight)
+            glDeleteSync(region.fence);
+        if (mapped) {
+            glState().bindBuffer(target, vbo);
+            glUnmapBuffer(target);
+        }
+        glState().deleteBuffer(vbo);
+    }
+
+    /**
+     * @brief 分配 bytes 字节，起始偏移是 alignment 的整数倍（alignment 不必是 2 的幂，例如顶点跨度 12）
+     *
+     * @return 失败（请求超过容量，或没有调用 fence() 就把整个环写满）时返回空分配
+     */
+    StreamAllocation allocate(std::size_t bytes, std::size_t alignment = 16) {
+        GLUTILS_PROFILE_ZONE("StreamBuffer::allocate");
+        if (pending) {
+            std::cerr << "StreamBuffer: 上一次分配还没有 commit，不能再次分配" << std::endl;
+            return {};
+        }
+        alignment = alignment == 0 ? 1 : alignment;
+        std::size_t start = (head + alignment - 1) / alignment * alignment;
+        if (bytes > capacity) {
+            std::cerr << "StreamBuffer: 分配 " << bytes << " 字节超过容量 " << capacity << std::endl;
+            return {};
+        }
+        if (start + bytes > capacity) {
+            // 环绕：尾部剩余空间作废，也算作"已写入"，等同一个栅栏保护
+            written += capacity - head;
+            head = start = 0;
+            if (streamMode == StreamMode::Orphan) {
+                glState().bindBuffer(target, vbo);
+                glBufferData(target, static_cast<GLsizeiptr>(capacity), nullptr, GL_STREAM_DRAW);
+                ++counters.orphans;
+            }
+        }
+        const std::size_t end = written + (start - head) + bytes;
+        if (streamMode != StreamMode::Orphan && !waitUntilFree(end))
+            return {};
+
+        written = end;
+        head = start + bytes;
+        ++counters.allocations;
+
+        StreamAllocation allocation;
+        allocation.offset = start;
+        allocation.size = bytes;
+        switch (streamMode) {
+        case StreamMode::Persistent:
+            allocation.data = mapped + start;
+            break;
+        case StreamMode::Unsynchronized:
+            // 栅栏已经保证这段区间不再被 GPU 读取，映射不需要同步
+            glState().bindBuffer(target, vbo);
+            allocation.data = glMapBufferRange(target, static_cast<GLintptr>(start), static_cast<GLsizeiptr>(bytes),
+                                               GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+            if (!allocation.data)
+                std::cerr << "StreamBuffer: glMapBufferRange 失败" << std::endl;
+            break;
+        default:
+            allocation.data = staging.data() + start;
+            break;
+        }
+        pending = static_cast<bool>(allocation);
+        return allocation;
+    }
+
+    // 写入完成；之后才能发出使用这段数据的绘制命令
+    void commit(const StreamAllocation& allocation) {
+        if (!allocation)
+            return;
+        pending = false;
+        if (streamMode == StreamMode::Unsynchronized) {
+            glState().bindBuffer(target, vbo);
+            glUnmapBuffer(target);
+        } else if (streamMode == StreamMode::Orphan) {
+            glState().bindBuffer(target, vbo);
+            glBufferSubData(target, static_cast<GLintptr>(allocation.offset), static_cast<GLsizeiptr>(allocation.size), allocation.data);
+        }
+        counters.bytes += allocation.size;
+        GLUTILS_COUNT_UPLOAD(allocation.size);
+    }
+
+    // 在使用了本帧分配的所有绘制命令之后调用，保护这些区间直到 GPU 执行完
+    void fence() {
+        if (streamMode == StreamMode::Orphan || written == fenced)
+            return;
+        inFlight.push_back({ glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), written });
+        fenced = written;
+    }
+
+    unsigned int buffer() const { return vbo; }
+    GLenum bufferTarget() const { return target; }
+    std::size_t size() const { return capacity; }
+    StreamMode mode() const { return streamMode; }
+    const StreamBufferStats& stats() const { return counters; }
+    void resetStats() { counters = StreamBufferStats{}; }
+
+private:
+    struct Region {
+        GLsync fence;
+        // 栅栏插入时累计写入的字节数（单调递增，不回绕）
+        std::size_t written;
+    };
+
+    // 等到 [end - capacity, end) 不再与 GPU 尚未读完的区间重叠
+    bool waitUntilFree(std::size_t end) {
+        // 已经确认 GPU 用完的累计字节数：最后一个已触发的栅栏
+        while (end > retired + capacity) {
+            if (inFlight.empty()) {
+                std::cerr << "StreamBuffer: 环已写满，分配之间需要调用 fence()" << std::endl;
+                return false;
+            }
+            Region& oldest = inFlight.front();
+            GLenum result = glClientWaitSync(oldest.fence, 0, 0);
+            if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED) {
+                GLUTILS_PROFILE_ZONE("StreamBuffer stall");
+                Stopwatch timer;
+                ++counters.stalls;
+                do {
+                    result = glClientWaitSync(oldest.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+                } while (result == GL_TIMEOUT_EXPIRED);
+                counters.stallMs += timer.milliseconds();
+                if (result == GL_WAIT_FAILED)
+                    std::cerr << "StreamBuffer: glClientWaitSync 失败" << std::endl;
+            }
+            retired = oldest.written;
+            glDeleteSync(oldest.fence);
+            inFlight.pop_front();
+        }
+        // 顺便回收已经完成的栅栏，避免对象堆积
+        while (!inFlight.empty()) {
+            const GLenum result = glClientWaitSync(inFlight.front().fence, 0, 0);
+            if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED)
+                break;
+            retired = inFlight.front().written;
+            glDeleteSync(inFlight.front().fence);
+            inFlight.pop_front();
+        }
+        return true;
+    }
+
+    GLenum target;
+    std::size_t capacity;
+    StreamMode streamMode;
+    unsigned int vbo = 0;
+    std::uint8_t* mapped = nullptr;
+    std::vector<std::uint8_t> staging;
+    // 已分配但还没有 commit
+    bool pending = false;
+
+    // head 为环内下一个可用偏移；written / fenced / retired 是单调累计的字节数
+    std::size_t head = 0;
+    std::size_t written = 0;
+    std::size_t fenced = 0;
+    std::size_t retired = 0;
+    std::deque<Region> inFlight;
+    StreamBufferStats counters;
+};
+
+}
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Parallel.hpp"
+#include "Simd.hpp"
+
+namespace glutils {
+
+/**
+ * @brief 批量 TRS（平移 / 旋转 / 缩放）数据，每个分量一个数组（SoA）
+ *
+ * 旋转为单位四元数 (x, y, z, w)。按分量分开存放后，SIMD 内核一次从每个数组
+ * 连续读取 4 / 8 个实例的同一分量，不需要任何重排。
+ */
+struct TransformArrays {
+    std::vector<float> px, py, pz;
+    std::vector<float> qx, qy, qz, qw;
+    std::vector<float> sx, sy, sz;
+
+    std::size_t size() const { return px.size(); }
+
+    // 新增的实例为单位变换
+    void resize(std::size_t count) {
+        for (auto* a : { &px, &py, &pz, &qx, &qy, &qz })
+            a->resize(count, 0.0f);
+        for (auto* a : { &qw, &sx, &sy, &sz })
+            a->resize(count, 1.0f);
+    }
+
+    void set(std::size_t i, const glm::vec3& position, const glm::vec4& rotation, const glm::vec3& scale) {
+        px[i] = position.x; py[i] = position.y; pz[i] = position.z;
+        qx[i] = rotation.x; qy[i] = rotation.y; qz[i] = rotation.z; qw[i] = rotation.w;
+        sx[i] = scale.x; sy[i] = scale.y; sz[i] = scale.z;
+    }
+};
+
+namespace detail {
+
+// 列主序，与 glm::mat4 相同：m[列 * 4 + 行]
+inline void transformScalar(const TransformArrays& t, const float* vp, float* world, float* mvp, std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+        const float x = t.qx[i], y = t.qy[i], z = t.qz[i], w = t.qw[i];
+        const float w3[4][3] = {
+            { (1.0f - 2.0f * (y * y + z * z)) * t.sx[i], 2.0f * (x * y + w * z) * t.sx[i], 2.0f * (x * z - w * y) * t.sx[i] },
+            { 2.0f * (x * y - w * z) * t.sy[i], (1.0f - 2.0f * (x * x + z * z)) * t.sy[i], 2.0f * (y * z + w * x) * t.sy[i] },
+            { 2.0f * (x * z + w * y) * t.sz[i], 2.0f * (y * z - w * x) * t.sz[i], (1.0f - 2.0f * (x * x + y * y)) * t.sz[i] },
+            { t.px[i], t.py[i], t.pz[i] },
+        };
+        for (int c = 0; c < 4; ++c) {
+            const float h = c == 3 ? 1.0f : 0.0f;
+            if (world) {
+                float* out = world + i * 16 + c * 4;
+                out[0] = w3[c][0]; out[1] = w3[c][1]; out[2] = w3[c][2]; out[3] = h;
+            }
+            if (mvp) {
+                float* out = mvp + i * 16 + c * 4;
+                for (int r = 0; r < 4; ++r)
+                    out[r] = vp[r] * w3[c][0] + vp[4 + r] * w3[c][1] + vp[8 + r] * w3[c][2] + vp[12 + r] * h;
+            }
+        }
+    }
+}
+
+#ifdef GLUTILS_SSE2
+// 一次处理 4 个实例：各分量在寄存器的 4 个通道里，算完后按列转置写回 4 个矩阵
+inline void transformSse2(const TransformArrays& t, const float* vp, float* world, float* mvp, std::size_t begin, std::size_t end) {
+    const __m128 one = _mm_set1_ps(1.0f), two = _mm_set1_ps(2.0f), zero = _mm_setzero_ps();
+    std::size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        const __m128 x = _mm_loadu_ps(&t.qx[i]), y = _mm_loadu_ps(&t.qy[i]), z = _mm_loadu_ps(&t.qz[i]), w = _mm_loadu_ps(&t.qw[i]);
+        const __m128 sx = _mm_loadu_ps(&t.sx[i]), sy = _mm_loadu_ps(&t.sy[i]), sz = _mm_loadu_ps(&t.sz[i]);
+        const __m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+        const __m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+        const __m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+        __m128 m[4][4] = {
+            { _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx), _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx),
+              _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx), zero },
+            { _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy), _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy),
+              _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy), zero },
+            { _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz), _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz),
+              _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz), zero },
+            { _mm_loadu_ps(&t.px[i]), _mm_loadu_ps(&t.py[i]), _mm_loadu_ps(&t.pz[i]), one },
+        };
+        if (world) {
+            for (int c = 0; c < 4; ++c) {
+                __m128 r0 = m[c][0], r1 = m[c][1], r2 = m[c][2], r3 = m[c][3];
+                _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+                _mm_storeu_ps(world + (i + 0) * 16 + c * 4, r0);
+                _mm_storeu_ps(world + (i + 1) * 16 + c * 4, r1);
+                _mm_storeu_ps(world + (i + 2) * 16 + c * 4, r2);
+                _mm_storeu_ps(world + (i + 3) * 16 + c * 4, r3);
+            }
+        }
+        if (mvp) {
+            for (int c = 0; c < 4; ++c) {
+                __m128 r[4];
+                for (int row = 0; row < 4; ++row) {
+                    __m128 sum = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(vp[row]), m[c][0]), _mm_mul_ps(_mm_set1_ps(vp[4 + row]), m[c][1]));
+                    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(vp[8 + row]), m[c][2]));
+                    r[row] = c == 3 ? _mm_add_ps(sum, _mm_set1_ps(vp[12 + row])) : sum;
+                }
+                _MM_TRANSPOSE4_PS(r[0], r[1], r[2], r[3]);
+                for (int k = 0; k < 4; ++k)
+                    _mm_storeu_ps(mvp + (i + k) * 16 + c * 4, r[k]);
+            }
+        }
+    }
+    transformScalar(t, vp, world, mvp, i, end);
+}
+#endif
+
+#ifdef GLUTILS_AVX2
+// 把 4 个寄存器（4 行 × 8 个实例）转置成 8 个实例各自的一列并写回
+GLUTILS_TARGET_AVX2 inline void storeColumns8(float* base, std::size_t column, __m256 r0, __m256 r1, __m256 r2, __m256 r3) {
+    const __m256 t0 = _mm256_unpacklo_ps(r0, r1), t1 = _mm256_unpackhi_ps(r0, r1);
+    const __m256 t2 = _mm256_unpacklo_ps(r2, r3), t3 = _mm256_unpackhi_ps(r2, r3);
+    // u0 为实例 0 / 4 的列，u1 为 1 / 5，依此类推（低 128 位 / 高 128 位）
+    const __m256 u[4] = {
+        _mm256_shuffle_ps(t0, t2, 0x44), _mm256_shuffle_ps(t0, t2, 0xEE),
+        _mm256_shuffle_ps(t1, t3, 0x44), _mm256_shuffle_ps(t1, t3, 0xEE),
+    };
+    for (int k = 0; k < 4; ++k) {
+        _mm_storeu_ps(base + k * 16 + column * 4, _mm256_castps256_ps128(u[k]));
+        _mm_storeu_ps(base + (k + 4) * 16 + column * 4, _mm256_extractf128_ps(u[k], 1));
+    }
+}
+
+// 一次处理 8 个实例，与 SSE2 版本相同的计算，乘加用 FMA
+GLUTILS_TARGET_AVX2 inline void transformAvx2(const TransformArrays& t, const float* vp, float* world, float* mvp, std::size_t begin, std::size_t end) {
+    const __m256 one = _mm256_set1_ps(1.0f), two = _mm256_set1_ps(2.0f), zero = _mm256_setzero_ps();
+    std::size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        const __m256 x = _mm256_loadu_ps(&t.qx[i]), y = _mm256_loadu_ps(&t.qy[i]), z = _mm256_loadu_ps(&t.qz[i]), w = _mm256_loadu_ps(&t.qw[i]);
+        const __m256 sx = _mm256_loadu_ps(&t.sx[i]), sy = _mm256_loadu_ps(&t.sy[i]), sz = _mm256_loadu_ps(&t.sz[i]);
+        const __m256 xx = _mm256_mul_ps(x, x), yy = _mm256_mul_ps(y, y), zz = _mm256_mul_ps(z, z);
+        const __m256 xy = _mm256_mul_ps(x, y), xz = _mm256_mul_ps(x, z), yz = _mm256_mul_ps(y, z);
+        const __m256 wx = _mm256_mul_ps(w, x), wy = _mm256_mul_ps(w, y), wz = _mm256_mul_ps(w, z);
+        const __m256 m[4][4] = {
+            { _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(yy, zz), one), sx), _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xy, wz)), sx),
+              _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xz, wy)), sx), zero },
+            { _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xy, wz)), sy), _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(xx, zz), one), sy),
+              _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(yz, wx)), sy), zero },
+            { _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xz, wy)), sz), _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(yz, wx)), sz),
+              _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(xx, yy), one), sz), zero },
+            { _mm256_loadu_ps(&t.px[i]), _mm256_loadu_ps(&t.py[i]), _mm256_loadu_ps(&t.pz[i]), one },
+        };
+        if (world) {
+            for (std::size_t c = 0; c < 4; ++c)
+                storeColumns8(world + i * 16, c, m[c][0], m[c][1], m[c][2], m[c][3]);
+        }
+        if (mvp) {
+            for (std::size_t c = 0; c < 4; ++c) {
+                __m256 r[4];
+                for (int row = 0; row < 4; ++row) {
+                    __m256 sum = _mm256_mul_ps(_mm256_set1_ps(vp[row]), m[c][0]);
+                    sum = _mm256_fmadd_ps(_mm256_set1_ps(vp[4 + row]), m[c][1], sum);
+                    sum = _mm256_fmadd_ps(_mm256_set1_ps(vp[8 + row]), m[c][2], sum);
+                    r[row] = c == 3 ? _mm256_add_ps(sum, _mm256_set1_ps(vp[12 + row])) : sum;
+                }
+                storeColumns8(mvp + i * 16, c, r[0], r[1], r[2], r[3]);
+            }
+        }
+    }
+    transformScalar(t, vp, world, mvp, i, end);
+}
+#endif
+
+}
+
+/**
+ * @brief 计算 [begin, end) 范围内实例的世界矩阵和 MVP 矩阵
+ *
+ * world[i] = T * R * S，mvp[i] = viewProjection * world[i]；
+ * world、mvp 可以为 nullptr，表示不需要该输出。
+ * level 高于本机或本次编译支持的级别时自动降级。
+ */
+inline void computeTransforms(const TransformArrays& transforms, const glm::mat4& viewProjection, glm::mat4* world, glm::mat4* mvp,
+                              std::size_t begin, std::size_t end, SimdLevel level = detectSimdLevel()) {
+    const float* vp = &viewProjection[0][0];
+    float* worldOut = world ? &world[0][0][0] : nullptr;
+    float* mvpOut = mvp ? &mvp[0][0][0] : nullptr;
+    level = std::min(level, detectSimdLevel());
+#ifdef GLUTILS_AVX2
+    if (level == SimdLevel::AVX2)
+        return detail::transformAvx2(transforms, vp, worldOut, mvpOut, begin, end);
+#endif
+#ifdef GLUTILS_SSE2
+    if (level >= SimdLevel::SSE2)
+        return detail::transformSse2(transforms, vp, worldOut, mvpOut, begin, end);
+#endif
+    detail::transformScalar(transforms, vp, worldOut, mvpOut, begin, end);
+}
+
+// 同上，处理全部实例，按 grain 个实例一块分给所有核心
+inline void computeTransformsParallel(const TransformArrays& transforms, const glm::mat4& viewProjection, glm::mat4* world, glm::mat4* mvp,
+                                      SimdLevel level = detectSimdLevel(), std::size_t grain = 8192) {
+    parallelFor(transforms.size(), grain, [&](std::size_t begin, std::size_t end) {
+        computeTransforms(transforms, viewProjection, world, mvp, begin, end, level);
+    });
+}
+
+/**
+ * @brief 法线矩阵：模型矩阵左上 3x3 的逆的转置，把物体空间法线变换到世界空间
+ *
+ * 每次绘制在 CPU 上算一次，作为 uniform 传给着色器，避免在顶点着色器里对每个顶点求 4x4 逆矩阵。
+ * 只含旋转和均匀缩放时结果与 mat3(model) 只差一个系数，着色器归一化后相同。
+ */
+inline glm::mat3 normalMatrix(const glm::mat4& model) {
+    return glm::transpose(glm::inverse(glm::mat3(model)));
+}
+
+}
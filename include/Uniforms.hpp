@@ -0,0 +1,319 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "GLState.hpp"
+#include "Profiler.hpp"
+
+namespace glutils {
+
+namespace detail {
+
+// 64 位 FNV-1a，可在编译期求值
+constexpr std::uint64_t fnv1a(std::string_view data, std::uint64_t hash = 0xcbf29ce484222325ull) {
+    for (char c : data) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+// 数组 uniform 的活动名称形如 "lights[0]"，去掉末尾的 "[0]" 后再求哈希
+inline std::string_view stripArraySuffix(std::string_view name) {
+    if (name.size() > 3 && name.substr(name.size() - 3) == "[0]")
+        name.remove_suffix(3);
+    return name;
+}
+
+}
+
+/**
+ * @brief uniform 名称的哈希
+ *
+ * 用字符串字面量构造时在编译期求哈希，运行期只剩一次整数查表：shader.setUniform("mvp", mvp)。
+ * 运行期拼出来的名称用 UniformName::fromString。
+ */
+struct UniformName {
+    std::uint64_t hash;
+
+    consteval UniformName(const char* name) : hash(detail::fnv1a(name)) {}
+
+    static UniformName fromString(std::string_view name) { return UniformName(detail::fnv1a(name), 0); }
+
+private:
+    constexpr UniformName(std::uint64_t hash, int) : hash(hash) {}
+};
+
+/**
+ * @brief C++ 类型到 glUniform* 调用的映射
+ *
+ * 未特化的类型不能作为 uniform 设置。
+ */
+template<typename T>
+struct UniformTraits;
+
+template<> struct UniformTraits<float> { static void upload(GLint l, GLsizei n, const float* v) { glUniform1fv(l, n, v); } };
+template<> struct UniformTraits<int> { static void upload(GLint l, GLsizei n, const int* v) { glUniform1iv(l, n, v); } };
+template<> struct UniformTraits<unsigned int> { static void upload(GLint l, GLsizei n, const unsigned int* v) { glUniform1uiv(l, n, v); } };
+template<> struct UniformTraits<glm::vec2> { static void upload(GLint l, GLsizei n, const glm::vec2* v) { glUniform2fv(l, n, glm::value_ptr(*v)); } };
+template<> struct UniformTraits<glm::vec3> { static void upload(GLint l, GLsizei n, const glm::vec3* v) { glUniform3fv(l, n, glm::value_ptr(*v)); } };
+template<> struct UniformTraits<glm::vec4> { static void upload(GLint l, GLsizei n, const glm::vec4* v) { glUniform4fv(l, n, glm::value_ptr(*v)); } };
+template<> struct UniformTraits<glm::ivec2> { static void upload(GLint l, GLsizei n, const glm::ivec2* v) { glUniform2iv(l, n, glm::value_ptr(*v)); } };
+template<> struct UniformTraits<glm::ivec3> { static void upload(GLint l, GLsizei n, const glm::ivec3* v) { glUniform3iv(l, n, glm::value_ptr(*v)); } };
+template<> struct UniformTraits<glm::ivec4> { static void upload(GLint l, GLsizei n, const glm::ivec4* v) { glUniform4iv(l, n, glm::value_ptr(*v)); } };
+template<> struct UniformTraits<glm::mat3> { static void upload(GLint l, GLsizei n, const glm::mat3* v) { glUniformMatrix3fv(l, n, GL_FALSE, glm::value_ptr(*v)); } };
+template<> struct UniformTraits<glm::mat4> { static void upload(GLint l, GLsizei n, const glm::mat4* v) { glUniformMatrix4fv(l, n, GL_FALSE, glm::value_ptr(*v)); } };
+
+template<typename T>
+concept uniform_value = requires(GLint l, GLsizei n, const T* v) { UniformTraits<T>::upload(l, n, v); };
+
+namespace detail {
+
+// GL 类型在默认 uniform 块中占用的字节数（用于影子副本）
+inline std::size_t uniformTypeBytes(GLenum type) {
+    switch (type) {
+    case GL_FLOAT: case GL_INT: case GL_UNSIGNED_INT: case GL_BOOL: return 4;
+    case GL_FLOAT_VEC2: case GL_INT_VEC2: case GL_UNSIGNED_INT_VEC2: case GL_BOOL_VEC2: return 8;
+    case GL_FLOAT_VEC3: case GL_INT_VEC3: case GL_UNSIGNED_INT_VEC3: case GL_BOOL_VEC3: return 12;
+    case GL_FLOAT_VEC4: case GL_INT_VEC4: case GL_UNSIGNED_INT_VEC4: case GL_BOOL_VEC4: case GL_FLOAT_MAT2: return 16;
+    case GL_FLOAT_MAT3: return 36;
+    case GL_FLOAT_MAT4: return 64;
+    case GL_FLOAT_MAT2x3: case GL_FLOAT_MAT3x2: return 24;
+    case GL_FLOAT_MAT2x4: case GL_FLOAT_MAT4x2: return 32;
+    case GL_FLOAT_MAT3x4: case GL_FLOAT_MAT4x3: return 48;
+    default: return 4; // 采样器、图像等：一个整数单元号
+    }
+}
+
+}
+
+// 默认 uniform 块中的一个活动 uniform
+struct UniformInfo {
+    std::uint64_t hash;
+    GLint location;
+    GLenum type;
+    GLint arraySize;
+    // 影子副本在 UniformTable::shadow 中的偏移与长度
+    std::uint32_t shadowOffset;
+    std::uint32_t shadowBytes;
+};
+
+// uniform 块中的一个成员，偏移和步长由驱动按块布局给出
+struct UniformBlockMember {
+    std::uint64_t hash;
+    GLenum type;
+    GLint offset;
+    GLint arraySize;
+    GLint arrayStride;
+    GLint matrixStride;
+};
+
+// 程序中的一个活动 uniform 块
+struct UniformBlockInfo {
+    std::uint64_t hash;
+    GLuint index;
+    GLint dataSize;
+    std::vector<UniformBlockMember> members;
+
+    const UniformBlockMember* member(UniformName name) const {
+        auto it = std::lower_bound(members.begin(), members.end(), name.hash, [](const UniformBlockMember& m, std::uint64_t h) { return m.hash < h; });
+        return it != members.end() && it->hash == name.hash ? &*it : nullptr;
+    }
+};
+
+/**
+ * @brief 程序的 uniform 表
+ *
+ * 链接后调用一次 introspect()，把所有活动 uniform 与 uniform 块按名称哈希排序存进连续数组，
+ * 之后的查找是整数二分而不是 glGetUniformLocation 的字符串比较。
+ * 每个 uniform 在 shadow 中保留上一次上传的值，值没有变化时跳过 glUniform* 调用。
+ */
+class UniformTable {
+public:
+    void introspect(GLuint program) {
+        uniforms.clear();
+        blocks.clear();
+        shadow.clear();
+
+        GLint count = 0, maxLength = 0;
+        glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+        std::string name(static_cast<std::size_t>(std::max(maxLength, 1)), '\0');
+        std::vector<UniformBlockMember> blockMembers;
+        std::vector<GLint> memberBlock;
+        for (GLuint i = 0; i < static_cast<GLuint>(count); ++i) {
+            GLsizei length = 0;
+            GLint size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(program, i, static_cast<GLsizei>(name.size()), &length, &size, &type, name.data());
+            const std::uint64_t hash = detail::fnv1a(detail::stripArraySuffix(std::string_view(name.data(), static_cast<std::size_t>(length))));
+
+            GLint blockIndex = -1;
+            glGetActiveUniformsiv(program, 1, &i, GL_UNIFORM_BLOCK_INDEX, &blockIndex);
+            if (blockIndex >= 0) {
+                UniformBlockMember member{ hash, type, 0, size, 0, 0 };
+                glGetActiveUniformsiv(program, 1, &i, GL_UNIFORM_OFFSET, &member.offset);
+                glGetActiveUniformsiv(program, 1, &i, GL_UNIFORM_ARRAY_STRIDE, &member.arrayStride);
+                glGetActiveUniformsiv(program, 1, &i, GL_UNIFORM_MATRIX_STRIDE, &member.matrixStride);
+                blockMembers.push_back(member);
+                memberBlock.push_back(blockIndex);
+                continue;
+            }
+            const std::uint32_t bytes = static_cast<std::uint32_t>(detail::uniformTypeBytes(type) * static_cast<std::size_t>(size));
+            uniforms.push_back({ hash, glGetUniformLocation(program, name.c_str()), type, size, static_cast<std::uint32_t>(shadow.size()), bytes });
+            shadow.resize(shadow.size() + bytes);
+        }
+        std::sort(uniforms.begin(), uniforms.end(), [](const UniformInfo& a, const UniformInfo& b) { return a.hash < b.hash; });
+        // 影子副本里还没有有效值
+        valid.assign(uniforms.size(), 0);
+
+        GLint blockCount = 0, maxBlockName = 0;
+        glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCKS, &blockCount);
+        glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxBlockName);
+        std::string blockName(static_cast<std::size_t>(std::max(maxBlockName, 1)), '\0');
+        for (GLuint b = 0; b < static_cast<GLuint>(blockCount); ++b) {
+            GLsizei length = 0;
+            glGetActiveUniformBlockName(program, b, static_cast<GLsizei>(blockName.size()), &length, blockName.data());
+            UniformBlockInfo block{ detail::fnv1a(std::string_view(blockName.data(), static_cast<std::size_t>(length))), b, 0, {} };
+            glGetActiveUniformBlockiv(program, b, GL_UNIFORM_BLOCK_DATA_SIZE, &block.dataSize);
+            for (std::size_t m = 0; m < blockMembers.size(); ++m) {
+                if (memberBlock[m] == static_cast<GLint>(b))
+                    block.members.push_back(blockMembers[m]);
+            }
+            std::sort(block.members.begin(), block.members.end(), [](const UniformBlockMember& x, const UniformBlockMember& y) { return x.hash < y.hash; });
+            blocks.push_back(std::move(block));
+        }
+        std::sort(blocks.begin(), blocks.end(), [](const UniformBlockInfo& a, const UniformBlockInfo& b) { return a.hash < b.hash; });
+    }
+
+    const UniformInfo* find(UniformName name) const {
+        auto it = std::lower_bound(uniforms.begin(), uniforms.end(), name.hash, [](const UniformInfo& u, std::uint64_t h) { return u.hash < h; });
+        return it != uniforms.end() && it->hash == name.hash ? &*it : nullptr;
+    }
+
+    const UniformBlockInfo* block(UniformName name) const {
+        auto it = std::lower_bound(blocks.begin(), blocks.end(), name.hash, [](const UniformBlockInfo& b, std::uint64_t h) { return b.hash < h; });
+        return it != blocks.end() && it->hash == name.hash ? &*it : nullptr;
+    }
+
+    /**
+     * @brief 设置 uniform（数组时从第 0 个元素开始设置 count 个），程序必须已经 glUseProgram
+     *
+     * @return 实际调用了 glUniform* 时返回 true；名称不存在或值未变化时返回 false
+     */
+    template<uniform_value T>
+    bool set(UniformName name, const T* values, std::size_t count = 1) {
+        const UniformInfo* info = find(name);
+        if (!info)
+            return false;
+        count = std::min(count, static_cast<std::size_t>(info->arraySize));
+        const std::size_t bytes = std::min(sizeof(T) * count, static_cast<std::size_t>(info->shadowBytes));
+        const std::size_t index = static_cast<std::size_t>(info - uniforms.data());
+        std::byte* cached = shadow.data() + info->shadowOffset;
+        if (valid[index] && std::memcmp(cached, values, bytes) == 0)
+            return false;
+        std::memcpy(cached, values, bytes);
+        valid[index] = 1;
+        UniformTraits<T>::upload(info->location, static_cast<GLsizei>(count), values);
+        GLUTILS_COUNT_UPLOAD(bytes);
+        return true;
+    }
+
+    // 外部直接调用 glUniform* 修改过程序后，丢弃影子副本
+    void invalidate() { std::fill(valid.begin(), valid.end(), 0); }
+
+    const std::vector<UniformInfo>& all() const { return uniforms; }
+    const std::vector<UniformBlockInfo>& allBlocks() const { return blocks; }
+
+private:
+    std::vector<UniformInfo> uniforms;
+    std::vector<UniformBlockInfo> blocks;
+    std::vector<std::byte> shadow;
+    std::vector<char> valid;
+};
+
+/**
+ * @brief 按 uniform 块布局打包的 UBO
+ *
+ * 布局取自某个程序中该块的内省结果（成员偏移、数组步长、矩阵步长），着色器端应声明 layout(std140)，
+ * 这样所有程序中同名块的布局一致，一个 UBO 可以同时绑定给多个程序。
+ * set() 只写 CPU 端暂存并记录脏区间，flush() 用一次 glBufferSubData 上传整个脏区间。
+ */
+class UniformBuffer {
+public:
+    UniformBuffer(const UniformBlockInfo& block, GLuint binding) : layout(block), binding(binding), staging(static_cast<std::size_t>(block.dataSize)) {
+        glGenBuffers(1, &ubo);
+        glState().bindBuffer(GL_UNIFORM_BUFFER, ubo);
+        glBufferData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(staging.size()), nullptr, GL_DYNAMIC_DRAW);
+        glState().bindBufferBase(GL_UNIFORM_BUFFER, binding, ubo);
+    }
+
+    UniformBuffer(const UniformBuffer&) = delete;
+    UniformBuffer& operator=(const UniformBuffer&) = delete;
+
+    ~UniformBuffer() { glState().deleteBuffer(ubo); }
+
+    /**
+     * @brief 写入块成员（数组时写入第 element 个元素），值未变化时不标脏
+     *
+     * @return 成员存在时返回 true
+     */
+    template<uniform_value T>
+    bool set(UniformName name, const T& value, std::size_t element = 0) {
+        const UniformBlockMember* member = layout.member(name);
+        if (!member || element >= static_cast<std::size_t>(member->arraySize))
+            return false;
+        std::size_t offset = static_cast<std::size_t>(member->offset) + element * static_cast<std::size_t>(member->arrayStride);
+        if constexpr (std::is_same_v<T, glm::mat3> || std::is_same_v<T, glm::mat4>) {
+            // 矩阵按列存放，每列占 matrixStride 字节（std140 下 mat3 的列补齐到 16 字节）
+            for (int column = 0; column < T::length(); ++column)
+                write(offset + std::size_t(column) * static_cast<std::size_t>(member->matrixStride), glm::value_ptr(value[column]), sizeof(value[column]));
+        } else {
+            write(offset, &value, sizeof(T));
+        }
+        return true;
+    }
+
+    // 上传脏区间，没有修改时不产生任何 GL 调用
+    void flush() {
+        if (dirtyBegin >= dirtyEnd)
+            return;
+        glState().bindBuffer(GL_UNIFORM_BUFFER, ubo);
+        glBufferSubData(GL_UNIFORM_BUFFER, static_cast<GLintptr>(dirtyBegin), static_cast<GLsizeiptr>(dirtyEnd - dirtyBegin), staging.data() + dirtyBegin);
+        GLUTILS_COUNT_UPLOAD(dirtyEnd - dirtyBegin);
+        dirtyBegin = staging.size();
+        dirtyEnd = 0;
+    }
+
+    unsigned int buffer() const { return ubo; }
+    GLuint bindingPoint() const { return binding; }
+
+private:
+    void write(std::size_t offset, const void* data, std::size_t bytes) {
+        if (offset + bytes > staging.size() || std::memcmp(staging.data() + offset, data, bytes) == 0)
+            return;
+        std::memcpy(staging.data() + offset, data, bytes);
+        dirtyBegin = std::min(dirtyBegin, offset);
+        dirtyEnd = std::max(dirtyEnd, offset + bytes);
+    }
+
+    UniformBlockInfo layout;
+    GLuint binding;
+    unsigned int ubo = 0;
+    std::vector<std::byte> staging;
+    // 初始时整个缓冲都需要上传
+    std::size_t dirtyBegin = 0;
+    std::size_t dirtyEnd = staging.size();
+};
+
+}
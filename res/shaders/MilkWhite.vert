@@ -2,11 +2,12 @@
 layout(location=0) in vec3 aPos;
 layout(location=1) in vec3 aNormal;
 uniform mat4 mvp;
-uniform mat4 model;
+// transpose(inverse(mat3(model)))，每次绘制在 CPU 上算一次（glutils::normalMatrix）
+uniform mat3 normalMatrix;
 out vec3 vNormal;
 out vec3 vPos;
 void main(){
     vPos = aPos;
-    vNormal = mat3(transpose(inverse(model))) * aNormal;
+    vNormal = normalMatrix * aNormal;
     gl_Position = mvp * vec4(aPos, 1.0);
 }
\ No newline at end of file